@@ -45,7 +45,7 @@ struct Bdd {
   //________________________________________
   //  Should be private:
 
-    Bdd(DdManager* d, DdNode* n) : dd(d), node(n) { Cudd_Ref(node); }
+    Bdd(DdManager* d, DdNode* n) : dd(d), node(n) { if (!null()) Cudd_Ref(node); }     // -- CUDD returns NULL when out of resources
 
     DdManager* dd;
     DdNode*    node;
@@ -113,6 +113,10 @@ macro Bdd bddAndExist(const Bdd& x, const Bdd& y, const Bdd& quant) {
 macro Bdd bddExist(const Bdd& x, const Bdd& quant) {
     return Bdd(x.dd, Cudd_bddAndAbstract(x.dd, x.node, Cudd_ReadOne(x.dd), quant.node)); }
 
+macro Bdd bddRestrict(const Bdd& x, const Bdd& care) {     // -- agrees with 'x' on 'care', smaller (hopefully) elsewhere
+    assert(x.dd == care.dd);
+    return Bdd(x.dd, Cudd_bddRestrict(x.dd, x.node, care.node)); }
+
 macro Bdd bddSupport(const Bdd& x) {
     return Bdd(x.dd, Cudd_Support(x.dd, x.node)); }
 
@@ -122,6 +126,9 @@ macro bool bddIntersect_p(const Bdd& x, const Bdd& y) {     // -- returns TRUE i
     DdNode* ret = Cudd_bddIteConstant(x.dd, x.node, y.node, ff); Cudd_Deref(ff);
     return ret != ff; }
 
+macro uint bddSize(const Bdd& x) {
+    return Cudd_DagSize(x.node); }
+
 
 //=================================================================================================
 // -- BDD manager:
@@ -135,12 +142,15 @@ public:
    ~BddMgr()                { Cudd_Quit(dd); }
 
     void setReorder(bool on) { if (on) Cudd_AutodynEnable(dd, CUDD_REORDER_SIFT); else Cudd_AutodynDisable(dd); }
+    void reorder() { Cudd_ReduceHeap(dd, CUDD_REORDER_SIFT, 0); }
+    void group(uint idx, uint n) { Cudd_MakeTreeNode(dd, idx, n, MTR_FIXED); }    // -- variables 'idx..idx+n-1' are kept adjacent and in order by reordering
     Bdd  True() { return Bdd(dd, Cudd_ReadOne(dd)); }
     Bdd  var(uint idx) { return Bdd(dd, Cudd_bddIthVar(dd, idx)); }
 
     // Statistics:
     uint nodeCount() const { return Cudd_ReadKeys(dd); }
     uint deadCount() const { return Cudd_ReadDead(dd); }
+    uint reorderCount() const { return Cudd_ReadReorderings(dd); }
 };
 
 
@@ -237,242 +247,343 @@ Bdd remapBdd(const Bdd& b, IntMap<uint,uint>& varmap)
 }
 #endif
 
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Variable order and quantification schedule:
+
+
+enum { var_PI, var_Cur, var_Next };
+
+
+// PIs and flops in the order they are reached by a depth-first traversal from 'w_bad', then from
+// the next-state function of each flop found so far (in order). Sources not in the cone of the
+// property are put last.
+static
+void sourceOrder(NetlistRef N, Wire w_bad, Vec<GLit>& srcs)
+{
+    WZet      seen;
+    Vec<GLit> Q;
+    uint      next = 0;
+    Wire      root = w_bad;
+    for(;;){
+        Q.push(+root);
+        while (Q.size() > 0){
+            Wire w = N[Q.popC()];
+            if (seen.add(w)) continue;
+
+            if (type(w) == gate_PI || type(w) == gate_Flop)
+                srcs.push(w);
+            else{
+                for (uint i = w.size(); i > 0; i--)
+                    if (w[i-1]) Q.push(+w[i-1]);
+            }
+        }
+
+        while (next < srcs.size() && type(N[srcs[next]]) != gate_Flop) next++;
+        if (next == srcs.size()) break;
+        root = N[srcs[next++]][0];
+    }
+
+    For_Gatetype(N, gate_PI  , w) if (!seen.has(w)) srcs.push(w);
+    For_Gatetype(N, gate_Flop, w) if (!seen.has(w)) srcs.push(w);
+}
+
+
+// Variables of 'f' except next-state variables.
+static
+void supportVars(const Bdd& f, const Vec<uchar>& var_kind, Vec<uint>& out)
+{
+    out.clear();
+    Bdd b = bddSupport(f);
+    while (!b.isConst()){
+        if (var_kind[b.index()] != var_Next)
+            out.push(b.index());
+        b = b[1];
+    }
+}
+
+
+// Greedy ordering of the conjuncts of the transition relation (in the spirit of IWLS95 and MLP):
+// next conjunct is the one that brings the fewest new variables into the product while allowing
+// the most variables to be quantified away (ties broken on BDD size). Current-state variables
+// are "active" from the start (they are in the support of the set we compute the image of).
+static
+void orderConjuncts(const Vec<Vec<uint> >& sup, const Vec<uint>& size, const Vec<uchar>& var_kind, Vec<uint>& order)
+{
+    Vec<uint>  occ(var_kind.size(), 0);
+    Vec<uchar> active(var_kind.size(), 0);
+    Vec<uchar> done(sup.size(), 0);
+    for (uint i = 0; i < sup.size(); i++)
+        for (uint j = 0; j < sup[i].size(); j++)
+            occ[sup[i][j]]++;
+    for (uint v = 0; v < var_kind.size(); v++)
+        active[v] = (var_kind[v] == var_Cur);
+
+    order.clear();
+    while (order.size() < sup.size()){
+        uint best = UINT_MAX;
+        int  best_cost = INT_MAX;
+        for (uint i = 0; i < sup.size(); i++){
+            if (done[i]) continue;
+            int cost = 0;
+            for (uint j = 0; j < sup[i].size(); j++){
+                uint v = sup[i][j];
+                if (!active[v])  cost++;
+                if (occ[v] == 1) cost -= 2;
+            }
+            if (cost < best_cost || (cost == best_cost && size[i] < size[best])){
+                best = i;
+                best_cost = cost; }
+        }
+
+        done[best] = 1;
+        order.push(best);
+        for (uint j = 0; j < sup[best].size(); j++){
+            uint v = sup[best][j];
+            active[v] = 1;
+            occ[v]--;
+        }
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Reachability:
+
+
 /*
-DdNode *
-Cudd_bddSwapVariables(
-  DdManager * dd,
-  DdNode * f,
-  DdNode ** x,
-  DdNode ** y,
-  int  n
-)
-*/
+The transition relation is kept partitioned: one conjunct 's' <-> f(s,x)' per flop, merged
+greedily into clusters of at most 'P.cluster_lim' nodes. The image of a set 'S' is computed as:
 
+    Img(S) = Exists(Q_k, ... Exists(Q_1, Exists(Q_0, S) & C_1) ... & C_k)
 
-lbool bddReach(NetlistRef N0, const Vec<Wire>& props, const Params_BddReach& P)
+where 'Q_j' holds the variables whose last occurrence is in cluster 'C_j' ('Q_0' the state
+variables of no cluster). Inputs only occurring in one cluster are quantified from it once and
+for all. Next-state functions are built in topological order, freeing each node's BDD after its
+last fanout has been processed.
+*/
+lbool bddReach(NetlistRef N0, const Vec<Wire>& props, const Params_BddReach& P, int* bug_free_depth)
 {
+    if (bug_free_depth) *bug_free_depth = -1;
+
     // Initialize netlist:
     Netlist N;
     initBmcNetlist(N0, props, N, true);
+    Get_Pob(N, init_bad);
+    Get_Pob(N, flop_init);
 
-    Vec<uint> pi_idx, si_idx, so_idx;   // -- maps from "number" attribute.
-    IntZet<uint> sos;            // -- map state-output indices to state-inputs (so_idx -> si_idx)
-    uint n_vars = 0;
-    For_Gatetype(N, gate_PI, w)
-        pi_idx(attr_PI(w).number, UINT_MAX) = n_vars++;
-    For_Gatetype(N, gate_Flop, w){
-        si_idx(attr_Flop(w).number, UINT_MAX) = n_vars;
-        so_idx(attr_Flop(w).number, UINT_MAX) = n_vars + 1;
-        sos.add(n_vars + 1);
-        n_vars += 2;
+    // Allocate variables (current and next state of a flop are adjacent):
+    Vec<GLit> srcs;
+    sourceOrder(N, init_bad[1], srcs);
+
+    WMap<uint> var_of(UINT_MAX);    // -- PI or flop -> variable index (for flops, next state is 'var_of[w] + 1')
+    Vec<uchar> var_kind;
+    Vec<GLit>  flops;
+    for (uint i = 0; i < srcs.size(); i++){
+        Wire w = N[srcs[i]];
+        var_of(w) = var_kind.size();
+        if (type(w) == gate_PI)
+            var_kind.push(var_PI);
+        else{
+            var_kind.push(var_Cur);
+            var_kind.push(var_Next);
+            flops.push(w);
+        }
     }
+    uint n_vars = var_kind.size();
 
     // Initialize BDD manager:
     BddMgr B(n_vars);
+    for (uint i = 0; i < flops.size(); i++)
+        B.group(var_of[N[flops[i]]], 2);
     B.setReorder(P.var_reorder);
 
-    // Build transition functions:
+    // Build next-state functions:
     Add_Pob(N, up_order);
+    WMap<uint> n_refs(0);
+    For_Gatetype(N, gate_Flop, w)
+        n_refs(w[0])++;
+    n_refs(init_bad[1])++;
+    for (uintg i = 0; i < up_order.size(); i++){
+        Wire w = N[up_order[i]];
+        if (type(w) == gate_And || type(w) == gate_PO)
+            For_Inputs(w, v)
+                n_refs(v)++;
+    }
+
     WMap<Bdd> n2b;
     n2b(N.True()) = B.True();
-    /**/WriteLn "Building transition relation:";
+    uint peak = 0;
     for (uintg i = 0; i < up_order.size(); i++){
-        /**/Write "\r%_ / %_   (mem: %DB)\f", i, up_order.size(), memUsed();
+        if (!P.quiet && (i & 1023) == 0)
+            Write "\rBuilding next-state functions: %_ / %_   (%_ nodes)\f", i, up_order.size(), B.nodeCount();
         Wire w = N[up_order[i]];
         Bdd b;
         switch (type(w)){
-        case gate_PI  : b = B.var(pi_idx[attr_PI  (w).number]); break;
-        case gate_Flop: b = B.var(si_idx[attr_Flop(w).number]); break;
+        case gate_PI  : b = B.var(var_of[w]); break;
+        case gate_Flop: b = B.var(var_of[w]); break;
         case gate_And : b = bddAnd(n2b[w[0]] ^ sign(w[0]), n2b[w[1]] ^ sign(w[1])); break;
         case gate_PO  : b = n2b[w[0]] ^ sign(w[0]); break;
         default: assert(false); }
 
         if (b.null()){
-            WriteLn "BDD manager ran out of resources while building transition relation.";
+            if (!P.quiet) WriteLn "\nBDD manager ran out of resources while building transition relation.";
             return l_Undef; }
 
-        n2b(w) = b;
+        if (type(w) == gate_And || type(w) == gate_PO){
+            For_Inputs(w, v){
+                assert(n_refs[v] > 0);
+                if (--n_refs(v) == 0)
+                    n2b(v).clear();
+            }
+        }
+        if (n_refs[w] > 0)
+            n2b(w) = b;
+        newMax(peak, B.nodeCount());
     }
-    /**/NewLine;
-    WriteLn "Nodes: %_  (dead %_)", B.nodeCount(), B.deadCount();
 
-    // Build partitioned transition relation:
-    Vec<Bdd> part;
-    /**/uint cc = 0;
-    For_Gatetype(N, gate_Flop, w){
-        /**/Write "\r%_ / %_   (mem: %DB)\f", cc++, N.typeCount(gate_Flop), memUsed();
-        int num = attr_Flop(w).number;
-        Bdd x = B.var(so_idx[num]);
-        Bdd b = bddXor(~x, n2b[w[0]] ^ sign(w[0]));
-        part(num) = b;
+    Vec<Bdd>        part;
+    Vec<Vec<uint> > sup(flops.size());
+    Vec<uint>       size;
+    for (uint i = 0; i < flops.size(); i++){
+        Wire w = N[flops[i]];
+        part.push(bddXor(~B.var(var_of[w] + 1), n2b[w[0]] ^ sign(w[0])));
+        supportVars(part[i], var_kind, sup[i]);
+        size.push(bddSize(part[i]));
     }
-    /**/NewLine;
-
-    // Build property BDD:
-    Get_Pob(N, init_bad);
     Bdd b_bad = n2b[init_bad[1]] ^ sign(init_bad[1]);
-
-    // Deref nodes:
     n2b.clear(true);
-    WriteLn "Nodes: %_  (dead %_)", B.nodeCount(), B.deadCount();
-
-    // Build initial state:
-    Get_Pob(N, flop_init);
-    Bdd b_front = B.True();
-    For_Gatetype(N, gate_Flop, w){
-        lbool val = flop_init[w];
-        if (val != l_Undef){
-            uint num = attr_Flop(w).number;
-            b_front = bddAnd(b_front, B.var(si_idx[num]) ^ (val == l_False));
+    if (!P.quiet) WriteLn "\rBuilding next-state functions: done   (%_ nodes, peak %_)\f", B.nodeCount(), peak;
+
+    // Cluster conjuncts:
+    Vec<uint> order;
+    orderConjuncts(sup, size, var_kind, order);
+
+    Vec<Bdd> clus;
+    Bdd      c;
+    for (uint i = 0; i < order.size(); i++){
+        Bdd p = part[order[i]];
+        if (!c.null()){
+            Bdd cp = bddAnd(c, p);
+            if (bddSize(cp) <= P.cluster_lim){
+                c = cp;
+                continue; }
+            clus.push(c);
         }
+        c = p;
     }
+    if (!c.null()) clus.push(c);
+    part.clear(true);
 
-    // Compute support sets:
-    Vec<Vec<uint> > sup;
-    Vec<uint>       occurs;
-    For_Gatetype(N, gate_Flop, w){
-        int num = attr_Flop(w).number;
-        Bdd b = bddSupport(part[num]);
-
-        Vec<uint>& cube = sup(num);
-        while (!b.isConst()){
-            if (!sos.has(b.index())){
-                cube.push(b.index());
-                occurs(b.index(), 0)++;
-            }
-            b = b[1];
-        }
+    if (P.var_reorder){
+        B.reorder();
+        if (!P.quiet) WriteLn "Reordered variables: %_ nodes", B.nodeCount();
     }
 
+    // Quantification schedule:
+    Vec<Vec<uint> > csup(clus.size());
+    Vec<uint>       occ(n_vars, 0);
+    for (uint j = 0; j < clus.size(); j++){
+        supportVars(clus[j], var_kind, csup[j]);
+        for (uint k = 0; k < csup[j].size(); k++)
+            occ[csup[j][k]]++;
+    }
 
-#if 0
-    // Debug:
-    For_Gatetype(N, gate_Flop, w){
-        uint num = attr_Flop(w).number;
-        sort(sup[num]);
-        Write "sup  %_:", num;
-        for (uint i = 0; i < sup[num].size(); i++){
-            uind n;
-            n = search(pi_idx, sup[num][i]); if (n != UIND_MAX) Write " x%_", n;
-            n = search(si_idx, sup[num][i]); if (n != UIND_MAX) Write " s%_", n;
-            n = search(so_idx, sup[num][i]); if (n != UIND_MAX) Write " s%_'", n;
+    for (uint j = 0; j < clus.size(); j++){     // -- quantify inputs local to a cluster
+        Bdd b_quant = B.True();
+        for (uint k = 0; k < csup[j].size(); k++){
+            uint v = csup[j][k];
+            if (var_kind[v] == var_PI && occ[v] == 1)
+                b_quant = bddAnd(b_quant, B.var(v));
+        }
+        if (!b_quant.isConst()){
+            clus[j] = bddExist(clus[j], b_quant);
+            supportVars(clus[j], var_kind, csup[j]);
         }
-        NewLine;
     }
-    Dump(occurs);
-#endif
-
-    // Reachability:
-    Bdd b_all = b_front;
-    for(uint iter = 0;; iter++){
-        WriteLn "\a*Iteration %_\a* -- Reached set: %_   Front set: %_", iter, /**/Cudd_DagSize(b_all.node), Cudd_DagSize(b_front.node);
-
-#if 1
-        Vec<Pair<uint,GLit> > ffs;
-        For_Gatetype(N, gate_Flop, w)
-            ffs.push(make_tuple(Cudd_DagSize(part[attr_Flop(w).number].node), w.lit()));
-        sort_reverse(ffs);
 
-        // <<== mix into the order that we prefer to actually eliminate variables sooner rather than later...
-#endif
+    Vec<uint> last(n_vars, UINT_MAX);
+    for (uint j = 0; j < clus.size(); j++)
+        for (uint k = 0; k < csup[j].size(); k++)
+            last[csup[j][k]] = j;
+
+    Bdd      b_quant0 = B.True();
+    Vec<Bdd> quant(clus.size(), B.True());
+    for (uint v = 0; v < n_vars; v++){
+        if (var_kind[v] == var_Next) continue;
+        if (last[v] != UINT_MAX)
+            quant[last[v]] = bddAnd(quant[last[v]], B.var(v));
+        else if (var_kind[v] == var_Cur)
+            b_quant0 = bddAnd(b_quant0, B.var(v));
+    }
 
-        // Compute image:
-        Vec<uint> occ(copy_, occurs);
-#if 0
-        For_Gatetype(N, gate_Flop, w){
-#else
-        for (uint ii = 0; ii < ffs.size(); ii++){
-            Wire w = N[ffs[ii].snd];
-#endif
-            uint n = attr_Flop(w).number;
-            Bdd b_quant = B.True();
-            //**/Vec<uint> cube;
-            for (uint i = 0; i < sup[n].size(); i++){
-                uint idx = sup[n][i]; assert(occ[idx] != 0);
-                occ[idx]--;
-                if (occ[idx] == 0){
-                    b_quant = bddAnd(b_quant, B.var(idx));
-                    //**/cube.push(idx);
-                }
-            }
-            //**/Dump(cube);
+    if (!P.quiet){
+        uint max_size = 0;
+        for (uint j = 0; j < clus.size(); j++)
+            newMax(max_size, bddSize(clus[j]));
+        WriteLn "Transition relation: %_ conjuncts in %_ clusters  (largest %_ nodes)", flops.size(), clus.size(), max_size;
+    }
 
-            b_front = bddAndExist(b_front, part[n], b_quant);
-//            b_front = bddAnd(b_front, part[n]);
+    // Variable substitution (current <-> next):
+    DdManager*   dd = B.True().dd;
+    Vec<DdNode*> from, into;
+    for (uint i = 0; i < flops.size(); i++){
+        uint v = var_of[N[flops[i]]];
+        from.push(Cudd_bddIthVar(dd, v));
+        into.push(Cudd_bddIthVar(dd, v + 1));
+    }
 
-            //**/WriteLn "-- intermediate front set: %_", Cudd_DagSize(b_front.node);
-            if (P.debug_output){
-                for (uint i = Cudd_DagSize(b_front.node) / 100; i != 0; i--) Write "#";
-                NewLine;
-            }
-        }
-#if 0
-Dump(occurs);
-        Bdd b_quant = B.True();
-        for (uint idx = 0; idx < occurs.size(); idx++){
-            if (occurs[idx] == 0) continue;
-            assert(occ[idx] == 0);
-            b_quant = bddAnd(b_quant, B.var(idx));
-        }
-        b_front = bddAndExist(b_front, B.True(), b_quant);
-#endif
+    // Initial states:
+    Bdd b_init = B.True();
+    For_Gatetype(N, gate_Flop, w){
+        lbool val = flop_init[w];
+        if (val != l_Undef)
+            b_init = bddAnd(b_init, B.var(var_of[w]) ^ (val == l_False));
+    }
 
-        // Quantify flops not in any partition:
-        {
-            Bdd b_quant = B.True();
-            Bdd b = bddSupport(b_front);
-            while (!b.isConst()){
-                if (!sos.has(b.index()))
-                    b_quant = bddAnd(b_quant, B.var(b.index()));
-                b = b[1];
-            }
-            b_front = bddExist(b_front, b_quant);
+    // Reachability:
+    Bdd b_false   = ~B.True();
+    Bdd b_reached = b_init;
+    Bdd b_front   = b_init;
+    for (uint iter = 0;; iter++){
+        // Property fail?
+        if (bddIntersect_p(b_bad, b_front)){
+            if (!P.quiet) WriteLn "Bad state reached at depth %_.", iter;
+            return l_False; }
+        if (bug_free_depth) *bug_free_depth = iter;
+
+        // Simplify frontier using reached states as don't-cares:
+        Bdd b_from = b_front;
+        if (P.simp_front){
+            Bdd b_simp = bddRestrict(b_front, bddOr(b_front, ~b_reached));
+            if (bddSize(b_simp)    < bddSize(b_from)) b_from = b_simp;
+            if (bddSize(b_reached) < bddSize(b_from)) b_from = b_reached;
         }
 
+        if (!P.quiet) WriteLn "\a*Iteration %_\a* -- Reached set: %_   Front set: %_   Image of: %_   (%_ nodes)", iter, bddSize(b_reached), bddSize(b_front), bddSize(b_from), B.nodeCount();
 
-        //dumpDot("bdd.dot", b_front);
-
-        // Translate variables:
-#if 1
-/*TEMP*/
-        DdManager* dd = b_front.dd;
-        Vec<DdNode*> from, into;
-        for (uind i = 0; i < si_idx.size(); i++) if (si_idx[i] != UIND_MAX) from.push(Cudd_bddIthVar(dd, si_idx[i]));
-        for (uind i = 0; i < so_idx.size(); i++) if (si_idx[i] != UIND_MAX) into.push(Cudd_bddIthVar(dd, so_idx[i]));
-        assert(from.size() == into.size());
-     #if 0
-        Dump(pi_idx);
-        Dump(si_idx);
-        Dump(so_idx);
-        dumpDot((FMT "b_all_%_.dot", iter), b_all);
-        dumpDot((FMT "before_%_.dot", iter), b_front);
-        dumpDot((FMT "support_%_.dot", iter), bddSupport(b_front));
-     #endif
-        b_front = Bdd(dd, Cudd_bddSwapVariables(dd, b_front.node, from.base(), into.base(), from.size()));
-     #if 0
-        dumpDot((FMT "after_%_.dot", iter), b_front);
-     #endif
-        //exit(0);
-/*END*/
-#endif
-
-        // Property fail?
-        if (bddIntersect_p(b_bad, b_front)){    // <<== check init state too
-            WriteLn "Counterexample found!";
-            return l_False;
+        // Compute image:
+        Bdd b_img = bddExist(b_from, b_quant0);
+        for (uint j = 0; j < clus.size() && !b_img.null(); j++){
+            b_img = bddAndExist(b_img, clus[j], quant[j]);
+            if (P.debug_output && !b_img.null()){
+                for (uint i = bddSize(b_img) / 100; i != 0; i--) Write "#";
+                NewLine;
+            }
         }
+        if (!b_img.null())
+            b_img = Bdd(dd, Cudd_bddSwapVariables(dd, b_img.node, from.base(), into.base(), from.size()));
+        if (b_img.null()){
+            if (!P.quiet) WriteLn "BDD manager ran out of resources during image computation.";
+            return l_Undef; }
 
         // Fixed point reached?
-        Bdd b_all_new = bddOr(b_all, b_front);
-        //**/WriteLn "b_all: %_ %_", b_all.uid(), b_all_new.uid();
-        if (b_all == b_all_new){
-            WriteLn "Fixed point reached.";
-            return l_True;
-        }
-        b_all = b_all_new;
+        b_front = bddAnd(b_img, ~b_reached);
+        if (b_front == b_false){
+            if (!P.quiet) WriteLn "Fixed point reached.";
+            return l_True; }
+        b_reached = bddOr(b_reached, b_front);
     }
-
-    return l_Undef;
 }
 
 
@@ -24,19 +24,23 @@ using namespace std;
 
 
 struct Params_BddReach {
-    bool    var_reorder;
+    bool    var_reorder;    // -- dynamic variable reordering (sifting)
+    uint    cluster_lim;    // -- conjuncts of the transition relation are merged while below this many nodes
+    bool    simp_front;     // -- simplify frontier with reached states as don't-cares before each image
     bool    quiet;
     bool    debug_output;
 
     Params_BddReach() :
         var_reorder (false),
+        cluster_lim (5000),
+        simp_front  (true),
         quiet       (false),
         debug_output(false)
     {}
 };
 
 
-lbool bddReach(NetlistRef N0, const Vec<Wire>& props, const Params_BddReach& P = Params_BddReach());
+lbool bddReach(NetlistRef N0, const Vec<Wire>& props, const Params_BddReach& P = Params_BddReach(), int* bug_free_depth = NULL);
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
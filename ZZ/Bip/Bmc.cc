@@ -18,12 +18,175 @@
 
 #include "ParClient.hh"
 
-//#define USE_COMPACT_MAPS
-
 namespace ZZ {
 using namespace std;
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// BmcFrameMap:
+
+
+// Maps '(frame, gate of N)' to a gate of the unrolling 'F'. Live frames are stored back to back
+// in one arena of 'N.size()' GLits per frame. Frames below 'firstLive()' are retired and only
+// remember their inputs (PIs, and in frame 0 also the flops), which is what counterexample
+// extraction needs. Since 'F' is strashed, the rest of a retired frame can be rebuilt on demand
+// without creating new gates; such "revived" frames are dropped again by 'dropRevived()'.
+//
+class BmcFrameMap {
+    uint            n_slots;
+    uint            n_frames;       // -- frames created so far
+    uint            first_live;
+    uint            lowest_write;   // -- lowest frame written to since last 'retire()'
+    Vec<GLit>       arena;          // -- frame 'first_live + i' is stored at offset 'i * n_slots'
+    Vec<uint>       input_idx;      // -- gate of 'N' -> index into 'kept[d]' (flops only valid for frame 0)
+    uint            n_pis;
+    Vec<Vec<GLit> > kept;           // -- inputs of retired frames
+    Vec<Vec<GLit> > revived;        // -- temporarily rebuilt retired frames (empty if not revived)
+
+    void grow(uint d);
+    bool isInput(uint d, GLit w) const { return input_idx[w.id] < ((d == 0) ? UINT_MAX : n_pis); }
+
+public:
+    BmcFrameMap(NetlistRef N);
+
+    uint size     () const { return n_frames; }
+    uint firstLive() const { return first_live; }
+
+    GLit  operator()(uint d, GLit w) const;
+    GLit& ref(uint d, GLit w);
+        // -- Returns a writable slot; will revive a retired frame if necessary. The reference
+        // is invalidated by the next call to 'ref()'.
+
+    void   retire(uint d);  // -- Retire all frames below 'd'.
+    void   dropRevived();
+    uint   lowestWrite() const { return lowest_write; }
+
+    void   references(Vec<GLit>& out) const;    // -- All gates of 'F' referred to by live frames and retired inputs.
+    void   translate(const Vec<GLit>& xlat);    // -- Rename gates of 'F' (revived frames must have been dropped).
+    uint64 memUsed() const; // -- in bytes
+};
+
+
+BmcFrameMap::BmcFrameMap(NetlistRef N) :
+    n_slots(N.size()),
+    n_frames(0),
+    first_live(0),
+    lowest_write(UINT_MAX),
+    n_pis(0)
+{
+    input_idx.growTo(n_slots, UINT_MAX);
+    For_Gatetype(N, gate_PI, w)
+        input_idx[id(w)] = n_pis++;
+    uint n = n_pis;
+    For_Gatetype(N, gate_Flop, w)
+        input_idx[id(w)] = n++;
+}
+
+
+void BmcFrameMap::grow(uint d)
+{
+    if (d < n_frames) return;
+    n_frames = d + 1;
+    arena.growTo((n_frames - first_live) * n_slots, glit_NULL);
+}
+
+
+GLit BmcFrameMap::operator()(uint d, GLit w) const
+{
+    if (d >= n_frames)
+        return glit_NULL;
+    if (d >= first_live)
+        return arena[(d - first_live) * n_slots + w.id];
+    if (isInput(d, w))
+        return kept[d][input_idx[w.id]];
+    if (d < revived.size() && revived[d].size() > 0)
+        return revived[d][w.id];
+    return glit_NULL;
+}
+
+
+GLit& BmcFrameMap::ref(uint d, GLit w)
+{
+    grow(d);
+    newMin(lowest_write, d);
+    if (d >= first_live)
+        return arena[(d - first_live) * n_slots + w.id];
+    if (isInput(d, w))
+        return kept[d][input_idx[w.id]];
+
+    revived.growTo(d + 1);
+    if (revived[d].size() == 0)
+        revived[d].growTo(n_slots, glit_NULL);
+    return revived[d][w.id];
+}
+
+
+void BmcFrameMap::retire(uint d)
+{
+    lowest_write = UINT_MAX;
+    dropRevived();
+    newMin(d, n_frames);
+    if (d <= first_live) return;
+
+    // Save inputs of retiring frames:
+    kept.growTo(d);
+    for (uint k = first_live; k < d; k++){
+        const GLit* frame = &arena[(k - first_live) * n_slots];
+        Vec<GLit>&  inps  = kept[k];
+        inps.growTo((k == 0) ? input_idx.size() : n_pis, glit_NULL);
+        for (uint i = 0; i < n_slots; i++)
+            if (isInput(k, GLit(i)))
+                inps[input_idx[i]] = frame[i];
+        inps.shrinkTo((k == 0) ? inps.size() : n_pis);
+    }
+
+    // Move remaining live frames to the front of the arena (capacity is kept for reuse):
+    uint off = (d - first_live) * n_slots;
+    for (uint i = off; i < arena.size(); i++)
+        arena[i - off] = arena[i];
+    arena.shrinkTo(arena.size() - off);
+    first_live = d;
+}
+
+
+void BmcFrameMap::dropRevived()
+{
+    for (uint i = 0; i < revived.size(); i++)
+        revived[i].clear(true);
+}
+
+
+void BmcFrameMap::references(Vec<GLit>& out) const
+{
+    for (uint i = 0; i < arena.size(); i++)
+        if (arena[i] != glit_NULL) out.push(+arena[i]);
+    for (uint d = 0; d < kept.size(); d++)
+        for (uint i = 0; i < kept[d].size(); i++)
+            if (kept[d][i] != glit_NULL) out.push(+kept[d][i]);
+}
+
+
+void BmcFrameMap::translate(const Vec<GLit>& xlat)
+{
+    for (uint i = 0; i < arena.size(); i++)
+        if (arena[i] != glit_NULL) arena[i] = xlat[arena[i].id] ^ arena[i].sign;
+    for (uint d = 0; d < kept.size(); d++)
+        for (uint i = 0; i < kept[d].size(); i++)
+            if (kept[d][i] != glit_NULL) kept[d][i] = xlat[kept[d][i].id] ^ kept[d][i].sign;
+}
+
+
+uint64 BmcFrameMap::memUsed() const
+{
+    uint64 sz = (uint64)arena.capacity() * sizeof(GLit) + input_idx.capacity() * sizeof(uint);
+    for (uint i = 0; i < kept.size(); i++)
+        sz += (uint64)kept[i].capacity() * sizeof(GLit);
+    for (uint i = 0; i < revived.size(); i++)
+        sz += (uint64)revived[i].capacity() * sizeof(GLit);
+    return sz;
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // BmcTrace:
 
@@ -33,16 +196,23 @@ class BmcTrace {
     NetlistRef          N;          // Design
     Netlist             F;          // Unrolled design
     MultiSat            S;          // SAT environment
-  #if !defined(USE_COMPACT_MAPS)
-    Vec<WMap<Wire> >    n2f;        // Map '(frame, wire)' to wire in 'F'.
-  #else
-    Vec<CompactBmcMap>  n2f;        // Map '(frame, wire)' to wire in 'F'.
-  #endif
+    BmcFrameMap         n2f;        // Map '(frame, wire)' to wire in 'F'.
     WMap<Lit>           f2s;        // Map gate in 'F' to SAT literal.
     WZet                keep_f;     // Gates in 'F' that we hypothesize are best kept as SAT variables
     Clausify<MetaSat>   C;
     Vec<MemUnroll>      memu;
 
+    // Frame retirement:
+    Vec<uint>           f_frame;        // Frame in which a gate of 'F' was created ('UINT_MAX' for constants).
+    uint                lag;            // Extending the unrolling has reached this many frames back.
+    uint                f_compacted;    // Size of 'F' after last compaction.
+    bool                thaw_retired;   // Let a simplifying SAT solver eliminate variables of removed gates.
+    uint                n_frozen;       // SAT variables below this have been frozen.
+    uint                n_compactions;
+
+    void  freezeNewVars();
+    void  compact();
+
 public:
     BmcTrace(NetlistRef N, EffortCB* cb);
 
@@ -62,22 +232,35 @@ public:
     uint  nVars     () const { return (uint)S.nVars(); }
     uint  nGates    () const { return F.gateCount(); }
 
+    // Frame retirement:
+    void   retire(uint frame);      // -- Call when done with 'frame'; frames far enough behind it are retired.
+    uint   nFrames () const { return n2f.size(); }
+    uint   nCompactions() const { return n_compactions; }
+    uint   nRetired() const { return n2f.firstLive(); }
+    uint64 frameMem() const { return n2f.memUsed(); }
+
     // Export unrolling:
     NetlistRef              trace   () const { return F; }
-//    const Vec<WMap<Wire> >& traceMap() const { return n2f; }
 
     // Clausification control:
     void  setSimpleTseitin(bool val) { C.simple_tseitin = val; }
     void  setQuantClaus   (bool val) { C.quant_claus    = val; }
 
     // SAT solver:
-    void  setSatSolver(SolverType t) { S.selectSolver(t); }
+    void  setSatSolver(SolverType t, bool thaw_retired_ = false) { S.selectSolver(t); thaw_retired = thaw_retired_; }
+        // -- 'thaw_retired' requires a simplifying SAT solver ('sat_Mss') and the standard clausifier.
 };
 
 
 BmcTrace::BmcTrace(NetlistRef N_, EffortCB* cb) :
     N(N_),
-    C(S, F, f2s, keep_f, NULL, cb)
+    n2f(N_),
+    C(S, F, f2s, keep_f, NULL, cb),
+    lag(0),
+    f_compacted(0),
+    thaw_retired(false),
+    n_frozen(0),
+    n_compactions(0)
 {
     Add_Pob0(F, strash);
     if (cb){
@@ -95,24 +278,29 @@ BmcTrace::BmcTrace(NetlistRef N_, EffortCB* cb) :
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 
-#if 1
 // EXPERIMENTAL!
 Wire BmcTrace::insert(Wire w, uint k)
 {
     NetlistRef N = netlist(w);
-    n2f.growTo(k + 1);
-    Wire ret = n2f(k)[w];
+    Wire ret = n2f(k, w) + F;
     if (!ret){
         switch (type(w)){
         case gate_Const: ret = F.True(); assert(+w == glit_True); break;
         case gate_PO   : ret = insert(w[0], k); break;
-        case gate_And  : ret = s_And(insert(w[0], k), insert(w[1], k)); break;
-        case gate_PI:    ret = F.add(PI_()); break;
+        case gate_And  :{
+            Wire x = insert(w[0], k);
+            Wire y = insert(w[1], k);
+            uint sz0 = F.size();
+            ret = s_And(x, y);
+            if (id(ret) >= sz0)
+                f_frame(id(ret), UINT_MAX) = k;
+            break;}
+        case gate_PI:    ret = F.add(PI_()); f_frame(id(ret), UINT_MAX) = k; break;
         case gate_Flop:
             if (k == 0){
                 Get_Pob(N, flop_init);
                 if (flop_init[w] == l_Undef)
-                    ret = F.add(PI_());
+                    ret = F.add(PI_()), f_frame(id(ret), UINT_MAX) = 0;
                 else assert(flop_init[w] != l_Error),
                     ret = F.True() ^ (flop_init[w] == l_False);
             }else
@@ -122,18 +310,7 @@ Wire BmcTrace::insert(Wire w, uint k)
             ShoutLn "INTERNAL ERROR! Unsupported gate type reached in 'insertUnrolled()': %_", GateType_name[type(w)];
             assert(false); }
 
-        n2f[k](w) = ret;
-
-    }else if (type(ret) != gate_Const){
-#if 0
-        Lit p = f2s[ret];
-        if (p != lit_Undef){
-            lbool v = S.topValue(p);
-            if      (v == l_True)  ret =  F.True();
-            else if (v == l_False) ret = ~F.True();
-            //**/if (ret.id() == gid_True) std_out += "*";
-        }
-#endif
+        n2f.ref(k, w) = ret;
     }
 
     Get_Pob(N, fanout_count);
@@ -143,14 +320,6 @@ Wire BmcTrace::insert(Wire w, uint k)
     return ret ^ sign(w);
 }
 
-#else
-Wire BmcTrace::insert(Wire w, uint frame)
-{
-    assert(nl(N) == nl(w));
-    return insertUnrolled(w, frame, F, n2f, Params_Unroll(&keep_f, &memu));
-}
-#endif
-
 
 // Returns FALSE if clausification timed out
 bool BmcTrace::force(Wire f)
@@ -165,6 +334,15 @@ bool BmcTrace::force(Wire f)
 }
 
 
+// A simplifying SAT solver must not eliminate variables that later clauses may refer to. Only
+// 'compact()' knows which variables are safe to release.
+void BmcTrace::freezeNewVars()
+{
+    for (; n_frozen < S.nVars(); n_frozen++)
+        S.freeze(n_frozen);
+}
+
+
 lbool BmcTrace::solve(const Vec<Wire>& assumps, uint64 timeout)
 {
     try{
@@ -177,6 +355,7 @@ lbool BmcTrace::solve(const Vec<Wire>& assumps, uint64 timeout)
             S.timeout = timeout;
           #endif
         }
+        freezeNewVars();
         return S.solve(lits);
     }catch (Excp_Clausify_Abort){
         return l_Undef;
@@ -184,6 +363,131 @@ lbool BmcTrace::solve(const Vec<Wire>& assumps, uint64 timeout)
 }
 
 
+// Going one frame deeper typically reaches one frame further back than last time, until the
+// cone of influence saturates, so frames are kept for the largest distance seen so far plus a
+// margin. (Reaching further back is still correct, it just revives retired frames temporarily.)
+void BmcTrace::retire(uint frame)
+{
+    if (n2f.lowestWrite() <= frame)
+        newMax(lag, frame - n2f.lowestWrite());
+    n2f.retire((frame >= lag + 2) ? frame - lag - 2 : 0);
+
+    if (F.size() - f_compacted > 16384 && F.size() > 2 * f_compacted)
+        compact();
+}
+
+
+struct BmcTrace_OldGate {
+    GLit in0, in1;
+    Lit  lit;
+    uint frame;
+    bool cut, keep;
+};
+
+
+// Rebuild 'F' from the gates still reachable from live frames (and the inputs of retired
+// frames). Where live logic refers to a gate of a retired frame that has a SAT variable, that
+// gate is replaced by a PI mapped to the same SAT literal (a "cut point"); its definition stays
+// in the SAT solver. SAT variables of removed gates are thawed (if 'thaw_retired') so that a
+// simplifying solver can eliminate them. Nothing is done if most of 'F' is still reachable.
+void BmcTrace::compact()
+{
+    uint first_live = n2f.firstLive();
+    f_frame.growTo(F.size(), UINT_MAX);
+    #define Is_Cut(g) (type(g) == gate_And && f_frame[id(g)] != UINT_MAX && f_frame[id(g)] < first_live && f2s[g] != Lit_NULL)
+
+    // Collect reachable gates in topological order:
+    Vec<GLit> roots;
+    n2f.references(roots);
+
+    Vec<GLit> order;
+    WZet      seen;
+    Vec<Pair<GLit,bool> > Q;
+    for (uint i = 0; i < roots.size(); i++){
+        if (roots[i].id < gid_FirstUser || seen.has(roots[i] + F)) continue;
+        Q.push(make_tuple(roots[i], false));
+        while (Q.size() > 0){
+            Wire w = Q.last().fst + F;
+            if (seen.has(w)){
+                Q.pop();
+            }else if (!Q.last().snd && type(w) == gate_And && !Is_Cut(w)){
+                Q.last().snd = true;
+                For_Inputs(w, v)
+                    if (id(v) >= gid_FirstUser && !seen.has(+v))
+                        Q.push(make_tuple(+v, false));
+            }else{
+                Q.pop();
+                seen.add(w);
+                order.push(w);
+            }
+        }
+    }
+
+    f_compacted = F.size();
+    if (order.size() > F.size() / 4 * 3)
+        return;     // -- not worth rebuilding (retired logic is still in use and has no cut points)
+
+    // Save what is needed from old 'F':
+    Vec<BmcTrace_OldGate> old(order.size());
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + F;
+        BmcTrace_OldGate& o = old[i];
+        o.cut   = (type(w) != gate_And || Is_Cut(w));
+        o.in0   = o.cut ? glit_NULL : w[0].lit();
+        o.in1   = o.cut ? glit_NULL : w[1].lit();
+        o.lit   = f2s[w];
+        o.frame = f_frame[id(w)];
+        o.keep  = keep_f.has(w);
+    }
+    #undef Is_Cut
+
+    Vec<Lit> const_lit;
+    Vec<bool> const_keep;
+    for (gate_id i = 0; i < gid_FirstUser; i++){
+        const_lit .push(f2s[F[i]]);
+        const_keep.push(keep_f.has(F[i]));
+    }
+
+    if (thaw_retired){
+        freezeNewVars();
+        for (uint i = gid_FirstUser; i < F.size(); i++){
+            if (!seen.has(F[i]) && f2s[F[i]] != Lit_NULL)
+                S.thaw(f2s[F[i]].id);
+        }
+    }
+
+    // Rebuild:
+    Vec<GLit> xlat(F.size(), glit_NULL);
+    F.clear();
+    f2s.clear();
+    keep_f.clear();
+    f_frame.clear();
+    C.forgetNetlist();
+    Add_Pob0(F, strash);
+
+    for (gate_id i = 0; i < gid_FirstUser; i++){
+        xlat[i] = GLit(i);
+        if (const_lit[i] != Lit_NULL) f2s(F[i]) = const_lit[i];
+        if (const_keep[i])            keep_f.add(F[i]);
+    }
+
+    for (uint i = 0; i < order.size(); i++){
+        const BmcTrace_OldGate& o = old[i];
+        Wire w = o.cut ? F.add(PI_()) : s_And((xlat[o.in0.id] ^ o.in0.sign) + F, (xlat[o.in1.id] ^ o.in1.sign) + F);
+        xlat[order[i].id] = w;
+
+        if (o.lit != Lit_NULL && f2s[w] == Lit_NULL) f2s(+w) = o.lit ^ sign(w);
+        if (o.keep)                                  keep_f.add(+w);
+        if (id(w) >= gid_FirstUser)                  f_frame(id(w), UINT_MAX) = o.frame;
+    }
+    Assure_Pob0(F, fanout_count);
+
+    n2f.translate(xlat);
+    f_compacted = F.size();
+    n_compactions++;
+}
+
+
 void BmcTrace::getModel(Vec<Vec<lbool> >& pi, Vec<Vec<lbool> >& ff) const
 {
     pi.clear(); pi.setSize(n2f.size());
@@ -192,7 +496,7 @@ void BmcTrace::getModel(Vec<Vec<lbool> >& pi, Vec<Vec<lbool> >& ff) const
     // Translate model from SAT solver:
     for (uint d = 0; d < pi.size(); d++){
         For_Gatetype(N, gate_PI, w){
-            Wire x = n2f[d][w];
+            Wire x = n2f(d, w) + F;
             int  num = attr_PI(w).number;
             if (!x) pi[d](num) = l_False;
             else{
@@ -204,7 +508,7 @@ void BmcTrace::getModel(Vec<Vec<lbool> >& pi, Vec<Vec<lbool> >& ff) const
 
         if (d == 0){
             For_Gatetype(N, gate_Flop, w){
-                Wire x = n2f[d][w];
+                Wire x = n2f(d, w) + F;
                 int  num = attr_Flop(w).number;
                 if (num == num_NULL) continue;
 
@@ -238,6 +542,18 @@ void BmcTrace::addClause(const Vec<GLit>& clause, uint frame)
         tmp.push(p);
     }
     S.addClause(tmp);
+    n2f.dropRevived();
+}
+
+
+static
+void reportFrames(const BmcTrace* T, const Params_Bmc* P)
+{
+    if (P->quiet || !P->frame_gc) return;
+    uint n_live = T->nFrames() - T->nRetired();
+    WriteLn "Frame maps: %_ live + %_ retired frames, %^DB  (%^DB per frame)",
+        n_live, T->nRetired(), T->frameMem(), T->frameMem() / max_(1u, T->nFrames());
+    WriteLn "Unrolling : %_ gates after %_ compactions", T->nGates(), T->nCompactions();
 }
 
 
@@ -295,6 +611,8 @@ lbool lookaheadBmc(BmcTrace& T, const Params_Bmc& P, Cex* cex, int* bf_depth, Ne
                             break;
                     // Advance that many steps, shifting 'la_unsat' appropriately:
                     d += i;
+                    if (P.frame_gc)
+                        T.retire(d);
                     for (uint j = 0; j < P.la_steps; j++){
                         if (i + j < P.la_steps)
                             la_unsat[j] = la_unsat[i + j];
@@ -344,7 +662,8 @@ lbool bmc_(NetlistRef N0, const Vec<Wire>& props, const Params_Bmc& P, Cex* cex,
     Get_Pob(N, init_bad);
     T.setSimpleTseitin(P.simple_tseitin);
     T.setQuantClaus   (P.quant_claus);
-    T.setSatSolver    (P.sat_solver);
+    T.setSatSolver    (P.sat_solver, P.frame_gc && P.sat_solver == sat_Mss && !P.quant_claus);
+    On_Scope_Exit(reportFrames, &T, &P);
 
     Info_Bmc info;
     if (cb) cb->info = &info;
@@ -425,6 +744,8 @@ lbool bmc_(NetlistRef N0, const Vec<Wire>& props, const Params_Bmc& P, Cex* cex,
                 sendMsg_Progress(0, 1/*safety*/, (FMT "bug-free-depth: %_\n", d));
             if (!T.force(~w_bad))       // -- returns FALSE if clausification timed out
                 return l_Undef;
+            if (P.frame_gc)
+                T.retire(d);
         }else{ assert(result == l_Undef);
             return l_Undef;
         }
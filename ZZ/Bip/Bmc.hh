@@ -30,6 +30,7 @@ struct Params_Bmc {
     bool    quant_claus;
     uint    la_steps;           // -- look-ahead frames
     double  la_decay;           // -- relative focus between step k and k+1 (< 1 means less focus on k+1)
+    bool    frame_gc;           // -- retire old frames of the unrolling (with 'sat_Mss' and standard clausification, their SAT variables are also eliminated)
     bool    quiet;
     bool    par_send_result;
 
@@ -39,6 +40,7 @@ struct Params_Bmc {
         quant_claus    (false),
         la_steps       (1),
         la_decay       (0.8),
+        frame_gc       (true),
         quiet          (false),
         par_send_result(true)
     {}
@@ -106,6 +106,16 @@ void Clausify<SAT>::clear()
 }
 
 
+template<class SAT>
+void Clausify<SAT>::forgetNetlist()
+{
+    assert(defs.size() == 0);
+    n_visits.clear();
+    tmp_seen.clear();
+    qDispose();
+}
+
+
 template<class SAT>
 void Clausify<SAT>::initKeep()
 {
@@ -397,7 +407,7 @@ void Clausify<SAT>::qEnd(bool force)
         Wire f = N[defs.last().var];
         n2s(f) = S.addLit();
         Clas& cs = defs.last().cs;
-        static Vec<Lit> tmp; tmp.clear();  // <== elim. temporary?
+        Vec<Lit>& tmp = tmp_lits; tmp.clear();
         for (uind i = 0; i < cs.size(); i++){
             Cla& c = cs[i];
             assert(tmp.size() == 0);
@@ -174,6 +174,10 @@ struct Clausify {
         // -- Clear map 'n2s', internal maps AND the SAT-solver (except for statistics).
         // Will NOT clear: 'N', 'keep', 'cb', 'effort_cb' (or any option)
 
+    void forgetNetlist();
+        // -- Drop internal data referring to gates of 'N' (call when 'N' is rebuilt; the caller is
+        // responsible for 'n2s' and 'keep'). SAT-solver is not affected.
+
     void initKeep();
         // -- If you don't want to control it more fine-grained, this method will add 'fanout_count' ot 'N' and
         // use it to preserve any element with fanout > 1. You can still add more nods to 'keep' that as of
@@ -218,6 +222,7 @@ protected:
     IntTmpMap<uint/*Var*/,uchar> var2loc;// -- temp. for 'tryElim()'
     Vec<Clausify_CCla>   pos, neg, res;  // -- temp. for 'tryElim()'
     Vec<uint>            tmp_memo;       // -- temp. for 'storeMemo()'
+    Vec<Lit>             tmp_lits;       // -- temp. for 'qEnd()'
 
     bool qBegin(Wire f);
     void qAddClause(const Cla& fs);
@@ -486,7 +486,7 @@ void translateCex(const Vec<Vec<lbool> >& pi, const Vec<Vec<lbool> >& ff, Netlis
 
     for (uint d = 0; d < pi.size(); d++){
         for (uint num = 0; num < pi[d].size(); num++)
-            if (pi[d][num] != l_Undef)
+            if (pi[d][num] != l_Undef && num2pi(num) != Wire_NULL)
                 cex.inputs[d](num2pi[num]) = pi[d][num];
     }
 
@@ -1847,6 +1847,136 @@ void lutClausify(NetlistRef M, Vec<Pair<uint,GLit> >& roots, bool initialized, S
     lutClausify_(M, roots, initialized, S, m2s); }
 
 
+//=================================================================================================
+// -- Template clausification:
+
+
+void LutCnfTemplate::init(NetlistRef M, const Vec<GLit>& roots)
+{
+    lits.clear(); cl_end.clear(); flops.clear(); next.clear(); flop_val0.clear(); tmpl.clear();
+    base.clear(); iface.clear();
+
+    // Sequential cone-of-influence:
+    WZet coi;
+    for (uint i = 0; i < roots.size(); i++)
+        coi.add(+roots[i] + M);
+    for (uint i = 0; i < coi.size(); i++){
+        Wire w = coi.list()[i];
+        if (type(w) == gate_Flop)
+            flops.push(w);
+        For_Inputs(w, v)
+            coi.add(+v);
+    }
+
+    // Template variables:
+    first_local = 2 + flops.size();
+    n_locals = 0;
+    tmpl(M.True ()) =  Lit(1);
+    tmpl(M.False()) = ~Lit(1);
+    for (uint i = 0; i < flops.size(); i++)
+        tmpl(flops[i] + M) = Lit(2 + i);
+
+    Vec<Wire> sinks;
+    for (uint i = 0; i < roots.size(); i++)
+        sinks.push(roots[i] + M);
+    for (uint i = 0; i < flops.size(); i++)
+        sinks.push((flops[i] + M)[0]);
+    if (sinks.size() == 0)
+        return;
+
+    Vec<gate_id> order;
+    upOrder(sinks, order);
+
+    // Clausify:
+    Lit inputs[4];
+    for (uint n = 0; n < order.size(); n++){
+        Wire w = M[order[n]];
+        switch (type(w)){
+        case gate_Const:
+        case gate_Flop:
+            break;
+
+        case gate_PI:
+            tmpl(w) = Lit(first_local + n_locals++);
+            break;
+
+        case gate_PO:
+        case gate_SO:
+            tmpl(w) = tmpl[w[0]] ^ sign(w[0]);
+            break;
+
+        case gate_Npn4:{
+            for (uint i = 0; i < 4; i++)
+                inputs[i] = Lit_NULL;
+            For_Inputs(w, v)
+                inputs[Iter_Var(v)] = tmpl[v] ^ sign(v);
+            Lit output = Lit(first_local + n_locals++);
+
+            uint cl = attr_Npn4(w).cl;
+            for (uint i = 0; i < cnfIsop_size(cl); i++){
+                cnfIsop_clause(cl, i, inputs, output, tmp);
+                append(lits, tmp);
+                cl_end.push(lits.size());
+            }
+            tmpl(w) = output;
+            break;}
+
+        default:
+            ShoutLn "INTERNAL ERROR! Unexpected type in clausification: %_", GateType_name[type(w)];
+            assert(false);
+        }
+    }
+
+    // Frame interface:
+    Get_Pob(M, flop_init);
+    for (uint i = 0; i < flops.size(); i++){
+        Wire w = flops[i] + M;
+        next.push(tmpl[w[0]] ^ sign(w[0]));
+        flop_val0.push(flop_init[w]);
+    }
+}
+
+
+template<class SAT>
+void LutCnfTemplate::addFrame_(SAT& S, bool initialized)
+{
+    uint d = base.size();
+    iface.push();
+    Vec<Lit>& in = iface.last();
+    in.setSize(first_local, Lit_NULL);
+    in[1] = S.True();
+    for (uint i = 0; i < flops.size(); i++){
+        if (d == 0){
+            lbool val = initialized ? flop_val0[i] : l_Undef;
+            in[2 + i] = (val == l_Undef) ? S.addLit() : S.True() ^ (val == l_False);
+        }else
+            in[2 + i] = reloc(d - 1, next[i]);
+    }
+
+    // Fresh variables (solvers hand them out consecutively):
+    base.push(0);
+    for (uint j = 0; j < n_locals; j++){
+        Lit p = S.addLit();
+        if (j == 0) base[d] = p.id;
+        assert(p.id == base[d] + j);
+    }
+
+    // Stamp clauses:
+    uint k = 0;
+    for (uint i = 0; i < cl_end.size(); i++){
+        tmp.clear();
+        for (; k < cl_end[i]; k++)
+            tmp.push(reloc(d, lits[k]));
+        S.addClause(tmp);
+    }
+}
+
+
+void LutCnfTemplate::addFrame(MetaSat& S, bool initialized) { addFrame_(S, initialized); }
+void LutCnfTemplate::addFrame(SatPfl&  S, bool initialized) { addFrame_(S, initialized); }
+void LutCnfTemplate::addFrame(SatStd&  S, bool initialized) { addFrame_(S, initialized); }
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Constraint handling:
 
@@ -251,6 +251,52 @@ macro Lit lutClausify(NetlistRef M, uint depth, GLit w_root, bool initialized, /
     return m2s[depth][w_root]; }
 
 
+// The combinational transition relation of a CNF-mapped netlist (with 'Npn4' LUTs), restricted to
+// the sequential cone-of-influence of 'roots', clausified once into a template. 'addFrame()'
+// stamps the next time frame into the SAT solver by offsetting the template variables; there is
+// no unrolled netlist and no per-frame map. Use 'lit()' to get the literal of a gate in a frame.
+//
+class LutCnfTemplate {
+    // Template variables: '1' is TRUE, '2 + i' the value of 'flops[i]' in the current frame, and
+    // 'first_local + j' a variable that is fresh in each frame ('j < n_locals').
+    uint            first_local;
+    uint            n_locals;
+    Vec<Lit>        lits;           // -- clause literals (template variables)
+    Vec<uint>       cl_end;         // -- clause 'i' ends before 'lits[cl_end[i]]'
+    Vec<GLit>       flops;
+    Vec<Lit>        next;           // -- next-state function of 'flops[i]'
+    Vec<lbool>      flop_val0;      // -- initial value of 'flops[i]'
+    WMap<Lit>       tmpl;           // -- gates in the cone-of-influence -> template literal
+
+    Vec<uint>       base;           // -- first solver variable of each stamped frame
+    Vec<Vec<Lit> >  iface;          // -- solver literals of template variables '0 .. first_local-1' of each stamped frame
+    Vec<Lit>        tmp;
+
+    Lit reloc(uint frame, Lit p) const {
+        return (p.id < first_local) ? iface[frame][p.id] ^ p.sign : Lit(base[frame] + p.id - first_local, p.sign); }
+
+    template<class SAT> void addFrame_(SAT& S, bool initialized);
+
+public:
+    LutCnfTemplate() : first_local(0), n_locals(0) {}
+    LutCnfTemplate(NetlistRef M, const Vec<GLit>& roots) : first_local(0), n_locals(0) { init(M, roots); }
+
+    void init(NetlistRef M, const Vec<GLit>& roots);
+
+    void addFrame(MetaSat& S, bool initialized);
+    void addFrame(SatPfl&  S, bool initialized);
+    void addFrame(SatStd&  S, bool initialized);
+        // -- if 'initialized', flops of frame 0 are given their 'flop_init' value (otherwise left free).
+
+    Lit  lit(uint frame, Wire w) const { Lit p = tmpl[w]; assert(p != Lit_NULL); return reloc(frame, p ^ sign(w)); }
+        // -- 'w' must be in the cone-of-influence of 'roots' and 'frame' must have been stamped.
+
+    uint nFrames () const { return base.size(); }
+    uint nVars   () const { return n_locals; }          // -- per frame
+    uint nClauses() const { return cl_end.size(); }     // -- per frame
+};
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Constraint handling:
 
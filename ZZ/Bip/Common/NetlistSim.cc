@@ -0,0 +1,332 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : NetlistSim.cc
+//| Module      : Bip
+//| Description : Bit-parallel random simulation of a netlist.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| The inner loops run over the contiguous words of a row with the sign of each fanin folded into
+//| an XOR-mask, which lets the compiler vectorize them.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "ZZ/Generics/Sort.hh"
+#include "NetlistSim.hh"
+#include "ZZ_Npn4.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Helpers:
+
+
+macro uint64 signMask(GLit p) {
+    return 0ull - (uint64)p.sign; }
+
+
+// Evaluate 4-input LUT 'ftb' for 64 patterns at once by a Shannon expansion of the truth table.
+static
+uint64 evalLut4Word(uint ftb, const uint64* x)
+{
+    uint64 v[16];
+    for (uint j = 0; j < 16; j++)
+        v[j] = 0ull - ((ftb >> j) & 1);
+
+    uint sz = 16;
+    for (uint i = 0; i < 4; i++){
+        sz >>= 1;
+        for (uint j = 0; j < sz; j++)
+            v[j] = (x[i] & v[2*j+1]) | (~x[i] & v[2*j]);
+    }
+    return v[0];
+}
+
+
+static
+bool isLogic(GateType t)
+{
+    switch (t){
+    case gate_PO: case gate_SO: case gate_Buf: case gate_Not:
+    case gate_And: case gate_Or: case gate_Xor: case gate_Equiv:
+    case gate_And3: case gate_Or3: case gate_Xor3:
+    case gate_Mux: case gate_Maj: case gate_One: case gate_Gamb:
+    case gate_Conj: case gate_Disj: case gate_Even: case gate_Odd:
+    case gate_Lut4: case gate_Npn4:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Construction:
+
+
+NetlistSim::NetlistSim(NetlistRef N_, uint n_words_) :
+    N(N_),
+    n_words(n_words_),
+    frame(0)
+{
+    assert(n_words > 0);
+    upOrder(N, order);
+
+    row_of.growTo(N.size(), 0);     // -- row 0 is 'gid_NULL' (all zeros); missing inputs read as FALSE
+    for (gate_id i = 0; i < gid_FirstUser; i++)
+        row_of[i] = i;
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = N[order[i]];
+        row_of[id(w)] = gid_FirstUser + i;
+
+        if (type(w) == gate_Flop)
+            flops.push(order[i]);
+        else if (isLogic(type(w)))
+            logic.push(order[i]);
+        else
+            inputs.push(order[i]);
+    }
+
+    data.growTo((gid_FirstUser + order.size()) * n_words, 0);
+    for (uint k = 0; k < n_words; k++)
+        data[gid_True * n_words + k] = ~0ull;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Evaluation:
+
+
+void NetlistSim::evalGate(Wire w)
+{
+    uint64* z = (*this)[w];
+    uint    n = n_words;
+
+    switch (type(w)){
+    case gate_PO: case gate_SO: case gate_Buf: case gate_Not:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]) ^ (type(w) == gate_Not ? ~0ull : 0ull);
+        for (uint k = 0; k < n; k++) z[k] = a[k] ^ ma;
+        break; }
+
+    case gate_And:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]);
+        const uint64* b = (*this)[w[1]]; uint64 mb = signMask(w[1]);
+        for (uint k = 0; k < n; k++) z[k] = (a[k] ^ ma) & (b[k] ^ mb);
+        break; }
+
+    case gate_Or:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]);
+        const uint64* b = (*this)[w[1]]; uint64 mb = signMask(w[1]);
+        for (uint k = 0; k < n; k++) z[k] = (a[k] ^ ma) | (b[k] ^ mb);
+        break; }
+
+    case gate_Xor: case gate_Equiv:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]) ^ (type(w) == gate_Equiv ? ~0ull : 0ull);
+        const uint64* b = (*this)[w[1]]; uint64 mb = signMask(w[1]);
+        for (uint k = 0; k < n; k++) z[k] = (a[k] ^ ma) ^ (b[k] ^ mb);
+        break; }
+
+    case gate_And3: case gate_Or3: case gate_Xor3:
+    case gate_Mux: case gate_Maj: case gate_One: case gate_Gamb:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]);
+        const uint64* b = (*this)[w[1]]; uint64 mb = signMask(w[1]);
+        const uint64* c = (*this)[w[2]]; uint64 mc = signMask(w[2]);
+        switch (type(w)){
+        case gate_And3:
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = x & y & u; }
+            break;
+        case gate_Or3:
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = x | y | u; }
+            break;
+        case gate_Xor3:
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = x ^ y ^ u; }
+            break;
+        case gate_Mux:
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = (x & y) | (~x & u); }
+            break;
+        case gate_Maj:
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = (x & y) | (x & u) | (y & u); }
+            break;
+        case gate_One:
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = (x ^ y ^ u) & ~(x & y & u); }
+            break;
+        default: /*Gamb*/
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = (x & y & u) | ~(x | y | u); }
+        }
+        break; }
+
+    case gate_Conj: case gate_Disj: case gate_Even: case gate_Odd:{
+        GateType t = type(w);
+        uint64 init = (t == gate_Conj || t == gate_Even) ? ~0ull : 0ull;
+        for (uint k = 0; k < n; k++) z[k] = init;
+        For_Inputs(w, v){
+            const uint64* a = (*this)[v]; uint64 ma = signMask(v);
+            if      (t == gate_Conj) for (uint k = 0; k < n; k++) z[k] &= a[k] ^ ma;
+            else if (t == gate_Disj) for (uint k = 0; k < n; k++) z[k] |= a[k] ^ ma;
+            else                     for (uint k = 0; k < n; k++) z[k] ^= a[k] ^ ma;
+        }
+        break; }
+
+    case gate_Lut4: case gate_Npn4:{
+        uint ftb = (type(w) == gate_Lut4) ? attr_Lut4(w).ftb : npn4_repr[attr_Npn4(w).cl];
+
+        const uint64* in[4];
+        uint64 ms[4];
+        for (uint i = 0; i < 4; i++){
+            in[i] = (*this)[w[i]];
+            ms[i] = signMask(w[i]); }
+
+        uint64 x[4];
+        for (uint k = 0; k < n; k++){
+            for (uint i = 0; i < 4; i++)
+                x[i] = in[i][k] ^ ms[i];
+            z[k] = evalLut4Word(ftb, x);
+        }
+        break; }
+
+    default:
+        ShoutLn "INTERNAL ERROR! Unexpected gate type in 'NetlistSim': %_", GateType_name[type(w)];
+        assert(false);
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Public interface:
+
+
+void NetlistSim::randomizeInputs(uint64& seed)
+{
+    for (uint i = 0; i < inputs.size(); i++){
+        uint64* z = (*this)[GLit(inputs[i])];
+        for (uint k = 0; k < n_words; k++)
+            z[k] = irandl(seed);
+    }
+}
+
+
+void NetlistSim::initState(uint64& seed)
+{
+    frame = 0;
+
+    Vec<lbool> init(flops.size(), l_Undef);
+    if (Has_Pob(N, flop_init)){
+        Get_Pob(N, flop_init);
+        for (uint i = 0; i < flops.size(); i++)
+            init[i] = flop_init[N[flops[i]]];
+    }
+
+    for (uint i = 0; i < flops.size(); i++){
+        lbool   val = init[i];
+        uint64* z   = (*this)[GLit(flops[i])];
+        if (val == l_Undef){
+            for (uint k = 0; k < n_words; k++) z[k] = irandl(seed);
+        }else{
+            uint64 v = (val == l_True) ? ~0ull : 0ull;
+            for (uint k = 0; k < n_words; k++) z[k] = v;
+        }
+    }
+}
+
+
+void NetlistSim::simulate()
+{
+    for (uint i = 0; i < logic.size(); i++)
+        evalGate(N[logic[i]]);
+}
+
+
+void NetlistSim::step()
+{
+    // Gather next state first; a flop may feed another flop directly.
+    tmp.setSize(flops.size() * n_words);
+    for (uint i = 0; i < flops.size(); i++){
+        Wire w = N[flops[i]];
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]);
+        for (uint k = 0; k < n_words; k++)
+            tmp[i * n_words + k] = a[k] ^ ma;
+    }
+    for (uint i = 0; i < flops.size(); i++){
+        uint64* z = (*this)[GLit(flops[i])];
+        for (uint k = 0; k < n_words; k++)
+            z[k] = tmp[i * n_words + k];
+    }
+
+    frame++;
+}
+
+
+void NetlistSim::run(uint n_frames, uint64& seed)
+{
+    initState(seed);
+    for (uint d = 0; d < n_frames; d++){
+        if (d > 0) step();
+        randomizeInputs(seed);
+        simulate();
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Incremental simulation:
+
+
+// Combinational fanouts, stored compactly: fanouts of gate 'g' are 'fan_list[fan_start[g] ..
+// fan_start[g + 1]]'. Edges into flops are left out (they only matter at 'step()').
+void NetlistSim::computeFanouts()
+{
+    fan_start.reset(N.size() + 1, 0);
+    for (uint i = 0; i < logic.size(); i++){
+        Wire w = N[logic[i]];
+        For_Inputs(w, v)
+            fan_start[id(v) + 1]++;
+    }
+    for (uint i = 0; i < N.size(); i++)
+        fan_start[i + 1] += fan_start[i];
+
+    Vec<uint> fill;
+    fan_start.copyTo(fill);
+    fan_list.setSize(fan_start.last());
+    for (uint i = 0; i < logic.size(); i++){
+        Wire w = N[logic[i]];
+        For_Inputs(w, v)
+            fan_list[fill[id(v)]++] = logic[i];
+    }
+}
+
+
+void NetlistSim::resimulate(const Vec<GLit>& changed)
+{
+    if (fan_start.size() == 0)
+        computeFanouts();
+
+    // Collect transitive fanout (by row number, which is also the topological position):
+    tmp_seen.reset(N.size(), false);
+    tmp_rows.clear();
+    for (uint i = 0; i < changed.size(); i++)
+        tmp_seen[changed[i].id] = true;
+
+    Vec<gate_id> Q;
+    for (uint i = 0; i < changed.size(); i++)
+        Q.push(changed[i].id);
+    while (Q.size() > 0){
+        gate_id g = Q.popC();
+        for (uint j = fan_start[g]; j < fan_start[g + 1]; j++){
+            gate_id h = fan_list[j];
+            if (!tmp_seen[h]){
+                tmp_seen[h] = true;
+                tmp_rows.push(row_of[h]);
+                Q.push(h);
+            }
+        }
+    }
+
+    sort(tmp_rows);
+    for (uint i = 0; i < tmp_rows.size(); i++)
+        evalGate(N[order[tmp_rows[i] - gid_FirstUser]]);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,84 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : NetlistSim.hh
+//| Module      : Bip
+//| Description : Bit-parallel random simulation of a netlist.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Netlist counterpart of 'GigSim' (see 'ZZ/Gig/GigSim.hh'). Used for cheap filtering of
+//| candidate equivalences/constraints before they are handed to the SAT solver.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Bip__NetlistSim_hh
+#define ZZ__Bip__NetlistSim_hh
+
+#include "ZZ_Netlist.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'NetlistSim':
+
+
+// Simulates '64 * n_words' patterns in parallel. Each gate owns a row of 'n_words' consecutive
+// words, rows stored in topological order. The netlist must not be modified during the
+// life-span of this object.
+//
+// PIs and gates the simulator does not understand (memories, 'Uif', 'WLut' etc.) are treated
+// as free inputs and given random values by 'randomizeInputs()'. Flops are initialized from
+// 'flop_init' (random if missing or 'l_Undef') by 'initState()' and updated by 'step()'.
+//
+class NetlistSim {
+    NetlistRef     N;
+    uint           n_words;
+    uint           frame;
+    Vec<gate_id>   order;       // -- gates in topological order (constants excluded)
+    Vec<uint>      row_of;      // -- gate id -> row number (= position in 'order' offset by 'gid_FirstUser')
+    Vec<gate_id>   logic;       // -- gates to evaluate, in topological order
+    Vec<gate_id>   inputs;      // -- free inputs
+    Vec<gate_id>   flops;
+    Vec<uint64>    data;        // -- 'n_words' words per row
+    Vec<uint64>    tmp;
+
+    // Fanouts (computed on demand by 'resimulate()'):
+    Vec<uint>      fan_start;
+    Vec<gate_id>   fan_list;
+    Vec<uchar>     tmp_seen;
+    Vec<uint>      tmp_rows;
+
+    void evalGate(Wire w);
+    void computeFanouts();
+
+public:
+    NetlistSim(NetlistRef N, uint n_words = 4);
+
+    uint  words()     const { return n_words; }
+    uint  patterns()  const { return n_words * 64; }
+    uint  currFrame() const { return frame; }
+
+    uint64*       operator[](GLit w)       { return &data[row_of[w.id] * n_words]; }
+    const uint64* operator[](GLit w) const { return &data[row_of[w.id] * n_words]; }
+        // -- NOTE! Sign of 'w' is ignored.
+    uint64 word(GLit w, uint k) const { return (*this)[w][k] ^ (0ull - (uint64)w.sign); }
+
+    void randomizeInputs(uint64& seed);
+    void initState(uint64& seed);
+    void simulate();
+        // -- Evaluate all logic of the current frame (inputs and flops must be set).
+    void step();
+        // -- Move to next frame by latching the flop inputs (must be preceded by 'simulate()').
+    void run(uint n_frames, uint64& seed);
+        // -- Convenience: initialize then simulate 'n_frames' frames with random inputs. Final
+        // state is the last frame simulated.
+
+    void resimulate(const Vec<GLit>& changed);
+        // -- After overwriting the rows of some inputs or flops ('changed'), re-evaluate only
+        // their transitive fanout.
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
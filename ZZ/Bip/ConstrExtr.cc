@@ -12,6 +12,7 @@
 //|________________________________________________________________________________________________
 
 #include "Prelude.hh"
+#include "ZZ/Generics/Sort.hh"
 #include "ZZ_Bip.Common.hh"
 
 namespace ZZ {
@@ -80,6 +81,7 @@ class Invar {
     // Helpers:
     Lit get(GLit w) { return C.clausify(insertUnrolled(w + N, k, F, n2f)); }
     void splitClasses(Vec<Vec<GLit> >& cands, uint start_from);
+    void simSplit(Vec<Vec<GLit> >& cands);
 
     // Statistics:
     uint n_classes;
@@ -209,6 +211,52 @@ void Invar::getFirst(Vec<Vec<GLit> >& cands)
 
     n_classes = 1;
     n_lit_in_class = cands.last().size();
+
+    if (!bwd)
+        simSplit(cands);
+}
+
+
+// Split the initial class by random simulation of frames '0..k' from the initial state. Every
+// pattern is a reachable state, so no true candidate is lost, and most of the splitting 'refine()'
+// would otherwise do one SAT call at a time is done here in a single pass.
+void Invar::simSplit(Vec<Vec<GLit> >& cands)
+{
+    ZZ_PTimer_Scope(constr_split);
+    assert(cands.size() == 1);
+
+    NetlistSim sim(N, 16);
+    uint64 seed = DEFAULT_SEED;
+    sim.run(k + 1, seed);
+
+    // Group by hash of simulation vector (collisions only mean less splitting):
+    Vec<GLit> cl;
+    mov(cands[0], cl);
+    cands.clear();
+
+    Vec<Pair<uint64,uint> > sigs;
+    for (uint i = 0; i < cl.size(); i++){
+        uint64 h = 0;
+        for (uint j = 0; j < sim.words(); j++)
+            h = (h ^ sim.word(cl[i], j)) * 0x9E3779B97F4A7C15ull;
+        sigs.push(make_tuple(h, i));
+    }
+    sort(sigs);
+
+    n_classes = 0;
+    n_lit_in_class = 0;
+    for (uint i = 0; i < sigs.size();){
+        uint j = i + 1;
+        while (j < sigs.size() && sigs[j].fst == sigs[i].fst) j++;
+        if (j - i > 1){
+            cands.push();
+            for (uint n = i; n < j; n++)
+                cands.last().push(cl[sigs[n].snd]);
+            n_classes++;
+            n_lit_in_class += j - i;
+        }
+        i = j;
+    }
 }
 
 
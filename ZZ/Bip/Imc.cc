@@ -151,9 +151,9 @@ lbool imcStd_(NetlistRef           N0,
     double cpu_time0 = cpuTime();
     if (bf_depth) *bf_depth = -1;
 
-    ImcTrace  imc(N0, props   , P.fwd, cb, P.simplify_itp, P.simple_tseitin, P.quant_claus, P.prune_itp);
+    ImcTrace  imc(N0, props   , P.fwd, cb, P.simplify_itp, P.simple_tseitin, P.quant_claus, P.prune_itp, P.proof_file, P.stream_itp);
     IndCheck  ind(imc.design(), P.fwd, cb);
-    ImcTrace* imc_simp = P.spin ? new ImcTrace(N0, props, P.fwd, cb, P.simplify_itp, P.simple_tseitin, P.quant_claus) : (ImcTrace*)NULL;
+    ImcTrace* imc_simp = P.spin ? new ImcTrace(N0, props, P.fwd, cb, P.simplify_itp, P.simple_tseitin, P.quant_claus, false, P.proof_file, P.stream_itp) : (ImcTrace*)NULL;
     Netlist   N_simp;
     On_Scope_Exit(condDelete<ImcTrace>, imc_simp);
 
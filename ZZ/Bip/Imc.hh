@@ -36,6 +36,8 @@ struct Params_ImcStd {
     bool    spin;
     bool    quiet;
     bool    par_send_result;
+    bool    proof_file;         // -- keep proof log on disk rather than in memory
+    bool    stream_itp;         // -- interpolate learned clauses as they are produced
 
     Params_ImcStd() :
         fwd            (true),
@@ -46,7 +48,9 @@ struct Params_ImcStd {
         quant_claus    (false),
         spin           (false),
         quiet          (false),
-        par_send_result(true)
+        par_send_result(true),
+        proof_file     (false),
+        stream_itp     (false)
     {}
 };
 
@@ -29,7 +29,8 @@ using namespace std;
 
 
 ImcTrace::ImcTrace(NetlistRef N0_, const Vec<Wire>& props_, bool forward, EffortCB* cb,
-                   bool simplify_itp_, bool simple_tseitin, bool quant_claus, bool prune_itp_) :
+                   bool simplify_itp_, bool simple_tseitin, bool quant_claus, bool prune_itp_,
+                   bool proof_file, bool stream_itp) :
     N0(N0_),
     props(copy_, props_),
     fwd(forward),
@@ -51,6 +52,9 @@ ImcTrace::ImcTrace(NetlistRef N0_, const Vec<Wire>& props_, bool forward, Effort
     CH.quant_claus    = quant_claus;
     CB.quant_claus    = quant_claus;
 
+    if (proof_file) S.proofUseFile();
+    if (stream_itp) S.proofStreaming();
+
     initNetlist();
     if (cb){
         S.timeout         = VIRT_TIME_QUANTA;
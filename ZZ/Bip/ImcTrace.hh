@@ -103,7 +103,10 @@ public:
   //  Public interface:
 
     ImcTrace(NetlistRef N0_, const Vec<Wire>& props_, bool forward, EffortCB* cb = NULL,
-             bool simplify_itp_ = false, bool simple_tseitin = false, bool quant_claus = false, bool prune_itp = false);
+             bool simplify_itp_ = false, bool simple_tseitin = false, bool quant_claus = false, bool prune_itp = false,
+             bool proof_file = false, bool stream_itp = false);
+        // -- 'proof_file' keeps the SAT solver's proof log on disk; 'stream_itp' computes the
+        // sub-interpolant of each clause as it is learned (see 'Proof::setStreaming()').
 
     NetlistRef design() const { return N; }
         // -- Returns the simplified version of 'N0' (with pobs: strash, fanout_count, init_bad)
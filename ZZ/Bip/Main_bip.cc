@@ -44,8 +44,10 @@
 #include "ConstrExtr.hh"
 #include "SimpInvar.hh"
 #include "PropCluster.hh"
+#include "PropSched.hh"
+#include "Portfolio.hh"
 
-#define NO_BERKELEY_ABC
+//#define NO_BERKELEY_ABC
 
 #if !defined(NO_BERKELEY_ABC)
 #include "Bdd.hh"
@@ -870,6 +872,7 @@ int main(int argc, char** argv)
     // Command line -- new property driven reachability (The Trebuchet):
     CLI cli_treb;
     addCli_Treb(cli_treb);
+    cli_treb.add("threads", "uint", "1", "Run this many cooperating instances as threads (different seeds, shared cubes). '-timeout' is wall-clock then.");
     cli.addCommand("treb", "Trebuchet version of PDR.", &cli_treb);
 
     // Command line -- new property driven reachability:
@@ -887,6 +890,22 @@ int main(int argc, char** argv)
     cli_pdr.add("dump-invar", "bool", "no", "Dump invariant in clause form.");
     cli.addCommand("pdr", "Property driven reachability analysis.", &cli_pdr);
 
+    // Command line -- in-process portfolio:
+    CLI cli_port;
+    cli_port.add("eng", "string", "treb,pdr,bmc", "Comma separated list of engines to run concurrently: treb, pdr, bmc, imc (may be repeated).");
+    cli_port.add("share", "bool", "yes", "Exchange unreachable cubes and bug-free depths between engines.");
+    cli.addCommand("portfolio", "Run several engines as threads; first result wins. '-timeout' is wall-clock here.", &cli_port);
+
+    // Command line -- multi-property scheduler:
+    CLI cli_sched;
+    cli_sched.add("eng", "{pdr, bmc, treb}", "pdr", "Engine to run on each cluster of properties.");
+    cli_sched.add("threads", "int[1:]", "4", "Number of clusters verified concurrently.");
+    cli_sched.add("clusters", "uint", "0", "Number of clusters to form. 0 = one per 16 properties.");
+    cli_sched.add("pivots", "int[1:]", "256", "Number of state variables to track in support computation.");
+    cli_sched.add("seq", "int[1:]", "5", "Sequential depth of support analysis.");
+    cli_sched.add("slice", "ufloat", "5", "Initial time slice of a cluster (seconds). Extended while the engine makes progress.");
+    cli.addCommand("sched", "Verify properties cluster by cluster on a thread pool. '-timeout' is wall-clock here. With several properties, '-output' writes one result file per property: '<output>.<property#>'.", &cli_sched);
+
     // Command line -- PMC:
     CLI cli_pmc;
     addCli_Pmc(cli_pmc);
@@ -909,6 +928,8 @@ int main(int argc, char** argv)
     cli_imc.add("qc", "bool", "no", "Quantification based clausification.");
     cli_imc.add("st", "bool", "no", "Simple binary Tseitin clausification.");
     cli_imc.add("spin", "bool", "no", "Spin interpolant to minimize it.");
+    cli_imc.add("pfile", "bool", "no", "Store SAT proof log in a temporary file (memory mapped) rather than in memory.");
+    cli_imc.add("stream", "bool", "no", "Compute interpolants incrementally as clauses are learned.");
     // <<== experimental options here for turning off variable removal or recycling
     cli.addCommand("imc", "Interpolation based modelchecking.", &cli_imc);
 
@@ -918,12 +939,14 @@ int main(int argc, char** argv)
     cli_bmc.add("st", "bool", "no", "Simple binary Tseitin clausification.");
     cli_bmc.add("la", "int[1:]", "1", "Number of look-ahead frames.");
     cli_bmc.add("la-decay", "ufloat", "0.8", "Smaller numbers mean later frames are given less time. '1' = all frames have equal time.");
-    cli_bmc.add("sat", "{zz, msc, abc, glu, glr, msr}", "msc", "SAT-solver to use.");
+    cli_bmc.add("sat", "{zz, msc, abc, glu, glr, msr, par, mss}", "msc", "SAT-solver to use. 'par' is a multi-threaded portfolio.");
+    cli_bmc.add("gc", "bool", "yes", "Retire old frames of the unrolling. With '-sat=mss -qc=no', their SAT variables are eliminated as well.");
 
     cli.addCommand("bmc", "Bounded model checking", &cli_bmc);
 
     // Command line -- Multi-BMC:
     CLI cli_multi_bmc;
+    cli_multi_bmc.add("stamp", "bool", "yes", "Clausify transition relation once and instantiate frames from that template.");
     cli.addCommand("multi-bmc", "Multi-property bounded model checking", &cli_multi_bmc);
 
     // Command line -- ping-pong interpolation:
@@ -933,6 +956,8 @@ int main(int argc, char** argv)
 #if !defined(NO_BERKELEY_ABC)
     CLI cli_bdd;
     cli_bdd.add("reorder", "bool", "no", "Enable dynamic variable reordering.");
+    cli_bdd.add("cluster", "uint", "5000", "Merge conjuncts of the transition relation up to this BDD size.");
+    cli_bdd.add("simp", "bool", "yes", "Simplify frontier set with reached states as don't-cares.");
     cli_bdd.add("debug", "bool", "no", "Enable debug output.");
     cli.addCommand("bdd", "BDD based reachability [EXPERIMENTAL].", &cli_bdd);
 #endif
@@ -1455,7 +1480,10 @@ int main(int argc, char** argv)
                        (cli.get("sat").enum_val == 2) ? sat_Abc :
                        (cli.get("sat").enum_val == 3) ? sat_Glu :
                        (cli.get("sat").enum_val == 4) ? sat_Glr :
-                       (cli.get("sat").enum_val == 5) ? sat_Msr : (assert(false), sat_NULL);
+                       (cli.get("sat").enum_val == 5) ? sat_Msr :
+                       (cli.get("sat").enum_val == 6) ? sat_Par :
+                       (cli.get("sat").enum_val == 7) ? sat_Mss : (assert(false), sat_NULL);
+        P.frame_gc       = cli_bmc.get("gc").bool_val;
 
         EffortCB_Timeout cb(vtimeout, timeout);
         Cex   cex;
@@ -1466,6 +1494,7 @@ int main(int argc, char** argv)
 
     }else if (cli.cmd == "multi-bmc"){
         Params_MultiBmc P;
+        P.stamp = cli.get("stamp").bool_val;
         multiBmc(N, P);
         // <<== output result etc.
 
@@ -1478,6 +1507,8 @@ int main(int argc, char** argv)
         P.quant_claus    = cli_imc.get("qc").bool_val;
         P.simple_tseitin = cli_imc.get("st").bool_val;
         P.spin           = cli_imc.get("spin").bool_val;
+        P.proof_file     = cli_imc.get("pfile").bool_val;
+        P.stream_itp     = cli_imc.get("stream").bool_val;
         P.quiet          = cli.get("quiet").bool_val;
         EffortCB_Timeout cb(vtimeout, timeout);
         Cex     cex;
@@ -1508,14 +1539,90 @@ int main(int argc, char** argv)
     }else if (cli.cmd == "treb"){
         Params_Treb P;
         setParams(cli, P);
-        EffortCB_Timeout cb(vtimeout, timeout);
+        uint    n_threads = cli.get("threads").int_val;
         Cex     cex;
         Netlist N_inv;
         int     bug_free_depth;
-        lbool   result = treb(N, props, P, &cex, N_inv, &bug_free_depth, &cb);
+        lbool   result;
+        if (n_threads > 1){
+            Params_Portfolio PP;
+            PP.engines.clear();
+            for (uint i = 0; i < n_threads; i++)
+                PP.engines.push("treb");
+            PP.treb     = P;
+            PP.timeout  = timeout;
+            PP.vtimeout = vtimeout;
+            PP.quiet    = quiet;
+            result = portfolio(N, props, PP, &cex, N_inv, &bug_free_depth);
+        }else{
+            EffortCB_Timeout cb(vtimeout, timeout);
+            result = treb(N, props, P, &cex, N_inv, &bug_free_depth, &cb);
+        }
 
         outputVerificationResult(N, props, result, &cex, orig_num_pis, N_inv, bug_free_depth, cli.get("check").bool_val, output, quiet, T0, Tr0);
 
+    }else if (cli.cmd == "portfolio"){
+        Params_Portfolio P;
+        P.engines.clear();
+        Vec<Str> engs;
+        splitArray(cli.get("eng").string_val.slice(), ",", engs);
+        for (uind i = 0; i < engs.size(); i++){
+            P.engines.push(String(engs[i]));
+            if (!isPortfolioEngine(P.engines.last())){
+                ShoutLn "ERROR! Unknown engine: %_", P.engines.last();
+                exit(1); }
+        }
+        if (P.engines.size() == 0){
+            ShoutLn "ERROR! No engines given.";
+            exit(1); }
+        P.share    = cli.get("share").bool_val;
+        P.timeout  = timeout;
+        P.vtimeout = vtimeout;
+        P.quiet    = quiet;
+        Cex     cex;
+        Netlist N_inv;
+        int     bug_free_depth;
+        lbool   result = portfolio(N, props, P, &cex, N_inv, &bug_free_depth);
+
+        outputVerificationResult(N, props, result, &cex, orig_num_pis, N_inv, bug_free_depth, cli.get("check").bool_val, output, quiet, T0, Tr0);
+
+    }else if (cli.cmd == "sched"){
+        static cchar* engines[] = { "pdr", "bmc", "treb" };
+        Params_PropSched P;
+        P.engine     = engines[cli.get("eng").enum_val];
+        P.n_threads  = cli.get("threads").int_val;
+        P.n_clusters = cli.get("clusters").int_val;
+        P.n_pivots   = cli.get("pivots").int_val;
+        P.seq_depth  = cli.get("seq").int_val;
+        P.slice      = cli.get("slice").float_val;
+        P.timeout    = timeout;
+        P.quiet      = quiet;
+        Vec<lbool> status;
+        Vec<int>   bug_free_depth;
+        Vec<Cex>   cexs;
+        propSched(N, props, P, status, bug_free_depth, &cexs);
+
+        // Report each property as a single-property run ('propSched()' has already printed them):
+        for (uint i = 0; i < props.size(); i++){
+            Vec<Wire> prop(1, props[i]);
+            String    out_i = (output == "" || props.size() == 1) ? output : String((FMT "%_.%_", output, attr_PO(props[i]).number));
+            int       bfd   = (status[i] == l_True) ? -1 : bug_free_depth[i];
+            outputVerificationResult(N, prop, status[i], &cexs[i], orig_num_pis, NetlistRef(), bfd, false, out_i, true, T0, Tr0);
+
+            if (par){
+                Vec<uint> props_(1, i);
+                if (status[i] == l_True)
+                    sendMsg_Result_holds(props_, 1/*safety prop*/);
+                else if (status[i] == l_False){
+                    Vec<uint> depths(1, (uint)cexs[i].depth());
+                    sendMsg_Result_fails(props_, 1/*safety prop*/, depths, cexs[i], N, true);
+                }else
+                    sendMsg_Result_unknown(props_, 1/*safety prop*/);
+            }
+        }
+
+        if (!quiet) writeResourceUsage(T0, Tr0);
+
     }else if (cli.cmd == "pdr2"){
         Params_Pdr2 P;
         setParams(cli, P);
@@ -1547,11 +1654,14 @@ int main(int argc, char** argv)
     }else if (cli.cmd == "bdd"){
         Params_BddReach P;
         P.var_reorder = cli.get("reorder").bool_val;
+        P.cluster_lim = cli.get("cluster").int_val;
+        P.simp_front = cli.get("simp").bool_val;
         P.debug_output = cli.get("debug").bool_val;
         P.quiet = quiet;
       #if !defined(_MSC_VER)
-        //bddReach(N, props, P);
-        if (!quiet) writeResourceUsage(T0, Tr0);
+        int   bug_free_depth;
+        lbool result = bddReach(N, props, P, &bug_free_depth);
+        outputVerificationResult(N, props, result, NULL, orig_num_pis, NetlistRef(), bug_free_depth, false, output, quiet, T0, Tr0);
       #else
         WriteLn "BDD reachability not available under Windows (yet!)";
       #endif
@@ -1727,7 +1837,14 @@ int main(int argc, char** argv)
         uint n_pivots   = cli.get("pivots").int_val;
         uint seq_depth  = cli.get("seq").int_val;
         Vec<Vec<uint> > clusters;
-        clusterProperties(N, n_clusters, n_pivots, seq_depth, clusters);
+        clusterProperties(N, props, n_clusters, n_pivots, seq_depth, clusters);
+
+        for (uint i = 0; i < clusters.size(); i++){
+            Write "Cluster %_:", i;
+            for (uint j = 0; j < clusters[i].size(); j++)
+                Write " %_", attr_PO(props[clusters[i][j]]).number;
+            NewLine;
+        }
 
     }else if (cli.cmd == "saber"){
         uint target_enl = cli.get("k").int_val;
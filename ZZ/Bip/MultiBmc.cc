@@ -89,15 +89,38 @@ void multiBmc(NetlistRef M, const Params_MultiBmc& P)
     // Run BMC:
     MultiSat S(sat_Msc);
     Vec<LLMap<GLit,Lit> > n2s;
+    LutCnfTemplate T;
+    double T_cnf = 0;
+    if (P.stamp){
+        double T0 = cpuTime();
+        T.init(N, props);
+        T_cnf += cpuTime() - T0;
+        WriteLn "Frame template:";
+        WriteLn "  -- variables : %_", T.nVars();
+        WriteLn "  -- clauses   : %_", T.nClauses();
+    }
+
     uint n_props = props.size();
     for (uint depth = 0;; depth++){
-        WriteLn "Depth %_   (#clauses: %,d)  [%t]", depth, S.nClauses(), cpuTime();
+        WriteLn "Depth %_   (#clauses: %,d)  [%t  cnf: %t]", depth, S.nClauses(), cpuTime(), T_cnf;
+
+        if (P.stamp){
+            double T0 = cpuTime();
+            T.addFrame(S, true);
+            T_cnf += cpuTime() - T0;
+        }
 
         for (uint i = 0; i < props.size(); i++){
             if (props[i] == glit_NULL) continue;
 
             Vec<Lit> assumps;
-            assumps.push(~lutClausify(N, depth, props[i], true, S, n2s));
+            if (P.stamp)
+                assumps.push(~T.lit(depth, props[i] + N));
+            else{
+                double T0 = cpuTime();
+                assumps.push(~lutClausify(N, depth, props[i], true, S, n2s));
+                T_cnf += cpuTime() - T0;
+            }
 
             lbool result = S.solve(assumps);
             if (result == l_True){
@@ -111,7 +134,7 @@ void multiBmc(NetlistRef M, const Params_MultiBmc& P)
     }
   Done:;
 
-    WriteLn "CPU-time: %t", cpuTime();
+    WriteLn "CPU-time: %t  (clausification: %t)", cpuTime(), T_cnf;
     // <<== lazy constraints (enforce in every frame or just failing frames?)
     // <<== per output timeout? (continue on old properties by going back in the trace?)
 }
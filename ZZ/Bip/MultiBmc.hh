@@ -11,6 +11,11 @@ using namespace std;
 
 
 struct Params_MultiBmc {
+    bool    stamp;      // -- clausify the transition relation once and instantiate each frame from that template
+
+    Params_MultiBmc() :
+        stamp(true)
+    {}
 };
 
 
@@ -28,7 +28,11 @@ using namespace std;
 // PAR initilization:
 
 
-bool par = false;    // -- TRUE if running Bip in PAR mode.
+ZZ_Thread_Local bool par = false;    // -- TRUE if running Bip in PAR mode.
+
+static ZZ_Thread_Local ParChannel* par_chan        = NULL;
+static ZZ_Thread_Local uint        par_chan_member = 0;
+static ZZ_Thread_Local uind        par_chan_pos    = 0;
 
 
 struct ParWriter : ConsoleWriter {
@@ -187,6 +191,8 @@ static const Array<uchar> empty_data(NULL, 0);
 
 Msg receiveMsg(int fd)
 {
+    assert(!par_chan);      // -- engines running on a channel only poll
+
     if (log_to)
         fputc('R', log_to), fflush(log_to);
     if (replay){
@@ -210,6 +216,12 @@ Msg receiveMsg(int fd)
 
 Msg pollMsg(int fd)
 {
+    if (par_chan){
+        Msg msg;
+        par_chan->fetch(par_chan_member, par_chan_pos, msg);
+        return msg;
+    }
+
     if (replay){
         if (replay == (FILE*)1)
             return Msg_NULL;
@@ -253,6 +265,10 @@ Msg pollMsg(int fd)
 #if 1
 void sendMsg(uint type, Array<const uchar> data, int fd)
 {
+    if (par_chan){
+        par_chan->post(par_chan_member, type, data);
+        return; }
+
     char buf[HEADER_Length + 1];
     sprintf(buf, "%.*u %.*u ", HEADER_TypeBytes, type, HEADER_SizeBytes, data.size());
     //**/fprintf(stderr, "##  Sending message with header [%s]\n", buf);
@@ -1040,6 +1056,123 @@ void sendMsg_ClauseInvar(const Vec<int>& clauses)
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// In-process message channel:
+
+
+ParChannel::ParChannel() :
+    n_reserved(0)
+{
+    chunks = xmalloc<Chunk>(max_chunks);
+    for (uint i = 0; i < max_chunks; i++)
+        chunks[i] = NULL;
+    ZZ_If_Pthreads(pthread_mutex_init(&lock, NULL);)
+}
+
+
+ParChannel::~ParChannel()
+{
+    for (uind i = 0; i < n_reserved; i++)
+        delete chunks[i >> chunk_bits][i & (chunk_size-1)];
+    for (uint i = 0; i < max_chunks; i++)
+        if (chunks[i]) xfree((Slot*)chunks[i]);
+    xfree(chunks);
+    ZZ_If_Pthreads(pthread_mutex_destroy(&lock);)
+}
+
+
+void ParChannel::post(uint member, uint type, Array<const uchar> data)
+{
+    if (type == 6/*Progress*/){
+        // Extract bug-free depth from progress text (first 8 bytes are 'prop_no' and 'prop_type'):
+        cchar* key = "bug-free-depth: ";
+        uint   key_sz = strlen(key);
+        for (uind i = 8; i + key_sz < data.size(); i++){
+            if (memcmp(&data[i], key, key_sz) == 0){
+                int d = 0;
+                for (uind j = i + key_sz; j < data.size() && data[j] >= '0' && data[j] <= '9'; j++)
+                    d = d * 10 + (data[j] - '0');
+                ZZ_If_Pthreads(ScopedMutexLock dummy(&lock);)
+                if (bf_depth(member, -1) < d)
+                    bf_depth[member] = d;
+                break;
+            }
+        }
+
+    }else if (type == 104/*UCube*/){
+        Post* p = new Post;
+        p->member = member;
+        p->type   = type;
+        for (uind i = 0; i < data.size(); i++)
+            p->data.push(data[i]);
+
+        uind idx = atomicAdd(&n_reserved, (uind)1);
+        uind ci  = idx >> chunk_bits;
+        if (ci >= max_chunks){
+            ShoutLn "INTERNAL ERROR! ParChannel overflow.";
+            exit(255); }
+
+        if (!chunks[ci]){
+            Slot* c = xmalloc<Slot>(chunk_size);
+            for (uint i = 0; i < chunk_size; i++)
+                c[i] = NULL;
+            memoryBarrier();
+            if (!atomicCas(&chunks[ci], (Slot*)NULL, c))
+                xfree(c);       // -- someone else got there first
+        }
+        memoryBarrier();        // -- 'p' must be fully written before it is published
+        chunks[ci][idx & (chunk_size-1)] = p;
+    }
+}
+
+
+// Get next message not sent by 'member' at or after position 'pos' (which is advanced). Returns
+// FALSE (and leaves 'msg' untouched) if there is none.
+bool ParChannel::fetch(uint member, uind& pos, Msg& msg)
+{
+    uind end = n_reserved;
+    while (pos < end){
+        Slot* c = chunks[pos >> chunk_bits];
+        if (!c) break;
+        Post* p = c[pos & (chunk_size-1)];
+        if (!p) break;          // -- reserved but not yet published; keep the order
+        memoryBarrier();
+        pos++;
+        if (p->member != member){
+            msg = Msg(p->type, Pkg(p->data));   // -- fresh copy; 'Pkg' reference counting is not thread-safe
+            return true;
+        }
+    }
+    return false;
+}
+
+
+int ParChannel::bugFreeDepth()
+{
+    ZZ_If_Pthreads(ScopedMutexLock dummy(&lock);)
+    int ret = -1;
+    for (uint i = 0; i < bf_depth.size(); i++)
+        newMax(ret, bf_depth[i]);
+    return ret;
+}
+
+
+void attachParChannel(ParChannel* chan, uint member)
+{
+    par_chan = chan;
+    par_chan_member = member;
+    par_chan_pos = 0;
+    par = true;
+}
+
+
+void detachParChannel()
+{
+    par_chan = NULL;
+    par = false;
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 }
 
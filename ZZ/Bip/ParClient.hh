@@ -26,8 +26,8 @@ using namespace std;
 // PAR initilization:
 
 
-extern bool par;    // -- TRUE if running Bip in PAR mode.
-void startPar();    // -- Initialize PAR client and redirect 'std_out'.
+extern ZZ_Thread_Local bool par;    // -- TRUE if running Bip in PAR mode (or attached to a 'ParChannel').
+void startPar();                    // -- Initialize PAR client and redirect 'std_out'.
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -83,6 +83,50 @@ void sendMsg_ClauseInvar(const Vec<int>& clauses);
 void streamIn_Netlist(const uchar* in, const uchar* end, NetlistRef N);
 void streamOut_Netlist(Vec<uchar>& data, NetlistRef N);
 
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// In-process message channel:
+
+
+// Replaces the PAR pipes for engines running as threads of the same process. A thread attached
+// to a channel runs in PAR mode; 'sendMsg()' posts to the channel and 'pollMsg()' returns messages
+// posted by the OTHER members (in order). Only unreachable cubes (104) and progress messages (6)
+// are kept; everything else an engine sends is dropped.
+//
+// Cube posts are appended without locking: a slot is reserved by an atomic increment and the
+// post is published by storing its pointer. Readers stop at the first reserved but not yet
+// published slot, so every member sees the posts in the same order.
+//
+struct ParChannel {
+    struct Post {
+        uint       member;
+        uint       type;
+        Vec<uchar> data;
+    };
+
+    enum { chunk_bits = 12, chunk_size = 1 << chunk_bits, max_chunks = 1 << 16 };
+
+    typedef Post* volatile Slot;        // -- NULL until the post is published
+    typedef Slot*  volatile Chunk;      // -- 'chunk_size' slots, allocated on demand
+
+    Chunk*        chunks;               // -- 'max_chunks' elements
+    volatile uind n_reserved;           // -- number of slots handed out by 'post()'
+
+    Vec<int>    bf_depth;       // -- best reported "bug-free-depth" per member (-1 if none)
+    ZZ_If_Pthreads(pthread_mutex_t lock;)   // -- protects 'bf_depth' only
+
+    ParChannel();
+   ~ParChannel();
+
+    void post(uint member, uint type, Array<const uchar> data);
+    bool fetch(uint member, uind& pos, /*out*/Msg& msg);
+    int  bugFreeDepth();        // -- maximum over all members
+};
+
+
+void attachParChannel(ParChannel* chan, uint member);   // -- for the calling thread only
+void detachParChannel();
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 }
 #endif
@@ -1220,7 +1220,9 @@ void Pdr::extractCex(ProofObl start, Cex& cex)
         }
 
         // Run SAT-solver to find inputs for one transition:
-        lbool result = S.solve(assumps); assert(result == l_True);
+        lbool result = S.solve(assumps);
+        if (result == l_Undef) throw Excp_Pdr_Abort();
+        assert(result == l_True);
 
         // Store model in counter-example:
         cex_pi.push();
@@ -1307,6 +1307,8 @@ bool Pdr2::blockCube(TCube s0)
 
 bool Pdr2::run()
 {
+    npn4Init();
+
     // Add a flop on top of the property:
     Get_Pob(N, properties);
     Get_Pob(N, flop_init);
@@ -1372,16 +1374,12 @@ bool Pdr2::run()
                 Get_Pob(N, up_order);
                 up_order.recompute();
 
-#if 1
+                // Frames and cubes carry over unchanged (the new property fails only where the
+                // old one did), but the solvers are rebuilt from them. Extending the solvers in
+                // place (dropping the clausified 'w_prop_in' and 'w_prop') is also sound but
+                // measured slower; rebuilding is cheap next to blocking and propagation.
                 for (uint d = 0; d < F.size(); d++)
                     recycleSolver(d);
-#else
-                for (uint d = 0; d < F.size(); d++){
-                    n2s[d][0](w_prop_in) = lit_Undef;
-                    n2s[d][1](w_prop) = lit_Undef;
-                    clausify(d, w_prop, 1);
-                }
-#endif
 
                 WriteLn "           \a*\a/==>> increasing\a/ k \a/to\a/ %_ \a/<<==\a/\a*", ++klive_depth;
 
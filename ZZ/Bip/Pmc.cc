@@ -1059,6 +1059,8 @@ bool Pmc::blockCube(TCube s0)
 
 bool Pmc::run()
 {
+    npn4Init();
+
     // Add a flop on top of the property:
     Get_Pob(N, properties);
     Get_Pob(N, flop_init);
@@ -0,0 +1,276 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Portfolio.cc
+//| Module      : Bip
+//| Description : Run several verification engines as threads of the same process.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//|
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "Portfolio.hh"
+#include "ParClient.hh"
+#include "Treb.hh"
+#include "Pdr.hh"
+#include "Bmc.hh"
+#include "Imc.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Worker state:
+
+
+struct PortfolioShared {
+    ParChannel   chan;
+    volatile int winner;        // -- index of first engine to produce a definite result (-1 if none yet)
+
+    PortfolioShared() : winner(-1) {}
+};
+
+
+struct PortfolioWorker {
+    // Input:
+    uint              num;
+    String            engine;
+    Netlist           M;        // -- private copy of the netlist
+    Vec<Wire>         props;    // -- single (conjoined) property of 'M'
+    bool              share;
+    Params_Treb       P_treb;
+    uint64            vt_limit;
+    double            real_limit;
+    PortfolioShared*  shared;
+
+    // Output:
+    lbool             result;
+    Cex               cex;
+    Netlist           N_invar;
+    int               bf_depth;
+    double            real_time;
+
+    PortfolioWorker() : num(0), share(false), vt_limit(UINT64_MAX), real_limit(DBL_MAX), shared(NULL), result(l_Undef), bf_depth(-1), real_time(0) {}
+};
+
+
+// Abort engine when another engine has finished, or when out of (wall-clock) time. CPU time is
+// shared by all threads, so 'EffortCB_Timeout' cannot be used.
+struct EffortCB_Portfolio : EffortCB {
+    const PortfolioWorker& W;
+    EffortCB_Portfolio(const PortfolioWorker& W_) : W(W_) {}
+
+    bool operator()() {
+        return W.shared->winner == -1 && virt_time < W.vt_limit && (W.real_limit == DBL_MAX || realTime() < W.real_limit); }
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Run one engine:
+
+
+bool isPortfolioEngine(const String& name)
+{
+    return name == "treb" || name == "pdr" || name == "bmc" || name == "imc";
+}
+
+
+static
+void runEngine(PortfolioWorker& W)
+{
+    EffortCB_Portfolio cb(W);
+    double T0 = realTime();
+
+    if (W.share)
+        attachParChannel(&W.shared->chan, W.num);
+
+    if (W.engine == "treb"){
+        // Instances get different seeds, so several "treb" engines shuffle their literals
+        // differently during generalization and learn different cubes, which they exchange:
+        Params_Treb P = W.P_treb;
+        P.quiet = true;
+        P.par_send_cubes = true;
+        P.par_recv_cubes = true;
+        P.seed += W.num;
+        W.result = treb(W.M, W.props, P, &W.cex, W.N_invar, &W.bf_depth, &cb);
+
+    }else if (W.engine == "pdr"){
+        Params_Pdr P;
+        P.quiet = true;
+        W.result = propDrivenReach(W.M, W.props, P, &W.cex, W.N_invar, &W.bf_depth, &cb);
+
+    }else if (W.engine == "bmc"){
+        Params_Bmc P;
+        P.quiet = true;
+        W.result = bmc(W.M, W.props, P, &W.cex, &W.bf_depth, &cb);
+
+    }else if (W.engine == "imc"){
+        Params_ImcStd P;
+        P.quiet = true;
+        W.result = imcStd(W.M, W.props, P, &W.cex, W.N_invar, &W.bf_depth, &cb);
+
+    }else
+        assert(false);
+
+    if (W.share)
+        detachParChannel();
+
+    W.real_time = realTime() - T0;
+    if (W.result != l_Undef)
+        atomicCas(&W.shared->winner, -1, (int)W.num);
+}
+
+
+#if defined(ZZ_PTHREADS)
+extern "C" void* portfolioThread(void* data);
+void* portfolioThread(void* data)
+{
+    runEngine(*static_cast<PortfolioWorker*>(data));
+    return NULL;
+}
+#endif
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Main function:
+
+
+// Instantiate serialized netlist 'data' into 'M' and conjoin its properties into a single one
+// (engines in PAR mode only handle one property).
+static
+void instantiateCopy(const Vec<uchar>& data, NetlistRef M, Vec<Wire>& props)
+{
+    streamIn_Netlist(data.base(), data.base() + data.size(), M);
+
+    Get_Pob(M, properties);
+    if (properties.size() == 1){
+        props.push(properties[0]);
+        return; }
+
+    Wire w_conj = M.True();
+    for (uind i = 0; i < properties.size(); i++)
+        w_conj = M.add(And_(), w_conj, properties[i][0]);
+    For_Gatetype(M, gate_PO, w)
+        remove(w);
+
+    properties.clear();
+    properties.push(M.add(PO_(0), w_conj));
+    props.push(properties[0]);
+}
+
+
+lbool portfolio(NetlistRef N, const Vec<Wire>& props, const Params_Portfolio& P, Cex* cex, NetlistRef invariant, int* bug_free_depth)
+{
+    assert(P.engines.size() > 0);
+
+    // Serialize netlist once, with 'props' as its only properties:
+    Vec<uchar> data;
+    {
+        Assure_Pob(N, properties);
+        Vec<Wire> saved;
+        properties.copyTo(saved);
+        properties.clear();
+        for (uind i = 0; i < props.size(); i++)
+            properties.push(props[i]);
+        streamOut_Netlist(data, N);
+        properties.clear();
+        for (uind i = 0; i < saved.size(); i++)
+            properties.push(saved[i]);
+    }
+
+    // Setup workers (on the main thread, so that netlist allocation is sequential):
+    double          T0 = realTime();
+    PortfolioShared shared;
+    Vec<PortfolioWorker*> ws;
+    for (uint i = 0; i < P.engines.size(); i++){
+        ws.push(new PortfolioWorker);
+        PortfolioWorker& W = *ws.last();
+        W.num        = i;
+        W.engine     = P.engines[i];
+        W.share      = P.share;
+        W.P_treb     = P.treb;
+        W.vt_limit   = P.vtimeout;
+        W.real_limit = (P.timeout == DBL_MAX) ? DBL_MAX : T0 + P.timeout;
+        W.shared     = &shared;
+        instantiateCopy(data, W.M, W.props);
+    }
+    data.clear(true);
+
+    if (!P.quiet){
+        WriteLn "Portfolio:%_ (%_)", ZZ_If_Pthreads_Else("", " NOTE! Compiled without pthreads; running engines one at a time."), info(ws[0]->M);
+        Write   "  engines:";
+        for (uint i = 0; i < ws.size(); i++) Write " %_", ws[i]->engine;
+        NewLine;
+    }
+
+    // Run engines:
+  #if defined(ZZ_PTHREADS)
+    reserveNetlists(8 * ws.size() + 16);   // -- engines create netlists of their own; avoid reallocation of global table
+
+    Vec<pthread_t> threads(ws.size());
+    for (uint i = 0; i < ws.size(); i++){
+        if (pthread_create(&threads[i], NULL, portfolioThread, ws[i]) != 0){
+            ShoutLn "ERROR! Could not create thread for engine: %_", ws[i]->engine;
+            exit(1); }
+    }
+    for (uint i = 0; i < ws.size(); i++)
+        pthread_join(threads[i], NULL);
+
+    unreserveNetlists();
+  #else
+    for (uint i = 0; i < ws.size() && shared.winner == -1; i++){
+        PortfolioWorker& W = *ws[i];
+        if (P.timeout != DBL_MAX)
+            W.real_limit = realTime() + (T0 + P.timeout - realTime()) / (ws.size() - i);
+        runEngine(W);
+    }
+  #endif
+
+    // Collect result:
+    lbool result   = l_Undef;
+    int   bf_depth = shared.chan.bugFreeDepth();
+    for (uint i = 0; i < ws.size(); i++){
+        PortfolioWorker& W = *ws[i];
+        if (W.result == l_Undef)
+            newMax(bf_depth, W.bf_depth);
+        if (!P.quiet)
+            WriteLn "  [%_] %_  \a/(%.2f s)\a/", W.engine, (W.result == l_True) ? "proved" : (W.result == l_False) ? "FAILED" : "aborted", W.real_time;
+    }
+
+    if (shared.winner != -1){
+        PortfolioWorker& W = *ws[shared.winner];
+        result = W.result;
+        if (!P.quiet) WriteLn "Winner: \a*%_\a*", W.engine;
+
+        if (result == l_False){
+            bf_depth = W.bf_depth;
+            if (cex){
+                CCex ccex;
+                translateCex(W.cex, ccex, W.M);
+                translateCex(ccex, N, *cex);
+            }
+
+        }else{
+            bf_depth = INT_MAX;
+            if (invariant && W.N_invar.typeCount(gate_PO) == 1){
+                invariant.clear();
+                Add_Pob0(invariant, strash);
+                For_Gatetype(W.N_invar, gate_PO, w)
+                    invariant.add(PO_(0), copyFormula(w[0], invariant));
+            }
+        }
+    }
+
+    if (bug_free_depth)
+        *bug_free_depth = bf_depth;
+
+    for (uint i = 0; i < ws.size(); i++)
+        delete ws[i];
+
+    return result;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
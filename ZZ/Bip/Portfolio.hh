@@ -0,0 +1,70 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Portfolio.hh
+//| Module      : Bip
+//| Description : Run several verification engines as threads of the same process.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Each engine works on a private copy of the (preprocessed) netlist. The first engine to prove
+//| or refute the property cancels the others through their effort callbacks. Unreachable cubes
+//| and bug-free depths are exchanged through an in-process 'ParChannel' (see 'ParClient.hh').
+//|
+//| Without 'ZZ_PTHREADS', engines are run one after another with an equal share of the timeout.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Bip__Portfolio_hh
+#define ZZ__Bip__Portfolio_hh
+
+#include "ZZ_Netlist.hh"
+#include "ZZ_Bip.Common.hh"
+#include "Treb.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Parameters:
+
+
+struct Params_Portfolio {
+    Vec<String> engines;        // Engines to run, one thread each ("treb", "pdr", "bmc", "imc"). May be repeated.
+    bool        share;          // Exchange unreachable cubes and bug-free depths between engines.
+    double      timeout;        // Wall-clock timeout (in seconds) for the whole portfolio.
+    uint64      vtimeout;       // Virtual timeout for each individual engine.
+    bool        quiet;          // Suppress output (engines are always run in quiet mode).
+    Params_Treb treb;           // Base parameters of "treb" engines. Engine 'i' adds 'i' to the seed.
+
+    Params_Portfolio() :
+        share(true),
+        timeout(DBL_MAX),
+        vtimeout(UINT64_MAX),
+        quiet(false)
+    {
+        engines.push("treb");
+        engines.push("pdr");
+        engines.push("bmc");
+    }
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Functions:
+
+
+bool isPortfolioEngine(const String& name);
+
+lbool portfolio(NetlistRef              N,
+                const Vec<Wire>&        props,
+                const Params_Portfolio& P,
+                Cex*                    cex,
+                NetlistRef              invariant,
+                int*                    bug_free_depth
+                );
+    // -- 'N' must have contiguously numbered PIs and flops (see 'checkNumbering()'). 'P.engines'
+    // must be non-empty and contain only names accepted by 'isPortfolioEngine()'.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
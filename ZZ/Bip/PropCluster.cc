@@ -13,6 +13,7 @@
 
 #include "Prelude.hh"
 #include "PropCluster.hh"
+#include "ZZ/Generics/Sort.hh"
 
 namespace ZZ {
 using namespace std;
@@ -48,8 +49,42 @@ void pickPivots(NetlistRef N, uint n_pivots, WMap<uint>& pivots)
 }
 
 
-void clusterProperties(NetlistRef N, uint n_clusters, uint n_pivots, uint seq_depth, /*out*/Vec<Vec<uint> >& clusters)
+static
+uint popCount(uint64 word)
 {
+  #if defined(__GNUC__)
+    return __builtin_popcountll(word);
+  #else
+    uint n = 0;
+    for (; word != 0; word &= word - 1) n++;
+    return n;
+  #endif
+}
+
+
+// Jaccard distance between a support and the union support of a cluster (in '[0, 1]').
+static
+double supportDist(const uint64* sup, const uint64* uni, uint words)
+{
+    uint n_common = 0, n_union = 0;
+    for (uint j = 0; j < words; j++){
+        n_common += popCount(sup[j] & uni[j]);
+        n_union  += popCount(sup[j] | uni[j]);
+    }
+    return (n_union == 0) ? 0.0 : 1.0 - (double)n_common / n_union;
+}
+
+
+// Partition 'props' into at most 'n_clusters' groups of properties with similar (approximate)
+// support. The support of a property is approximated by which of 'n_pivots' randomly selected
+// flops are reachable within 'seq_depth' frames. Cluster seeds are selected by farthest-first
+// traversal, then remaining properties are assigned (largest support first) to the closest
+// cluster that is not full. Output are indices into 'props'.
+void clusterProperties(NetlistRef N, const Vec<Wire>& props, uint n_clusters, uint n_pivots, uint seq_depth, /*out*/Vec<Vec<uint> >& clusters)
+{
+    clusters.clear();
+    if (props.size() == 0) return;
+
     // Select pivot elements:
     WMap<uint> pivots;
     pickPivots(N, n_pivots, pivots);
@@ -84,23 +119,77 @@ void clusterProperties(NetlistRef N, uint n_clusters, uint n_pivots, uint seq_de
         }
     }
 
-#if 1   /*DEBUG*/
-    Get_Pob(N, properties);
-    for (uint i = 0; i < properties.size(); i++){
-        uint64* sup = &mem[properties[i].id() * words];
+#if 0   /*DEBUG*/
+    for (uint i = 0; i < props.size(); i++){
+        uint64* sup = &mem[props[i].id() * words];
         for (uint j = 0; j < words; j++)
             Write "%.16x", sup[j];
         NewLine;
     }
 #endif  /*END DEBUG*/
 
+    // Order properties by decreasing support size:
+    Vec<Pair<uint,uint> > by_size;  // -- (size, prop index)
+    for (uint i = 0; i < props.size(); i++){
+        const uint64* sup = &mem[props[i].id() * words];
+        uint sz = 0;
+        for (uint j = 0; j < words; j++)
+            sz += popCount(sup[j]);
+        by_size.push(make_tuple(~sz, i));
+    }
+    sort(by_size);
+
+    // Select seeds by farthest-first traversal:
+    Vec<uint64> uni;            // -- union support of each cluster ('words' words per cluster)
+    Vec<double> dist(props.size(), 1.0);
+    Vec<uchar>  assigned(props.size(), 0);
+    newMin(n_clusters, props.size());
+    uint next = by_size[0].snd;
+    while (clusters.size() < n_clusters){
+        const uint64* sup = &mem[props[next].id() * words];
+        clusters.push();
+        clusters.last().push(next);
+        assigned[next] = 1;
+        for (uint j = 0; j < words; j++)
+            uni.push(sup[j]);
+
+        double best = 0;
+        for (uint i = 0; i < props.size(); i++){
+            if (assigned[i]) continue;
+            newMin(dist[i], supportDist(&mem[props[i].id() * words], sup, words));
+            if (dist[i] > best){
+                best = dist[i];
+                next = i; }
+        }
+        if (best == 0) break;   // -- remaining properties coincide with a seed
+    }
 
-/*
-    1000 properties => 1,000,000 pairwise distances    
+    // Assign remaining properties:
+    uint cap = (props.size() + clusters.size() - 1) / clusters.size() * 2;
+    for (uint k = 0; k < by_size.size(); k++){
+        uint i = by_size[k].snd;
+        if (assigned[i]) continue;
+
+        const uint64* sup = &mem[props[i].id() * words];
+        uint   best_c = UINT_MAX;
+        double best_d = DBL_MAX;
+        for (uint c = 0; c < clusters.size(); c++){
+            if (clusters[c].size() >= cap) continue;
+            double d = supportDist(sup, &uni[c * words], words);
+            if (d < best_d || (d == best_d && clusters[c].size() < clusters[best_c].size())){
+                best_d = d;
+                best_c = c; }
+        }
+        assert(best_c != UINT_MAX);
+
+        clusters[best_c].push(i);
+        for (uint j = 0; j < words; j++)
+            uni[best_c * words + j] |= sup[j];
+    }
 
-    can I make a move that decreases the sum of support size? if not, same question counting one occurance as zero, two as zero etc.
-    abcd    abcd
-*/
+    for (uint c = 0; c < clusters.size(); c++)
+        sort(clusters[c]);
+    xfree(mem);
 }
 
 
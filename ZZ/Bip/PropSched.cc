@@ -0,0 +1,451 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : PropSched.cc
+//| Module      : Bip
+//| Description : Verify many properties by running clusters of them concurrently.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//|
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "PropSched.hh"
+#include "PropCluster.hh"
+#include "Treb.hh"
+#include "Pdr.hh"
+#include "Bmc.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Cone of influence extraction:
+
+
+// Copy the transitive fanin of 'w0' into 'M'. Flops are created without an input; they are put
+// on 'new_flops' for the caller to connect.
+static
+Wire copyCone(Wire w0, NetlistRef M, WMap<Wire>& n2m, Vec<Wire>& new_flops)
+{
+    Vec<Wire> Q(1, +w0);
+    while (Q.size() > 0){
+        Wire w = Q.last();
+        if (n2m[w]){
+            Q.pop();
+            continue; }
+
+        switch (type(w)){
+        case gate_PI:
+            n2m(w) = M.add(PI_(attr_PI(w).number));
+            Q.pop();
+            break;
+        case gate_Flop:
+            n2m(w) = M.add(Flop_(attr_Flop(w).number));
+            new_flops.push(w);
+            Q.pop();
+            break;
+        case gate_And:{
+            Wire x = n2m[w[0]];
+            Wire y = n2m[w[1]];
+            if      (!x) Q.push(+w[0]);
+            else if (!y) Q.push(+w[1]);
+            else{
+                n2m(w) = s_And(x ^ sign(w[0]), y ^ sign(w[1]));
+                Q.pop();
+            }
+            break;}
+        default:
+            ShoutLn "INTERNAL ERROR! Unexpected gate type in property cone: %_", GateType_name[type(w)];
+            assert(false);
+        }
+    }
+    return n2m[w0] ^ sign(w0);
+}
+
+
+// Copy the cone of influence of 'sinks' (POs of 'N') into the empty netlist 'M'. PIs, flops and
+// POs keep their numbers. Constraints are copied and then folded into the properties, so
+// 'verifyCex()' will not change 'M' later. The copied properties are returned in 'm_sinks'
+// (same order as 'sinks').
+static
+void extractCone(NetlistRef N, const Vec<Wire>& sinks, NetlistRef M, Vec<Wire>& m_sinks)
+{
+    Get_Pob(N, flop_init);
+    Add_Pob0(M, strash);
+    Add_Pob2(M, flop_init, m_flop_init);
+    Add_Pob2(M, properties, m_properties);
+
+    WMap<Wire> n2m;
+    n2m(N.True ()) = M.True ();
+    n2m(N.False()) = M.False();
+    Vec<Wire> new_flops;
+
+    for (uint i = 0; i < sinks.size(); i++){
+        Wire w = sinks[i]; assert(type(w) == gate_PO);
+        Wire w_m = M.add(PO_(attr_PO(w).number), copyCone(w[0], M, n2m, new_flops));
+        m_properties.push(w_m ^ sign(w));
+    }
+
+    if (Has_Pob(N, constraints)){
+        Get_Pob(N, constraints);
+        Add_Pob2(M, constraints, m_constraints);
+        for (uint i = 0; i < constraints.size(); i++){
+            Wire w = constraints[i];
+            m_constraints.push(M.add(PO_(attr_PO(w).number), copyCone(w[0], M, n2m, new_flops)));
+        }
+    }
+
+    while (new_flops.size() > 0){
+        Wire w = new_flops.popC();
+        Wire w_m = n2m[w];
+        w_m.set(0, copyCone(w[0], M, n2m, new_flops));
+        m_flop_init(w_m) = flop_init[w];
+    }
+
+    foldConstraints(M);
+    m_sinks.clear();
+    for (uint i = 0; i < m_properties.size(); i++)
+        m_sinks.push(m_properties[i]);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Scheduler state:
+
+
+struct PropSched_Cluster {
+    uint        num;
+    Vec<uint>   props;          // -- unresolved properties (indices into 'props' of 'propSched()')
+    Netlist     M;              // -- cone of influence (extracted on first run)
+    Vec<Wire>   m_props;        // -- 'm_props[i]' is the copy of 'props[i]' in 'M'
+    double      slice;          // -- time slice for next run (doubled after each preemption)
+    uint        n_runs;
+    int         bf_depth;       // -- bug-free depth of unresolved properties
+
+    PropSched_Cluster() : num(0), slice(0), n_runs(0), bf_depth(-1) {}
+};
+
+
+struct PropSched_Shared {
+    // Input:
+    NetlistRef              N;
+    const Vec<Wire>&        props;
+    const Params_PropSched& P;
+    double                  T0;
+    double                  deadline;
+
+    // Work:
+    Vec<PropSched_Cluster*> clusters;
+    Vec<uint>               queue;      // -- clusters waiting for a thread (FIFO from 'q_head')
+    uint                    q_head;
+    volatile uint           n_waiting;  // -- read without lock by effort callbacks
+    uint                    n_running;
+    volatile bool           stop;
+
+    // Output:
+    Vec<lbool>&             status;
+    Vec<int>&               bf_depth;
+    Vec<CCex>*              ccexs;      // -- counterexamples in PI/flop numbers (if requested)
+    uint                    n_proved;
+    uint                    n_failed;
+
+  #if defined(ZZ_PTHREADS)
+    pthread_mutex_t         lock;
+    pthread_cond_t          changed;
+  #endif
+
+    PropSched_Shared(NetlistRef N_, const Vec<Wire>& props_, const Params_PropSched& P_, Vec<lbool>& status_, Vec<int>& bf_depth_, Vec<CCex>* ccexs_) :
+        N(N_), props(props_), P(P_), T0(realTime()), deadline(P_.timeout == DBL_MAX ? DBL_MAX : T0 + P_.timeout),
+        q_head(0), n_waiting(0), n_running(0), stop(false), status(status_), bf_depth(bf_depth_), ccexs(ccexs_), n_proved(0), n_failed(0)
+    {
+        ZZ_If_Pthreads(pthread_mutex_init(&lock, NULL);)
+        ZZ_If_Pthreads(pthread_cond_init(&changed, NULL);)
+    }
+
+   ~PropSched_Shared()
+    {
+        ZZ_If_Pthreads(pthread_cond_destroy(&changed);)
+        ZZ_If_Pthreads(pthread_mutex_destroy(&lock);)
+        for (uint i = 0; i < clusters.size(); i++)
+            delete clusters[i];
+    }
+
+    void acquire() { ZZ_If_Pthreads(pthread_mutex_lock(&lock);) }
+    void release() { ZZ_If_Pthreads(pthread_mutex_unlock(&lock);) }
+    void wait   () { ZZ_If_Pthreads(pthread_cond_wait(&changed, &lock);) }
+    void signal () { ZZ_If_Pthreads(pthread_cond_broadcast(&changed);) }
+
+    void enqueue(uint c) {
+        if (q_head == queue.size()){ queue.clear(); q_head = 0; }
+        queue.push(c);
+        n_waiting = queue.size() - q_head; }
+};
+
+
+// Abort engine when out of time. When its time slice is used up, the engine may continue if
+// its depth has increased during the slice, or if no other cluster is waiting for a thread.
+struct EffortCB_PropSched : EffortCB {
+    PropSched_Shared&        S;
+    const PropSched_Cluster& C;
+    double                   slice_end;
+    uint                     slice_depth;
+    bool                     preempted;
+
+    EffortCB_PropSched(PropSched_Shared& S_, const PropSched_Cluster& C_) :
+        S(S_), C(C_), slice_end(realTime() + C_.slice), slice_depth(0), preempted(false) {}
+
+    uint depth() const {
+        if (!info) return 0;
+        if (S.P.engine == "pdr")  return static_cast<Info_Pdr*> (info)->depth;
+        if (S.P.engine == "bmc")  return static_cast<Info_Bmc*> (info)->depth;
+        if (S.P.engine == "treb") return static_cast<Info_Treb*>(info)->depth;
+        return 0; }
+
+    bool operator()() {
+        if (S.stop) return false;
+        double now = realTime();
+        if (now >= S.deadline) return false;
+        if (now < slice_end) return true;
+
+        uint d = depth();
+        if (d > slice_depth || S.n_waiting == 0){
+            slice_depth = d;
+            slice_end = now + C.slice;
+            return true;
+        }
+        preempted = true;
+        return false;
+    }
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Run one cluster:
+
+
+bool isPropSchedEngine(const String& name)
+{
+    return name == "pdr" || name == "bmc" || name == "treb";
+}
+
+
+static
+void runCluster(PropSched_Shared& S, PropSched_Cluster& C)
+{
+    if (C.n_runs == 0){
+        Vec<Wire> sinks;
+        for (uint i = 0; i < C.props.size(); i++)
+            sinks.push(S.props[C.props[i]]);
+        extractCone(S.N, sinks, C.M, C.m_props);
+    }
+
+    // Run engine:
+    EffortCB_PropSched cb(S, C);
+    Cex     cex;
+    Netlist N_invar;
+    int     bf_depth = -1;
+    lbool   result   = l_Undef;
+    double  T0       = realTime();
+
+    if (S.P.engine == "pdr"){
+        Params_Pdr P;
+        P.quiet = true;
+        result = propDrivenReach(C.M, C.m_props, P, &cex, N_invar, &bf_depth, &cb);
+
+    }else if (S.P.engine == "bmc"){
+        Params_Bmc P;
+        P.quiet = true;
+        result = bmc(C.M, C.m_props, P, &cex, &bf_depth, &cb);
+
+    }else if (S.P.engine == "treb"){
+        Params_Treb P;
+        P.quiet = true;
+        result = treb(C.M, C.m_props, P, &cex, N_invar, &bf_depth, &cb);
+
+    }else
+        assert(false);
+
+    Vec<uint> fails_at;
+    if (result == l_False && !verifyCex(C.M, C.m_props, cex, &fails_at)){
+        ShoutLn "INTERNAL ERROR! Counterexample for cluster %_ did not verify.", C.num;
+        result = l_Undef;
+        C.props.clear();    // -- give up on this cluster
+        C.m_props.clear();
+    }
+
+    // 'M' is private to the cluster, so express the counterexample in numbers before it goes:
+    CCex ccex;
+    if (result == l_False && S.ccexs)
+        translateCex(cex, ccex, C.M);
+
+    // Report:
+    S.acquire();
+    C.n_runs++;
+    newMax(C.bf_depth, bf_depth);
+
+    if (result == l_True){
+        for (uint i = 0; i < C.props.size(); i++){
+            uint p = C.props[i];
+            S.status[p]   = l_True;
+            S.bf_depth[p] = INT_MAX;
+            WriteLn "Property# %_: proved   \a/[cluster %_, %.2f s]\a/", attr_PO(S.props[p]).number, C.num, realTime() - S.T0;
+        }
+        S.n_proved += C.props.size();
+        C.props.clear();
+        C.m_props.clear();
+
+    }else if (result == l_False){
+        uint j = 0;
+        for (uint i = 0; i < C.props.size(); i++){
+            uint p = C.props[i];
+            if (fails_at[i] == UINT_MAX){
+                C.props  [j] = C.props  [i];
+                C.m_props[j] = C.m_props[i];
+                j++;
+            }else{
+                S.status[p]   = l_False;
+                S.bf_depth[p] = (int)fails_at[i] - 1;
+                S.n_failed++;
+                if (S.ccexs){
+                    CCex& c = (*S.ccexs)[p];
+                    ccex.copyTo(c);
+                    c.inputs.shrinkTo(fails_at[i] + 1);
+                    if (c.flops.size() > fails_at[i] + 1)
+                        c.flops.shrinkTo(fails_at[i] + 1);
+                }
+                WriteLn "Property# %_: FAILED at depth %_   \a/[cluster %_, %.2f s]\a/", attr_PO(S.props[p]).number, fails_at[i], C.num, realTime() - S.T0;
+            }
+        }
+        C.props  .shrinkTo(j);
+        C.m_props.shrinkTo(j);
+
+    }else{
+        if (cb.preempted)
+            C.slice *= 2;
+        if (!S.P.quiet && C.props.size() > 0)
+            WriteLn "  \a/cluster %_: %_ properties, bug-free depth %_ after %.2f s (run %_)\a/", C.num, C.props.size(), C.bf_depth, realTime() - T0, C.n_runs;
+    }
+
+    for (uint i = 0; i < C.props.size(); i++)
+        newMax(S.bf_depth[C.props[i]], C.bf_depth);
+
+    if (C.props.size() == 0)
+        C.M.clear();            // -- release memory of resolved cluster
+    S.release();
+}
+
+
+static
+void schedWorker(PropSched_Shared& S)
+{
+    S.acquire();
+    for(;;){
+        while (S.q_head == S.queue.size() && S.n_running > 0 && !S.stop)
+            S.wait();
+        if (S.q_head == S.queue.size() || S.stop)
+            break;
+
+        PropSched_Cluster& C = *S.clusters[S.queue[S.q_head++]];
+        S.n_waiting = S.queue.size() - S.q_head;
+        S.n_running++;
+        S.release();
+
+        runCluster(S, C);
+
+        S.acquire();
+        S.n_running--;
+        if (realTime() >= S.deadline)
+            S.stop = true;
+        else if (C.props.size() > 0)
+            S.enqueue(C.num);
+        S.signal();
+    }
+    S.signal();
+    S.release();
+}
+
+
+#if defined(ZZ_PTHREADS)
+extern "C" void* propSchedThread(void* data);
+void* propSchedThread(void* data)
+{
+    schedWorker(*static_cast<PropSched_Shared*>(data));
+    return NULL;
+}
+#endif
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Main function:
+
+
+void propSched(NetlistRef N, const Vec<Wire>& props, const Params_PropSched& P, Vec<lbool>& status, Vec<int>& bug_free_depth, Vec<Cex>* cexs)
+{
+    if (!isPropSchedEngine(P.engine)){
+        ShoutLn "ERROR! Unknown engine for property scheduler: %_", P.engine;
+        exit(1); }
+
+    status.clear();
+    status.growTo(props.size(), l_Undef);
+    bug_free_depth.clear();
+    bug_free_depth.growTo(props.size(), -1);
+    if (cexs){
+        cexs->clear();
+        cexs->growTo(props.size()); }
+    if (props.size() == 0) return;
+
+    Vec<CCex> ccexs(cexs ? props.size() : 0);
+    PropSched_Shared S(N, props, P, status, bug_free_depth, cexs ? &ccexs : NULL);
+
+    // Cluster properties (on the main thread; 'N' is only read after this point):
+    Vec<Vec<uint> > cs;
+    uint n_clusters = (P.n_clusters != 0) ? P.n_clusters : (props.size() + 15) / 16;
+    clusterProperties(N, props, n_clusters, P.n_pivots, P.seq_depth, cs);
+
+    for (uint i = 0; i < cs.size(); i++){
+        S.clusters.push(new PropSched_Cluster);
+        PropSched_Cluster& C = *S.clusters.last();
+        C.num   = i;
+        C.slice = P.slice;
+        cs[i].copyTo(C.props);
+        S.enqueue(i);
+    }
+
+    uint n_threads = ZZ_If_Pthreads_Else(min_(P.n_threads, S.clusters.size()), 1);
+    if (!P.quiet){
+        WriteLn "Property scheduler:%_", ZZ_If_Pthreads_Else("", " NOTE! Compiled without pthreads; running clusters one at a time.");
+        WriteLn "  %_ properties in %_ clusters, engine '%_', %_ threads", props.size(), S.clusters.size(), P.engine, n_threads;
+    }
+
+    // Run clusters:
+  #if defined(ZZ_PTHREADS)
+    reserveNetlists(8 * n_threads + 16);   // -- engines create netlists of their own; avoid reallocation of global table
+
+    Vec<pthread_t> threads(n_threads);
+    for (uint i = 0; i < n_threads; i++){
+        if (pthread_create(&threads[i], NULL, propSchedThread, &S) != 0){
+            ShoutLn "ERROR! Could not create thread for property scheduler.";
+            exit(1); }
+    }
+    for (uint i = 0; i < n_threads; i++)
+        pthread_join(threads[i], NULL);
+
+    unreserveNetlists();
+  #else
+    schedWorker(S);
+  #endif
+
+    if (cexs){
+        for (uint i = 0; i < props.size(); i++)
+            if (status[i] == l_False)
+                translateCex(ccexs[i], N, (*cexs)[i]);
+    }
+
+    if (!P.quiet)
+        WriteLn "Proved: %_   Failed: %_   Undetermined: %_   \a/(%.2f s)\a/", S.n_proved, S.n_failed, props.size() - S.n_proved - S.n_failed, realTime() - S.T0;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,77 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : PropSched.hh
+//| Module      : Bip
+//| Description : Verify many properties by running clusters of them concurrently.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Properties are grouped by support ('clusterProperties()'). Each cluster gets its own netlist
+//| holding just the cone of influence of its properties, and clusters are verified one engine
+//| run at a time on a pool of threads. A run that uses up its time slice is allowed to continue
+//| as long as the engine's depth keeps increasing (or no other cluster is waiting); otherwise it
+//| is preempted and the cluster is requeued with a doubled slice. Results are written as soon
+//| as each property is resolved.
+//|
+//| Without 'ZZ_PTHREADS', clusters are run one at a time with the same policy.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Bip__PropSched_hh
+#define ZZ__Bip__PropSched_hh
+
+#include "ZZ_Netlist.hh"
+#include "ZZ_Bip.Common.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Parameters:
+
+
+struct Params_PropSched {
+    String  engine;         // Engine to run on each cluster: "pdr", "bmc" or "treb".
+    uint    n_threads;      // Number of clusters verified concurrently.
+    uint    n_clusters;     // Number of clusters to form ('0' = one per 16 properties).
+    uint    n_pivots;       // }- Support approximation, see 'clusterProperties()'.
+    uint    seq_depth;      // }
+    double  slice;          // Initial time slice (wall-clock seconds) of each cluster.
+    double  timeout;        // Wall-clock timeout for the whole run.
+    bool    quiet;          // Only write the per-property results.
+
+    Params_PropSched() :
+        engine("pdr"),
+        n_threads(4),
+        n_clusters(0),
+        n_pivots(256),
+        seq_depth(5),
+        slice(5.0),
+        timeout(DBL_MAX),
+        quiet(false)
+    {}
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Functions:
+
+
+bool isPropSchedEngine(const String& name);
+
+void propSched(NetlistRef              N,
+               const Vec<Wire>&        props,
+               const Params_PropSched& P,
+               Vec<lbool>&             status,
+               Vec<int>&               bug_free_depth,
+               Vec<Cex>*               cexs = NULL
+               );
+    // -- On return, 'status[i]' tells if 'props[i]' was proved ('l_True'), failed ('l_False') or
+    // is still unresolved ('l_Undef'). For failed properties, 'bug_free_depth[i]' is the depth of
+    // the failure minus one, otherwise the largest bug-free depth reached. If 'cexs' is given,
+    // '(*cexs)[i]' is a counterexample in 'N' ending at the failure of each failed 'props[i]'.
+    // Threads only read 'N'.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
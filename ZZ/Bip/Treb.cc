@@ -44,6 +44,7 @@ ZZ_PTimer_Add(treb_block_genNonInd);
 ZZ_PTimer_Add(treb_block_moveFwd);
 ZZ_PTimer_Add(treb_block_addCube);
 ZZ_PTimer_Add(treb_prop);
+ZZ_PTimer_Add(treb_import);
 ZZ_PTimer_Add(treb_coi);
 ZZ_PTimer_Add(treb_abs_refine);
 ZZ_PTimer_Add(treb_abc_refine);
@@ -142,6 +143,8 @@ class Treb {
     bool                refining;
     Vec<Cube>           rtrace;
 
+    Vec<GLit>           num2ff;     // Flop number -> flop of 'N' (for cubes received in PAR mode; built on demand).
+
   //________________________________________
   //  ABC interaction:
 
@@ -175,7 +178,8 @@ class Treb {
     void    dumpInvar();
 
     //  Cube Forward Propagation:
-    void    addBlockedCube(TCube s, bool subsumption = true);
+    void    addBlockedCube(TCube s, bool subsumption = true, bool send = true);
+    void    importCubes();
     bool    propagateBlockedCubes();
     void    semanticCoi(uint k0);
 
@@ -449,6 +453,9 @@ lbool Treb::recBlockCube(TCube s0, Cex* cex, uint* restartC)
     uint iter = 0;
 
     while (Q.size() > 0){
+        if (par && P.par_recv_cubes && !P.use_abstr)
+            importCubes();
+
         // Pop proof-obligation:
         ProofObl po = Q.pop();
         TCube    s  = po->tcube;
@@ -832,10 +839,10 @@ void Treb::dumpInvar()
 // -- Cube Forward Propagation:
 
 
-void Treb::addBlockedCube(TCube s, bool subsumption)
+void Treb::addBlockedCube(TCube s, bool subsumption, bool send)
 {
     //**/WriteLn "addBlockedCube(\a/%_\a/)", fmt(s);
-    if (par && P.par_send_cubes) sendMsg_UnreachCube(N, s);
+    if (par && P.par_send_cubes && send) sendMsg_UnreachCube(N, s);
 
     if (refining){
         //**/WriteLn "!!  rtrace learned: %_", s;
@@ -864,6 +871,55 @@ void Treb::addBlockedCube(TCube s, bool subsumption)
 }
 
 
+// Incorporate cubes blocked by other engines (received through the PAR interface). A cube is
+// only trusted as far as our own SAT solver can confirm it: it is re-derived relative to our
+// frames (which may be weaker or stronger than the sender's). Cubes already subsumed by our
+// frames are dropped without a SAT call.
+void Treb::importCubes()
+{
+    ZZ_PTimer_Scope(treb_import);
+
+    Msg msg;
+    while ((msg = pollMsg())){
+        if (msg.type != 104/*UCube*/) continue;
+
+        if (num2ff.size() == 0){
+            For_Gatetype(N, gate_Flop, w){
+                int num = attr_Flop(w).number;
+                if (num >= 0)
+                    num2ff(num, glit_NULL) = w; } }
+
+        uint      frame;
+        Vec<GLit> state;
+        unpack_UCube(msg.pkg, frame, state);
+
+        bool ok = (state.size() > 0);
+        for (uint i = 0; i < state.size(); i++){
+            GLit ff = num2ff(state[i].id, glit_NULL);
+            if (!ff){ ok = false; break; }
+            state[i] = ff ^ state[i].sign;
+        }
+        if (!ok) continue;
+
+        uint k = min_(frame, depth());
+        if (k == 0) continue;
+        TCube s(Cube(state), k);
+        if (Z->isInitial(s.cube)) continue;
+
+        // Lazy subsumption (syntactic only):
+        bool subsumed = false;
+        for (uint d = k; d < F.size() && !subsumed; d++)
+            for (uint i = 0; i < F[d].size(); i++)
+                if (subsumes(F[d][i], s.cube)){ subsumed = true; break; }
+        if (subsumed) continue;
+
+        TCube z = Z->solveRelative(s);
+        if (z)
+            addBlockedCube(z, true, false);     // -- don't echo the cube back
+    }
+}
+
+
 // Returns TRUE if invariant was found (some 'F[i]' is empty).
 bool Treb::propagateBlockedCubes()
 {
@@ -1901,6 +1957,7 @@ void addCli_Treb(CLI& cli)
     cli.add("sat"       , sat_types  , sat_default                  , "SAT-solver to use.");
     cli.add("send-invar", "bool"     , P.par_send_invar?"yes":"no"  , "Send invariant through PAR interface (only in PAR mode).");
     cli.add("send-cubes", "bool"     , P.par_send_cubes?"yes":"no"  , "Send blocked cubes during run (only in PAR mode).");
+    cli.add("recv-cubes", "bool"     , P.par_recv_cubes?"yes":"no"  , "Import cubes blocked by other engines (only in PAR mode).");
 }
 
 
@@ -1934,6 +1991,7 @@ void setParams(const CLI& cli, Params_Treb& P)
     P.save_invar    = cli.get("save-invar").string_val;
     P.par_send_invar= cli.get("send-invar").bool_val;
     P.par_send_cubes= cli.get("send-cubes").bool_val;
+    P.par_recv_cubes= cli.get("recv-cubes").bool_val;
 
     P.sat_solver = (cli.get("sat").enum_val == 0) ? sat_Zz :
                    (cli.get("sat").enum_val == 1) ? sat_Msc :
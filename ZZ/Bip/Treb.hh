@@ -60,6 +60,7 @@ struct Params_Treb {
     bool    par_send_result;    // If FALSE; CEX or unsat result is not reported in PAR mode.
     bool    par_send_invar;     // If TRUE, invariant is reported (as clauses) in PAR mode.
     bool    par_send_cubes;     // If TRUE, blocked cubes are reported (as cubes) in PAR mode.
+    bool    par_recv_cubes;     // If TRUE, cubes reported by other engines are imported in PAR mode.
 
     Params_Treb() :
         seed(0),
@@ -90,7 +91,8 @@ struct Params_Treb {
         quiet(false),
         par_send_result(true),
         par_send_invar(false),
-        par_send_cubes(false)
+        par_send_cubes(false),
+        par_recv_cubes(false)
     {}
 };
 
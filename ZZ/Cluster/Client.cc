@@ -13,9 +13,11 @@
 
 #include "Prelude.hh"
 #include "ZZ_Unix.hh"
-#include "ZZ_Md5.hh"
 #include "Cluster.hh"
 #include "Client.hh"
+#include "Protocol.hh"
+#include "EventLoop.hh"
+#include "ZZ/Generics/Map.hh"
 #include <errno.h>
 #include <syslog.h>
 
@@ -25,103 +27,38 @@ namespace ZZ {
 using namespace std;
 
 
-//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
-// ReqHeader:
-
-
-struct ReqHeader {
-    char  username[32];
-    uchar ssh_hash[16];     // 'fst' then 'snd' part of 'md5_hash' uint64s, both in little endian order.
-    uchar pkg_len[8];       // Little endian 64-bit number: length of package NOT including this header.
-    uchar pkg_tag[4];       // Little endian 32-bit number encoding 'ReqType'.
-};
-
-enum ReqType {
-    req_NULL,
-    req_Launch,
-    req_Pause,
-    req_Resume,
-    req_Kill,
-};
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Server->Client communication:
 
 
 static
-String username(const ReqHeader& req)
+bool cl_send(int fd, Array<cchar> pkg, ReqType type)
 {
-    String text;
-    for (uint i = 0; i < sizeof(req.username); i++){
-        if (req.username[i] == 0) break;
-        text.push(req.username[i]);
+    Vec<char> data;
+    putRequest(data, type, pkg);
+
+    uind pos = 0;
+    while (pos < data.size()){
+        ssize_t n = write(fd, data.base() + pos, data.size() - pos);
+        if (n < 0){
+            if (errno == EINTR) continue;
+            syslog(LOG_ERR, "'cl_send()' failed: fd=%d.", fd);
+            return false;
+        }
+        pos += n;
     }
-    return text;
-}
-
-
-static
-uint64 pkgLen(const ReqHeader& req)
-{
-    return (uint64)req.pkg_len[0] | ((uint64)req.pkg_len[1] << 8) | ((uint64)req.pkg_len[2] << 16) | ((uint64)req.pkg_len[3] << 24)
-         | ((uint64)req.pkg_len[4] << 32) | ((uint64)req.pkg_len[5] << 40) | ((uint64)req.pkg_len[6] << 48) | ((uint64)req.pkg_len[7] << 56);
+    return true;
 }
 
 
 static
-ReqType pkgTag(const ReqHeader& req)
-{
-    return ReqType((uint)req.pkg_tag[0] | ((uint)req.pkg_tag[1] << 8) | ((uint)req.pkg_tag[2] << 16) | ((uint)req.pkg_tag[3] << 24));
-}
-
-
-void makeRequest(ReqHeader& req, String user, uint64 len, uint tag)
+bool cl_sendId(int fd, uint64 job_id, ReqType type)
 {
-    for (uint i = 0; i < sizeof(req.username); i++)
-        req.username[i] = (i < user.size()) ? user[i] : 0;
-
-    Str text = readFile(homeDir(user) + "/.ssh/id_rsa");
-    if (!text)
-        memset(req.ssh_hash, 0, sizeof(req.ssh_hash));
-    else{
-        md5_hash h = md5(text);
-        for (uint i = 0; i < 8; i++)
-            req.ssh_hash[i] = h.fst >> (8 * i);
-        for (uint i = 0; i < 8; i++)
-            req.ssh_hash[8+i] = h.snd >> (8 * i);
-    }
-
+    char pkg[8];
     for (uint i = 0; i < 8; i++)
-        req.pkg_len[i] = len >> (8 * i);
-    for (uint i = 0; i < 4; i++)
-        req.pkg_tag[i] = tag >> (8 * i);
-}
+        pkg[i] = char(job_id >> (i * 8));
 
-
-static
-bool validateRequest(const ReqHeader& req)
-{
-    ReqHeader tmp;
-    makeRequest(tmp, username(req), 0, 0);
-    return memcmp(req.ssh_hash, tmp.ssh_hash, sizeof(req.ssh_hash)) == 0;
-}
-
-
-//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
-// Server->Client communication:
-
-
-static
-bool cl_send(int fd, const String& pkg, ReqType type)
-{
-    ReqHeader req;
-    makeRequest(req, userName(), pkg.size(), type);
-
-    ssize_t m = write(fd, &req, sizeof(req));
-    ssize_t n = write(fd, pkg.base(), pkg.size());
-
-    if (m != sizeof(req) || n != (ind)pkg.size()){
-        syslog(LOG_ERR, "'cl_send()' failed: fd=%d.", fd);
-        return false;
-    }else
-        return true;
+    return cl_send(fd, slice(pkg[0], pkg[8]), type);
 }
 
 
@@ -129,53 +66,41 @@ bool cl_launch(int fd, const Job& job)
 {
     String pkg;
     job.serialize(pkg);
-    return cl_send(fd, pkg, req_Launch);
+    return cl_send(fd, pkg.slice(), req_Launch);
 }
 
 
-bool cl_pause(int fd, uint64 job_id)
+bool cl_launchBatch(int fd, const Vec<Job>& jobs)
 {
     String pkg;
-    for (uint i = 0; i < 8; i++)
-        pkg.push(char(job_id >> (i * 8)));
-
-    return cl_send(fd, pkg, req_Pause);
+    putJobs(pkg, jobs);
+    return cl_send(fd, pkg.slice(), req_LaunchBatch);
 }
 
-bool cl_resume(int fd, uint64 job_id)
-{
-    String pkg;
-    for (uint i = 0; i < 8; i++)
-        pkg.push(char(job_id >> (i * 8)));
 
-    return cl_send(fd, pkg, req_Resume);
-}
-
-
-bool cl_kill(int fd, uint64 job_id)
-{
-    String pkg;
-    for (uint i = 0; i < 8; i++)
-        pkg.push(char(job_id >> (i * 8)));
-
-    return cl_send(fd, pkg, req_Kill);
-}
+bool cl_pause (int fd, uint64 job_id) { return cl_sendId(fd, job_id, req_Pause ); }
+bool cl_resume(int fd, uint64 job_id) { return cl_sendId(fd, job_id, req_Resume); }
+bool cl_kill  (int fd, uint64 job_id) { return cl_sendId(fd, job_id, req_Kill  ); }
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
-// Launch job:
+// Drone state:
 
 
-static
-void sendMsg(const ClMsg& msg, int server_fd)
-{
-    ssize_t n = write(server_fd, &msg, sizeof(msg));
-    if (n != sizeof(msg))
-        syslog(LOG_ERR, "Could not send reply to server: server_fd=%d.", server_fd);
-}
+struct Drone {
+    Conn             server;
+    Map<int,uint64>  job_of;        // -- PID -> job ID (for running jobs)
+    Map<uint64,int>  pid_of;        // -- job ID -> PID
+    Vec<ClMsg>       replies;       // -- sent as one frame at the end of each event loop round
 
+    void launch(const String& username, const Job& job);
+    void signalJob(uint64 job_id, int signum);
+    void reapChildren();
+    void receive();
+};
 
-void launchJob(const String& username, const Job& job, int server_fd)
+
+void Drone::launch(const String& username, const Job& job)
 {
     ProcMode mode;
     if (username != "" && username != userName())
@@ -193,177 +118,169 @@ void launchJob(const String& username, const Job& job, int server_fd)
     char ret = startProcess(job.exec, job.args, child_pid, child_io, job.env, mode);
 
     if (ret != 0)
-        sendMsg(ClMsg(clmsg_LaunchFailed, job.id, ret), server_fd);
-    else
-        sendMsg(ClMsg(clmsg_LaunchSucceeded, job.id), server_fd);
+        replies.push(ClMsg(clmsg_LaunchFailed, job.id, ret));
+    else{
+        job_of.set(child_pid, job.id);
+        pid_of.set(job.id, child_pid);
+        replies.push(ClMsg(clmsg_LaunchSucceeded, job.id));
+    }
 }
 
 
-//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+void Drone::signalJob(uint64 job_id, int signum)
+{
+    int pid;
+    if (pid_of.peek(job_id, pid))
+        kill(-pid, signum);     // -- job is head of its own process group
+}
 
 
-static
-void removePrefix(Vec<char>& v, uind len)
+void Drone::reapChildren()
 {
-    for (uind i = len; i < v.size(); i++)
-        v[i-len] = v[i];
-    v.shrinkTo(v.size() - len);
+    int   status;
+    pid_t pid;
+    while ((pid = waitpid(-1, &status, WNOHANG)) > 0){
+        uint64 id;
+        if (job_of.peek(pid, id)){
+            replies.push(ClMsg(clmsg_JobFinished, id, (uint)status));
+            job_of.exclude(pid);
+            pid_of.exclude(id);
+        }
+    }
 }
 
 
-void receivePackage(Vec<char>& pkg, int server_fd)
+// Handle all complete requests in the input buffer. Throws 'Excp_Msg' on garbage (the connection
+// should then be closed; there is no way to resynchronize).
+void Drone::receive()
 {
-    for(;;){
-        if (pkg.size() < sizeof(ReqHeader))
-            return;
-        const ReqHeader& req = *reinterpret_cast<const ReqHeader*>(pkg.base());
-
-        if (!validateRequest(req)){
-            syslog(LOG_ALERT, "Spurious request data received.");
-            pkg.clear();
-            return; }
-
-        // Get package size:
-        uint64 len = pkgLen(req);
-        if (len > 1000000){   // -- request packets shouldn't be this big
-            syslog(LOG_ALERT, "Spurious request header received.");
-            pkg.clear();
-            return; }
-
-        if (pkg.size() >= sizeof(ReqHeader) + len){
-            // Received a complete package:
-            In in(pkg.slice(sizeof(ReqHeader)));
-
-            switch (pkgTag(req)){
-            case req_Launch: {
+    ReqHeader    req;
+    Array<cchar> pkg;
+    while (server.getRequest(req, pkg)){
+        if (!validateRequest(req))
+            throw Excp_Msg("Spurious request data received.");
+
+        try{
+            In in(pkg.base(), pkg.size());
+            uint64 id = 0;
+            ReqType tag = reqTag(req);
+            if (tag == req_Pause || tag == req_Resume || tag == req_Kill){
+                if (pkg.size() != 8) throw Excp_EOF();
+                for (uint i = 0; i < 8; i++)
+                    id |= uint64((uchar)pkg[i]) << (8 * i);
+            }
+
+            switch (tag){
+            case req_Launch:{
                 Job job;
                 job.deserialize(in);
-                launchJob(username(req), job, server_fd);
-                removePrefix(pkg, sizeof(ReqHeader) + len);
-                break;}
-
-            case req_Pause:{
-
+                launch(reqUser(req), job);
                 break; }
 
-            case req_Kill:{
+            case req_LaunchBatch:{
+                Vec<Job> jobs;
+                getJobs(in, jobs);
+                String user = reqUser(req);
+                for (uint i = 0; i < jobs.size(); i++)
+                    launch(user, jobs[i]);
                 break; }
 
+            case req_Pause : signalJob(id, SIGSTOP); break;
+            case req_Resume: signalJob(id, SIGCONT); break;
+            case req_Kill  : signalJob(id, SIGKILL); break;
+
             default:
-                syslog(LOG_CRIT, "Spurious request tag received: %d  [aborting]", (int)pkgTag(req));
-                exit(1);
+                throw Excp_Msg("Spurious request tag received.");
             }
-
-        }else
-            return;
+        }catch (Excp_EOF){
+            throw Excp_Msg("Truncated request package.");
+        }
     }
 }
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Main loop:
 
 
-static pid_t child_pid[1024];
-static int   child_stat[1024];
-static uint  child_sz;
-
-ZZ_Initializer(child, 0){ child_sz = 0; }
-
-
-static void SIGCHLD_signalHandler(int signum)
-{
-    child_pid[child_sz] = wait(&child_stat[child_sz]);
-    child_sz++;
-}
+enum { tag_Listen, tag_Server };
 
 
 void clientLoop(int port)
 {
     int sock_fd = setupSocket(port);
+    setNonBlocking(sock_fd);
 
-    signal(SIGCHLD, SIGCHLD_signalHandler);     // -- setup empty signal handler to make 'select()' abort on child process termination.
+    EventLoop loop;
+    loop.watch(sock_fd, tag_Listen);
+    loop.catchSignal(SIGCHLD);
+    loop.setTimer(PROBE_INTERVAL);
 
     syslog(LOG_INFO, "CL-client started.");
 
-    Vec<char> pkg;
-    int server_fd = -1;
+    Drone   D;
+    Conn&   server = D.server;
+    Vec<Ev> evs;
     for(;;){
-        // Listen for event:
-        fd_set fds;
-        FD_ZERO(&fds);
-        FD_SET(sock_fd, &fds);
-        if (server_fd != -1)
-            FD_SET(server_fd, &fds);
-
-        int n;
-        if (child_sz > 0){
-            n = -1;
-        }else{
-            struct timeval timeout;
-            timeout.tv_sec = (uint)PROBE_INTERVAL;
-            timeout.tv_usec = (PROBE_INTERVAL - (uint)PROBE_INTERVAL) * 1000000;
-            n = select(FD_SETSIZE, &fds, NULL, NULL, &timeout);
-            // <<== replace by top process?
-        }
-
-        // React to event:
-        if (n == -1){
-            // Child process terminated:
-            while (child_sz > 0){
-                child_sz--;
-                // <<== report to server
-                //WriteLn "Child died:  pid=%_  status=%_", child_pid[child_sz], child_stat[child_sz];
-            }
-
-        }else if (n == 0){
-            // Heartbeat:
-
-        }else{
-            if (FD_ISSET(sock_fd, &fds)){
-                // New connection:
-                int fd = acceptConnection(sock_fd);
-                syslog(LOG_NOTICE, "New server connection: fd=%d", fd);
-                pkg.clear();
+        loop.wait(evs);
+
+        for (uint i = 0; i < evs.size(); i++){
+            const Ev& ev = evs[i];
+
+            if (ev.type == ev_Signal){
+                // Child process terminated:
+                D.reapChildren();
+
+            }else if (ev.type == ev_Timer){
+                // Heartbeat:
+                D.reapChildren();   // -- (SIGCHLD may be lost for children started in between)
+                // <<== replace by top process?
+
+            }else if (ev.tag == tag_Listen){
+                // New connection (the latest one wins):
+                int fd;
+                while ((fd = acceptNonBlocking(sock_fd)) != -1){
+                    syslog(LOG_NOTICE, "New server connection: fd=%d", fd);
+                    if (server.fd != -1){
+                        syslog(LOG_NOTICE, "Closing old server connection: fd=%d", server.fd);
+                        server.close();
+                    }
+                    server.fd = fd;
+                    loop.watch(fd, tag_Server);
+                }
 
-                if (server_fd != -1){
-                    syslog(LOG_NOTICE, "Closing old server connection: fd=%d", server_fd);
-                    shutdown(server_fd, SHUT_RDWR);
-                    close(server_fd);
+            }else if (ev.tag == tag_Server && server.fd != -1){
+                // Incoming data on socket (or room for outgoing):
+                bool open = true;
+                if (ev.rd){
+                    open = server.fill();
+                    try{
+                        D.receive();
+                    }catch (const Excp_Msg& err){
+                        syslog(LOG_ALERT, "%s  [closing connection]", err.msg.c_str());
+                        open = false;
+                    }
                 }
+                if (open && ev.wr)
+                    open = server.flush();
 
-                server_fd = fd;
-                fcntl(fd, F_SETFL, O_NONBLOCK);
+                if (!open){
+                    syslog(LOG_NOTICE, "Server disconnected: fd=%d", server.fd);
+                    server.close();
+                }
             }
+        }
 
-            if (FD_ISSET(server_fd, &fds)){
-                // Incoming data on socket:
-                uint64 tot_size = 0;
-                char buf[4096];
-                for(;;){
-                    errno = 0;
-                    ssize_t size = read(server_fd, buf, sizeof(buf));
-                    if (size < 0){
-                        if (errno != EAGAIN)
-                            syslog(LOG_ERR, "Unexpected error while reading data from server: %s", strerror(errno));
-                        break;
-                    }else if (size == 0){
-                        if (tot_size == 0){
-                            // First read was empty; assume socket is closed:
-                            syslog(LOG_NOTICE, "Server disconnected: fd=%d", server_fd);
-                            shutdown(server_fd, SHUT_RDWR);
-                            close(server_fd);
-                            server_fd = -1;
-                        }
-                        break;
-                    }else{
-                        for (int i = 0; i < size; i++)
-                            pkg.push(buf[i]);
-                        tot_size += size;
-                    }
+        // Send status updates of this round:
+        if (D.replies.size() > 0){
+            if (server.fd != -1){
+                putMsgs(server.out, D.replies);
+                if (!server.flush()){
+                    syslog(LOG_ERR, "Could not send reply to server: fd=%d.", server.fd);
+                    server.close();
                 }
-
-                receivePackage(pkg, server_fd);     // -- will clear 'pkg' if complete
             }
+            D.replies.clear();
         }
     }
 }
@@ -32,6 +32,7 @@ void clientLoop(int port);   // -- will listen for connection from server on giv
 
 
 bool cl_launch(int fd, const Job& job);
+bool cl_launchBatch(int fd, const Vec<Job>& jobs);
 bool cl_pause (int fd, uint64 job_id);
 bool cl_resume(int fd, uint64 job_id);
 bool cl_kill  (int fd, uint64 job_id);
@@ -50,10 +51,11 @@ enum ClMsgType {
 };
 
 
+// Sent in batches; see 'Protocol.hh'.
 struct ClMsg {
     ClMsgType   type;       // -- message type
     uint64      id;         // -- job ID
-    uint64      data;       // -- extra data connected to this message (used by 'LaunchFailed')
+    uint64      data;       // -- extra data connected to this message ('LaunchFailed': error code, 'JobFinished': wait status)
 
     ClMsg() {}
     ClMsg(ClMsgType type_, uint64 id_, uint64 data_ = 0) : type(type_), id(id_), data(data_) {}
@@ -0,0 +1,154 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : EventLoop.cc
+//| Module      : Cluster
+//| Description : Edge-triggered 'epoll()' event loop with timer and signal events.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//|
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "EventLoop.hh"
+#include <errno.h>
+#include <sys/epoll.h>
+#include <sys/timerfd.h>
+#include <sys/signalfd.h>
+
+namespace ZZ {
+using namespace std;
+
+
+static const uint64 tag_Timer  = ~uint64(0);     // -- internal tags (users should not use these)
+static const uint64 tag_Signal = ~uint64(1);
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+EventLoop::EventLoop(uint max_events_) :
+    timer_fd(-1),
+    signal_fd(-1),
+    max_events(max_events_)
+{
+    ev_buf = xmalloc<char>(max_events * sizeof(struct epoll_event));
+    ep_fd = epoll_create1(EPOLL_CLOEXEC);
+    if (ep_fd < 0)
+        perror("Call to 'epoll_create1()'"),
+        exit(-1);
+    sigemptyset(&sig_mask);
+}
+
+
+EventLoop::~EventLoop()
+{
+    if (timer_fd  != -1) close(timer_fd);
+    if (signal_fd != -1) close(signal_fd);
+    close(ep_fd);
+    xfree((char*)ev_buf);
+}
+
+
+static
+void addFd(int ep_fd, int fd, uint64 tag, uint32_t flags)
+{
+    struct epoll_event ev;
+    ev.events   = flags;
+    ev.data.u64 = tag;
+    if (epoll_ctl(ep_fd, EPOLL_CTL_ADD, fd, &ev) < 0)
+        perror("Call to 'epoll_ctl()'"),
+        exit(-1);
+}
+
+
+void EventLoop::watch(int fd, uint64 tag)
+{
+    assert(tag != tag_Timer && tag != tag_Signal);
+    addFd(ep_fd, fd, tag, EPOLLIN | EPOLLOUT | EPOLLRDHUP | EPOLLET);
+}
+
+
+void EventLoop::unwatch(int fd)
+{
+    struct epoll_event ev;      // -- (must be non-NULL for kernels before 2.6.9)
+    epoll_ctl(ep_fd, EPOLL_CTL_DEL, fd, &ev);
+}
+
+
+void EventLoop::setTimer(double interval)
+{
+    if (timer_fd == -1){
+        timer_fd = timerfd_create(CLOCK_MONOTONIC, TFD_NONBLOCK | TFD_CLOEXEC);
+        if (timer_fd < 0)
+            perror("Call to 'timerfd_create()'"),
+            exit(-1);
+        addFd(ep_fd, timer_fd, tag_Timer, EPOLLIN);     // -- level-triggered; we read it every time
+    }
+
+    struct itimerspec spec;
+    spec.it_interval.tv_sec  = (time_t)interval;
+    spec.it_interval.tv_nsec = long((interval - (time_t)interval) * 1e9);
+    spec.it_value = spec.it_interval;
+    timerfd_settime(timer_fd, 0, &spec, NULL);
+}
+
+
+void EventLoop::catchSignal(int signum)
+{
+    sigaddset(&sig_mask, signum);
+    sigprocmask(SIG_BLOCK, &sig_mask, NULL);
+
+    bool first = (signal_fd == -1);
+    signal_fd = signalfd(signal_fd, &sig_mask, SFD_NONBLOCK | SFD_CLOEXEC);
+    if (signal_fd < 0)
+        perror("Call to 'signalfd()'"),
+        exit(-1);
+    if (first)
+        addFd(ep_fd, signal_fd, tag_Signal, EPOLLIN);
+}
+
+
+void EventLoop::wait(Vec<Ev>& events, double timeout)
+{
+    events.clear();
+
+    struct epoll_event* evs = (struct epoll_event*)ev_buf;
+    int timeout_ms = (timeout < 0) ? -1 : int(timeout * 1000 + 0.5);
+    int n;
+    do n = epoll_wait(ep_fd, evs, max_events, timeout_ms);
+    while (n < 0 && errno == EINTR);
+    if (n < 0)
+        perror("Call to 'epoll_wait()'"),
+        exit(-1);
+
+    for (int i = 0; i < n; i++){
+        uint64 tag = evs[i].data.u64;
+        if (tag == tag_Timer){
+            uint64 count;
+            if (read(timer_fd, &count, sizeof(count)) == sizeof(count)){
+                events.push(Ev(ev_Timer));
+                events.last().count = count;
+            }
+
+        }else if (tag == tag_Signal){
+            struct signalfd_siginfo info;
+            while (read(signal_fd, &info, sizeof(info)) == sizeof(info)){
+                events.push(Ev(ev_Signal));
+                events.last().signum = info.ssi_signo;
+            }
+
+        }else{
+            uint32_t flags = evs[i].events;
+            events.push(Ev(ev_Fd));
+            Ev& ev = events.last();
+            ev.tag = tag;
+            ev.rd  = flags & (EPOLLIN | EPOLLRDHUP | EPOLLHUP | EPOLLERR);
+            ev.wr  = flags & EPOLLOUT;
+            ev.hup = flags & (EPOLLRDHUP | EPOLLHUP | EPOLLERR);
+        }
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,85 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : EventLoop.hh
+//| Module      : Cluster
+//| Description : Edge-triggered 'epoll()' event loop with timer and signal events.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Replaces the 'select(FD_SETSIZE, ...)' loops of client and server. File descriptors are
+//| watched edge-triggered for both reading and writing, so a descriptor must be read (written)
+//| until 'EAGAIN' before it will be reported again. Periodic ticks come from a 'timerfd' and
+//| signals from a 'signalfd' (the signals are blocked for the process, so no signal handlers and
+//| no races with 'epoll_wait()'). Cost per wake-up is proportional to the number of events, not
+//| to the number of watched descriptors. Linux only.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Cluster__EventLoop_hh
+#define ZZ__Cluster__EventLoop_hh
+
+#include <signal.h>
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Events:
+
+
+enum EvType {
+    ev_Fd,          // -- watched file descriptor changed state
+    ev_Timer,       // -- periodic timer expired ('count' times since last reported)
+    ev_Signal,      // -- signal 'signum' was received
+};
+
+
+struct Ev {
+    EvType  type;
+    uint64  tag;        // -- 'ev_Fd': tag given to 'watch()'
+    bool    rd;         // -- 'ev_Fd': new data available (or EOF)
+    bool    wr;         // -- 'ev_Fd': output buffer has room again
+    bool    hup;        // -- 'ev_Fd': peer hung up or error (remaining data can still be read)
+    uint64  count;      // -- 'ev_Timer': number of expirations
+    int     signum;     // -- 'ev_Signal': signal number
+
+    Ev(EvType type_ = ev_Fd) : type(type_), tag(0), rd(false), wr(false), hup(false), count(0), signum(0) {}
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'EventLoop':
+
+
+class EventLoop : public NonCopyable {
+    int         ep_fd;
+    int         timer_fd;
+    int         signal_fd;
+    sigset_t    sig_mask;
+    uint        max_events;
+    void*       ev_buf;         // -- room for 'max_events' of 'struct epoll_event'
+
+public:
+    EventLoop(uint max_events = 1024);
+   ~EventLoop();
+        // -- 'max_events' is the maximum number of descriptor events returned by one 'wait()'.
+
+    void watch  (int fd, uint64 tag);
+    void unwatch(int fd);
+        // -- 'fd' should be non-blocking. Closing a descriptor unwatches it automatically.
+
+    void setTimer(double interval);
+        // -- Periodic timer ('interval' in seconds, 0 disarms it).
+
+    void catchSignal(int signum);
+        // -- Block 'signum' and report it as an event instead. NOTE! Child processes inherit blocked
+        // signals; 'startProcess()' resets the mask in the child.
+
+    void wait(Vec<Ev>& events, double timeout = -1);
+        // -- Wait for at least one event (or 'timeout' seconds; negative means forever). 'events'
+        // is cleared first.
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
@@ -4,6 +4,8 @@
 #include "Client.hh"
 #include "ZZ_Unix.hh"
 #include "TopMonitor.hh"
+#include "Protocol.hh"
+#include "EventLoop.hh"
 
 using namespace ZZ;
 
@@ -109,19 +111,31 @@ Kopiera 'top' till 'cluster-top' och skapa ~/.cluster-toprc
 void send(const Job& job)
 {
     int fd = connectToSocket((char*)"localhost", 0xF00D);
-    if (fd < 0){
+    if (fd == -1){
         WriteLn "Could not connect to client.";
         exit(1);
     }
 
     cl_launch(fd, job);
 
-    ClMsg msg;
-    ssize_t n = read(fd, &msg, sizeof(msg));
-    if (n == sizeof(msg))
-        WriteLn "Reply:  type=%_  id=%_  data=%C", (uint)msg.type, msg.id, (char)msg.data;
+    setNonBlocking(fd);
+    EventLoop loop;
+    loop.watch(fd, 0);
+
+    Conn       conn(fd);
+    Vec<ClMsg> msgs;
+    Vec<Ev>    evs;
+    bool       open = true;
+    while (open && msgs.size() == 0){
+        loop.wait(evs);
+        open = conn.fill();
+        conn.getMsgs(msgs);
+    }
+
+    if (msgs.size() > 0)
+        WriteLn "Reply:  type=%_  id=%_  data=%C", (uint)msgs[0].type, msgs[0].id, (char)msgs[0].data;
     else
-        WriteLn "Failed to read %_ bytes (got %_)", sizeof(msg), n;
+        WriteLn "Connection closed without reply.";
 }
 
 
@@ -0,0 +1,261 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Main_cl_bench.cc
+//| Module      : Cluster
+//| Description : Stress test of the server: thousands of simulated drones over loopback.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Forks a real server ('serverLoop()') whose configuration lists the same loopback socket once
+//| per drone. This process plays all the drones (every job "finishes" as soon as it is launched)
+//| and the user submitting the jobs, and measures the end-to-end job throughput. Optionally, some
+//| drones disconnect when given their first jobs, and some jobs are submitted on hold and then
+//| killed, to exercise rescheduling and job control.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "ZZ_CmdLine.hh"
+#include "ZZ_Unix.hh"
+#include "Cluster.hh"
+#include "Client.hh"
+#include "Server.hh"
+#include "Protocol.hh"
+#include "EventLoop.hh"
+#include <errno.h>
+#include <sys/resource.h>
+
+using namespace ZZ;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+// Like 'setupSocket()' but loopback only and with a backlog big enough for all drones.
+static
+int listenLoopback(uint port, uint backlog)
+{
+    int sock_fd = socket(PF_INET, SOCK_STREAM, 0);
+    if (sock_fd < 0)
+        perror("Call to 'socket()'"),
+        exit(-1);
+
+    int value = 1;
+    setsockopt(sock_fd, SOL_SOCKET, SO_REUSEADDR, &value, sizeof(value));
+
+    struct sockaddr_in addr;
+    memset(&addr, 0, sizeof(addr));
+    addr.sin_family      = AF_INET;
+    addr.sin_addr.s_addr = htonl(INADDR_LOOPBACK);
+    addr.sin_port        = htons(port);
+
+    if (bind(sock_fd, (struct sockaddr*)&addr, sizeof(addr)) < 0)
+        perror("Call to 'bind()'"),
+        exit(-1);
+    if (listen(sock_fd, backlog) < 0)
+        perror("Call to 'listen()'"),
+        exit(-1);
+
+    setNonBlocking(sock_fd);
+    return sock_fd;
+}
+
+
+static
+void makeJob(Job& job, uint64 id)
+{
+    job.id   = id;
+    job.exec = "/usr/bin/true";
+    job.args.push("-v");
+    job.args.push("design.aig");
+    job.dir  = "/tmp";
+    job.env.push("PATH=/usr/bin:/bin");
+    job.cpu  = 60;
+    job.stdout = "result.out";
+}
+
+
+enum { tag_Listen = 1, tag_User = 2 };      // -- drone 'i' has tag 'i + 16'
+
+
+int main(int argc, char** argv)
+{
+    ZZ_Init;
+
+    cli.add("drones", "uint", "2000"  , "Number of simulated drones.");
+    cli.add("jobs"  , "uint", "100000", "Number of jobs to submit.");
+    cli.add("batch" , "uint", "1000"  , "Jobs per submission request.");
+    cli.add("slots" , "uint", "4"     , "Concurrent jobs per drone.");
+    cli.add("port"  , "uint", "61460" , "Drones listen on this port, the server on the next.");
+    cli.add("lose"  , "uint", "0"     , "Number of drones that disconnect when given their first jobs.");
+    cli.add("hold"  , "uint", "0"     , "Number of jobs submitted on hold (priority 0) and then killed.");
+    cli.parseCmdLine(argc, argv);
+    uint n_drones = cli.get("drones").int_val;
+    uint n_jobs   = cli.get("jobs").int_val;
+    uint batch    = max_(1u, (uint)cli.get("batch").int_val);
+    uint slots    = cli.get("slots").int_val;
+    uint port     = cli.get("port").int_val;
+    uint n_lose   = cli.get("lose").int_val;
+    uint n_hold   = min_(n_jobs, (uint)cli.get("hold").int_val);
+    if (n_lose >= n_drones){
+        ShoutLn "Must keep at least one drone.";
+        exit(1); }
+
+    // Need two descriptors per drone (one in each process):
+    struct rlimit lim;
+    getrlimit(RLIMIT_NOFILE, &lim);
+    lim.rlim_cur = lim.rlim_max;
+    setrlimit(RLIMIT_NOFILE, &lim);
+    if (lim.rlim_cur < n_drones + 64){
+        ShoutLn "Too many drones for file descriptor limit (%_).", (uint64)lim.rlim_cur;
+        exit(1); }
+
+    // Setup drones and server:
+    int drone_sock = listenLoopback(port, n_drones);
+
+    String conf;
+    FWrite(conf) "/tmp/cl_bench.%_.conf", getpid();
+    {
+        OutFile out(conf);
+        for (uint i = 0; i < n_drones; i++)
+            FWriteLn(out) "127.0.0.1:%_", port;
+    }
+
+    double T0 = realTime();
+    pid_t server_pid = fork();
+    if (server_pid == 0){
+        close(drone_sock);
+        Vec<int> fds;
+        connectToDrones(conf, fds);
+        serverLoop(port + 1, fds, slots);
+        _exit(0);
+    }
+
+    EventLoop  loop(4096);
+    Vec<Conn*> drones;
+    Vec<Ev>    evs;
+    loop.watch(drone_sock, tag_Listen);
+    while (drones.size() < n_drones){
+        loop.wait(evs, 10);
+        if (evs.size() == 0){
+            ShoutLn "Server did not connect to all drones (%_ of %_).", drones.size(), n_drones;
+            kill(server_pid, SIGKILL);
+            exit(1); }
+
+        int fd;
+        while ((fd = acceptNonBlocking(drone_sock)) != -1){
+            loop.watch(fd, drones.size() + 16);
+            drones.push(new Conn(fd));
+        }
+    }
+    double T_connect = realTime() - T0;
+
+    // Connect as user (server starts listening after contacting the drones):
+    int user_fd = -1;
+    for (uint i = 0; i < 1000 && user_fd == -1; i++){
+        user_fd = connectToSocket((char*)"127.0.0.1", port + 1);
+        if (user_fd == -1) usleep(10000);
+    }
+    if (user_fd == -1){
+        ShoutLn "Could not connect to server.";
+        kill(server_pid, SIGKILL);
+        exit(1); }
+
+    // Submit jobs:
+    T0 = realTime();
+    Vec<Job> jobs;
+    for (uint i = 0; i < n_jobs; i += batch){
+        jobs.clear();
+        for (uint j = i; j < min_(n_jobs, i + batch); j++){
+            jobs.push();
+            makeJob(jobs.last(), j);
+            if (j < n_hold)
+                jobs.last().prio = 0;
+        }
+        cl_launchBatch(user_fd, jobs);
+    }
+    for (uint j = 0; j < n_hold; j++)
+        cl_kill(user_fd, j);
+    double T_submit = realTime() - T0;
+
+    setNonBlocking(user_fd);
+    Conn user(user_fd);
+    loop.watch(user_fd, tag_User);
+
+    // Run drones until all jobs have been reported back:
+    uint64     n_finished = 0, n_launched = 0, n_failed = 0, n_killed = 0, n_batches = 0, n_frames = 0;
+    Vec<ClMsg> replies;
+    Vec<ClMsg> msgs;
+    while (n_finished + n_failed + n_killed < n_jobs){
+        loop.wait(evs, 30);
+        if (evs.size() == 0){
+            ShoutLn "Stalled after %_ of %_ jobs.", n_finished, n_jobs;
+            kill(server_pid, SIGKILL);
+            exit(1); }
+
+        for (uint i = 0; i < evs.size(); i++){
+            const Ev& ev = evs[i];
+            if (ev.type != ev_Fd) continue;
+
+            if (ev.tag == tag_User){
+                if (!ev.rd) continue;
+                user.fill();
+                msgs.clear();
+                while (user.getMsgs(msgs)) n_frames++;
+                for (uint j = 0; j < msgs.size(); j++){
+                    if      (msgs[j].type == clmsg_JobFinished && msgs[j].data == SIGKILL) n_killed++;
+                    else if (msgs[j].type == clmsg_JobFinished)     n_finished++;
+                    else if (msgs[j].type == clmsg_LaunchSucceeded) n_launched++;
+                    else if (msgs[j].type == clmsg_LaunchFailed)    n_failed++;
+                }
+
+            }else if (ev.tag >= 16){
+                uint  d = ev.tag - 16;
+                Conn& D = *drones[d];
+                if (D.fd == -1) continue;
+                if (d < n_lose && ev.rd){
+                    D.close();      // -- (without looking at the jobs)
+                    continue; }
+                if (!ev.rd){
+                    D.flush();
+                    continue; }
+                D.fill();
+
+                ReqHeader    req;
+                Array<cchar> pkg;
+                replies.clear();
+                while (D.getRequest(req, pkg)){
+                    In in(pkg.base(), pkg.size());
+                    jobs.clear();
+                    getJobs(in, jobs);
+                    n_batches++;
+                    for (uint j = 0; j < jobs.size(); j++){
+                        replies.push(ClMsg(clmsg_LaunchSucceeded, jobs[j].id));
+                        replies.push(ClMsg(clmsg_JobFinished, jobs[j].id, 0));
+                    }
+                }
+                putMsgs(D.out, replies);
+                D.flush();
+            }
+        }
+    }
+    double T_run = realTime() - T0;
+
+    kill(server_pid, SIGKILL);
+    waitpid(server_pid, NULL, 0);
+    struct rusage usage;
+    getrusage(RUSAGE_CHILDREN, &usage);
+    double T_server = usage.ru_utime.tv_sec + usage.ru_utime.tv_usec * 1e-6 + usage.ru_stime.tv_sec + usage.ru_stime.tv_usec * 1e-6;
+    unlink(conf.c_str());
+
+    WriteLn "Drones         : %_  (%_ slots each, connected in %t)", n_drones, slots, T_connect;
+    WriteLn "Jobs           : %_  (%_ finished, %_ failed, %_ killed)", n_jobs, n_finished, n_failed, n_killed;
+    if (n_lose > 0)
+        WriteLn "Lost drones    : %_  (%_ launches reported)", n_lose, n_launched;
+    WriteLn "Launch batches : %_  (%.1f jobs each)", n_batches, double(n_jobs) / max_(n_batches, (uint64)1);
+    WriteLn "Status frames  : %_  (%.1f messages each)", n_frames, double(n_finished + n_launched + n_failed) / max_(n_frames, (uint64)1);
+    WriteLn "Submit time    : %t", T_submit;
+    WriteLn "Total time     : %t", T_run;
+    WriteLn "Server CPU     : %t  (%.2f us/job)", T_server, T_server / n_jobs * 1e6;
+    WriteLn "Throughput     : %,d jobs/min", uint64(n_jobs / T_run * 60);
+
+    return 0;
+}
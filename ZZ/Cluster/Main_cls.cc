@@ -36,6 +36,7 @@ int main(int argc, char** argv)
     ZZ_Init;
 
     cli.add("port", "uint", "61454", "Server port.");
+    cli.add("slots", "uint", "1", "Number of jobs to run concurrently on each drone.");
     cli.add("restart", "bool", "no", "First kill existing server, if any.");
     cli.add("conf", "string", "/etc/cls.conf", "Location of configuration file.");
     cli.add("kill", "bool", "no", "Kill existing server without starting a new one.");
@@ -67,7 +68,7 @@ int main(int argc, char** argv)
     connectToDrones(cli.get("conf").string_val, drone_fds);
 
     //int ret ___unused = daemon(1, 1);
-    //serverLoop(cli.get("port").int_val);
+    serverLoop(cli.get("port").int_val, drone_fds, cli.get("slots").int_val);
 
     return 0;
 }
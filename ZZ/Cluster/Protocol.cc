@@ -0,0 +1,295 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Protocol.cc
+//| Module      : Cluster
+//| Description : Binary wire protocol between users, server and clients (drones).
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//|
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "ZZ_Unix.hh"
+#include "ZZ_Md5.hh"
+#include "Protocol.hh"
+#include <errno.h>
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Requests:
+
+
+String reqUser(const ReqHeader& req)
+{
+    String text;
+    for (uint i = 0; i < sizeof(req.username); i++){
+        if (req.username[i] == 0) break;
+        text.push(req.username[i]);
+    }
+    return text;
+}
+
+
+uint64 reqLen(const ReqHeader& req)
+{
+    return (uint64)req.pkg_len[0] | ((uint64)req.pkg_len[1] << 8) | ((uint64)req.pkg_len[2] << 16) | ((uint64)req.pkg_len[3] << 24)
+         | ((uint64)req.pkg_len[4] << 32) | ((uint64)req.pkg_len[5] << 40) | ((uint64)req.pkg_len[6] << 48) | ((uint64)req.pkg_len[7] << 56);
+}
+
+
+ReqType reqTag(const ReqHeader& req)
+{
+    return ReqType((uint)req.pkg_tag[0] | ((uint)req.pkg_tag[1] << 8) | ((uint)req.pkg_tag[2] << 16) | ((uint)req.pkg_tag[3] << 24));
+}
+
+
+// Reading and hashing the key file for every request is far too slow for thousands of jobs per
+// minute, so hashes are cached (there are only a handful of users).
+static
+void sshHash(String user, uchar hash[16])
+{
+    static Vec<Pair<String,md5_hash> > cache;
+    for (uint i = 0; i < cache.size(); i++){
+        if (cache[i].fst == user){
+            for (uint j = 0; j < 8; j++) hash[j]   = cache[i].snd.fst >> (8 * j);
+            for (uint j = 0; j < 8; j++) hash[8+j] = cache[i].snd.snd >> (8 * j);
+            return;
+        }
+    }
+
+    Str text = readFile(homeDir(user) + "/.ssh/id_rsa");
+    if (!text){
+        memset(hash, 0, 16);        // -- not cached; the key may appear later
+        return; }
+
+    cache.push(make_tuple(user, md5(text)));
+    dispose(text);
+    sshHash(user, hash);
+}
+
+
+void makeRequest(ReqHeader& req, String user, uint64 len, uint tag)
+{
+    for (uint i = 0; i < sizeof(req.username); i++)
+        req.username[i] = (i < user.size()) ? user[i] : 0;
+
+    sshHash(user, req.ssh_hash);
+
+    for (uint i = 0; i < 8; i++)
+        req.pkg_len[i] = len >> (8 * i);
+    for (uint i = 0; i < 4; i++)
+        req.pkg_tag[i] = tag >> (8 * i);
+}
+
+
+bool validateRequest(const ReqHeader& req)
+{
+    uchar hash[16];
+    sshHash(reqUser(req), hash);
+    return memcmp(req.ssh_hash, hash, sizeof(hash)) == 0;
+}
+
+
+void putRequest(Vec<char>& out, ReqType type, Array<cchar> pkg)
+{
+    static String user = userName();
+
+    ReqHeader req;
+    makeRequest(req, user, pkg.size(), type);
+
+    uind sz = out.size();
+    out.growTo(sz + sizeof(req) + pkg.size());
+    memcpy(&out[sz], &req, sizeof(req));
+    if (pkg.size() > 0)
+        memcpy(&out[sz + sizeof(req)], pkg.base(), pkg.size());
+}
+
+
+void putJobs(Out& pkg, const Vec<Job>& jobs)
+{
+    putu(pkg, jobs.size());
+    for (uint i = 0; i < jobs.size(); i++)
+        jobs[i].serialize(pkg);
+}
+
+
+void getJobs(In& pkg, Vec<Job>& jobs)
+{
+    uint64 n = getu(pkg);
+    for (uint64 i = 0; i < n; i++){
+        jobs.push();
+        jobs.last().deserialize(pkg);
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Status messages:
+
+
+void putMsgs(Vec<char>& out, const Vec<ClMsg>& msgs)
+{
+    if (msgs.size() == 0) return;
+
+    Out pkg;
+    putu(pkg, msgs.size());
+    for (uint i = 0; i < msgs.size(); i++){
+        putu(pkg, msgs[i].type);
+        putu(pkg, msgs[i].id);
+        putu(pkg, msgs[i].data);
+    }
+
+    uint len = pkg.vec().size();
+    for (uint i = 0; i < 4; i++)
+        out.push(char(len >> (8 * i)));
+    append(out, pkg.vec());
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'Conn':
+
+
+void Conn::close()
+{
+    if (fd != -1){
+        shutdown(fd, SHUT_RDWR);
+        ::close(fd);
+        fd = -1;
+    }
+    in.clear(true);
+    out.clear(true);
+    in_pos = out_pos = 0;
+}
+
+
+bool Conn::fill()
+{
+    // Drop consumed data (only when it is at least half the buffer, to keep it amortized O(1)):
+    if (in_pos == in.size()){
+        in.clear();
+        in_pos = 0;
+    }else if (in_pos > 0 && in_pos >= in.size() / 2){
+        memmove(in.base(), in.base() + in_pos, in.size() - in_pos);
+        in.shrinkTo(in.size() - in_pos);
+        in_pos = 0;
+    }
+
+    for(;;){
+        uind sz = in.size();
+        in.growTo(sz + 65536);
+        ssize_t n = read(fd, in.base() + sz, 65536);
+        in.shrinkTo(sz + (n > 0 ? n : 0));
+
+        if (n > 0)
+            continue;
+        else if (n == 0)
+            return false;
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return true;
+        else if (errno != EINTR)
+            return false;
+    }
+}
+
+
+bool Conn::flush()
+{
+    while (out_pos < out.size()){
+        ssize_t n = write(fd, out.base() + out_pos, out.size() - out_pos);
+        if (n >= 0)
+            out_pos += n;
+        else if (errno == EAGAIN || errno == EWOULDBLOCK)
+            return true;
+        else if (errno != EINTR)
+            return false;
+    }
+    out.clear();
+    out_pos = 0;
+    return true;
+}
+
+
+void Conn::consume(uind n)
+{
+    assert(in_pos + n <= in.size());
+    in_pos += n;
+}
+
+
+bool Conn::getRequest(ReqHeader& req, Array<cchar>& pkg)
+{
+    Array<cchar> data = avail();
+    if (data.size() < sizeof(ReqHeader))
+        return false;
+    memcpy(&req, data.base(), sizeof(req));
+
+    uint64 len = reqLen(req);
+    if (len > max_pkg_len)
+        throw Excp_Msg("Request package too big.");
+    if (data.size() < sizeof(ReqHeader) + len)
+        return false;
+
+    pkg = data.slice(sizeof(ReqHeader), sizeof(ReqHeader) + len);
+    consume(sizeof(ReqHeader) + len);
+    return true;
+}
+
+
+bool Conn::getMsgs(Vec<ClMsg>& msgs)
+{
+    Array<cchar> data = avail();
+    if (data.size() < 4)
+        return false;
+
+    uint len = (uint)(uchar)data[0] | ((uint)(uchar)data[1] << 8) | ((uint)(uchar)data[2] << 16) | ((uint)(uchar)data[3] << 24);
+    if (len > max_pkg_len)
+        throw Excp_Msg("Status frame too big.");
+    if (data.size() < 4 + len)
+        return false;
+
+    try{
+        In in(data.base() + 4, len);
+        uint64 n = getu(in);
+        for (uint64 i = 0; i < n; i++){
+            ClMsgType type = ClMsgType(getu(in));
+            uint64    id   = getu(in);
+            uint64    val  = getu(in);
+            msgs.push(ClMsg(type, id, val));
+        }
+    }catch (Excp_EOF){
+        throw Excp_Msg("Truncated status frame.");
+    }
+
+    consume(4 + len);
+    return true;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Sockets:
+
+
+void setNonBlocking(int fd)
+{
+    int flags = fcntl(fd, F_GETFL);
+    fcntl(fd, F_SETFL, flags | O_NONBLOCK);
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+}
+
+
+int acceptNonBlocking(int sock_fd)
+{
+    for(;;){
+        int fd = accept4(sock_fd, NULL, NULL, SOCK_NONBLOCK | SOCK_CLOEXEC);
+        if (fd >= 0 || errno != EINTR)
+            return fd;
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,129 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Protocol.hh
+//| Module      : Cluster
+//| Description : Binary wire protocol between users, server and clients (drones).
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Two kinds of length-prefixed frames travel over the sockets:
+//|
+//|   - Requests (user->server, server->client): a 'ReqHeader' (user name, hash of that user's
+//|     SSH key, package length and tag) followed by the package. 'req_LaunchBatch' carries any
+//|     number of jobs in one package.
+//|
+//|   - Status messages (client->server, server->user): a 4 byte little endian length followed
+//|     by a batch of 'ClMsg's (count, then type/id/data for each, as variable length integers).
+//|
+//| 'Conn' buffers a non-blocking socket for use with the edge-triggered 'EventLoop'.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Cluster__Protocol_hh
+#define ZZ__Cluster__Protocol_hh
+
+#include "Client.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Requests:
+
+
+struct ReqHeader {
+    char  username[32];
+    uchar ssh_hash[16];     // 'fst' then 'snd' part of 'md5_hash' uint64s, both in little endian order.
+    uchar pkg_len[8];       // Little endian 64-bit number: length of package NOT including this header.
+    uchar pkg_tag[4];       // Little endian 32-bit number encoding 'ReqType'.
+};
+
+enum ReqType {
+    req_NULL,
+    req_Launch,             // -- one serialized 'Job'
+    req_Pause,              // -- job ID (8 bytes, little endian)
+    req_Resume,             // -- ditto
+    req_Kill,               // -- ditto
+    req_LaunchBatch,        // -- number of jobs (as 'putu()'), then that many serialized 'Job's
+};
+
+static const uint64 max_pkg_len = 256 * 1024 * 1024;     // -- anything bigger is considered garbage
+
+
+String  reqUser(const ReqHeader& req);
+uint64  reqLen (const ReqHeader& req);
+ReqType reqTag (const ReqHeader& req);
+
+void makeRequest(ReqHeader& req, String user, uint64 len, uint tag);
+bool validateRequest(const ReqHeader& req);
+    // -- The SSH key hash of each user is read once and then cached by the process.
+
+void putRequest(Vec<char>& out, ReqType type, Array<cchar> pkg);
+void putJobs   (Out& pkg, const Vec<Job>& jobs);
+void getJobs   (In&  pkg, Vec<Job>& jobs);
+    // -- Append a request from the current user to 'out' / (de)serialize a 'req_LaunchBatch' package.
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Status messages:
+
+
+void putMsgs(Vec<char>& out, const Vec<ClMsg>& msgs);
+    // -- Append one frame holding all of 'msgs' (nothing if empty).
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'Conn':
+
+
+class Conn : public NonCopyable {
+    Vec<char>   in;
+    uind        in_pos;         // -- data before this position has been consumed
+    uind        out_pos;        // -- data before this position has been written
+
+public:
+    int         fd;
+    Vec<char>   out;            // -- append data here, then call 'flush()'
+
+    Conn(int fd_ = -1) : in_pos(0), out_pos(0), fd(fd_) {}
+   ~Conn() { close(); }
+
+    void close();
+        // -- Close socket (if open) and clear buffers.
+
+    bool fill();
+        // -- Read until 'EAGAIN'. Returns FALSE if the peer closed the connection or on error.
+
+    bool flush();
+        // -- Write as much of 'out' as the socket accepts. Returns FALSE on error.
+
+    bool pending() const { return out_pos < out.size(); }
+        // -- Is there unwritten output? ('flush()' again when the socket becomes writable).
+
+    Array<cchar> avail() const { return in.slice(in_pos); }
+    void consume(uind n);
+        // -- Unconsumed input and removal of a prefix of it (amortized constant time).
+
+    bool getRequest(ReqHeader& req, Array<cchar>& pkg);
+        // -- If a complete request is available, return it and consume it. 'pkg' stays valid
+        // until the next call to 'fill()'. Throws 'Excp_Msg' on garbage.
+
+    bool getMsgs(Vec<ClMsg>& msgs);
+        // -- If a complete status frame is available, append its messages and consume it.
+        // Throws 'Excp_Msg' on garbage.
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Sockets:
+
+
+int acceptNonBlocking(int sock_fd);
+    // -- Accept a connection on a non-blocking listening socket. Returns -1 if there is none. The
+    // new socket is non-blocking and close-on-exec.
+
+void setNonBlocking(int fd);
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
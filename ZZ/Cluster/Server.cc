@@ -15,6 +15,10 @@
 #include "ZZ_Unix.hh"
 #include "Cluster.hh"
 #include "Server.hh"
+#include "Protocol.hh"
+#include "EventLoop.hh"
+#include "ZZ/Generics/Map.hh"
+#include "ZZ/Generics/Heap.hh"
 #include <errno.h>
 #include <syslog.h>
 
@@ -72,109 +76,424 @@ void connectToDrones(String config_file, Vec<int>& out_fds)
     Vec<Pair<String,uint> > addrs;
     readConfig(config_file, addrs);
 
-    //WriteLn "%\r_", addrs;
+    for (uint i = 0; i < addrs.size(); i++){
+        int fd = connectToSocket((char*)addrs[i].fst.c_str(), addrs[i].snd);
+        if (fd == -1){
+            syslog(LOG_WARNING, "Could not connect to drone: %s:%u", addrs[i].fst.c_str(), addrs[i].snd);
+            continue; }
 
-    /*
-    try to connect
-    */
+        setNonBlocking(fd);
+        out_fds.push(fd);
+    }
+    syslog(LOG_INFO, "Connected to %u of %u drones.", out_fds.size(), addrs.size());
 }
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 
 
-#if 0
-void serverLoop(int port)
+// Jobs are queued on priority (then submission order) and handed out in batches to drones with
+// free slots. Drones with free slots are kept on a stack, so the cost of an event does not depend
+// on the number of drones. Jobs with priority 0 are held until resumed by the user. If a drone is
+// lost, its jobs are queued again (a job whose drones keep getting lost is eventually reported as
+// failed).
+//
+// <<== 'conc' and 'batch' are not yet respected
+
+
+static const uint max_attempts = 3;     // -- launches on lost drones before giving up on a job
+
+
+struct SrvJob {
+    Job*    job;        // -- kept until the job is finished (a lost drone means launching it again)
+    uint    user;       // -- index into 'users'
+    uint64  user_id;    // -- job ID as given by the user
+    uint    drone;      // -- UINT_MAX while queued
+    uint    attempts;   // -- number of launches
+    bool    held;       // -- paused while queued; not dispatched until resumed
+
+    SrvJob() : job(NULL), user(UINT_MAX), user_id(0), drone(UINT_MAX), attempts(0), held(false) {}
+};
+
+
+struct QueuedJob {
+    uint    prio;
+    uint64  id;
+    QueuedJob(uint prio_ = 0, uint64 id_ = 0) : prio(prio_), id(id_) {}
+};
+
+macro bool operator<(const QueuedJob& x, const QueuedJob& y) {
+    return x.prio > y.prio || (x.prio == y.prio && x.id < y.id); }
+
+
+struct SrvDrone {
+    Conn        conn;
+    Vec<uint64> jobs;       // -- jobs launched on this drone and not yet finished (at most 'slots')
+    bool        idle;       // -- is on the 'idle' stack
+    SrvDrone(int fd) : conn(fd), idle(false) {}
+};
+
+
+struct SrvUser {
+    Conn               conn;
+    Map<uint64,uint64> ids;         // -- user's job ID -> server's job ID (for pause/resume/kill)
+    Vec<ClMsg>         replies;     // -- sent as one frame at the end of each event loop round
+    SrvUser(int fd) : conn(fd) {}
+};
+
+
+class Server {
+    enum { tag_User = 1, tag_Listen = 2 };      // -- stored in bits 32 and up ('tag_Drone' is 0)
+
+    EventLoop           loop;
+    int                 sock_fd;
+    uint                slots;
+
+    Vec<SrvDrone*>      drones;
+    Vec<uint>           idle;           // -- drones with free slots
+    Vec<SrvUser*>       users;          // -- NULL when disconnected
+    Vec<uint>           dirty;          // -- users with pending replies
+
+    Map<uint64,SrvJob>  jobs;           // -- all unfinished jobs
+    KeyHeap<QueuedJob>  queue;          // -- may contain stale entries (dispatched, held or finished jobs)
+    uint64              next_id;
+
+    void markIdle(uint d) { if (!drones[d]->idle){ drones[d]->idle = true; idle.push(d); } }
+    SrvJob& job(uint64 id) { SrvJob* J = NULL; jobs.peek(id, J); assert(J); return *J; }
+    void enqueue(uint64 id);
+    void reply(uint64 id, const ClMsg& msg, bool last);
+    void finish(uint64 id);
+    void lostDrone(uint d);
+    void control(uint u, ReqType tag, uint64 user_id);
+
+    void acceptUsers();
+    void readUser (uint u);
+    void readDrone(uint d);
+    void dispatch();
+    void flushReplies();
+
+public:
+    Server(int port, const Vec<int>& drone_fds, uint slots);
+   ~Server();
+    void run();
+};
+
+
+Server::Server(int port, const Vec<int>& drone_fds, uint slots_) :
+    loop(4096),
+    slots(slots_),
+    next_id(1)
 {
-    int sock_fd = setupSocket(port);
+    sock_fd = setupSocket(port);
+    setNonBlocking(sock_fd);
+    loop.watch(sock_fd, uint64(tag_Listen) << 32);
 
-    signal(SIGCHLD, SIGCHLD_signalHandler);     // -- setup empty signal handler to make 'select()' abort on child process termination.
+    for (uint i = 0; i < drone_fds.size(); i++){
+        drones.push(new SrvDrone(drone_fds[i]));
+        loop.watch(drone_fds[i], i);
+        markIdle(i);
+    }
+}
 
-    syslog(LOG_INFO, "CL-client started.");
 
-    Vec<char> pkg;
-    int server_fd = -1;
-    for(;;){
-        // Listen for event:
-        fd_set fds;
-        FD_ZERO(&fds);
-        FD_SET(sock_fd, &fds);
-        if (server_fd != -1)
-            FD_SET(server_fd, &fds);
-
-        int n;
-        if (child_sz > 0){
-            n = -1;
-        }else{
-            struct timeval timeout;
-            timeout.tv_sec = (uint)PROBE_INTERVAL;
-            timeout.tv_usec = (PROBE_INTERVAL - (uint)PROBE_INTERVAL) * 1000000;
-            n = select(FD_SETSIZE, &fds, NULL, NULL, &timeout);
-            // <<== replace by top process?
+Server::~Server()
+{
+    for (uint i = 0; i < drones.size(); i++) delete drones[i];
+    for (uint i = 0; i < users .size(); i++) delete users[i];
+    For_Map(jobs)
+        delete Map_Value(jobs).job;
+    close(sock_fd);
+}
+
+
+void Server::enqueue(uint64 id)
+{
+    SrvJob& J = job(id);
+    J.drone = UINT_MAX;
+    if (!J.held)
+        queue.add(QueuedJob(J.job->prio, id));
+}
+
+
+// Forward a status message to the user who submitted job 'id'.
+void Server::reply(uint64 id, const ClMsg& msg, bool last)
+{
+    SrvJob* J;
+    if (!jobs.peek(id, J)) return;
+
+    SrvUser* U = users[J->user];
+    if (U){
+        if (U->replies.size() == 0) dirty.push(J->user);
+        U->replies.push(ClMsg(msg.type, J->user_id, msg.data));
+    }
+    if (last)
+        finish(id);
+}
+
+
+// Forget job 'id' (finished, failed or killed). The drone's slot is freed.
+void Server::finish(uint64 id)
+{
+    SrvJob* J;
+    if (!jobs.peek(id, J)) return;
+
+    if (J->drone != UINT_MAX){
+        SrvDrone& D = *drones[J->drone];
+        revPullOut(D.jobs, id);
+        if (D.conn.fd != -1) markIdle(J->drone);
+    }
+    if (users[J->user])
+        users[J->user]->ids.exclude(J->user_id);
+
+    delete J->job;
+    jobs.exclude(id);
+}
+
+
+void Server::lostDrone(uint d)
+{
+    SrvDrone& D = *drones[d];
+    syslog(LOG_ERR, "Lost connection to drone: fd=%d  (%u jobs running)", D.conn.fd, D.jobs.size());
+    D.conn.close();
+
+    for (uint i = 0; i < D.jobs.size(); i++){
+        uint64  id = D.jobs[i];
+        SrvJob& J  = job(id);
+        if (J.attempts < max_attempts)
+            enqueue(id);
+        else{
+            J.drone = UINT_MAX;     // -- (slot is gone with the drone)
+            reply(id, ClMsg(clmsg_LaunchFailed, id, 'l'), true);
         }
+    }
+    D.jobs.clear();
+}
 
-        // React to event:
-        if (n == -1){
-            // Child process terminated:
-            while (child_sz > 0){
-                child_sz--;
-                // <<== report to server
-                //WriteLn "Child died:  pid=%_  status=%_", child_pid[child_sz], child_stat[child_sz];
-            }
 
-        }else if (n == 0){
-            // Heartbeat:
+// Pause, resume or kill a job on behalf of user 'u'. Unknown IDs are ignored (the job may have
+// finished already).
+void Server::control(uint u, ReqType tag, uint64 user_id)
+{
+    uint64 id;
+    if (!users[u]->ids.peek(user_id, id)) return;
+    SrvJob& J = job(id);
 
-        }else{
-            if (FD_ISSET(sock_fd, &fds)){
-                // New connection:
-                int fd = acceptConnection(sock_fd);
-                syslog(LOG_NOTICE, "New server connection: fd=%d", fd);
-                pkg.clear();
-
-                if (server_fd != -1){
-                    syslog(LOG_NOTICE, "Closing old server connection: fd=%d", server_fd);
-                    shutdown(server_fd, SHUT_RDWR);
-                    close(server_fd);
-                }
-
-                server_fd = fd;
-                fcntl(fd, F_SETFL, O_NONBLOCK);
+    if (J.drone == UINT_MAX){
+        // Queued:
+        if (tag == req_Pause)
+            J.held = true;
+        else if (tag == req_Resume){
+            if (J.held){
+                J.held = false;
+                enqueue(id); }
+        }else{ assert(tag == req_Kill);
+            reply(id, ClMsg(clmsg_JobFinished, id, SIGKILL), true); }   // -- wait status of a killed process
+
+    }else{
+        // Running (the drone reports the kill as 'JobFinished'):
+        SrvDrone& D = *drones[J.drone];
+        char pkg[8];
+        for (uint i = 0; i < 8; i++)
+            pkg[i] = char(id >> (i * 8));
+        putRequest(D.conn.out, tag, slice(pkg[0], pkg[8]));
+        if (!D.conn.flush())
+            lostDrone(J.drone);
+    }
+}
+
+
+void Server::acceptUsers()
+{
+    int fd;
+    while ((fd = acceptNonBlocking(sock_fd)) != -1){
+        uint u = users.size();
+        users.push(new SrvUser(fd));
+        loop.watch(fd, (uint64(tag_User) << 32) | u);
+        syslog(LOG_NOTICE, "New user connection: fd=%d", fd);
+    }
+}
+
+
+void Server::readUser(uint u)
+{
+    SrvUser& U = *users[u];
+    bool open = U.conn.fill();
+
+    try{
+        ReqHeader    req;
+        Array<cchar> pkg;
+        while (U.conn.getRequest(req, pkg)){
+            if (!validateRequest(req))
+                throw Excp_Msg("Spurious request data received from user.");
+
+            ReqType  tag = reqTag(req);
+            Vec<Job> new_jobs;
+            try{
+                In in(pkg.base(), pkg.size());
+                if (tag == req_Launch){
+                    new_jobs.push();
+                    new_jobs.last().deserialize(in);
+                }else if (tag == req_LaunchBatch)
+                    getJobs(in, new_jobs);
+                else if (tag == req_Pause || tag == req_Resume || tag == req_Kill){
+                    if (pkg.size() != 8) throw Excp_EOF();
+                    uint64 user_id = 0;
+                    for (uint i = 0; i < 8; i++)
+                        user_id |= uint64((uchar)pkg[i]) << (8 * i);
+                    control(u, tag, user_id);
+                }else
+                    throw Excp_Msg("Unsupported request from user.");
+            }catch (Excp_EOF){
+                throw Excp_Msg("Truncated request package from user.");
+            }
+
+            // Give jobs server-wide unique IDs and enqueue them:
+            for (uind i = 0; i < new_jobs.size(); i++){
+                uint64  id = next_id++;
+                SrvJob* J;
+                jobs.getI(id, J);
+                J->user    = u;
+                J->user_id = new_jobs[i].id;
+                J->held    = (new_jobs[i].prio == 0);
+                J->job     = new Job;
+                swp_mem(*J->job, new_jobs[i]);
+                J->job->id = id;
+                U.ids.set(J->user_id, id);
+                enqueue(id);
             }
+        }
+    }catch (const Excp_Msg& err){
+        syslog(LOG_ALERT, "%s  [closing connection]", err.msg.c_str());
+        open = false;
+    }
+
+    if (!open){
+        syslog(LOG_NOTICE, "User disconnected: fd=%d", U.conn.fd);
+        delete users[u];
+        users[u] = NULL;
+    }
+}
+
+
+void Server::readDrone(uint d)
+{
+    SrvDrone& D = *drones[d];
+    bool open = D.conn.fill();
+
+    Vec<ClMsg> msgs;
+    try{
+        while (D.conn.getMsgs(msgs));
+    }catch (const Excp_Msg& err){
+        syslog(LOG_ALERT, "%s  [closing connection]", err.msg.c_str());
+        open = false;
+    }
+
+    for (uint i = 0; i < msgs.size(); i++){
+        const ClMsg& msg = msgs[i];
+        reply(msg.id, msg, msg.type == clmsg_LaunchFailed || msg.type == clmsg_JobFinished);
+    }
+
+    if (!open)
+        lostDrone(d);
+}
 
-            if (FD_ISSET(server_fd, &fds)){
-                // Incoming data on socket:
-                uint64 tot_size = 0;
-                char buf[4096];
-                for(;;){
-                    errno = 0;
-                    ssize_t size = read(server_fd, buf, sizeof(buf));
-                    if (size < 0){
-                        if (errno != EAGAIN)
-                            syslog(LOG_ERR, "Unexpected error while reading data from server: %s", strerror(errno));
-                        break;
-                    }else if (size == 0){
-                        if (tot_size == 0){
-                            // First read was empty; assume socket is closed:
-                            syslog(LOG_NOTICE, "Server disconnected: fd=%d", server_fd);
-                            shutdown(server_fd, SHUT_RDWR);
-                            close(server_fd);
-                            server_fd = -1;
-                        }
-                        break;
-                    }else{
-                        for (int i = 0; i < size; i++)
-                            pkg.push(buf[i]);
-                        tot_size += size;
-                    }
-                }
-
-                receivePackage(pkg, server_fd);     // -- will clear 'pkg' if complete
+
+void Server::dispatch()
+{
+    String      pkg;
+    Vec<uint64> batch;
+    while (idle.size() > 0 && queue.size() > 0){
+        uint d = idle.last();
+        idle.pop();
+        SrvDrone& D = *drones[d];
+        D.idle = false;
+        if (D.conn.fd == -1 || D.jobs.size() >= slots) continue;
+
+        batch.clear();
+        while (D.jobs.size() + batch.size() < slots && queue.size() > 0){
+            uint64  id = queue.pop().id;
+            SrvJob* J;
+            if (!jobs.peek(id, J) || J->drone != UINT_MAX || J->held) continue;     // -- stale entry
+            J->drone = d;
+            J->attempts++;
+            batch.push(id);
+        }
+        if (batch.size() == 0) continue;
+
+        pkg.vec().clear();
+        putu(pkg, batch.size());
+        for (uint i = 0; i < batch.size(); i++){
+            job(batch[i]).job->serialize(pkg);
+            D.jobs.push(batch[i]);
+        }
+        putRequest(D.conn.out, req_LaunchBatch, pkg.slice());
+
+        if (!D.conn.flush()){
+            syslog(LOG_ERR, "Could not send jobs to drone: fd=%d", D.conn.fd);
+            lostDrone(d);
+        }else if (D.jobs.size() < slots)
+            markIdle(d);    // -- (queue is empty now)
+    }
+}
+
+
+void Server::flushReplies()
+{
+    for (uint i = 0; i < dirty.size(); i++){
+        SrvUser* U = users[dirty[i]];
+        if (!U) continue;
+        putMsgs(U->conn.out, U->replies);
+        U->replies.clear();
+        U->conn.flush();
+    }
+    dirty.clear();
+}
+
+
+void Server::run()
+{
+    syslog(LOG_INFO, "CL-server started.");
+
+    Vec<Ev> evs;
+    for(;;){
+        loop.wait(evs);
+
+        for (uint i = 0; i < evs.size(); i++){
+            const Ev& ev = evs[i];
+            uint kind = ev.tag >> 32;
+            uint idx  = (uint)ev.tag;
+
+            if (kind == tag_Listen)
+                acceptUsers();
+
+            else if (kind == tag_User){
+                if (!users[idx]) continue;
+                if (ev.rd)
+                    readUser(idx);
+                if (ev.wr && users[idx])
+                    users[idx]->conn.flush();
+
+            }else{
+                SrvDrone& D = *drones[idx];
+                if (D.conn.fd == -1) continue;
+                if (ev.rd)
+                    readDrone(idx);
+                if (ev.wr && D.conn.fd != -1)
+                    D.conn.flush();
             }
         }
+
+        dispatch();
+        flushReplies();
     }
 }
-#endif
+
+
+void serverLoop(int port, const Vec<int>& drone_fds, uint slots)
+{
+    Server S(port, drone_fds, slots);
+    S.run();
+}
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
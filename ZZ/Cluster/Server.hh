@@ -21,6 +21,13 @@ using namespace std;
 
 
 void connectToDrones(String config_file, Vec<int>& out_fds);
+    // -- Config file has lines "host[:port]". Drones that cannot be reached are skipped (logged).
+
+void serverLoop(int port, const Vec<int>& drone_fds, uint slots);
+    // -- Accept jobs from users on 'port' and run them on the drones, at most 'slots' at a time
+    // on each drone. Status messages are forwarded to the submitting user. Jobs of a lost drone
+    // are launched again elsewhere; after 'max_attempts' launches, 'LaunchFailed' is reported with
+    // error code 'l'. Never returns.
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -405,6 +405,7 @@ CnfMap::CnfMap(NetlistRef N_, Params_CnfMap P_, /*outs:*/NetlistRef M_, WWMap& n
     assert(n2m.size() == 0);
     assert(M.empty());
     assertAig(N, "CNF mapper");
+    npn4Init();
 
     run();
 
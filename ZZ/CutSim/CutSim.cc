@@ -235,8 +235,8 @@ void CutSim_Cut::elim(uint i)
 {
     assert(i < sz);
     //**/WriteLn "  (about to eliminate pin %_ from %_)", i, *this;
-    ftb_hi = apply_perm4[qrotate[i]][ftb_hi];
-    ftb_lo = apply_perm4[qrotate[i]][ftb_lo];
+    ftb_hi = applyPerm4(qrotate[i], ftb_hi);
+    ftb_lo = applyPerm4(qrotate[i], ftb_lo);
     // <<==assert
     sz--;
     for (uint j = i; j < sz; j++)
@@ -250,8 +250,8 @@ void CutSim_Cut::trim()
 {
     if (sz == 0) goto Done;
     while ((ftb_lo & 0x5555) == ((ftb_lo & 0xAAAA) >> 1) && (ftb_hi & 0x5555) == ((ftb_hi & 0xAAAA) >> 1)){
-        ftb_lo = apply_perm4[PERM4_3012][ftb_lo];
-        ftb_hi = apply_perm4[PERM4_3012][ftb_hi];
+        ftb_lo = applyPerm4(PERM4_3012, ftb_lo);
+        ftb_hi = applyPerm4(PERM4_3012, ftb_hi);
         in[0] = in[1];
         in[1] = in[2];
         in[2] = in[3];
@@ -261,8 +261,8 @@ void CutSim_Cut::trim()
 
     if (sz == 1) goto Done;
     while ((ftb_lo & 0x3333) == ((ftb_lo & 0xCCCC) >> 2) && (ftb_hi & 0x3333) == ((ftb_hi & 0xCCCC) >> 2)){
-        ftb_lo = apply_perm4[PERM4_0312][ftb_lo];
-        ftb_hi = apply_perm4[PERM4_0312][ftb_hi];
+        ftb_lo = applyPerm4(PERM4_0312, ftb_lo);
+        ftb_hi = applyPerm4(PERM4_0312, ftb_hi);
         in[1] = in[2];
         in[2] = in[3];
         sz--;
@@ -271,8 +271,8 @@ void CutSim_Cut::trim()
 
     if (sz == 2) goto Done;
     while ((ftb_lo & 0x0F0F) == ((ftb_lo & 0xF0F0) >> 4) && (ftb_hi & 0x0F0F) == ((ftb_hi & 0xF0F0) >> 4)){
-        ftb_lo = apply_perm4[PERM4_0132][ftb_lo];
-        ftb_hi = apply_perm4[PERM4_0132][ftb_hi];
+        ftb_lo = applyPerm4(PERM4_0132, ftb_lo);
+        ftb_hi = applyPerm4(PERM4_0132, ftb_hi);
         in[2] = in[3];
         sz--;
         if (sz == 2) goto Done;
@@ -464,6 +464,7 @@ void addCut(Vec<Cut>& cuts, const Cut& c, uint max_cuts)
 static
 void combineCutPair(Cut c, Cut d, Vec<Cut>& out_cuts, uint max_cutsize, uint cuts_per_node, uint heuristic_cutoff)
 {
+    npn4Init();
     //**/Write "combineCutPair: ";
     //**/Dump(c, d);
     if (c.size() + d.size() > heuristic_cutoff) return;
@@ -552,10 +553,10 @@ void combineCutPair(Cut c, Cut d, Vec<Cut>& out_cuts, uint max_cutsize, uint cut
   Done:;
 
     // Compute new FTB:
-    c.ftb_lo = apply_perm4[pseq4_to_perm4[pseq4Make(perm_c[0], perm_c[1], perm_c[2], perm_c[3])]][c.ftb_lo];
-    c.ftb_hi = apply_perm4[pseq4_to_perm4[pseq4Make(perm_c[0], perm_c[1], perm_c[2], perm_c[3])]][c.ftb_hi];
-    d.ftb_lo = apply_perm4[pseq4_to_perm4[pseq4Make(perm_d[0], perm_d[1], perm_d[2], perm_d[3])]][d.ftb_lo];
-    d.ftb_hi = apply_perm4[pseq4_to_perm4[pseq4Make(perm_d[0], perm_d[1], perm_d[2], perm_d[3])]][d.ftb_hi];
+    c.ftb_lo = applyPerm4(pseq4_to_perm4[pseq4Make(perm_c[0], perm_c[1], perm_c[2], perm_c[3])], c.ftb_lo);
+    c.ftb_hi = applyPerm4(pseq4_to_perm4[pseq4Make(perm_c[0], perm_c[1], perm_c[2], perm_c[3])], c.ftb_hi);
+    d.ftb_lo = applyPerm4(pseq4_to_perm4[pseq4Make(perm_d[0], perm_d[1], perm_d[2], perm_d[3])], d.ftb_lo);
+    d.ftb_hi = applyPerm4(pseq4_to_perm4[pseq4Make(perm_d[0], perm_d[1], perm_d[2], perm_d[3])], d.ftb_hi);
     //**/Dump(c, d);
 
     result.ftb_lo = c.ftb_lo & d.ftb_lo;
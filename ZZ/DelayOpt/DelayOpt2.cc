@@ -14,6 +14,7 @@
 #include "Prelude.hh"
 #include "DelayOpt2.hh"
 #include "TimingRef.hh"
+#include "IncTiming.hh"
 #include "ZZ/Generics/Sort.hh"
 #include "ZZ/Generics/Heap.hh"
 #include "ZZ/Generics/IdHeap.hh"
@@ -197,6 +198,7 @@ class DelayOpt {
     TMap            slew;
     TMap            dep;
     float           area;
+    IncTiming*      tim;        // -- timing of the discrete cells, kept up-to-date incrementally (set by 'run()')
 
     // Continuous model:
     WMap<float>     alt;        // -- cell alternative: '0 .. n-1', where 'n' is the number of functionally equivalent cells
@@ -270,7 +272,7 @@ public:
 
     DelayOpt(NetlistRef N_, const SC_Lib& L_, const Vec<float>& wire_cap_, const Params_DelayOpt& P_) :
         N(N_), L(L_), wire_cap(wire_cap_), P(P_),
-        buf_sym(UINT_MAX), buf_grp(UINT_MAX), area(-1), Q(LevQueue_lt(N, level)), R(LevQueue_lt(N, level)), seed(DEFAULT_SEED)
+        buf_sym(UINT_MAX), buf_grp(UINT_MAX), area(-1), tim(NULL), Q(LevQueue_lt(N, level)), R(LevQueue_lt(N, level)), seed(DEFAULT_SEED)
         {}
 
     void run();
@@ -300,6 +302,12 @@ inline uint DelayOpt::maxAltNo(Wire w) const {
 
 float DelayOpt::computeCritLen(uint approx)
 {
+    if (tim != NULL && (approx == UINT_MAX || approx == P.approx)){
+        tim->syncCells();
+        tim->propagate();
+        return tim->maxArrival();
+    }
+
     assert(order.size() > 0);
     TMap load;
     computeLoads(N, L, wire_cap, load);
@@ -451,6 +459,7 @@ void DelayOpt::legalize()
                             load(v).fall -= cell(w0,L).pins[Iter_Var(v)].fall_cap; }
 
                         setAltNo(w0, altNo(w0) + 1);
+                        tim->cellChanged(w0);
                         upsized = true;
 
                         For_Inputs(w0, v){  // -- add load of new gate
@@ -1211,11 +1220,10 @@ void DelayOpt::continuousResizing()
     For_Gatetype(N, gate_Uif, w)
         setAltNo(w, (uint)floor(alt[w] + 0.5));
 
-    // Static timing:
-    load.clear(); arr.clear(); dep.clear(); slew.clear();
-    computeLoads(N, L, wire_cap, load);
-    staticTiming(N, L, load, order, P.approx, arr, slew);
-    revStaticTiming(N, L, load, slew, order, P.approx, dep);
+    // Static timing (only cells that differ from the legalized sizes are re-timed):
+    tim->syncCells();
+    tim->propagate();
+    tim->exportTiming(load, arr, slew, dep);
     area = getTotalArea(N, L);
 
     if (P.verbosity >= 1){
@@ -1370,11 +1378,10 @@ void DelayOpt::alternativeResizing(float req_time)
     For_Gatetype(N, gate_Uif, w)
         setAltNo(w, (uint)floor(alt[w] + 0.5));
 
-    // Static timing:
-    load.clear(); arr.clear(); dep.clear(); slew.clear();
-    computeLoads(N, L, wire_cap, load);
-    staticTiming(N, L, load, order, P.approx, arr, slew);
-    revStaticTiming(N, L, load, slew, order, P.approx, dep);
+    // Static timing (only cells that differ from the legalized sizes are re-timed):
+    tim->syncCells();
+    tim->propagate();
+    tim->exportTiming(load, arr, slew, dep);
     area = getTotalArea(N, L);
 
     if (P.verbosity >= 1){
@@ -1494,8 +1501,10 @@ void DelayOpt::run()
     // Pre-buffer:
     preBuffer();
 
-    // Compute initial loads:
+    // Compute initial loads and timing:
     computeLoads(N, L, wire_cap, load);
+    IncTiming inc_timing(N, L, wire_cap, P.approx);
+    tim = &inc_timing;
 
     // Legalize:
     WriteLn "Initial delay  : %.2f ps   (area %,d)", L.ps(computeCritLen()), (uint64)getTotalArea(N, L);
@@ -1503,8 +1512,7 @@ void DelayOpt::run()
     WriteLn "Legalized delay: %.2f ps   (area %,d)", L.ps(computeCritLen()), (uint64)getTotalArea(N, L);
 
     // Initial timing:
-    staticTiming(N, L, load, order, P.approx, arr, slew);
-    revStaticTiming(N, L, load, slew, order, P.approx, dep);
+    tim->exportTiming(load, arr, slew, dep);
     area = getTotalArea(N, L);
 
     /**/signal(SIGINT, SIGINT_handler2);
@@ -1518,6 +1526,7 @@ void DelayOpt::run()
         WriteLn "Table-based delay: \a/%.2f ps\a/", L.ps(computeCritLen(0)); }
 
     addInternalNames();
+    tim = NULL;
 }
 
 
@@ -0,0 +1,458 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : IncTiming.cc
+//| Module      : DelayOpt
+//| Description : Incremental static timing on top of the reference timing model.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Gates are re-timed by recomputing their values from scratch in the same order as the reference
+//| implementation does, so unaffected gates reproduce their old values bit-for-bit and
+//| propagation stops there. The only exception is 'load', which is summed over the fanout list
+//| rather than in gate order, so it may differ in the last bits from 'computeLoads()'.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "IncTiming.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Constructor:
+
+
+IncTiming::IncTiming(NetlistRef N_, const SC_Lib& L_, const Vec<float>& wire_cap_, uint approx_) :
+    NlLis(N_.nl()),
+    N(N_), L(L_), wire_cap(wire_cap_), approx(approx_),
+    timed_sym(UINT_MAX),
+    lo(UINT_MAX),
+    hi(0),
+    n_fwd_evals(0),
+    n_bwd_evals(0)
+{
+    assert(Has_Pob(N, dyn_fanouts));
+
+    // Full timing:
+    Vec<GLit> order;
+    topoOrder(N, order);
+    computeLoads(N, L, wire_cap, load);
+    staticTiming(N, L, load, order, approx, arr, slew);
+    revStaticTiming(N, L, load, slew, order, approx, dep);
+
+    // Levelize:
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + N;
+        if (type(w) == gate_Flop) continue;
+        For_Inputs(w, v)
+            newMax(level(w), level[v] + 1);
+    }
+
+    For_Gatetype(N, gate_Uif, w)
+        timed_sym(w) = attr_Uif(w).sym;
+
+    // Critical path heap:
+    crit.prio = &max_arr;
+    max_arr.growTo(N.size(), 0.0f);
+    For_Gates(N, w){
+        if (type(w) != gate_Uif && type(w) != gate_Pin) continue;
+        max_arr[id(w)] = max_(arr[w].rise, arr[w].fall);
+        crit.push(id(w));
+    }
+    crit.heapify();
+
+    N.listen(*this, NlMsgs_new(msg_Update, msg_Add, msg_Remove));
+}
+
+
+IncTiming::~IncTiming()
+{
+    N.unlisten(*this, NlMsgs_new(msg_Update, msg_Add, msg_Remove));
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Listener interface:
+
+
+// NOTE! Listener callbacks only record the dirty frontier; fanout lists may not be up-to-date yet.
+void IncTiming::update(Wire w, uint pin, Wire w_old, Wire w_new)
+{
+    if (w_old == w_new) return;
+
+    markFwd(w);
+    if (w_old){ markLoad(w_old); markBwd(w_old); }
+    if (w_new){ markLoad(w_new); markBwd(w_new); }
+}
+
+
+void IncTiming::add(Wire w)
+{
+    markFwd(w);     // -- inputs are connected (and reported) later
+}
+
+
+void IncTiming::remove(Wire w)
+{
+    For_Inputs(w, v){
+        markLoad(v);
+        markBwd(v); }
+
+    load(w) = arr(w) = slew(w) = dep(w) = TValues(0, 0);
+    timed_sym(w) = UINT_MAX;
+    crit.exclude(id(w));
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Local timing:
+
+
+// Mirrors 'computeLoads()' for a single gate.
+TValues IncTiming::computeLoad(Wire w)
+{
+    Get_Pob(N, dyn_fanouts);
+    Fanouts fs = dyn_fanouts[w];
+
+    TValues ld(0, 0);
+    for (uint i = 0; i < fs.size(); i++){
+        Connect c = fs[i];
+        if (type(c) != gate_Uif) continue;
+        const SC_Pin& pin = cell(c, L).pins[c.pin];
+        ld.rise += pin.rise_cap;
+        ld.fall += pin.fall_cap;
+    }
+
+    if (wire_cap.size() > 0){
+        uint n = min_(dyn_fanouts.count(w), wire_cap.size() - 1);
+        ld.rise += wire_cap[n];
+        ld.fall += wire_cap[n];
+    }
+    return ld;
+}
+
+
+// Mirrors 'staticTiming()' for a single (non multi-output) gate.
+void IncTiming::timeNode(Wire w, TValues& a, TValues& s)
+{
+    a = s = TValues(0, 0);
+
+    Wire w0;
+    uint out_pin;
+    if (type(w) == gate_Uif && !isMultiOutput(w, L)){
+        w0 = w;
+        out_pin = w.size();
+    }else if (type(w) == gate_Pin){
+        w0 = w[0];
+        out_pin = w0.size() + attr_Pin(w).number;
+    }else
+        return;
+
+    const SC_Pin& pin = cell(w0, L).pins[out_pin];
+    For_Inputs(w0, v){
+        const SC_Timings& ts = pin.rtiming[Iter_Var(v)];
+        if (ts.size() == 0) continue;
+        timeGate(ts[0], arr[v], slew[v], load[w], approx, a, s);
+    }
+}
+
+
+// Mirrors 'revStaticTiming()' for a single gate: the departure time of 'w' as the maximum over
+// the contributions from its fanouts.
+void IncTiming::revTimeNode(Wire w, TValues& d)
+{
+    Get_Pob(N, dyn_fanouts);
+    Fanouts fs = dyn_fanouts[w];
+
+    d = TValues(0, 0);
+    for (uint i = 0; i < fs.size(); i++){
+        Connect c = fs[i];
+        if (type(c) == gate_Pin){
+            newMax(d.rise, dep[c].rise);
+            newMax(d.fall, dep[c].fall);
+
+        }else if (type(c) == gate_Uif){
+            const SC_Cell& cl = cell(c, L);
+            if (cl.n_outputs == 1){
+                const SC_Timings& ts = cl.pins[c.size()].rtiming[c.pin];
+                if (ts.size() == 0) continue;
+                revTimeGate(ts[0], dep[c], slew[w], load[c], approx, d);
+
+            }else{
+                Fanouts gs = dyn_fanouts[c];
+                for (uint j = 0; j < gs.size(); j++){
+                    Wire p = gs[j];
+                    if (type(p) != gate_Pin) continue;
+                    const SC_Timings& ts = cl.pins[c.size() + attr_Pin(p).number].rtiming[c.pin];
+                    if (ts.size() == 0) continue;
+                    revTimeGate(ts[0], dep[p], slew[w], load[p], approx, d);
+                }
+            }
+        }
+    }
+}
+
+
+void IncTiming::updateCrit(Wire w)
+{
+    max_arr(id(w), 0.0f) = max_(arr[w].rise, arr[w].fall);
+    if (!crit.weakAdd(id(w)))
+        crit.update(id(w));
+}
+
+
+// The gates whose departure time depend on the departure time, slew or load of 'w'.
+void IncTiming::markFaninsBwd(Wire w)
+{
+    if (type(w) == gate_Pin){
+        markBwd(w[0]);
+        w = w[0];
+    }else if (type(w) != gate_Uif)
+        return;
+    For_Inputs(w, v)
+        markBwd(v);
+}
+
+
+void IncTiming::enqueueFanins(Wire w)
+{
+    if (type(w) == gate_Pin){
+        enqueue(w[0]);
+        w = w[0];
+    }else if (type(w) != gate_Uif)
+        return;
+    For_Inputs(w, v)
+        enqueue(v);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Propagation:
+
+
+void IncTiming::cellChanged(Wire w)
+{
+    assert(type(w) == gate_Uif);
+    timed_sym(w) = attr_Uif(w).sym;
+
+    markFwd(w);             // -- new delay tables
+    markFaninsBwd(w);
+    For_Inputs(w, v)
+        markLoad(v);        // -- new input pin capacitances
+}
+
+
+void IncTiming::syncCells()
+{
+    For_Gatetype(N, gate_Uif, w)
+        if (timed_sym[w] != attr_Uif(w).sym)
+            cellChanged(w);
+}
+
+
+// Levels only ever increase, so a rewiring can at worst make the levels sparser.
+void IncTiming::fixLevels()
+{
+    Get_Pob(N, dyn_fanouts);
+
+    Vec<GLit> Q_lev;
+    for (uint i = 0; i < dirty_fwd.size(); i++)
+        Q_lev.push(dirty_fwd[i]);
+
+    while (Q_lev.size() > 0){
+        Wire w = Q_lev.popC() + N;
+        if (N.deleted(id(w)) || type(w) == gate_Flop) continue;
+
+        uint lv = 0;
+        For_Inputs(w, v)
+            newMax(lv, level[v] + 1);
+
+        if (lv > level[w]){
+            level(w) = lv;
+            Fanouts fs = dyn_fanouts[w];
+            for (uint i = 0; i < fs.size(); i++)
+                Q_lev.push(fs[i]);
+        }
+    }
+}
+
+
+void IncTiming::propagate()
+{
+    Get_Pob(N, dyn_fanouts);
+
+    // New Uifs have their attribute set by now:
+    for (uint i = 0; i < dirty_fwd.size(); i++){
+        Wire w = dirty_fwd[i] + N;
+        if (!N.deleted(id(w)) && type(w) == gate_Uif && timed_sym[w] == UINT_MAX)
+            cellChanged(w);
+    }
+
+    // Loads:
+    for (uint i = 0; i < dirty_load.size(); i++){
+        Wire w = dirty_load[i] + N;
+        in_dirty_load.exclude(w);
+        if (N.deleted(id(w))) continue;
+
+        TValues ld = computeLoad(w);
+        if (!(ld == load[w])){
+            load(w) = ld;
+            markFwd(w);
+            markFaninsBwd(w);
+        }
+    }
+    dirty_load.clear();
+
+    fixLevels();
+
+    // Forward propagation (arrival and slew):
+    for (uint i = 0; i < dirty_fwd.size(); i++){
+        Wire w = dirty_fwd[i] + N;
+        in_dirty_fwd.exclude(w);
+        if (!N.deleted(id(w)))
+            enqueue(w);
+    }
+    dirty_fwd.clear();
+
+    for (uint lv = lo; lv <= hi; lv++){     // -- 'hi' grows as fanouts are enqueued
+        for (uint j = 0; j < queue[lv].size(); j++){
+            Wire w = queue[lv][j] + N;
+            in_queue.exclude(w);
+
+            if (isMultiOutput(w, L)){
+                Fanouts fs = dyn_fanouts[w];
+                for (uint i = 0; i < fs.size(); i++)
+                    enqueue(fs[i]);
+                continue;
+            }
+
+            TValues a, s;
+            timeNode(w, a, s);
+            n_fwd_evals++;
+
+            bool arr_changed  = !(a == arr[w]);
+            bool slew_changed = !(s == slew[w]);
+            if (arr_changed){
+                arr(w) = a;
+                updateCrit(w);
+
+                if (type(w) == gate_Pin){   // -- multi-output cell gets the maximum of its outputs
+                    Wire w0 = w[0];
+                    Fanouts fs = dyn_fanouts[w0];
+                    TValues a0(0, 0);
+                    for (uint i = 0; i < fs.size(); i++){
+                        if (type(fs[i]) != gate_Pin) continue;
+                        newMax(a0.rise, arr[fs[i]].rise);
+                        newMax(a0.fall, arr[fs[i]].fall);
+                    }
+                    if (!(a0 == arr[w0])){
+                        arr(w0) = a0;
+                        updateCrit(w0); }
+                }
+            }
+            if (slew_changed){
+                slew(w) = s;
+                markBwd(w);
+            }
+            if (arr_changed || slew_changed){
+                Fanouts fs = dyn_fanouts[w];
+                for (uint i = 0; i < fs.size(); i++)
+                    if (type(fs[i]) == gate_Uif || type(fs[i]) == gate_Pin)
+                        enqueue(fs[i]);
+            }
+        }
+        queue[lv].clear();
+    }
+    lo = UINT_MAX;
+    hi = 0;
+
+    // Backward propagation (departure):
+    for (uint i = 0; i < dirty_bwd.size(); i++){
+        Wire w = dirty_bwd[i] + N;
+        in_dirty_bwd.exclude(w);
+        if (!N.deleted(id(w)))
+            enqueue(w);
+    }
+    dirty_bwd.clear();
+
+    for (uint lv = hi + 1; lv > lo;){ lv--;    // -- 'lo' shrinks as fanins are enqueued
+        for (uint j = 0; j < queue[lv].size(); j++){
+            Wire w = queue[lv][j] + N;
+            in_queue.exclude(w);
+
+            TValues d;
+            revTimeNode(w, d);
+            n_bwd_evals++;
+
+            if (!(d == dep[w])){
+                dep(w) = d;
+                enqueueFanins(w);
+            }
+        }
+        queue[lv].clear();
+    }
+    lo = UINT_MAX;
+    hi = 0;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Queries:
+
+
+float IncTiming::maxArrival() const
+{
+    return (crit.size() == 0) ? 0.0f : max_(0.0f, crit.peekPrio());
+}
+
+
+void IncTiming::exportTiming(TMap& out_load, TMap& out_arr, TMap& out_slew, TMap& out_dep) const
+{
+    load.copyTo(out_load);
+    arr .copyTo(out_arr);
+    slew.copyTo(out_slew);
+    dep .copyTo(out_dep);
+}
+
+
+macro bool closeTo(const TValues& x, const TValues& y, float rel_tol) {
+    return fabsf(x.rise - y.rise) <= rel_tol * max_(1.0f, fabsf(y.rise))
+        && fabsf(x.fall - y.fall) <= rel_tol * max_(1.0f, fabsf(y.fall)); }
+
+
+bool IncTiming::verify(float rel_tol)
+{
+    Vec<GLit> order;
+    topoOrder(N, order);
+
+    TMap ref_load, ref_arr, ref_slew, ref_dep;
+    computeLoads(N, L, wire_cap, ref_load);
+    staticTiming(N, L, ref_load, order, approx, ref_arr, ref_slew);
+    revStaticTiming(N, L, ref_load, ref_slew, order, approx, ref_dep);
+
+    uint mismatches = 0;
+    float max_ref = 0;
+    For_Gates(N, w){
+        bool ok = closeTo(load[w], ref_load[w], rel_tol)
+               && closeTo(arr [w], ref_arr [w], rel_tol)
+               && closeTo(slew[w], ref_slew[w], rel_tol)
+               && closeTo(dep [w], ref_dep [w], rel_tol);
+        if (!ok){
+            if (mismatches < 10)
+                WriteLn "IncTiming mismatch: %n  load=%_/%_  arr=%_/%_  slew=%_/%_  dep=%_/%_", w,
+                    load[w], ref_load[w], arr[w], ref_arr[w], slew[w], ref_slew[w], dep[w], ref_dep[w];
+            mismatches++;
+        }
+        newMax(max_ref, max_(ref_arr[w].rise, ref_arr[w].fall));
+    }
+
+    if (!closeTo(TValues(maxArrival(), 0), TValues(max_ref, 0), rel_tol)){
+        WriteLn "IncTiming mismatch: max arrival=%_  reference=%_", maxArrival(), max_ref;
+        mismatches++; }
+
+    return mismatches == 0;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
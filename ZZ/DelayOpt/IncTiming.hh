@@ -0,0 +1,155 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : IncTiming.hh
+//| Module      : DelayOpt
+//| Description : Incremental static timing on top of the reference timing model.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Keeps 'load', 'arr', 'slew' and 'dep' (as computed by 'computeLoads()', 'staticTiming()' and
+//| 'revStaticTiming()' of 'TimingRef.hh') up-to-date under netlist changes. Structural changes
+//| (buffer insertion, rewiring, removal) are picked up through the netlist listener interface;
+//| cell swaps ('attr_Uif(w).sym = ...') cannot be listened to and must be reported through
+//| 'cellChanged()' (or found by 'syncCells()'). Changes only mark a dirty frontier; nothing is
+//| re-timed until 'propagate()' is called, which then re-times the affected fanout cones
+//| (arrival, slew) in level order and the affected fanin cones (departure) in reverse level
+//| order, stopping wherever the values do not change.
+//|
+//| NOTE! 'dyn_fanouts' must be present in the netlist for the lifetime of the object.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__DelayOpt__IncTiming_hh
+#define ZZ__DelayOpt__IncTiming_hh
+
+#include "TimingRef.hh"
+#include "ZZ/Generics/IdHeap.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'IncTiming':
+
+
+class IncTiming : public NlLis, public NonCopyable {
+  //________________________________________
+  //  Problem input:
+
+    NetlistRef          N;
+    const SC_Lib&       L;
+    const Vec<float>&   wire_cap;
+    uint                approx;
+
+  //________________________________________
+  //  Timing data:
+
+    TMap            load;
+    TMap            arr;
+    TMap            slew;
+    TMap            dep;
+
+    WMap<uint>      level;          // -- 'level[w] > level[v]' for all (non-flop) fanins 'v' of 'w'
+    WMap<uint>      timed_sym;      // -- cell of each Uif as last seen by the timer (for 'syncCells()')
+
+    Vec<float>      max_arr;        // -- 'max(arr.rise, arr.fall)' indexed by gate ID
+    IdHeap<float,1> crit;           // -- all timed gates, ordered on 'max_arr'
+
+  //________________________________________
+  //  Dirty frontier:
+
+    Vec<GLit>       dirty_load;     // -- capacitive load may have changed
+    WSeen           in_dirty_load;
+    Vec<GLit>       dirty_fwd;      // -- arrival/slew may have changed (or fanins were rewired)
+    WSeen           in_dirty_fwd;
+    Vec<GLit>       dirty_bwd;      // -- departure may have changed
+    WSeen           in_dirty_bwd;
+
+    Vec<Vec<GLit> > queue;          // -- gates to re-time, bucketed on level (forward and backward pass)
+    WSeen           in_queue;
+    uint            lo, hi;         // -- range of non-empty buckets
+
+    // Statistics:
+    uint64          n_fwd_evals;
+    uint64          n_bwd_evals;
+
+  //________________________________________
+  //  Internal methods:
+
+    void    markLoad (Wire w) { if (!in_dirty_load.add(w)) dirty_load.push(w); }
+    void    markFwd  (Wire w) { if (!in_dirty_fwd .add(w)) dirty_fwd .push(w); }
+    void    markBwd  (Wire w) { if (!in_dirty_bwd .add(w)) dirty_bwd .push(w); }
+    void    markFaninsBwd(Wire w);
+    void    enqueue  (Wire w) { if (!in_queue.add(w)){ uint lv = level[w]; queue(lv).push(w); newMin(lo, lv); newMax(hi, lv); } }
+    void    enqueueFanins(Wire w);
+
+    TValues computeLoad(Wire w);
+    void    timeNode   (Wire w, TValues& a, TValues& s);
+    void    revTimeNode(Wire w, TValues& d);
+    void    updateCrit (Wire w);
+    void    fixLevels  ();
+
+public:
+  //________________________________________
+  //  Constructor:
+
+    IncTiming(NetlistRef N, const SC_Lib& L, const Vec<float>& wire_cap, uint approx);
+   ~IncTiming();
+        // -- Computes full static timing for 'N' and starts listening to changes.
+
+  //________________________________________
+  //  Listener interface:
+
+    void update(Wire w, uint pin, Wire w_old, Wire w_new);
+    void add   (Wire w);
+    void remove(Wire w);
+    void compact(const Vec<gate_id>& new_ids) { assert(false); }
+
+  //________________________________________
+  //  Updating:
+
+    void cellChanged(Wire w);
+        // -- Must be called after changing the standard cell of 'w' (a Uif). Several changes can
+        // be reported before calling 'propagate()'.
+
+    void syncCells();
+        // -- Compare all Uifs against the cell last timed and call 'cellChanged()' for those that
+        // differ. Useful after bulk changes (linear in the size of the netlist, but cheap).
+
+    void propagate();
+        // -- Bring timing up-to-date w.r.t. all changes reported since last call.
+
+  //________________________________________
+  //  Queries:
+
+    // NOTE! Queries reflect the state at the last call to 'propagate()'.
+    const TMap& getLoad() const { return load; }
+    const TMap& getArr () const { return arr;  }
+    const TMap& getSlew() const { return slew; }
+    const TMap& getDep () const { return dep;  }
+
+    float maxArrival() const;
+        // -- Length of the critical path (same as maximum of 'arr').
+
+    float criticalSlack(float req_time) const { return req_time - maxArrival(); }
+        // -- Worst slack of the design for a given required time (negative if violated).
+
+    float slack(Wire w, float req_time) const {
+        return req_time - max_(arr[w].rise + dep[w].rise, arr[w].fall + dep[w].fall); }
+        // -- Slack of the worst path through 'w'.
+
+    void exportTiming(TMap& out_load, TMap& out_arr, TMap& out_slew, TMap& out_dep) const;
+        // -- Copy the timing data (for algorithms working on their own maps).
+
+    uint64 fwdEvals() const { return n_fwd_evals; }
+    uint64 bwdEvals() const { return n_bwd_evals; }
+        // -- Number of gates re-timed forwards/backwards (for statistics).
+
+    bool verify(float rel_tol = 1e-4f);
+        // -- Compare against a full re-timing from scratch. Mismatches are reported on 'std_out'.
+        // Must be called right after 'propagate()'.
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
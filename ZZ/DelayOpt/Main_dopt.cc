@@ -14,6 +14,29 @@ using namespace ZZ;
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 
 
+// Read the timing tables of all cells the optimizer may pick: every size of the cells used in 'N'
+// and all buffers and inverters.
+static
+void loadSizingCells(NetlistRef N, SC_Lib& L)
+{
+    Vec<Vec<uint> >       groups;
+    Vec<Pair<uint,uint> > group_inv;
+    groupCellTypes(L, groups, &group_inv);
+
+    Vec<uchar> used(groups.size(), 0);
+    For_Gatetype(N, gate_Uif, w)
+        used[group_inv[attr_Uif(w).sym].fst] = 1;
+
+    for (uint i = 0; i < groups.size(); i++){
+        const SC_Cell& cell = L.cells[groups[i][0]];
+        if (used[i] || (cell.n_inputs == 1 && cell.n_outputs == 1)){
+            for (uint j = 0; j < groups[i].size(); j++)
+                loadCellTiming(L, groups[i][j]);
+        }
+    }
+}
+
+
 int main(int argc, char** argv)
 {
     ZZ_Init;
@@ -44,10 +67,10 @@ int main(int argc, char** argv)
     try{
         cpuClock();
         if (hasExtension(lib_file, "lib")){
-            readLiberty(lib_file, L);
-            WriteLn "Reading liberty file: \a*%t\a*", cpuClock();
+            bool cached = readLibertyCached(lib_file, L, /*lazy*/true);
+            WriteLn "Reading liberty file%_: \a*%t\a*", cached ? " (cached)" : "", cpuClock();
         }else{
-            readSclFile(lib_file, L);
+            readSclFile(lib_file, L, /*lazy*/true);
             WriteLn "Reading SCL file: \a*%t\a*", cpuClock();
         }
 
@@ -65,6 +88,7 @@ int main(int argc, char** argv)
 
     // No design? Just output some library info:
     if (design_file == ""){
+        loadCellTiming(L);
         Netlist N;
         Vec<Vec<uint> > groups;
         groupCellTypes(L, groups);
@@ -97,6 +121,14 @@ int main(int argc, char** argv)
     // Remap UIFs:
     remapUifs(N, mod2cell);
 
+    // Read timing tables:
+    try{
+        loadSizingCells(N, L);
+    }catch (Excp_Msg& msg){
+        ShoutLn "PARSE ERROR! %_", msg;
+        exit(1);
+    }
+
     // Compute loads:
     Vec<float> wire_cap;
     Str model_chosen;
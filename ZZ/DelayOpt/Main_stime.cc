@@ -23,6 +23,7 @@ int main(int argc, char** argv)
     cli.add("apx"   , "{none,lin,satch,quad}", "none"        , "Approximation to use for timing; 'none' uses Liberty tables.");
     cli.add("wmod"  , "string"               , ""            , "Override default selection of wire-load model.");
     cli.add("slack" , "uint"                 , "0"           , "Use GNU-plot to plot the slack for all gates (1) or just POs (2).");
+    cli.add("threads", "uint"                , "1"           , "Time the gates of each level on this many threads (result is the same for any value).");
     cli.add("dump"  , "string"               , ""            , "[DEBUG] Write flattened netlist to file.");
     cli.addCommand("all", "Time whole design.");
 
@@ -41,6 +42,11 @@ int main(int argc, char** argv)
     String wire_load_model = cli.get("wmod").string_val;
     uint   plot_slack = cli.get("slack").enum_val;
     String dump_file = cli.get("dump").string_val;
+    uint   n_threads = cli.get("threads").int_val;
+  #if !defined(ZZ_PTHREADS)
+    if (n_threads > 1)
+        WriteLn "NOTE! Compiled without pthreads; timing on a single thread.";
+  #endif
     if (hasExtension(design_file, "lib") || hasExtension(design_file, "scl"))
         swp(design_file, lib_file);
 
@@ -52,10 +58,10 @@ int main(int argc, char** argv)
     try{
         cpuClock();
         if (hasExtension(lib_file, "lib")){
-            readLiberty(lib_file, L);
-            WriteLn "Reading liberty file: \a*%t\a*", cpuClock();
+            bool cached = readLibertyCached(lib_file, L, /*lazy*/true);
+            WriteLn "Reading liberty file%_: \a*%t\a*", cached ? " (cached)" : "", cpuClock();
         }else{
-            readSclFile(lib_file, L);
+            readSclFile(lib_file, L, /*lazy*/true);
             WriteLn "Reading SCL file: \a*%t\a*", cpuClock();
         }
 
@@ -102,13 +108,21 @@ int main(int argc, char** argv)
     WriteLn "Design size: %_", info(N);
     NewLine;
 
+    // Read timing tables of the cells used:
+    try{
+        loadCellTiming(N, L);
+    }catch (Excp_Msg& msg){
+        ShoutLn "PARSE ERROR! %_", msg;
+        exit(1);
+    }
+
     // Dump flattened file?
     if (dump_file != "")
         N.write(dump_file);
 
     if (cli.cmd == "all"){
         // Compute static timing:
-        reportTiming(N, L, approx, plot_slack, wire_load_model);
+        reportTiming(N, L, approx, plot_slack, wire_load_model, n_threads);
         WriteLn "Static timing: \a*%t\a*", cpuClock();
 
     }else if (cli.cmd == "one"){
@@ -8,13 +8,19 @@
 //| (C) Copyright 2010-2014, The Regents of the University of California
 //|________________________________________________________________________________________________
 //|                                                                                  -- COMMENTS --
-//| Not optimized for speed, only for correctness and readability.
+//| Not optimized for speed, only for correctness and readability. The exception is 'staticTiming()'
+//| (used for full-chip timing), which works on flattened copies of the delay tables and can time
+//| the gates of a topological level in parallel; it computes exactly the same values.
 //|________________________________________________________________________________________________
 
 #include "Prelude.hh"
 #include "TimingRef.hh"
 #include "ZZ/Generics/Sort.hh"
 
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace ZZ {
 using namespace std;
 
@@ -94,6 +100,192 @@ macro void timeGate(const SC_Timing& t, Wire w, Wire v, const TMap& load, uint a
     //return timeGate(t, arr[v], slew[v], load[w], approx && type(v) != gate_PI, arr(w), slew(w)); }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Flattened tables (used by 'staticTiming()'):
+
+
+// A delay table and its transition table sampled at the same slew/load points (typical for
+// Liberty files, where both use the same template) are stored interleaved in one contiguous
+// array: 'tab[2*(i0*n1 + i1)]' is the delay and 'tab[2*(i0*n1 + i1) + 1]' the transition at
+// '(index0[i0], index1[i1])'. One position search and two 4-float loads then give both values.
+struct FlatSurf {
+    uint    n0, n1;
+    uint    index0;     // -- offsets into 'FlatTiming::data'
+    uint    index1;
+    uint    tab;
+};
+
+
+struct FlatArc {
+    const SC_Timing* t;     // -- NULL if no timing arc
+    bool             flat;  // -- if FALSE, 'rise' and 'fall' are unused (time through 't')
+    FlatSurf         rise;  // -- 'cell_rise' + 'rise_trans'
+    FlatSurf         fall;  // -- 'cell_fall' + 'fall_trans'
+};
+
+
+class FlatTiming {
+    const SC_Lib&   L;
+    bool            enabled;
+    Vec<uint>       cell_arcs;  // -- first arc of each cell in 'arcs' ('UINT_MAX' if not added yet)
+    Vec<FlatArc>    arcs;       // -- arc for input pin 'i' to output pin 'o' of cell 'c' is 'arcs[cell_arcs[c] + o * n_inputs + i]'
+    Vec<float>      data;
+
+    uint pushVec(const Vec<float>& v);
+    void addCell_(uint c);
+    bool flatten(const SC_Surface& delay, const SC_Surface& trans, FlatSurf& out);
+
+public:
+    FlatTiming(const SC_Lib& L_, bool enabled_) : L(L_), enabled(enabled_) {}
+
+    void addCell(uint c) { if (c >= cell_arcs.size() || cell_arcs[c] == UINT_MAX) addCell_(c); }
+        // -- Must be called for a cell before its arcs are looked up. May move 'base()'.
+
+    const FlatArc* cellArcs(uint c) const { assert(cell_arcs[c] != UINT_MAX); return &arcs[cell_arcs[c]]; }
+    const float*   base() const { return data.base(); }
+};
+
+
+uint FlatTiming::pushVec(const Vec<float>& v)
+{
+    uint off = data.size();
+    for (uint i = 0; i < v.size(); i++)
+        data.push(v[i]);
+    return off;
+}
+
+
+static
+bool sameIndex(const Vec<float>& v0, const Vec<float>& v1)
+{
+    if (v0.size() != v1.size()) return false;
+    for (uint i = 0; i < v0.size(); i++)
+        if (v0[i] != v1[i]) return false;
+    return true;
+}
+
+
+bool FlatTiming::flatten(const SC_Surface& delay, const SC_Surface& trans, FlatSurf& out)
+{
+    uint n0 = delay.index0.size();
+    uint n1 = delay.index1.size();
+    if (n0 < 2 || n1 < 2 || !sameIndex(delay.index0, trans.index0) || !sameIndex(delay.index1, trans.index1))
+        return false;
+    if (delay.data.size() != n0 || trans.data.size() != n0)
+        return false;
+    for (uint i = 0; i < n0; i++)
+        if (delay.data[i].size() != n1 || trans.data[i].size() != n1)
+            return false;
+
+    out.n0 = n0;
+    out.n1 = n1;
+    out.index0 = pushVec(delay.index0);
+    out.index1 = pushVec(delay.index1);
+    out.tab = data.size();
+    for (uint i = 0; i < n0; i++){
+        for (uint j = 0; j < n1; j++){
+            data.push(delay.data[i][j]);
+            data.push(trans.data[i][j]);
+        }
+    }
+    return true;
+}
+
+
+void FlatTiming::addCell_(uint c)
+{
+    const SC_Cell& cell = L.cells[c];
+    cell_arcs(c, UINT_MAX) = arcs.size();
+    for (uint o = 0; o < cell.n_outputs; o++){
+        const SC_Pin& pin = cell.outPin(o);
+        for (uint i = 0; i < cell.n_inputs; i++){
+            arcs.push();
+            FlatArc& a = arcs.last();
+            a.t = NULL;
+            a.flat = false;
+
+            if (i >= pin.rtiming.size()) continue;
+            const SC_Timings& ts = pin.rtiming[i];
+            if (ts.size() == 0) continue;
+            assert(ts.size() == 1);
+            a.t = &ts[0];
+
+            if (enabled)
+                a.flat = flatten(a.t->cell_rise, a.t->rise_trans, a.rise)
+                      && flatten(a.t->cell_fall, a.t->fall_trans, a.fall);
+        }
+    }
+}
+
+
+// Returns delay ('d') and transition ('t') for one edge; same arithmetic as 'fullLookup()'.
+macro void flatLookup(const FlatSurf& S, const float* D, float slew, float load, float& d, float& t)
+{
+    const float* index0 = D + S.index0;
+    const float* index1 = D + S.index1;
+
+    uint s, l;
+    for (s = 1; s < S.n0-1; s++)
+        if (index0[s] > slew)
+            break;
+    s--;
+
+    for (l = 1; l < S.n1-1; l++)
+        if (index1[l] > load)
+            break;
+    l--;
+
+    float sfrac = (slew - index0[s]) / (index0[s+1] - index0[s]);
+    float lfrac = (load - index1[l]) / (index1[l+1] - index1[l]);
+
+    const float* r0 = D + S.tab + 2*(s*S.n1 + l);     // -- {d, t} at '(s, l)' followed by {d, t} at '(s, l+1)'
+    const float* r1 = r0 + 2*S.n1;                  // -- same for row 's+1'
+  #if defined(__SSE2__)
+    __m128 a  = _mm_loadu_ps(r0);
+    __m128 b  = _mm_loadu_ps(r1);
+    __m128 lo = _mm_movelh_ps(a, b);                // -- {d0, t0, d1, t1} at load point 'l'   (rows 's', 's+1')
+    __m128 hi = _mm_movehl_ps(b, a);                // -- {d0, t0, d1, t1} at load point 'l+1'
+    __m128 p  = _mm_add_ps(lo, _mm_mul_ps(_mm_set1_ps(lfrac), _mm_sub_ps(hi, lo)));
+    __m128 p1 = _mm_movehl_ps(p, p);
+    __m128 r  = _mm_add_ps(p, _mm_mul_ps(_mm_set1_ps(sfrac), _mm_sub_ps(p1, p)));
+    d = _mm_cvtss_f32(r);
+    t = _mm_cvtss_f32(_mm_shuffle_ps(r, r, 1));
+  #else
+    float d0 = r0[0] + lfrac * (r0[2] - r0[0]);
+    float t0 = r0[1] + lfrac * (r0[3] - r0[1]);
+    float d1 = r1[0] + lfrac * (r1[2] - r1[0]);
+    float t1 = r1[1] + lfrac * (r1[3] - r1[1]);
+    d = d0 + sfrac * (d1 - d0);
+    t = t0 + sfrac * (t1 - t0);
+  #endif
+}
+
+
+// Same as 'timeGate()' for 'approx == 0'.
+static
+void timeGateFlat(const FlatArc& A, const float* D, TValues arr_in, TValues slew_in, TValues load, TValues& arr, TValues& slew)
+{
+    float d, t;
+    if (A.t->tsense == sc_ts_Pos || A.t->tsense == sc_ts_Non){
+        flatLookup(A.rise, D, slew_in.rise, load.rise, d, t);
+        newMax(arr .rise, arr_in.rise + d);
+        newMax(slew.rise, t);
+        flatLookup(A.fall, D, slew_in.fall, load.fall, d, t);
+        newMax(arr .fall, arr_in.fall + d);
+        newMax(slew.fall, t);
+    }
+
+    if (A.t->tsense == sc_ts_Neg || A.t->tsense == sc_ts_Non){
+        flatLookup(A.rise, D, slew_in.fall, load.rise, d, t);
+        newMax(arr .rise, arr_in.fall + d);
+        newMax(slew.rise, t);
+        flatLookup(A.fall, D, slew_in.rise, load.fall, d, t);
+        newMax(arr .fall, arr_in.rise + d);
+        newMax(slew.fall, t);
+    }
+}
+
+
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // General support functions:
@@ -221,42 +413,197 @@ void computeLoads(NetlistRef N, const SC_Lib& L, const Vec<float>& wire_cap, /*o
 }
 
 
-// Output parameters 'arr' and 'slew' should be default constructed and unmodifed.
-void staticTiming(NetlistRef N, const SC_Lib& L, const TMap& load, const Vec<GLit>& order, uint approx, /*outputs:*/TMap& arr, TMap& slew)
+//=================================================================================================
+// -- Static timing:
+
+
+#define STA_CHUNK   64      // -- number of gates a timing thread claims at a time
+
+
+struct StaticTiming {
+    NetlistRef      N;
+    const SC_Lib&   L;
+    const TMap&     load;
+    uint            approx;
+    TMap&           arr;
+    TMap&           slew;
+
+    FlatTiming      flat;
+
+    // Levelized order (only for multi-threaded timing):
+    Vec<GLit>       lv_order;   // -- Uifs and Pins of 'order' sorted on level
+    Vec<uint>       lv_start;   // -- level 'i' is 'lv_order[lv_start[i] .. lv_start[i+1]-1]'
+    Vec<uint>       lv_next;    // -- next gate to claim (relative 'lv_start[i]') for each level
+  #if defined(ZZ_PTHREADS)
+    pthread_barrier_t lv_barrier;
+  #endif
+
+    StaticTiming(NetlistRef N_, const SC_Lib& L_, const TMap& load_, uint approx_, TMap& arr_, TMap& slew_) :
+        N(N_), L(L_), load(load_), approx(approx_), arr(arr_), slew(slew_), flat(L_, approx_ == 0) {}
+
+    void timeNode(Wire w);
+    void levelize(const Vec<GLit>& order);
+    void worker();
+};
+
+
+// Times a single-output Uif or a Pin of a multi-output Uif. Only 'arr[w]' and 'slew[w]' are
+// written; the arrival time of the multi-output Uif itself is set by the caller. The cell must
+// have been added to 'flat'.
+void StaticTiming::timeNode(Wire w)
 {
+    Wire u;
+    uint out_pin;
+    if (type(w) == gate_Uif){
+        if (L.cells[attr_Uif(w).sym].n_outputs > 1) return;
+        u = w;
+        out_pin = 0;
+    }else{ assert(type(w) == gate_Pin);
+        u = w[0];
+        out_pin = attr_Pin(w).number;
+    }
+
+    uint           cell_idx = attr_Uif(u).sym;
+    const FlatArc* arcs = flat.cellArcs(cell_idx) + out_pin * L.cells[cell_idx].n_inputs;
+    const float*   D = flat.base();
+    TValues        a, s;        // -- output maps start out zero
+    TValues        ld = load[w];
+
+    For_Inputs(u, v){
+        const FlatArc& A = arcs[Iter_Var(v)];
+        if (!A.t) continue;
+
+        if (A.flat)
+            timeGateFlat(A, D, arr[v], slew[v], ld, a, s);
+        else
+            timeGate(*A.t, arr[v], slew[v], ld, approx, a, s);
+    }
+
+    arr (w) = a;
+    slew(w) = s;
+}
+
+
+// Sorts the Uifs and Pins of 'order' on level (and adds their cells to 'flat', which must not
+// change once the worker threads are running).
+void StaticTiming::levelize(const Vec<GLit>& order)
+{
+    WMap<uint> level;
+    uint n_levels = 0;
     for (uint i = 0; i < order.size(); i++){
         Wire w = order[i] + N;
-
         if (type(w) == gate_Uif){
-            uint cell_idx = attr_Uif(w).sym;
-            const SC_Cell& cell = L.cells[cell_idx];
-            if (cell.n_outputs > 1) continue;
+            flat.addCell(attr_Uif(w).sym);
+
+            uint lv = 0;
+            For_Inputs(w, v)
+                newMax(lv, level[v] + 1);
+            level(w) = lv;
+            newMax(n_levels, lv + 1);
+        }else if (type(w) == gate_Pin)
+            level(w) = level[w[0]];     // -- a Pin reads the inputs of its Uif, not the Uif itself
+    }
 
-            const SC_Pin& pin = cell.pins[w.size()];    // = first output; may be many (handled by 'gate_Pin' below?)
+    lv_start.reset(n_levels + 1, 0);
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + N;
+        if (type(w) == gate_Uif || type(w) == gate_Pin)
+            lv_start[level[w] + 1]++;
+    }
+    for (uint i = 1; i < lv_start.size(); i++)
+        lv_start[i] += lv_start[i-1];
 
-            For_Inputs(w, v){
-                const SC_Timings& ts = pin.rtiming[Iter_Var(v)];
-                if (ts.size() == 0) continue;
-                assert(ts.size() == 1);
-                const SC_Timing& t = ts[0];
+    Vec<uint> pos;
+    lv_start.copyTo(pos);
+    lv_order.setSize(lv_start.last());
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + N;
+        if (type(w) == gate_Uif || type(w) == gate_Pin)
+            lv_order[pos[level[w]]++] = w;
+    }
+}
 
-                timeGate(t, w, v, load, approx, arr, slew);
-            }
 
-        }else if (type(w) == gate_Pin){
-            uint out_pin = attr_Pin(w).number;
-            uint cell_idx = attr_Uif(w[0]).sym;
-            const SC_Cell& cell = L.cells[cell_idx];
-            const SC_Pin& pin = cell.pins[w[0].size() + out_pin];
+#if defined(ZZ_PTHREADS)
+extern "C" void* staticTimingThread(void* data);
+void* staticTimingThread(void* data)
+{
+    static_cast<StaticTiming*>(data)->worker();
+    return NULL;
+}
 
-            For_Inputs(w[0], v){
-                const SC_Timings& ts = pin.rtiming[Iter_Var(v)];
-                if (ts.size() == 0) continue;
-                assert(ts.size() == 1);
-                const SC_Timing& t = ts[0];
 
-                timeGate(t, w, v, load, approx, arr, slew);
+void StaticTiming::worker()
+{
+    for (uint lv = 0; lv+1 < lv_start.size(); lv++){
+        uint end = lv_start[lv+1];
+        for(;;){
+            uint i = lv_start[lv] + atomicAdd(&lv_next[lv], (uint)STA_CHUNK);
+            if (i >= end) break;
+
+            uint stop = min_(i + STA_CHUNK, end);
+            for (; i < stop; i++)
+                timeNode(lv_order[i] + N);
+        }
+        pthread_barrier_wait(&lv_barrier);
+    }
+}
+
+#else
+void StaticTiming::worker() { assert(false); }
+#endif
+
+
+// Output parameters 'arr' and 'slew' should be default constructed and unmodifed.
+void staticTiming(NetlistRef N, const SC_Lib& L, const TMap& load, const Vec<GLit>& order, uint approx, /*outputs:*/TMap& arr, TMap& slew, uint n_threads)
+{
+    StaticTiming sta(N, L, load, approx, arr, slew);
+
+  #if defined(ZZ_PTHREADS)
+    if (n_threads > 1){
+        sta.levelize(order);
+
+        // Grow maps written by worker threads to full size so they are never reallocated:
+        Wire last = GLit(N.size() - 1) + N;
+        arr(last);
+        slew(last);
+
+        sta.lv_next.reset(sta.lv_start.size(), 0);
+        pthread_barrier_init(&sta.lv_barrier, NULL, n_threads);
+
+        Vec<pthread_t> threads(n_threads);
+        for (uint t = 1; t < n_threads; t++){
+            if (pthread_create(&threads[t], NULL, staticTimingThread, &sta) != 0){
+                ShoutLn "ERROR! Could not create static timing thread.";
+                exit(1); }
+        }
+        sta.worker();
+        for (uint t = 1; t < n_threads; t++)
+            pthread_join(threads[t], NULL);
+
+        pthread_barrier_destroy(&sta.lv_barrier);
+
+        // Arrival time of a multi-output Uif is the max over its Pins:
+        for (uint i = 0; i < sta.lv_order.size(); i++){
+            Wire w = sta.lv_order[i] + N;
+            if (type(w) == gate_Pin){
+                newMax(arr(w[0]).rise, arr[w].rise);
+                newMax(arr(w[0]).fall, arr[w].fall);
             }
+        }
+        return;
+    }
+  #endif
+
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + N;
+
+        if (type(w) == gate_Uif){
+            sta.flat.addCell(attr_Uif(w).sym);
+            sta.timeNode(w);
+
+        }else if (type(w) == gate_Pin){
+            sta.timeNode(w);
             newMax(arr(w[0]).rise, arr[w].rise);
             newMax(arr(w[0]).fall, arr[w].fall);
         }
@@ -341,7 +688,7 @@ void dumpCriticalPath(NetlistRef N, const SC_Lib& L, const TMap& load, const TMa
 }
 
 
-void reportTiming(NetlistRef N, const SC_Lib& L, uint approx, uint plot_slack, String wire_load_model)
+void reportTiming(NetlistRef N, const SC_Lib& L, uint approx, uint plot_slack, String wire_load_model, uint n_threads)
 {
     // Compute loads:
     Vec<float> wire_cap;
@@ -367,7 +714,7 @@ void reportTiming(NetlistRef N, const SC_Lib& L, uint approx, uint plot_slack, S
 
     TMap arr;
     TMap slew;
-    staticTiming(N, L, load, order, approx, arr, slew);
+    staticTiming(N, L, load, order, approx, arr, slew, n_threads);
 
     // Show result:
     dumpCriticalPath(N, L, load, arr, slew);
@@ -80,8 +80,10 @@ bool getWireLoadModel(NetlistRef N, const SC_Lib& L, /*out*/Vec<float>& wire_cap
 void computeLoads(NetlistRef N, const SC_Lib& L, const Vec<float>& wire_cap, /*out*/TMap& load);
     // -- Sum up the output capacitance ("load") for each gate.
 
-void staticTiming(NetlistRef N, const SC_Lib& L, const TMap& load, const Vec<GLit>& order, uint approx, /*outputs:*/TMap& arr, TMap& slew);
-    // -- Compute slew and arrival time for entire netlist.
+void staticTiming(NetlistRef N, const SC_Lib& L, const TMap& load, const Vec<GLit>& order, uint approx, /*outputs:*/TMap& arr, TMap& slew, uint n_threads = 1);
+    // -- Compute slew and arrival time for entire netlist. If 'n_threads > 1' (requires
+    // 'ZZ_PTHREADS'), the gates of each topological level are timed in parallel. Result is
+    // independent of 'n_threads'.
 
 void revStaticTiming(NetlistRef N, const SC_Lib& L, const TMap& load, const TMap& slew, const Vec<GLit>& order, uint approx, /*out*/TMap& dep);
     // -- Compute departure time. Assumes load (from 'computeLoads()') and slew (from 'staticTiming()') are already computed.
@@ -89,7 +91,7 @@ void revStaticTiming(NetlistRef N, const SC_Lib& L, const TMap& load, const TMap
 void dumpCriticalPath(NetlistRef N, const SC_Lib& L, const TMap& load, const TMap& arr, const TMap& slew);
     // -- Quick-and-dirty reporting of the critical path. For debugging mainly.
 
-void reportTiming(NetlistRef N, const SC_Lib& L, uint approx, uint plot_slack = 0, String wire_load_model = "");
+void reportTiming(NetlistRef N, const SC_Lib& L, uint approx, uint plot_slack = 0, String wire_load_model = "", uint n_threads = 1);
     // -- Time the whole design and show the critical path. If 'plot_slack == 1', curve for all
     // gates is plotted, if 'plot_slack == 2' only POs are used.
 
@@ -132,6 +132,7 @@ private:
 // Wrapper function:
 void dsd6(uint64 ftb, Vec<uchar>& prog, Params_Dsd P)
 {
+    npn4Init();
     prog.clear();
 
     DsdState dsd(ftb, prog, P);
@@ -886,7 +887,7 @@ void testDsd()
         ushort ftb0 = npn4_repr[cl[i]];
         for (uint negs = 0; negs < 32; negs++){
             for (uint perm = 0; perm < 24; perm++){
-                uint64 ftb = apply_negs4[negs][apply_perm4[perm][ftb0]];
+                uint64 ftb = applyNegs4(negs, applyPerm4(perm, ftb0));
                 ftb |= ftb << 16;
                 ftb |= ftb << 32;
                 WriteLn "i=%_  negs=%_  perm=%_  ftb=%.4x   [%.8b]", i, negs, perm, ftb, (uint)(uchar)ftb;
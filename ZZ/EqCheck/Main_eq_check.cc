@@ -84,10 +84,10 @@ int main(int argc, char** argv)
         if (lib_file != ""){
             curr_file = lib_file;
             if (hasExtension(lib_file, "lib")){
-                readLiberty(lib_file, L);
-                WriteLn "Reading liberty file: \a*%t\a*", cpuClock();
+                bool cached = readLibertyCached(lib_file, L, /*lazy*/true);
+                WriteLn "Reading liberty file%_: \a*%t\a*", cached ? " (cached)" : "", cpuClock();
             }else{
-                readSclFile(lib_file, L);
+                readSclFile(lib_file, L, /*lazy*/true);
                 WriteLn "Reading SCL file: \a*%t\a*", cpuClock();
             }
         }
@@ -49,7 +49,7 @@ union Lit_union { Lit_data sid; uint32 data; };
 struct Lit : Lit_data {
     explicit Lit(uint id_, bool sign_ = false) { sign = sign_; id = id_; }
     Lit() { Lit_union u; u.data = 0; *this = static_cast<Lit&>(u.sid); }  // -- make sure 'id' and 'sign' are set to zero with just one operation
-    Lit(const Lit& other) { sign = other.sign; id = other.id; }
+    Lit(const Lit& other) : Lit_data(other) {}                         // -- one 32-bit copy rather than two bit-field updates
     Lit(Tag_packed, uint32 data) { Lit_union u; u.data = data; *this = static_cast<Lit&>(u.sid); }
 
     Lit operator~() const { return Lit(id, !sign); }
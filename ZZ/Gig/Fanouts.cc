@@ -14,6 +14,7 @@
 #include "Prelude.hh"
 #include "Fanouts.hh"
 #include "Macros.hh"
+#include "ZZ/Generics/Sort.hh"
 
 namespace ZZ {
 using namespace std;
@@ -102,5 +103,185 @@ void GigObj_Fanouts::init()
 }
 
 
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Dynamic fanouts:
+
+
+// Capacity given to a block of 'sz' fanouts when (re)building the table.
+macro uint withSlack(uint sz) {
+    return (sz == 0) ? 0 : sz + (sz >> 2) + 1; }
+
+
+void GigObj_DynamicFanouts::init()
+{
+    clear();
+    data.growTo(N->size());
+
+    // Count fanouts and divvy up memory:
+    For_All_Gates(*N, w)
+        For_Inputs(w, v)
+            data[v.id].size++;
+
+    uind offset = 0;
+    for (uint i = 0; i < data.size(); i++){
+        Outs& o = data[i];
+        o.offset = offset;
+        o.cap    = withSlack(o.size);
+        o.size   = 0;
+        offset += o.cap;
+    }
+    assert(offset <= UINT_MAX);     // -- we don't support more than 2^32 fanouts in total
+    mem.growTo(offset);
+
+    // Populate:
+    For_All_Gates(*N, w){
+        For_Inputs(w, v){
+            Outs& o = data[v.id];
+            CConnect& c = mem[o.offset + o.size++];
+            c.parent = w.lit() ^ sign(v);
+            c.pin    = Input_Pin(v);
+        }
+    }
+}
+
+
+void GigObj_DynamicFanouts::copyTo(GigObj& dst_) const
+{
+    GigObj_DynamicFanouts& dst = static_cast<GigObj_DynamicFanouts&>(dst_);
+
+    mem .copyTo(dst.mem);
+    data.copyTo(dst.data);
+    dst.n_waste = n_waste;
+}
+
+
+// Gate IDs are remapped by moving the 'Outs' headers; connects are rewritten within their blocks.
+// NOTE! Blocks still referenced from 'old_data' are invisible to 'repack()', so it must not run
+// until all headers have been moved ('addConn()' never repacks).
+void GigObj_DynamicFanouts::compact(const GigRemap& remap)
+{
+    Vec<Outs> old_data;
+    data.moveTo(old_data);
+    data.growTo(N->size());
+
+    for (gate_id i = 0; i < old_data.size(); i++){
+        Outs& o = old_data[i];
+        GLit  p = remap(GLit(i));
+        if (!p){
+            n_waste += o.cap;
+            continue; }
+
+        // Translate parents (the sign of a connect follows the sign of the new child literal):
+        uint n = 0;
+        for (uint k = 0; k < o.size; k++){
+            CConnect c = mem[o.offset + k];
+            GLit parent = remap(GLit(c.parent.id));
+            if (parent){
+                c.parent = GLit(parent.id, c.parent.sign ^ p.sign);
+                mem[o.offset + n++] = c;
+            }
+        }
+        o.size = n;
+
+        // Move block (merge if another gate was already mapped here):
+        Outs& d = data[p.id];
+        if (d.cap == 0)
+            d = o;
+        else{
+            for (uint k = 0; k < o.size; k++){
+                CConnect c = mem[o.offset + k];
+                addConn(p.id, static_cast<GLit&>(c.parent), c.pin);
+            }
+            n_waste += o.cap;
+        }
+    }
+
+    repackIfWasteful();
+}
+
+
+void GigObj_DynamicFanouts::removing(Wire w, bool recreated)
+{
+    For_Inputs(w, v)
+        remConn(v.id, w.id, Input_Pin(v));
+
+    if (!recreated){    // -- a recreated gate keeps its ID, and hence its fanouts
+        Outs& o = data[w.id];
+        n_waste += o.cap;
+        o = Outs();
+    }
+}
+
+
+void GigObj_DynamicFanouts::addConn(gate_id w, GLit parent, uint pin)
+{
+    Outs& o = data[w];
+    if (o.size == o.cap)
+        grow(o);
+
+    CConnect& c = mem[o.offset + o.size++];
+    c.parent = parent;
+    c.pin    = pin;
+}
+
+
+// Fanouts may be missing if a gate was removed before its fanouts were, so this is not an error.
+void GigObj_DynamicFanouts::remConn(gate_id w, gate_id parent, uint pin)
+{
+    Outs& o = data[w];
+    CConnect* cs = mem.base() + o.offset;
+    for (uint i = 0; i < o.size; i++){
+        if (cs[i].parent.id == parent && cs[i].pin == pin){
+            o.size--;
+            cs[i] = cs[o.size];
+            return;
+        }
+    }
+}
+
+
+void GigObj_DynamicFanouts::grow(Outs& o)
+{
+    uint new_cap = max_(2u, o.cap * 2);
+    if (o.offset + o.cap == mem.size())
+        mem.growTo(o.offset + new_cap);     // -- last block; extend in place
+    else{
+        uint offset = mem.size();
+        mem.growTo(offset + new_cap);
+        for (uint i = 0; i < o.size; i++)
+            mem[offset + i] = mem[o.offset + i];
+        n_waste += o.cap;
+        o.offset = offset;
+    }
+    o.cap = new_cap;
+}
+
+
+// Blocks are moved down in order of their offsets, so no block overwrites one not yet moved.
+// Capacities only shrink.
+void GigObj_DynamicFanouts::repack()
+{
+    Vec<Pair<uint,gate_id> > order;
+    for (gate_id i = 0; i < data.size(); i++)
+        if (data[i].cap > 0)
+            order.push(make_tuple(data[i].offset, i));
+    sort(order);
+
+    uint offset = 0;
+    for (uint k = 0; k < order.size(); k++){
+        Outs& o = data[order[k].snd];
+        uint cap = min_(o.cap, max_(withSlack(o.size), o.size + 1));
+        for (uint i = 0; i < o.size; i++)
+            mem[offset + i] = mem[o.offset + i];
+        o.offset = offset;
+        o.cap    = cap;
+        offset += cap;
+    }
+    mem.shrinkTo(offset);
+    n_waste = 0;
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 }
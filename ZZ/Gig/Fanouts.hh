@@ -135,6 +135,7 @@ class Fanouts {
     CConnect*   data;
 
     friend class GigObj_Fanouts;
+    friend class GigObj_DynamicFanouts;
     Fanouts(Gig& N_, CConnect* data_, uint sz_) : N(N_), sz(sz_), data(data_) {}
 
 public:
@@ -209,6 +210,82 @@ public:
 };
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Dynamic fanouts:
+
+
+// Fanouts kept up-to-date through netlist listeners, so the netlist need not be frozen. Each gate
+// owns a block of 'cap' connects in 'mem', of which the first 'size' are used. A full block is
+// moved to the end of 'mem' with double capacity; once more than half of 'mem' is abandoned
+// blocks, it is repacked in place. The order of fanouts is unspecified, and a returned 'Fanouts'
+// object is only valid until the next netlist change.
+//
+class GigObj_DynamicFanouts : public GigObj, public GigLis {
+    struct Outs {
+        uint offset;
+        uint size;
+        uint cap;
+        Outs() : offset(0), size(0), cap(0) {}
+    };
+
+    Vec<CConnect> mem;
+    uint          n_waste;      // -- number of elements of 'mem' not owned by any block
+    Vec<Outs>     data;
+
+    void addConn(gate_id w, GLit parent, uint pin);
+    void remConn(gate_id w, gate_id parent, uint pin);
+    void grow(Outs& o);
+    void repackIfWasteful() { if (n_waste > mem.size() / 2) repack(); }
+
+public:
+  //________________________________________
+  //  Constructor:
+
+    GigObj_DynamicFanouts(Gig& N_) :
+        GigObj(N_),
+        n_waste(0)
+    {
+        N->listen(*this, msg_Update | msg_Add | msg_Remove);
+    }
+
+   ~GigObj_DynamicFanouts(){
+        N->unlisten(*this, msg_Update | msg_Add | msg_Remove);
+    }
+
+  //________________________________________
+  //  GigObj interface:
+
+    void init();
+    void load(In&) { init(); }
+    void save(Out&) const {}
+    void copyTo(GigObj& dst) const;
+    void compact(const GigRemap& remap);
+
+  //________________________________________
+  //  Listener interface:
+
+    void updating(Wire w, uint pin, Wire w_old, Wire w_new) {
+        if (w_old) remConn(w_old.id, w.id, pin);
+        if (w_new){ addConn(w_new.id, GLit(w.id) ^ w_new.sign, pin); repackIfWasteful(); } }
+
+    void adding(Wire w) {
+        data.growTo(w.id + 1); }
+
+    void removing(Wire w, bool recreated);
+
+  //________________________________________
+  //  Methods:
+
+    void clear() { mem.clear(true); data.clear(true); n_waste = 0; }
+    void repack();  // -- squeeze out abandoned blocks (done automatically when needed)
+
+    uint count(Wire w) const { return data[w.id].size; }
+    Fanouts get(Wire w) const {
+        const Outs& o = data[w.id];
+        return Fanouts(*N, const_cast<CConnect*>(mem.base()) + o.offset, o.size); }
+};
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Fanout count (dynamic):
 
@@ -22,6 +22,9 @@
 
 #include "Prelude.hh"
 #include "StdLib.hh"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 
 namespace ZZ {
 using namespace std;
@@ -445,7 +448,7 @@ void Gig::copyTo(Gig& M) const
 // -- Compaction:
 
 
-void Gig::compact(GigRemap& remap, bool remove_unreach)
+void Gig::compact(GigRemap& remap, bool remove_unreach, bool dfs_order)
 {
     assert(!is_frozen);
 
@@ -461,10 +464,19 @@ void Gig::compact(GigRemap& remap, bool remove_unreach)
 
     // Get topological order:
     Vec<GLit> order;
-    if (remove_unreach)
-        removeUnreach(N, NULL, &order);
-    else
+    if (dfs_order){
+        if (remove_unreach)
+            removeUnreach(N, NULL, &order);
+        else{
+            Vec<GLit> unreach;
+            checkUnreach(N, &unreach, &order);
+            append(order, unreach);
+        }
+    }else{
+        if (remove_unreach)
+            removeUnreach(N);
         upOrder(N, order);
+    }
 
     // Fill in 'remap':
     for (gate_id i = 0; i < order.size(); i++){
@@ -528,9 +540,9 @@ void Gig::compact(GigRemap& remap, bool remove_unreach)
 }
 
 
-void Gig::compact(bool remove_unreach) {
+void Gig::compact(bool remove_unreach, bool dfs_order) {
     GigRemap remap;
-    compact(remap, remove_unreach); }
+    compact(remap, remove_unreach, dfs_order); }
 
 
 //=================================================================================================
@@ -633,6 +645,12 @@ void Gig::save(Out& out)
         putu(out, lut6_ftb[i]);
 
     // Write Gig objects:
+    saveObjs(out);
+}
+
+
+void Gig::saveObjs(Out& out)
+{
     for (uint i = 0; i < GigObjType_size; i++){
         if (objs[i]){
             putz(out, GigObjType_name[i]);
@@ -757,6 +775,13 @@ void Gig::load(In& in)
         lut6_ftb[i] = getu(in);
 
     // Read Gig objects:
+    loadObjs(in);
+}
+
+
+void Gig::loadObjs(In& in)
+{
+    Vec<char> buf;
     for(;;){
         getz(in, buf);
         if (eq(buf, ".")) break;
@@ -775,5 +800,269 @@ void Gig::load(In& in)
 }
 
 
+//=================================================================================================
+// -- Binary image:
+
+
+// Layout: a header page followed by the gate table, the pool of external fanins, the LUT6
+// side-table and the Gig objects, each section starting on a page boundary. Gates are stored
+// exactly as in memory, except that 'ext' holds an offset into the fanin pool instead of a
+// pointer. Numbering, type lists and freelists are rebuilt from the gate table on load.
+
+static const uchar  gig_image_version = 0x81;   // -- high bit separates images from the stream format
+static const uint64 gig_image_align   = 4096;
+static const uint32 gig_image_endian  = 0x01020304;
+
+
+struct GigImageHeader {
+    uchar   tag[elemsof(gig_file_tag)];
+    uchar   version;
+    uint32  endian;
+    uint32  sizeof_gate;
+    uint64  type_sig;
+    uint32  is_frozen;
+    uint32  use_freelist;
+    uint32  n_gates;
+    uint64  off_gates;
+    uint64  off_ext;
+    uint64  n_ext;          // -- in 'uint's
+    uint64  off_ftb;
+    uint64  n_ftb;
+    uint64  off_objs;
+    uint64  sz_objs;        // -- in bytes
+};
+
+
+// Signature of the gate type definitions; images are only valid between executables that agree.
+static
+uint64 gateTypeSignature()
+{
+    uint64 h = 14695981039346656037ull;
+    for (uint i = 0; i < GateType_size; i++){
+        for (cchar* p = GateType_name[i]; *p; p++)
+            h = (h ^ (uchar)*p) * 1099511628211ull;
+        h = (h ^ gatetype_size[i]) * 1099511628211ull;
+        h = (h ^ (uint)gatetype_attr[i]) * 1099511628211ull;
+    }
+    return h;
+}
+
+
+macro uint64 alignUp(uint64 pos) {
+    return (pos + gig_image_align - 1) & ~(gig_image_align - 1); }
+
+
+static
+void padTo(File& out, uint64& pos, uint64 target)
+{
+    static const char zeros[256] = {0};
+    assert(pos <= target);
+    while (pos < target){
+        uint64 n = min_(target - pos, (uint64)sizeof(zeros));
+        out.putChars(zeros, n);
+        pos += n;
+    }
+}
+
+
+void Gig::saveImage(String filename)
+{
+    File out(filename, "w");
+    if (out.null()) Throw(Excp_Msg) "Could not open file for writing: %_", filename;
+
+    GigImageHeader h;
+    memset(&h, 0, sizeof(h));
+    for (uint i = 0; i < elemsof(gig_file_tag); i++)
+        h.tag[i] = gig_file_tag[i];
+    h.version      = gig_image_version;
+    h.endian       = gig_image_endian;
+    h.sizeof_gate  = sizeof(Gate);
+    h.type_sig     = gateTypeSignature();
+    h.is_frozen    = is_frozen;
+    h.use_freelist = use_freelist;
+    h.n_gates      = size();
+
+    h.n_ext = 0;
+    for (gate_id i = 0; i < size(); i++){
+        const Gate& g = getGate(*this, i);
+        if (g.is_ext) h.n_ext += g.size;
+    }
+    h.n_ftb = lut6_ftb.size();
+
+    h.off_gates = gig_image_align;
+    h.off_ext   = alignUp(h.off_gates + (uint64)h.n_gates * sizeof(Gate));
+    h.off_ftb   = alignUp(h.off_ext + h.n_ext * sizeof(uint));
+    h.off_objs  = alignUp(h.off_ftb + h.n_ftb * sizeof(uint64));
+
+    uint64 pos = 0;
+    padTo(out, pos, h.off_gates);   // -- header is written last
+
+    // Gate table:
+    uint64 ext_pos = 0;
+    for (gate_id i = 0; i < size(); i++){
+        Gate g = getGate(*this, i);
+        if (g.is_ext){
+            g.ext = (uint*)(uintp)ext_pos;
+            ext_pos += g.size; }
+        out.putChars((cchar*)&g, sizeof(Gate));
+    }
+    pos += (uint64)h.n_gates * sizeof(Gate);
+
+    // External fanins:
+    padTo(out, pos, h.off_ext);
+    for (gate_id i = 0; i < size(); i++){
+        const Gate& g = getGate(*this, i);
+        if (g.is_ext)
+            out.putChars((cchar*)g.ext, g.size * sizeof(uint));
+    }
+    pos += h.n_ext * sizeof(uint);
+
+    // Side-tables:
+    padTo(out, pos, h.off_ftb);
+    out.putChars((cchar*)lut6_ftb.base(), h.n_ftb * sizeof(uint64));
+    pos += h.n_ftb * sizeof(uint64);
+
+    // Objects (in stream format):
+    padTo(out, pos, h.off_objs);
+    {
+        Out obj_out(out);
+        saveObjs(obj_out);
+    }
+    out.flush();
+    h.sz_objs = out.tell() - h.off_objs;
+
+    out.seek(0);
+    out.putChars((cchar*)&h, sizeof(h));
+}
+
+
+// Returns TRUE if 'filename' starts with the header of a binary image (see 'saveImage()').
+static
+bool isGigImage(String filename)
+{
+    File in(filename, "r");
+    if (in.null()) return false;
+
+    uchar buf[elemsof(gig_file_tag) + 1];
+    if (in.getChars((char*)buf, sizeof(buf)) != sizeof(buf)) return false;
+    for (uint i = 0; i < elemsof(gig_file_tag); i++)
+        if (buf[i] != gig_file_tag[i]) return false;
+    return buf[elemsof(gig_file_tag)] == gig_image_version;
+}
+
+
+void Gig::load(String filename)
+{
+    if (isGigImage(filename)){
+        loadImage(filename);
+        return; }
+
+    InFile in(filename);
+    if (in.null()) Throw(Excp_Msg) "Could not open file for reading: ", filename;
+    load(in);
+}
+
+
+void Gig::loadImage(String filename)
+{
+    assert(isEmpty());
+
+    // Map file:
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) Throw(Excp_Msg) "Could not open file for reading: %_", filename;
+
+    struct stat st;
+    if (fstat(fd, &st) != 0){
+        ::close(fd);
+        Throw(Excp_Msg) "Could not stat file: %_", filename; }
+    uint64 file_sz = st.st_size;
+
+    if (file_sz < sizeof(GigImageHeader)){
+        ::close(fd);
+        Throw(Excp_Msg) "Not a Gig image: %_", filename; }
+
+    void* base = mmap(NULL, file_sz, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED) Throw(Excp_Msg) "Could not memory-map file: %_", filename;
+    On_Scope_Exit(munmap, base, (size_t)file_sz);
+
+    // Validate header:
+    const GigImageHeader& h = *(const GigImageHeader*)base;
+    for (uint i = 0; i < elemsof(gig_file_tag); i++)
+        if (h.tag[i] != gig_file_tag[i])
+            Throw(Excp_Msg) "Not a .gnl file.";
+    if (h.version != gig_image_version)
+        Throw(Excp_Msg) "Unsupported version of image format: %d (expected %d)", h.version, gig_image_version;
+    if (h.endian != gig_image_endian || h.sizeof_gate != sizeof(Gate))
+        Throw(Excp_Msg) "Gig image was written on an incompatible architecture.";
+    if (h.type_sig != gateTypeSignature())
+        Throw(Excp_Msg) "Gig image was written with different gate type definitions; regenerate it (or use the stream format).";
+    if (h.n_gates < gid_FirstUser
+    ||  h.off_gates + (uint64)h.n_gates * sizeof(Gate) > file_sz
+    ||  h.off_ext + h.n_ext * sizeof(uint) > file_sz
+    ||  h.off_ftb + h.n_ftb * sizeof(uint64) > file_sz
+    ||  h.off_objs + h.sz_objs > file_sz)
+        Throw(Excp_Msg) "Gig image is truncated.";
+
+    is_frozen    = h.is_frozen;
+    use_freelist = h.use_freelist;
+
+    // Bulk copy gate table (persistent gates are already in place):
+    const Gate* src = (const Gate*)((cchar*)base + h.off_gates);
+    const uint* ext = (const uint*)((cchar*)base + h.off_ext);
+    uint n = h.n_gates;
+
+  #if defined(ZZ_GIG_PAGED)
+    for (gate_id id = size_; id < n; id++){
+        if ((id & (ZZ_GIG_PAGE_SIZE - 1)) == 0)
+            pages.push(xmalloc<Gate>(ZZ_GIG_PAGE_SIZE));
+        memcpy(&pages.last()[id & (ZZ_GIG_PAGE_SIZE - 1)], &src[id], sizeof(Gate));
+    }
+  #else
+    gates.growTo(n);
+    memcpy(&gates[gid_FirstUser], &src[gid_FirstUser], (n - gid_FirstUser) * sizeof(Gate));
+  #endif
+    size_ = n;
+
+    // Rebuild derived data:
+    for (gate_id id = gid_FirstUser; id < n; id++){
+        Gate&    g    = getGate(*this, id);
+        GateType type = (GateType)g.type;
+        if (type >= GateType_size)
+            Throw(Excp_Msg) "Gig image is corrupt.";
+
+        type_count[type]++;
+        if (type == gate_NULL){
+            if (use_freelist)
+                freelist.push(id);
+            continue; }
+
+        if (g.is_ext){
+            uint64 off = (uint64)(uintp)g.ext;
+            if (off + g.size > h.n_ext)
+                Throw(Excp_Msg) "Gig image is corrupt.";
+            g.ext = mem.alloc(g.size);
+            memcpy(g.ext, &ext[off], g.size * sizeof(uint));
+        }
+
+        if (isNumbered(type)){
+            uint num = g.inl[2];
+            if (gatetype_attr[type] == attr_Enum)
+                type_list[type](num, gid_NULL) = id;
+            numbers[type].pick(num);
+        }
+    }
+
+    // Side-tables:
+    lut6_ftb.setSize(h.n_ftb);
+    memcpy(lut6_ftb.base(), (cchar*)base + h.off_ftb, h.n_ftb * sizeof(uint64));
+
+    // Objects:
+    In in;
+    in.init((cchar*)base + h.off_objs, h.sz_objs);
+    loadObjs(in);
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 }
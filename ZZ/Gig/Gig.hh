@@ -378,6 +378,8 @@ struct Gig : Gig_data, NonCopyable {
     gate_id addInternal(GateType type, uint sz, uint attr, bool strash_normalized = false);
     void    loadGate(GateType type, uint sz);
     void    flushRle(Out& out, uchar type, uint count, uint end);
+    void    loadObjs(In& in);
+    void    saveObjs(Out& out);
 
   //________________________________________
   //  Constructor:
@@ -480,10 +482,13 @@ struct Gig : Gig_data, NonCopyable {
         // numbering scheme (which by default provides numbers in reverse order of freeing due to
         // the freelist implementation).
 
-    void  compact(bool remove_unreach = true);
-    void  compact(GigRemap& remap, bool remove_unreach = true);
+    void  compact(bool remove_unreach = true, bool dfs_order = true);
+    void  compact(GigRemap& remap, bool remove_unreach = true, bool dfs_order = true);
         // -- Will topologically order the gates and remove any gaps in the gate tables
         // created by gate removal. By default, unreachable gates (from COs) are first removed.
+        // With 'dfs_order', gates are laid out in DFS post-order from the COs, which puts most
+        // fanins next to their fanouts (unreachable gates, if kept, are placed last); otherwise
+        // the current order is preserved as far as possible.
 
   //________________________________________
   //  Disk:
@@ -491,15 +496,18 @@ struct Gig : Gig_data, NonCopyable {
     void load(In& in);      // -- may throw 'Excp_Msg'
     void save(Out& out);
 
-    void load(String filename) {
-        InFile in(filename);
-        if (in.null()) Throw(Excp_Msg) "Could not open file for reading: ", filename;
-        load(in); }
-
+    void load(String filename);     // -- also accepts files written by 'saveImage()'
     void save(String filename) {
         OutFile out(filename);
         if (out.null()) Throw(Excp_Msg) "Could not open file for writing: ", filename;
         save(out); }
+
+    void loadImage(String filename);    // -- may throw 'Excp_Msg'
+    void saveImage(String filename);
+        // -- Page-aligned binary image of the gate table. Loading memory-maps the file and copies
+        // the gate table in bulk rather than decoding it gate by gate. An image is only valid for
+        // executables with the same gate type definitions (this is checked); use 'save()' for
+        // archival.
 };
 
 
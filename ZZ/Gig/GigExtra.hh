@@ -35,6 +35,14 @@ macro Fanouts fanouts(Wire w)
 }
 
 
+// Requires Gig-object "DynamicFanouts".
+macro Fanouts dynFanouts(Wire w)
+{
+    Gig& N = *w.gig();
+    return static_cast<GigObj_DynamicFanouts&>(N.getObj(gigobj_DynamicFanouts)).get(w);
+}
+
+
 // Requires Gig-object "FanoutCount".
 macro uint nFanouts(Wire w)
 {
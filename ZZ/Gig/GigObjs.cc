@@ -21,15 +21,16 @@ using namespace std;
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 
 
-void GigObj_Fanouts_new    (Gig& N, GigObj*& ret, bool init) { ret = new GigObj_Fanouts    (N); if (init) ret->init(); }
-void GigObj_FanoutCount_new(Gig& N, GigObj*& ret, bool init) { ret = new GigObj_FanoutCount(N); if (init) ret->init(); }
-void GigObj_Strash_new     (Gig& N, GigObj*& ret, bool init) { ret = new GigObj_Strash     (N); if (init) ret->init(); }
+void GigObj_Fanouts_new       (Gig& N, GigObj*& ret, bool init) { ret = new GigObj_Fanouts       (N); if (init) ret->init(); }
+void GigObj_FanoutCount_new   (Gig& N, GigObj*& ret, bool init) { ret = new GigObj_FanoutCount   (N); if (init) ret->init(); }
+void GigObj_DynamicFanouts_new(Gig& N, GigObj*& ret, bool init) { ret = new GigObj_DynamicFanouts(N); if (init) ret->init(); }
+void GigObj_Strash_new        (Gig& N, GigObj*& ret, bool init) { ret = new GigObj_Strash        (N); if (init) ret->init(); }
 
 GigObj_Factory gigobj_factory_funcs[GigObjType_size] = {
     NULL,
     GigObj_Fanouts_new,
     GigObj_FanoutCount_new,
-    NULL,   // <<== dynamic fanouts, not done yet
+    GigObj_DynamicFanouts_new,
     GigObj_Strash_new,
 };
 
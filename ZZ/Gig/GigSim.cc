@@ -0,0 +1,335 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : GigSim.cc
+//| Module      : Gig
+//| Description : Bit-parallel random simulation of a Gig.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| The inner loops run over the contiguous words of a row with the sign of each fanin folded into
+//| an XOR-mask, which lets the compiler vectorize them (SSE2/AVX2 depending on target flags).
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "GigSim.hh"
+#include "ZZ_Npn4.hh"
+#include "ZZ/Generics/Sort.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Helpers:
+
+
+macro uint64 signMask(GLit p) {
+    return 0ull - (uint64)p.sign; }
+
+
+// Evaluate LUT 'ftb' (over 'n' inputs) for 64 patterns at once by a Shannon expansion of the
+// truth table, one input at a time.
+static
+uint64 evalLutWord(uint64 ftb, const uint64* x, uint n)
+{
+    uint64 v[64];
+    uint sz = 1u << n;
+    for (uint j = 0; j < sz; j++)
+        v[j] = 0ull - ((ftb >> j) & 1);
+
+    for (uint i = 0; i < n; i++){
+        sz >>= 1;
+        for (uint j = 0; j < sz; j++)
+            v[j] = (x[i] & v[2*j+1]) | (~x[i] & v[2*j]);
+    }
+    return v[0];
+}
+
+
+static
+bool isFreeInput(GateType t)
+{
+    switch (t){
+    case gate_PI: case gate_Clk: case gate_PPI:
+    case gate_Uif: case gate_Delay: case gate_Box: case gate_Sel:
+    case gate_MFlop: case gate_MemR: case gate_MemW: case gate_MMux: case gate_Vec:
+    case gate_WLut: case gate_CardE: case gate_CardG:
+        return true;
+    default:
+        return false;
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Construction:
+
+
+GigSim::GigSim(const Gig& N_, uint n_words_) :
+    N(N_),
+    n_words(n_words_),
+    frame(0)
+{
+    assert(n_words > 0);
+    upOrder(N, order);
+
+    row_of.growTo(N.size(), 0);     // -- row 0 is 'gid_NULL' (all zeros); missing inputs read as FALSE
+    for (gate_id i = 0; i < gid_FirstUser; i++)
+        row_of[i] = i;
+    for (uint i = 0; i < order.size(); i++){
+        Wire w = order[i] + N;
+        row_of[w.id] = gid_FirstUser + i;
+
+        if (w.type() == gate_FF)
+            flops.push(w);
+        else if (isFreeInput(w.type()))
+            inputs.push(w);
+        else
+            logic.push(w);
+    }
+
+    data.growTo((gid_FirstUser + order.size()) * n_words, 0);
+    for (uint k = 0; k < n_words; k++)
+        data[gid_True * n_words + k] = ~0ull;
+    setReset();
+}
+
+
+void GigSim::setReset()
+{
+    uint64 val = (frame == 0) ? ~0ull : 0ull;
+    for (uint k = 0; k < n_words; k++)
+        data[gid_Reset * n_words + k] = val;
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Evaluation:
+
+
+void GigSim::evalGate(Wire w)
+{
+    uint64* z = (*this)[w];
+    uint    n = n_words;
+
+    switch (w.type()){
+    case gate_PO: case gate_SafeProp: case gate_SafeCons: case gate_FairProp: case gate_FairCons:
+    case gate_Seq: case gate_Buf: case gate_Bar: case gate_Not:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]) ^ (w.type() == gate_Not ? ~0ull : 0ull);
+        for (uint k = 0; k < n; k++) z[k] = a[k] ^ ma;
+        break; }
+
+    case gate_And:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]);
+        const uint64* b = (*this)[w[1]]; uint64 mb = signMask(w[1]);
+        for (uint k = 0; k < n; k++) z[k] = (a[k] ^ ma) & (b[k] ^ mb);
+        break; }
+
+    case gate_Or:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]);
+        const uint64* b = (*this)[w[1]]; uint64 mb = signMask(w[1]);
+        for (uint k = 0; k < n; k++) z[k] = (a[k] ^ ma) | (b[k] ^ mb);
+        break; }
+
+    case gate_Xor: case gate_Equiv:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]) ^ (w.type() == gate_Equiv ? ~0ull : 0ull);
+        const uint64* b = (*this)[w[1]]; uint64 mb = signMask(w[1]);
+        for (uint k = 0; k < n; k++) z[k] = (a[k] ^ ma) ^ (b[k] ^ mb);
+        break; }
+
+    case gate_Mux: case gate_F7Mux: case gate_F8Mux:{
+        const uint64* s = (*this)[w[0]]; uint64 ms = signMask(w[0]);
+        const uint64* a = (*this)[w[1]]; uint64 ma = signMask(w[1]);
+        const uint64* b = (*this)[w[2]]; uint64 mb = signMask(w[2]);
+        for (uint k = 0; k < n; k++) z[k] = ((s[k] ^ ms) & (a[k] ^ ma)) | (~(s[k] ^ ms) & (b[k] ^ mb));
+        break; }
+
+    case gate_Maj: case gate_One: case gate_Gamb: case gate_Dot:{
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]);
+        const uint64* b = (*this)[w[1]]; uint64 mb = signMask(w[1]);
+        const uint64* c = (*this)[w[2]]; uint64 mc = signMask(w[2]);
+        switch (w.type()){
+        case gate_Maj:
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = (x & y) | (x & u) | (y & u); }
+            break;
+        case gate_One:
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = (x ^ y ^ u) & ~(x & y & u); }
+            break;
+        case gate_Gamb:
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = (x & y & u) | ~(x | y | u); }
+            break;
+        default: /*Dot*/
+            for (uint k = 0; k < n; k++){ uint64 x = a[k]^ma, y = b[k]^mb, u = c[k]^mc; z[k] = (x ^ y) | (x & u); }
+        }
+        break; }
+
+    case gate_Conj: case gate_Disj: case gate_Even: case gate_Odd:{
+        GateType t = w.type();
+        uint64 init = (t == gate_Conj) ? ~0ull : (t == gate_Even) ? ~0ull : 0ull;
+        for (uint k = 0; k < n; k++) z[k] = init;
+        For_Inputs(w, v){
+            const uint64* a = (*this)[v]; uint64 ma = signMask(v);
+            if      (t == gate_Conj) for (uint k = 0; k < n; k++) z[k] &= a[k] ^ ma;
+            else if (t == gate_Disj) for (uint k = 0; k < n; k++) z[k] |= a[k] ^ ma;
+            else                     for (uint k = 0; k < n; k++) z[k] ^= a[k] ^ ma;
+        }
+        break; }
+
+    case gate_Lut4: case gate_Npn4: case gate_Lut6:{
+        uint   sz  = w.size();
+        uint64 tt  = (w.type() == gate_Lut6) ? ftb(w) : (w.type() == gate_Lut4) ? w.arg() : npn4_repr[w.arg()];
+
+        const uint64* in[6];
+        uint64 ms[6];
+        for (uint i = 0; i < sz; i++){
+            in[i] = (*this)[w[i]];
+            ms[i] = signMask(w[i]); }
+
+        uint64 x[6];
+        for (uint k = 0; k < n; k++){
+            for (uint i = 0; i < sz; i++)
+                x[i] = in[i][k] ^ ms[i];
+            z[k] = evalLutWord(tt, x, sz);
+        }
+        break; }
+
+    default:
+        ShoutLn "INTERNAL ERROR! Unexpected gate type in 'GigSim': %_", GateType_name[w.type()];
+        assert(false);
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Public interface:
+
+
+void GigSim::randomizeInputs(uint64& seed)
+{
+    for (uint i = 0; i < inputs.size(); i++){
+        uint64* z = (*this)[inputs[i]];
+        for (uint k = 0; k < n_words; k++)
+            z[k] = irandl(seed);
+    }
+}
+
+
+void GigSim::initState(uint64& seed)
+{
+    frame = 0;
+    setReset();
+
+    for (uint i = 0; i < flops.size(); i++){
+        Wire w = flops[i] + N;
+        Wire w_init = w[1];
+        uint64* z = (*this)[w];
+        if (w_init && (w_init.id == gid_True || w_init.id == gid_False)){
+            uint64 val = ((w_init.id == gid_True) ^ w_init.sign) ? ~0ull : 0ull;
+            for (uint k = 0; k < n_words; k++) z[k] = val;
+        }else{
+            for (uint k = 0; k < n_words; k++) z[k] = irandl(seed);
+        }
+    }
+}
+
+
+void GigSim::simulate()
+{
+    for (uint i = 0; i < logic.size(); i++)
+        evalGate(logic[i] + N);
+}
+
+
+void GigSim::step()
+{
+    // Gather next state first; the 'Seq' gates are not necessarily ordered after the FFs they feed.
+    tmp.setSize(flops.size() * n_words);
+    for (uint i = 0; i < flops.size(); i++){
+        Wire w = flops[i] + N;
+        const uint64* a = (*this)[w[0]]; uint64 ma = signMask(w[0]);
+        for (uint k = 0; k < n_words; k++)
+            tmp[i * n_words + k] = a[k] ^ ma;
+    }
+    for (uint i = 0; i < flops.size(); i++){
+        uint64* z = (*this)[flops[i]];
+        for (uint k = 0; k < n_words; k++)
+            z[k] = tmp[i * n_words + k];
+    }
+
+    frame++;
+    setReset();
+}
+
+
+void GigSim::run(uint n_frames, uint64& seed)
+{
+    initState(seed);
+    for (uint d = 0; d < n_frames; d++){
+        if (d > 0) step();
+        randomizeInputs(seed);
+        simulate();
+    }
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Incremental simulation:
+
+
+// Combinational fanouts, stored compactly: fanouts of 'w' are 'fan_list[fan_start[w.id] ..
+// fan_start[w.id + 1]]'. Edges into FFs are left out (they only matter at 'step()').
+void GigSim::computeFanouts()
+{
+    fan_start.reset(N.size() + 1, 0);
+    for (uint i = 0; i < logic.size(); i++){
+        Wire w = logic[i] + N;
+        For_Inputs(w, v)
+            fan_start[v.id + 1]++;
+    }
+    for (uint i = 0; i < N.size(); i++)
+        fan_start[i + 1] += fan_start[i];
+
+    Vec<uint> fill;
+    fan_start.copyTo(fill);
+    fan_list.setSize(fan_start.last());
+    for (uint i = 0; i < logic.size(); i++){
+        Wire w = logic[i] + N;
+        For_Inputs(w, v)
+            fan_list[fill[v.id]++] = +w;
+    }
+}
+
+
+void GigSim::resimulate(const Vec<GLit>& changed)
+{
+    if (fan_start.size() == 0)
+        computeFanouts();
+
+    // Collect transitive fanout (by row number, which is also the topological position):
+    tmp_seen.reset(N.size(), false);
+    tmp_rows.clear();
+    for (uint i = 0; i < changed.size(); i++)
+        tmp_seen[changed[i].id] = true;
+
+    Vec<GLit> Q;
+    for (uint i = 0; i < changed.size(); i++)
+        Q.push(+changed[i]);
+    while (Q.size() > 0){
+        GLit p = Q.popC();
+        for (uint j = fan_start[p.id]; j < fan_start[p.id + 1]; j++){
+            GLit q = fan_list[j];
+            if (!tmp_seen[q.id]){
+                tmp_seen[q.id] = true;
+                tmp_rows.push(row_of[q.id]);
+                Q.push(q);
+            }
+        }
+    }
+
+    sort(tmp_rows);
+    for (uint i = 0; i < tmp_rows.size(); i++)
+        evalGate(order[tmp_rows[i] - gid_FirstUser] + N);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
@@ -0,0 +1,87 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : GigSim.hh
+//| Module      : Gig
+//| Description : Bit-parallel random simulation of a Gig.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//|
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Gig__GigSim_hh
+#define ZZ__Gig__GigSim_hh
+
+#include "StdLib.hh"
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'GigSim':
+
+
+// Simulates '64 * n_words' patterns in parallel. Each gate owns a row of 'n_words' consecutive
+// words, and rows are stored in topological order so that a simulation pass is a linear sweep
+// through memory. The netlist must not be modified during the life-span of this object.
+//
+// Combinational inputs are PIs, PPIs, black boxes and gates the simulator does not understand
+// (memories, 'WLut', cardinality gates); they are all given random values by
+// 'randomizeInputs()'. FFs are given values by 'initState()' and 'step()'. The 'Reset' gate
+// is TRUE in frame 0 and FALSE afterwards.
+//
+class GigSim {
+    const Gig&   N;
+    uint         n_words;
+    uint         frame;
+    Vec<GLit>    order;         // -- gates in topological order (constants excluded)
+    Vec<uint>    row_of;        // -- gate id -> row number (= position in 'order' offset by 'gid_FirstUser')
+    Vec<GLit>    logic;         // -- gates to evaluate, in topological order
+    Vec<GLit>    inputs;        // -- free inputs
+    Vec<GLit>    flops;
+    Vec<uint64>  data;          // -- 'n_words' words per row
+    Vec<uint64>  tmp;
+
+    // Fanouts (computed on demand by 'resimulate()'):
+    Vec<uint>    fan_start;
+    Vec<GLit>    fan_list;
+    Vec<uchar>   tmp_seen;
+    Vec<uint>    tmp_rows;
+
+    void evalGate(Wire w);
+    void setReset();
+    void computeFanouts();
+
+public:
+    GigSim(const Gig& N, uint n_words = 4);
+
+    uint  words()    const { return n_words; }
+    uint  patterns() const { return n_words * 64; }
+    uint  currFrame() const { return frame; }
+
+    uint64*       operator[](GLit w)       { return &data[row_of[w.id] * n_words]; }
+    const uint64* operator[](GLit w) const { return &data[row_of[w.id] * n_words]; }
+        // -- NOTE! Sign of 'w' is ignored.
+    uint64 word(GLit w, uint k) const { return (*this)[w][k] ^ (0ull - (uint64)w.sign); }
+
+    void randomizeInputs(uint64& seed);
+    void initState(uint64& seed);
+        // -- Set FFs to their initial value and go to frame 0. FFs without a constant init pin are
+        // given random values.
+    void simulate();
+        // -- Evaluate all logic of the current frame (inputs and FFs must be set).
+    void step();
+        // -- Move to next frame by latching the FF inputs (must be preceded by 'simulate()').
+    void run(uint n_frames, uint64& seed);
+        // -- Convenience: initialize then simulate 'n_frames' frames with random inputs. Final
+        // state is the last frame simulated.
+
+    void resimulate(const Vec<GLit>& changed);
+        // -- After overwriting the rows of some inputs or FFs ('changed'), re-evaluate only
+        // their transitive fanout.
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
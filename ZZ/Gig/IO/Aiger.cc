@@ -150,20 +150,22 @@ void readAiger_(In& in, Gig& N, bool verif_problem)
     }
 
 
-    // Read ANDs:
-    for (uint i = 0; i < n_Ands; i++){
-        uint delta0 = (uint)getUInt(in);
-        uint delta1 = (uint)getUInt(in);
-        uint my_id  = i + 1 + n_PIs + n_Flops;
-        uint lit0   = 2*my_id - delta0;
-        uint lit1   = lit0 - delta1;
-        Wire w_and  = N[aig2nl[my_id]]; assert_debug(w_and == gate_And);
-        Wire w0     = N[aig2nl[lit0 >> 1]] ^ (lit0 & 1);
-        Wire w1     = N[aig2nl[lit1 >> 1]] ^ (lit1 & 1);
-        w_and.set(0, w0);
-        w_and.set(1, w1);
-        //printf("%u = %sx%u & %sx%u\n", my_id, (left&1)?"~":"", left>>1, (right&1)?"~":"", right>>1);
-        //printf("%u = %sx%u & %sx%u\n", my_id, sign(w0)?"~":"", id(w0) - gid_FirstUser + 1, sign(w1)?"~":"", id(w1) - gid_FirstUser + 1);
+    // Read ANDs (decoding the deltas in batches, see 'getUInts()'):
+    const uint batch = 8192;
+    Vec<uint> deltas(2 * batch);
+    for (uint i0 = 0; i0 < n_Ands; i0 += batch){
+        uint n = min_(batch, n_Ands - i0);
+        getUInts(in, deltas.base(), 2 * n);
+        for (uint j = 0; j < n; j++){
+            uint my_id  = i0 + j + 1 + n_PIs + n_Flops;
+            uint lit0   = 2*my_id - deltas[2*j];
+            uint lit1   = lit0 - deltas[2*j + 1];
+            Wire w_and  = N[aig2nl[my_id]]; assert_debug(w_and == gate_And);
+            Wire w0     = N[aig2nl[lit0 >> 1]] ^ (lit0 & 1);
+            Wire w1     = N[aig2nl[lit1 >> 1]] ^ (lit1 & 1);
+            w_and.set(0, w0);
+            w_and.set(1, w1);
+        }
     }
 
 #if 0
@@ -231,17 +233,32 @@ void readAiger(In& in, Gig& N, bool verif_problem)
         throw Excp_AigerParseError(String("Unexpected end-of-file."));
     }catch (Excp_ParseNum err){
         throw Excp_AigerParseError(String("Incorrect number encoding: ") + Excp_ParseNum::Type_name[err.type]);
+    }catch (Excp_InZstreamError){
+        throw Excp_AigerParseError(String("Corrupt gzip stream."));
     }
 }
 
 
+// Opens files the same way as 'InFile' but decompresses gzipped files on a separate thread
+// (if compiled with 'ZZ_PTHREADS'), overlapping it with parsing.
 void readAigerFile(String filename, Gig& N, bool verif_problem)
 {
-    InFile in(filename);
-    if (in.null())
+    bool gzipped = hasExtension(filename, "gz");
+    File file(filename, "r");
+    if (file.null() && !gzipped){
+        file.open(filename + ".gz", "r");
+        gzipped = true; }
+    if (file.null())
         throw Excp_AigerParseError(String("Could not open: ") + filename);
 
-    readAiger(in, N, verif_problem);
+    if (gzipped){
+        GunzipReader gz(file);
+        In in(gz);
+        readAiger(in, N, verif_problem);
+    }else{
+        In in(file);
+        readAiger(in, N, verif_problem);
+    }
 }
 
 
@@ -266,56 +283,69 @@ struct GetNum {
 };
 
 
-void writeAiger(Out& out, const Gig& N, Array<uchar> comment)
+// AND-gate number 'i' in the order they are written; either gate order or 'order' (if non-empty).
+static inline
+Wire aigerAnd(const Gig& N, const Vec<GLit>& order, uind i)
 {
-    // Compute mapping:
-    WMap<uind> n2a;     // -- map wire in 'N' to AIGER literal.
-    n2a(N.True()) = 1;
+    Wire w = (order.size() == 0) ? N[i] : N[order[i]];
+    return (w.isRemoved() || w != gate_And) ? Wire_NULL : w;
+}
+
 
+// Gates are numbered by a flat array and written straight from the netlist; unless the netlist
+// is not topologically sorted, no intermediate gate order is stored.
+void writeAiger(Out& out, const Gig& N, Array<uchar> comment)
+{
+    // If netlist is already topologically sorted, use that order (reordering can be invasive):
     Vec<GLit> order;
-    {
-        WZet seen;
-        bool is_ordered = true;
-        For_Gates(N, w){    // -- if netlist is already topologically sorted, use that order (reordering can be invasive)
-            if (w == gate_And && (!seen.has(w[0]) || !seen.has(w[1]))){
-                is_ordered = false;
-                break;
-            }
-            seen.add(w);
-            order.push(w);
-        }
-        if (!is_ordered)
+    For_Gates(N, w){
+        if (w == gate_And && ((w[0].id > w.id && w[0] == gate_And) || (w[1].id > w.id && w[1] == gate_And))){
             upOrder(N, order);
+            break; }
     }
+    uind first = (order.size() == 0) ? (uind)gid_FirstUser : 0;
+    uind end   = (order.size() == 0) ? (uind)N.size()      : order.size();
 
     Vec<Wire> is, fs, os;
-    Vec<Wire> as(reserve_, N.typeCount(gate_And));
-    for (uind i = 0; i < order.size(); i++){
-        Wire w = N[order[i]];
-        switch (w.type()){
-        case gate_PI  : is.push(w); break;
-        case gate_FF  : fs.push(w); break;
-        case gate_PO  : os.push(w); break;
-        case gate_And : as.push(w); break;
-        case gate_Seq : break;
-        default: assert(false); }
-    }
+    For_Gatetype(N, gate_PI, w) is.push(w);
+    For_Gatetype(N, gate_FF, w) fs.push(w);
+    For_Gatetype(N, gate_PO, w) os.push(w);
 
     // If numbering is compact, chose that order for the AIGER file:
     sobSort(sob(is, proj_lt(GetNum())));
     sobSort(sob(os, proj_lt(GetNum())));
     sobSort(sob(fs, proj_lt(GetNum())));
 
-    uind piC   = 1;
-    uind flopC = 1 + is.size();
-    uind andC  = 1 + is.size() + fs.size();
-    for (uind i = 0; i < is.size(); i++) n2a(is[i]) = 2 * piC++;
-    for (uind i = 0; i < fs.size(); i++) n2a(fs[i]) = 2 * flopC++;
-    for (uind i = 0; i < as.size(); i++) n2a(as[i]) = 2 * andC++;
+    // Compute mapping:
+    Vec<uint> n2a(N.size(), 0);     // -- map gate ID in 'N' to AIGER literal (unsigned).
+    n2a[gid_True] = 1;
+
+    // Only AIG gates can be expressed; anything else would silently be written as constant 0:
+    For_Gates(N, w){
+        switch (w.type()){
+        case gate_PI: case gate_FF: case gate_PO: case gate_And: case gate_Seq: break;
+        case gate_Const:
+            if (w.lb() == l_Undef)
+                Throw(Excp_AigerWriteError) "Cannot write X-valued constant to AIGER: %_", w;
+            n2a[w.id] = (w.lb() == l_True);
+            break;
+        default:
+            Throw(Excp_AigerWriteError) "Cannot write gate type to AIGER: %_", w;
+        }
+    }
 
+    uint piC   = 1;
+    uint flopC = 1 + is.size();
+    uint andC  = 1 + is.size() + fs.size();
+    for (uind i = 0; i < is.size(); i++) n2a[is[i].id] = 2 * piC++;
+    for (uind i = 0; i < fs.size(); i++) n2a[fs[i].id] = 2 * flopC++;
+    for (uind i = first; i < end; i++){
+        Wire w = aigerAnd(N, order, i);
+        if (w) n2a[w.id] = 2 * andC++; }
+    uint n_ands = andC - (1 + is.size() + fs.size());
 
     // Write header, flops and POs:
-    out += "aig ", is.size() + fs.size() + as.size(), ' ', is.size(), ' ', fs.size(), ' ', os.size(), ' ', as.size(), '\n';
+    out += "aig ", is.size() + fs.size() + n_ands, ' ', is.size(), ' ', fs.size(), ' ', os.size(), ' ', n_ands, '\n';
 
     for (uind i = 0; i < fs.size(); i++){
         if (!fs[i])
@@ -323,7 +353,7 @@ void writeAiger(Out& out, const Gig& N, Array<uchar> comment)
         else{
             Wire w0 = fs[i][0];
             if (w0 == gate_Seq) w0 = w0[0] ^ w0.sign;
-            out += n2a[w0] ^ uind(sign(w0)), '\n';
+            out += n2a[w0.id] ^ uint(sign(w0)), '\n';
         }
     }
     for (uind i = 0; i < os.size(); i++){
@@ -331,15 +361,16 @@ void writeAiger(Out& out, const Gig& N, Array<uchar> comment)
             out += '0', '\n';
         else{
             Wire w0 = os[i][0];     // -- missing primary inputs are constant 0
-            out += n2a[w0] ^ uind(sign(w0)), '\n';
+            out += n2a[w0.id] ^ uint(sign(w0)), '\n';
         }
     }
 
-    for (uind i = 0; i < as.size(); i++){
-        Wire w = as[i];
-        uind idx_w  = n2a[w];
-        uind idx_w0 = n2a[w[0]] ^ uind(sign(w[0]));
-        uind idx_w1 = n2a[w[1]] ^ uind(sign(w[1]));
+    for (uind i = first; i < end; i++){
+        Wire w = aigerAnd(N, order, i);
+        if (!w) continue;
+        uint idx_w  = n2a[w.id];
+        uint idx_w0 = n2a[w[0].id] ^ uint(sign(w[0]));
+        uint idx_w1 = n2a[w[1].id] ^ uint(sign(w[1]));
         assert(idx_w > idx_w0); assert(idx_w > idx_w1);    // -- the topological order should assign a higher index to 'w'
         if (idx_w0 < idx_w1) swp(idx_w0, idx_w1);
         putu(out, idx_w - idx_w0);
@@ -24,6 +24,7 @@ using namespace std;
 
 
 Declare_Exception(Excp_AigerParseError);
+Declare_Exception(Excp_AigerWriteError);
 
 void readAiger    (In& in         , Gig& N, bool verif_prob);
 void readAigerFile(String filename, Gig& N, bool verif_prob);
@@ -31,7 +32,8 @@ void readAigerFile(String filename, Gig& N, bool verif_prob);
 
 void writeAiger    (Out& out       , const Gig& N, Array<uchar> comment = Array<uchar>());
 bool writeAigerFile(String filename, const Gig& N, Array<uchar> comment = Array<uchar>());
-    // -- returns FALSE if file could not be created.
+    // -- returns FALSE if file could not be created. Throws 'Excp_AigerWriteError' if 'N' contains
+    // gates other than PI, FF, PO, And, Seq or (non-X) Const.
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -0,0 +1,117 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Main_aiger_test.cc
+//| Module      : IO
+//| Description : Checks which gate types the AIGER writer accepts.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Netlists with gates that have no AIGER counterpart must be rejected with 'Excp_AigerWriteError'
+//| rather than written with those gates replaced by constant 0.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "ZZ_Gig.IO.hh"
+
+using namespace ZZ;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+static uint n_errors = 0;
+
+
+static
+bool writeFails(const Gig& N)
+{
+    Out out;
+    try{
+        writeAiger(out, N);
+    }catch (Excp_AigerWriteError){
+        return true;
+    }
+    return false;
+}
+
+
+// An AIG plus one gate of type 'type' (fed by the PIs, observed by a PO) must be rejected.
+static
+void checkRejected(GateType type, uint attr = 0)
+{
+    Gig N;
+    Wire x = N.add(gate_PI);
+    Wire y = N.add(gate_PI);
+    N.add(gate_PO).init(N.add(gate_And).init(x, ~y));
+
+    Wire w = (attr != 0) ? N.add(type, attr) : N.add(type);
+    for (uint i = 0; i < w.size(); i++)
+        w.set(i, (i & 1) ? y : x);
+    N.add(gate_PO).init(w);
+
+    if (!writeFails(N)){
+        ShoutLn "ERROR! Gate type %_ was not rejected.", GateType_name[type];
+        n_errors++; }
+}
+
+
+// Constants and ANDs survive a round trip.
+static
+void checkRoundTrip()
+{
+    Gig N;
+    Wire x = N.add(gate_PI);
+    Wire y = N.add(gate_PI);
+    Wire t = N.add(gate_Const); t.lb_set(l_True);
+    Wire f = N.add(gate_Const); f.lb_set(l_False);
+    N.add(gate_PO).init(t);
+    N.add(gate_PO).init(~f);
+    N.add(gate_PO).init(f);
+    N.add(gate_PO).init(N.add(gate_And).init(x, ~y));
+
+    Out out;
+    writeAiger(out, N);
+
+    Gig M;
+    In in(out.vec().base(), out.vec().size());
+    readAiger(in, M, false);
+
+    Vec<GLit> outs(4, GLit_NULL);
+    For_Gatetype(M, gate_PO, w)
+        if (w.num() < 4) outs[w.num()] = w[0];
+
+    if (outs[0] != GLit_True || outs[1] != GLit_True || outs[2] != ~GLit_True
+    ||  M.typeCount(gate_And) != 1 || !(outs[3] + M == gate_And))
+    {
+        ShoutLn "ERROR! Constants or AND gate not preserved by AIGER round trip.";
+        n_errors++;
+    }
+
+    Gig X;
+    Wire u = X.add(gate_Const);
+    X.add(gate_PO).init(u);
+    if (!writeFails(X)){
+        ShoutLn "ERROR! X-valued constant was not rejected.";
+        n_errors++; }
+}
+
+
+int main(int argc, char** argv)
+{
+    ZZ_Init;
+
+    checkRoundTrip();
+
+    checkRejected(gate_Xor);
+    checkRejected(gate_Mux);
+    checkRejected(gate_Buf);
+    checkRejected(gate_Lut4, 0x6666);
+    checkRejected(gate_Npn4, 1);
+    checkRejected(gate_Lut6);
+
+    if (n_errors > 0){
+        ShoutLn "%_ AIGER writer checks failed.", n_errors;
+        return 1; }
+
+    WriteLn "All AIGER writer checks passed.";
+    return 0;
+}
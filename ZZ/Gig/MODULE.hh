@@ -1 +1,2 @@
 #include "ZZ/Gig/StdLib.hh"
+#include "ZZ/Gig/GigSim.hh"
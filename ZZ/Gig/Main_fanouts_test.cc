@@ -0,0 +1,219 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Main_fanouts_test.cc
+//| Module      : Gig
+//| Description : Randomized consistency test for the dynamic fanout database.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Edits a random AIG with "DynamicFanouts" attached, and after every batch of edits compares the
+//| database against fanouts computed from scratch. Also checks after 'compact()', and calls the
+//| object's own 'compact()' directly with a remap that merges gates (which 'Gig::compact()'
+//| never produces) to exercise the block merging.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "StdLib.hh"
+#include "ZZ/Generics/Sort.hh"
+
+using namespace ZZ;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+// A connect as (signed parent, pin); sorted and compared as a multiset.
+typedef Pair<uint64,uint> Conn;
+
+macro Conn mkConn(GLit parent, uint pin) { return make_tuple((uint64(parent.id) << 1) | parent.sign, pin); }
+
+
+static
+Wire randGate(Gig& N, uint64& seed, gate_id lim)
+{
+    for (uint n = 0; n < 64; n++){
+        Wire w = N[irand(seed, lim)];
+        if (!w.isRemoved() && (w == gate_PI || w == gate_And))
+            return w ^ bool(irand(seed, 2));
+    }
+    return N.False() ^ bool(irand(seed, 2));
+}
+
+
+// Expected fanouts of every gate, with gate IDs translated by 'remap' the way
+// 'GigObj_DynamicFanouts::compact()' does (the parent's sign is dropped, the child's sign kept).
+static
+void refFanouts(const Gig& N, const GigRemap& remap, Vec<Vec<Conn> >& ref)
+{
+    for (uint i = 0; i < ref.size(); i++) ref[i].clear();
+    ref.growTo(N.size());
+
+    For_Gates(N, w){
+        gate_id parent = remap(w.id);
+        if (parent == gid_NULL) continue;
+        For_Inputs(w, v){
+            GLit child = remap(v.lit());
+            if (child)
+                ref[child.id].push(mkConn(GLit(parent, child.sign), Input_Pin(v)));
+        }
+    }
+    for (uint i = 0; i < ref.size(); i++)
+        sort(ref[i]);
+}
+
+
+static
+void identityRemap(const Gig& N, GigRemap& remap)
+{
+    remap.new_lit.clear();
+    for (gate_id i = 0; i < N.size(); i++)
+        remap.new_lit.push(GLit(i));
+}
+
+
+static uint n_errors = 0;
+
+static
+void check(Gig& N, const GigRemap& remap, cchar* where)
+{
+    Vec<Vec<Conn> > ref;
+    refFanouts(N, remap, ref);
+
+    Vec<Conn> got;
+    For_All_Gates(N, w){
+        if (w.isRemoved()) continue;
+        Fanouts fs = dynFanouts(w);
+        got.clear();
+        for (uint i = 0; i < fs.size(); i++)
+            got.push(mkConn(fs[i].lit(), fs[i].pin));
+        sort(got);
+
+        if (!vecEqual(got, ref[w.id])){
+            if (n_errors < 10)
+                ShoutLn "MISMATCH (%_) at %_: got %_ fanouts, expected %_", where, w, got.size(), ref[w.id].size();
+            n_errors++;
+        }
+    }
+}
+
+static
+void check(Gig& N, cchar* where)
+{
+    GigRemap remap;
+    identityRemap(N, remap);
+    check(N, remap, where);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+// New fanins are always taken from lower IDs, so the netlist stays acyclic (the gate table
+// is topologically ordered to begin with, and stays so through 'compact()'). Removed IDs are
+// recycled, so new gates may land anywhere.
+static
+void randomEdits(Gig& N, uint64& seed, uint n_edits)
+{
+    for (uint n = 0; n < n_edits; n++){
+        uint action = irand(seed, 10);
+        if (action < 6){
+            // Rewire a fanin:
+            Wire w = N[irand(seed, N.size())];
+            if (w.isRemoved() || (w != gate_And && w != gate_PO)) continue;
+            uint pin = (w == gate_And) ? irand(seed, 2) : 0;
+            w.set(pin, randGate(N, seed, w.id));
+
+        }else if (action < 9){
+            // Add a gate, and sometimes make it observable:
+            Wire w = N.add(gate_And);   // -- may recycle the ID of a removed gate
+            w.set(0, randGate(N, seed, w.id));
+            w.set(1, randGate(N, seed, w.id));
+            if (irand(seed, 4) == 0)
+                N.add(gate_PO).init(w);
+
+        }else{
+            // Remove a dangling gate:
+            Wire w = N[irand(seed, N.size())];
+            if (!w.isRemoved() && w == gate_And && dynFanouts(w).size() == 0)
+                remove(w);
+        }
+    }
+}
+
+
+static
+void buildRandom(Gig& N, uint64& seed, uint n_pis, uint n_ands, uint n_pos)
+{
+    for (uint i = 0; i < n_pis; i++)
+        N.add(gate_PI);
+    for (uint i = 0; i < n_ands; i++){
+        Wire w = N.add(gate_And);
+        w.set(0, randGate(N, seed, w.id));
+        w.set(1, randGate(N, seed, w.id));
+    }
+    for (uint i = 0; i < n_pos; i++){
+        Wire w = N.add(gate_PO);
+        w.set(0, randGate(N, seed, w.id));
+    }
+}
+
+
+// Let 'GigObj_DynamicFanouts::compact()' merge every 'n'th AND gate into its predecessor (sometimes
+// negated). The netlist itself is not changed, so the object is dropped afterwards.
+static
+void mergeTest(Gig& N, uint64& seed, uint n)
+{
+    GigRemap remap;
+    identityRemap(N, remap);
+    gate_id prev = gid_NULL;
+    uint    k = 0;
+    For_Gates(N, w){
+        if (w != gate_And) continue;
+        if (prev != gid_NULL && ++k % n == 0)
+            remap.new_lit[w.id] = GLit(prev, irand(seed, 2));
+        else
+            prev = w.id;
+    }
+
+    GigObj& obj = N.getObj(gigobj_DynamicFanouts);
+    obj.compact(remap);
+    check(N, remap, "merge");
+    N.removeObj(gigobj_DynamicFanouts);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+int main(int argc, char** argv)
+{
+    ZZ_Init;
+
+    uint64 seed = (argc > 1) ? atoll(argv[1]) : 42;
+    uint   rounds = (argc > 2) ? atoi(argv[2]) : 20;
+
+    for (uint r = 0; r < rounds; r++){
+        Gig N;
+        buildRandom(N, seed, 16, 200 + irand(seed, 800), 16);
+        N.addObj(gigobj_DynamicFanouts);
+        check(N, "init");
+
+        for (uint b = 0; b < 10; b++){
+            randomEdits(N, seed, 500);
+            check(N, "edit");
+
+            if (b % 3 == 2){
+                N.compact(irand(seed, 2), irand(seed, 2));
+                check(N, "compact");
+            }
+        }
+
+        mergeTest(N, seed, 1 + irand(seed, 3));
+    }
+
+    if (n_errors > 0){
+        ShoutLn "%_ fanout mismatches.", n_errors;
+        return 1; }
+
+    WriteLn "All fanout checks passed.";
+    return 0;
+}
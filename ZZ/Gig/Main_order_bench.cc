@@ -0,0 +1,193 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Main_order_bench.cc
+//| Module      : Gig
+//| Description : Measures how the gate order left by 'compact()' affects traversal speed.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Builds an array multiplier as an AIG, scatters it into a level-by-level order, and compacts it
+//| with and without DFS layout. Each result is timed on two sweeps: bit-parallel simulation in gate
+//| table order, and 'upOrder()'. 'near' is the fraction of fanins at most 4 (64) IDs away.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "StdLib.hh"
+#include "ZZ/Generics/Sort.hh"
+
+using namespace ZZ;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+static Wire mkAnd(Gig& N, Wire u, Wire v) { return N.add(gate_And).init(u, v); }
+static Wire mkOr (Gig& N, Wire u, Wire v) { return ~mkAnd(N, ~u, ~v); }
+static Wire mkXor(Gig& N, Wire u, Wire v) { return mkOr(N, mkAnd(N, u, ~v), mkAnd(N, ~u, v)); }
+
+
+// 'n' by 'n' bit array multiplier with ripple carry rows.
+static
+void buildMult(Gig& N, uint n)
+{
+    Vec<Wire> a, b;
+    for (uint i = 0; i < n; i++) a.push(N.add(gate_PI));
+    for (uint i = 0; i < n; i++) b.push(N.add(gate_PI));
+
+    Vec<Wire> acc;
+    for (uint i = 0; i < n; i++)
+        acc.push(mkAnd(N, a[i], b[0]));
+    acc.push(N.False());
+
+    for (uint j = 1; j < n; j++){
+        N.add(gate_PO).init(acc[0]);
+        Wire carry = N.False();
+        for (uint i = 0; i < n; i++){
+            Wire p = mkAnd(N, a[i], b[j]);
+            Wire x = mkXor(N, acc[i+1], p);
+            Wire s = mkXor(N, x, carry);
+            carry  = mkOr(N, mkAnd(N, acc[i+1], p), mkAnd(N, x, carry));
+            acc[i] = s;
+        }
+        acc[n] = carry;
+    }
+    for (uint i = 0; i < acc.size(); i++)
+        N.add(gate_PO).init(acc[i]);
+}
+
+
+// Copy 'N' into 'M' in the given topological order (a permutation of the gates of 'N').
+static
+void copyInOrder(const Gig& N, const Vec<GLit>& order, Gig& M)
+{
+    WMapX<GLit> xlat;
+    xlat.initBuiltins();
+    for (uint i = 0; i < order.size(); i++)
+        copyGate(order[i] + N, M, xlat);
+}
+
+
+// Gates sorted on logic level, random order within a level.
+static
+void levelOrder(const Gig& N, Vec<GLit>& order)
+{
+    Vec<GLit> topo;
+    upOrder(N, topo);
+
+    Vec<uint> level(N.size(), 0);
+    for (uint i = 0; i < topo.size(); i++){
+        Wire w = topo[i] + N;
+        For_Inputs(w, v)
+            newMax(level[w.id], level[v.id] + 1);
+    }
+
+    uint64 seed = 42;
+    Vec<Pair<uint64,GLit> > tmp;
+    for (uint i = 0; i < topo.size(); i++)
+        tmp.push(make_tuple((uint64(level[topo[i].id]) << 32) | irand(seed, 0x7FFFFFFF), topo[i]));
+    sort(tmp);
+
+    order.clear();
+    for (uint i = 0; i < tmp.size(); i++)
+        order.push(tmp[i].snd);
+}
+
+
+static
+double simSweep(const Gig& N, uint rounds)
+{
+    Vec<uint64> sim(N.size(), 0);
+    uint64 seed = 1;
+    double T0 = cpuTime();
+    for (uint r = 0; r < rounds; r++){
+        For_Gates(N, w){
+            if (w == gate_PI)
+                sim[w.id] = (uint64(irand(seed, 0x7FFFFFFF)) << 32) ^ irand(seed, 0x7FFFFFFF);
+            else if (w == gate_And)
+                sim[w.id] = (sim[w[0].id] ^ -uint64(w[0].sign)) & (sim[w[1].id] ^ -uint64(w[1].sign));
+            else if (w == gate_PO)
+                sim[w.id] = sim[w[0].id] ^ -uint64(w[0].sign);
+        }
+    }
+    return (cpuTime() - T0) / rounds;
+}
+
+
+static
+double orderSweep(const Gig& N, uint rounds)
+{
+    double T0 = cpuTime();
+    for (uint r = 0; r < rounds; r++){
+        Vec<GLit> order;
+        upOrder(N, order);
+    }
+    return (cpuTime() - T0) / rounds;
+}
+
+
+// Fraction of fanins at most 'lim' gate IDs away from their fanout.
+static
+double nearFanins(const Gig& N, uint lim)
+{
+    uint64 near = 0, cnt = 0;
+    For_Gates(N, w){
+        For_Inputs(w, v){
+            if (v.id >= gid_FirstUser){
+                if (w.id - v.id <= lim) near++;
+                cnt++;
+            }
+        }
+    }
+    return double(near) / cnt;
+}
+
+
+static
+void report(cchar* name, const Gig& N, uint rounds)
+{
+    assert(isCanonical(N));
+    double T_sim = simSweep(N, rounds);
+    double T_up  = orderSweep(N, rounds);
+    WriteLn "%<26%_ near: %>5%.1f%% %>5%.1f%%   sim: %>9%t (%>6%.1f Mgates/s)   upOrder: %>9%t (%>6%.1f Mgates/s)",
+        name, nearFanins(N, 4) * 100, nearFanins(N, 64) * 100, T_sim, N.count() / T_sim / 1e6, T_up, N.count() / T_up / 1e6;
+}
+
+
+int main(int argc, char** argv)
+{
+    ZZ_Init;
+
+    if (argc > 3 || (argc > 1 && argv[1][0] == '-')){
+        ShoutLn "USAGE: order_bench.exe [<multiplier width>] [<rounds>]";
+        exit(1); }
+    uint n      = (argc > 1) ? atoi(argv[1]) : 512;
+    uint rounds = (argc > 2) ? atoi(argv[2]) : 5;
+
+    Gig N0;
+    buildMult(N0, n);
+    WriteLn "Multiplier %_x%_: %,d gates", n, n, N0.count();
+    NewLine;
+
+    report("construction order", N0, rounds);
+
+    // A scattered, but still topological, starting point:
+    Vec<GLit> order;
+    levelOrder(N0, order);
+    Gig N;
+    copyInOrder(N0, order, N);
+    report("level order", N, rounds);
+
+    Gig M;
+    N.copyTo(M);
+    M.compact(false, false);
+    report("compact(false, false)", M, rounds);
+
+    N.copyTo(M);
+    M.compact(false);
+    report("compact(false)", M, rounds);
+
+    N.copyTo(M);
+    M.compact();
+    report("compact()", M, rounds);
+
+    return 0;
+}
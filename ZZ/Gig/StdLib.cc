@@ -344,6 +344,7 @@ void normalizeLut4s(Gig& N, bool ban_constant_luts)
 // NOTE! If LUTs have inputs not in the support if it's FTB, those inputs may end up unreachable.
 void putIntoNpn4(Gig& N, WSeen* out_inverted)
 {
+    npn4Init();
     uint64 mask = gtm_XigLogic | GTM_(Buf) | GTM_(Not) | GTM_(Or) | GTM_(Equiv) | GTM_(Lut4);
 
     WSeen inverted;
@@ -25,9 +25,14 @@ using namespace std;
 
 
 // Pre-hash: gate does not yet exist
-macro uint64 prehash_Bin(GLit p, GLit q) { return defaultHash(make_tuple(p, q)); }
-macro uint64 prehash_Tri(GLit p, GLit q, GLit r) { return defaultHash(make_tuple(p, q, r)); }
-macro uint64 prehash_Lut(GLit p, GLit q, GLit r, GLit s, uint arg) { return defaultHash(make_tuple(make_tuple(p, q, r, s), arg)); }
+macro uint64 prehash_Bin(GLit p, GLit q) {
+    return strashMix((uint64(p.data()) << 32) | q.data()); }
+
+macro uint64 prehash_Tri(GLit p, GLit q, GLit r) {
+    return strashMix(((uint64(p.data()) << 32) | q.data()) ^ strashMix(r.data())); }
+
+macro uint64 prehash_Lut(GLit p, GLit q, GLit r, GLit s, uint arg) {
+    return strashMix(((uint64(p.data()) << 32) | q.data()) ^ strashMix(((uint64(r.data()) << 32) | s.data()) ^ strashMix(arg))); }
 
 
 // Re-hash: gate exists in netlist
@@ -38,7 +43,7 @@ template<> fts_macro uint64 rehash<ght_Tri>(Wire w) { return prehash_Tri(w[0], w
 template<> fts_macro uint64 rehash<ght_Lut>(Wire w) { return prehash_Lut(w[0], w[1], w[2], w[3], w.arg()); }
 
 
-// 'GateHash's hash methods:
+// 'GateHash's hash method:
 template<GateHashType htype>
 inline uint64 GateHash<htype>::hash(GLit p) const
 {
@@ -47,32 +52,26 @@ inline uint64 GateHash<htype>::hash(GLit p) const
 }
 
 
-template<>
-inline bool GateHash<ght_Bin>::equal(GLit p, GLit q) const
-{
-    Wire u = p + *obj.N;
-    Wire v = q + *obj.N;
-    return u[0] == v[0] && u[1] == v[1];
-}
+// Lookup predicates (gate has these inputs):
+struct GateMatch_Bin {
+    const Gig& N; GLit d0, d1;
+    GateMatch_Bin(const Gig& N_, GLit d0_, GLit d1_) : N(N_), d0(d0_), d1(d1_) {}
+    bool operator()(GLit p) const { Wire w = p + N; return w[0] == d0 && w[1] == d1; }
+};
 
 
-template<>
-inline bool GateHash<ght_Tri>::equal(GLit p, GLit q) const
-{
-    Wire u = p + *obj.N;
-    Wire v = q + *obj.N;
-    return u[0] == v[0] && u[1] == v[1] && u[2] == v[2];
-}
+struct GateMatch_Tri {
+    const Gig& N; GLit d0, d1, d2;
+    GateMatch_Tri(const Gig& N_, GLit d0_, GLit d1_, GLit d2_) : N(N_), d0(d0_), d1(d1_), d2(d2_) {}
+    bool operator()(GLit p) const { Wire w = p + N; return w[0] == d0 && w[1] == d1 && w[2] == d2; }
+};
 
 
-
-template<>
-inline bool GateHash<ght_Lut>::equal(GLit p, GLit q) const
-{
-    Wire u = p + *obj.N;
-    Wire v = q + *obj.N;
-    return u[0] == v[0] && u[1] == v[1] && u[2] == v[2] && u[3] == v[3] && u.arg() == v.arg();
-}
+struct GateMatch_Lut {
+    const Gig& N; GLit d0, d1, d2, d3; uint arg;
+    GateMatch_Lut(const Gig& N_, GLit d0_, GLit d1_, GLit d2_, GLit d3_, uint arg_) : N(N_), d0(d0_), d1(d1_), d2(d2_), d3(d3_), arg(arg_) {}
+    bool operator()(GLit p) const { Wire w = p + N; return w[0] == d0 && w[1] == d1 && w[2] == d2 && w[3] == d3 && w.arg() == arg; }
+};
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -105,28 +104,29 @@ GigObj_Strash::~GigObj_Strash()
 }
 
 
-// Assumes a strashed netlist with an empty 'strash' object.
+// Assumes a strashed netlist. Tables are sized from the gate counts up front, and gates are
+// inserted without looking for duplicates.
 void GigObj_Strash::rehashNetlist()
 {
-    and_nodes.clear();
-    xor_nodes.clear();
-    mux_nodes.clear();
-    maj_nodes.clear();
-    one_nodes.clear();
-    gmb_nodes.clear();
-    dot_nodes.clear();
-    lut_nodes.clear();
-
-    For_UpOrder(*N, w){
+    and_nodes.clear(); and_nodes.reserve(N->typeCount(gate_And));
+    xor_nodes.clear(); xor_nodes.reserve(N->typeCount(gate_Xor));
+    mux_nodes.clear(); mux_nodes.reserve(N->typeCount(gate_Mux));
+    maj_nodes.clear(); maj_nodes.reserve(N->typeCount(gate_Maj));
+    one_nodes.clear(); one_nodes.reserve(N->typeCount(gate_One));
+    gmb_nodes.clear(); gmb_nodes.reserve(N->typeCount(gate_Gamb));
+    dot_nodes.clear(); dot_nodes.reserve(N->typeCount(gate_Dot));
+    lut_nodes.clear(); lut_nodes.reserve(N->typeCount(gate_Lut4));
+
+    For_Gates(*N, w){
         switch (w.type()){
-        case gate_And:  { bool ok = !and_nodes.add(w); assert(ok); break; }
-        case gate_Xor:  { bool ok = !xor_nodes.add(w); assert(ok); break; }
-        case gate_Mux:  { bool ok = !mux_nodes.add(w); assert(ok); break; }
-        case gate_Maj:  { bool ok = !maj_nodes.add(w); assert(ok); break; }
-        case gate_One:  { bool ok = !one_nodes.add(w); assert(ok); break; }
-        case gate_Gamb: { bool ok = !gmb_nodes.add(w); assert(ok); break; }
-        case gate_Dot:  { bool ok = !dot_nodes.add(w); assert(ok); break; }
-        case gate_Lut4: { bool ok = !lut_nodes.add(w); assert(ok); break; }
+        case gate_And:  and_nodes.insert(rehash<ght_Bin>(w), w); break;
+        case gate_Xor:  xor_nodes.insert(rehash<ght_Bin>(w), w); break;
+        case gate_Mux:  mux_nodes.insert(rehash<ght_Tri>(w), w); break;
+        case gate_Maj:  maj_nodes.insert(rehash<ght_Tri>(w), w); break;
+        case gate_One:  one_nodes.insert(rehash<ght_Tri>(w), w); break;
+        case gate_Gamb: gmb_nodes.insert(rehash<ght_Tri>(w), w); break;
+        case gate_Dot:  dot_nodes.insert(rehash<ght_Tri>(w), w); break;
+        case gate_Lut4: lut_nodes.insert(rehash<ght_Lut>(w), w); break;
         default: ;/*nothing*/ }
     }
 }
@@ -158,84 +158,42 @@ void GigObj_Strash::removing(Wire w, bool)
 // -- Hashed gate creation:
 
 
-template<class SET>
-fts_macro GLit lookup_helper(SET& nodes, Gig& N, GLit d0, GLit d1, uind idx)
-{
-    void* cell = nodes.firstCell(idx);
-    while (cell){
-        Wire w = nodes.key(cell) + N;
-        if (w[0] == d0 && w[1] == d1)
-            return w;
-        cell = nodes.nextCell(cell);
-    }
-    return GLit_NULL;
-}
-
-
-template<class SET>
-fts_macro GLit lookup_helper(SET& nodes, Gig& N, GLit d0, GLit d1, GLit d2, uind idx)
-{
-    void* cell = nodes.firstCell(idx);
-    while (cell){
-        Wire w = nodes.key(cell) + N;
-        if (w[0] == d0 && w[1] == d1 && w[2] == d2)
-            return w;
-        cell = nodes.nextCell(cell);
-    }
-    return GLit_NULL;
-}
-
-
-template<class SET>
-fts_macro GLit lookup_helper(SET& nodes, Gig& N, GLit d0, GLit d1, GLit d2, GLit d3, uint arg, uind idx)
-{
-    void* cell = nodes.firstCell(idx);
-    while (cell){
-        Wire w = nodes.key(cell) + N;
-        if (w[0] == d0 && w[1] == d1 && w[2] == d2 && w[3] == d3 && w.arg() == arg)
-            return w;
-        cell = nodes.nextCell(cell);
-    }
-    return GLit_NULL;
-}
-
-
-template<class SET>
-fts_macro GLit add_Bin(SET& nodes, GateType type, Gig& N, GLit u, GLit v, bool just_try)
+template<class TAB>
+fts_macro GLit add_Bin(TAB& nodes, GateType type, Gig& N, GLit u, GLit v, bool just_try)
 {
-    uind   idx = nodes.index_(prehash_Bin(u, v));
-    GLit   w   = lookup_helper(nodes, N, u, v, idx);
+    uint64 h = prehash_Bin(u, v);
+    GLit   w = nodes.lookup(h, GateMatch_Bin(N, u, v));
     if (!w && !just_try){
         w = GLit(N.addInternal(type, 2, /*arg*/0, true));
         N[w].set_unchecked(0, u);
         N[w].set_unchecked(1, v);
-        nodes.newEntry(idx, w);
+        nodes.insert(h, w);
     }
     return w;
 }
 
 
-template<class SET>
-fts_macro GLit add_Tri(SET& nodes, GateType type, Gig& N, GLit p, GLit q, GLit r, bool just_try)
+template<class TAB>
+fts_macro GLit add_Tri(TAB& nodes, GateType type, Gig& N, GLit p, GLit q, GLit r, bool just_try)
 {
-    uind   idx = nodes.index_(prehash_Tri(p, q, r));
-    GLit   w   = lookup_helper(nodes, N, p, q, r, idx);
+    uint64 h = prehash_Tri(p, q, r);
+    GLit   w = nodes.lookup(h, GateMatch_Tri(N, p, q, r));
     if (!w && !just_try){
         w = GLit(N.addInternal(type, 3, /*arg*/0, true));
         N[w].set_unchecked(0, p);
         N[w].set_unchecked(1, q);
         N[w].set_unchecked(2, r);
-        nodes.newEntry(idx, w);
+        nodes.insert(h, w);
     }
     return w;
 }
 
 
-template<class SET>
-fts_macro GLit add_Lut(SET& nodes, GateType type, Gig& N, GLit p, GLit q, GLit r, GLit s, uint arg, bool just_try)
+template<class TAB>
+fts_macro GLit add_Lut(TAB& nodes, GateType type, Gig& N, GLit p, GLit q, GLit r, GLit s, uint arg, bool just_try)
 {
-    uind   idx = nodes.index_(prehash_Lut(p, q, r, s, arg));
-    GLit   w   = lookup_helper(nodes, N, p, q, r, s, arg, idx);
+    uint64 h = prehash_Lut(p, q, r, s, arg);
+    GLit   w = nodes.lookup(h, GateMatch_Lut(N, p, q, r, s, arg));
     if (!w && !just_try){
         w = GLit(N.addInternal(type, 4, arg, true));
         N[w].set_unchecked(0, p);
@@ -243,7 +201,7 @@ fts_macro GLit add_Lut(SET& nodes, GateType type, Gig& N, GLit p, GLit q, GLit r
         N[w].set_unchecked(2, r);
         N[w].set_unchecked(3, s);
         N[w].arg_set(arg);
-        nodes.newEntry(idx, w);
+        nodes.insert(h, w);
     }
     return w;
 }
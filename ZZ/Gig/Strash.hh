@@ -15,7 +15,7 @@
 #define ZZ__Gig__Strash_hh
 
 #include "Gig.hh"
-#include "ZZ/Generics/Set.hh"
+#include "StrashTab.hh"
 
 namespace ZZ {
 using namespace std;
@@ -38,7 +38,6 @@ struct GateHash {
     GateHash(const GigObj& obj_) : obj(obj_) {}
 
     uint64 hash(GLit p) const;
-    bool   equal(GLit p, GLit q) const;
 };
 
 
@@ -47,18 +46,18 @@ struct GateHash {
 
 
 class GigObj_Strash : public GigObj, public GigLis {
-    Set<GLit,GateHash<ght_Bin> >  and_nodes;
-    Set<GLit,GateHash<ght_Bin> >  xor_nodes;
-    Set<GLit,GateHash<ght_Tri> >  mux_nodes;
-    Set<GLit,GateHash<ght_Tri> >  maj_nodes;
-    Set<GLit,GateHash<ght_Tri> >  one_nodes;
-    Set<GLit,GateHash<ght_Tri> >  gmb_nodes;
-    Set<GLit,GateHash<ght_Tri> >  dot_nodes;
-    Set<GLit,GateHash<ght_Lut> >  lut_nodes;
+    StrashTab<GateHash<ght_Bin> >  and_nodes;
+    StrashTab<GateHash<ght_Bin> >  xor_nodes;
+    StrashTab<GateHash<ght_Tri> >  mux_nodes;
+    StrashTab<GateHash<ght_Tri> >  maj_nodes;
+    StrashTab<GateHash<ght_Tri> >  one_nodes;
+    StrashTab<GateHash<ght_Tri> >  gmb_nodes;
+    StrashTab<GateHash<ght_Tri> >  dot_nodes;
+    StrashTab<GateHash<ght_Lut> >  lut_nodes;
 
     bool initializing;      // -- Set during execution of 'strashNetlist()' to modify the behavior of 'removing()'
 
-    void rehashNetlist();   // -- Assumes a strashed netlist with an empty 'strash' object.
+    void rehashNetlist();   // -- Bulk rebuild of the tables. Assumes a strashed netlist.
     void strashNetlist();   // -- Rebuilds netlist bottom-up and removes redundant nodes.
 
 public:
@@ -0,0 +1,238 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : StrashTab.hh
+//| Module      : Gig
+//| Description : Open addressing hash table for structural hashing.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Keys are gates ('GLit's); the gate itself holds the hashed data (its inputs), so the table
+//| only stores the key plus one control byte per slot. The control byte is either 'Empty',
+//| 'Deleted' or the top 7 bits of the key's hash ("fingerprint"). A lookup loads 16 control
+//| bytes at a time (one SSE2 compare) and only inspects gates whose fingerprint matches, which
+//| typically means zero or one gate dereference per lookup.
+//|________________________________________________________________________________________________
+
+#ifndef ZZ__Gig__StrashTab_hh
+#define ZZ__Gig__StrashTab_hh
+
+#include "BasicTypes.hh"
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
+namespace ZZ {
+using namespace std;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Helpers:
+
+
+// Finalizer of MurmurHash3; the table uses both the low bits (slot) and the high bits
+// (fingerprint) of a hash value, so these must be well mixed.
+macro uint64 strashMix(uint64 h)
+{
+    h ^= h >> 33;
+    h *= 0xFF51AFD7ED558CCDull;
+    h ^= h >> 33;
+    h *= 0xC4CEB9FE1A85EC53ull;
+    h ^= h >> 33;
+    return h;
+}
+
+
+macro uint lowestBitIdx(uint mask)
+{
+  #if defined(__GNUC__)
+    return __builtin_ctz(mask);
+  #else
+    uint i = 0;
+    while ((mask & 1) == 0) mask >>= 1, i++;
+    return i;
+  #endif
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Class 'StrashTab':
+
+
+// 'HASH' must provide 'uint64 hash(GLit) const' (used when the table is resized or an element
+// removed). Lookups take the hash of the (not yet existing) gate and a predicate 'MATCH' with
+// 'bool operator()(GLit) const'. No two keys may be equal under the predicate; 'insert()' does
+// not check this.
+//
+template<class HASH>
+class StrashTab {
+    enum { GROUP = 16 };
+    enum { ctrl_Empty = 0x80, ctrl_Deleted = 0xFE };    // -- fingerprints are in '[0, 0x7F]'
+
+    uchar*  ctrl;       // -- 'cap + GROUP' bytes; the last 'GROUP' bytes mirror the first ones
+    GLit*   slot;
+    uint    cap;        // -- power of two, at least 'GROUP' (or 0 if nothing allocated)
+    uint    sz;         // -- number of keys
+    uint    n_used;     // -- number of non-empty slots (keys + tombstones)
+    HASH    hasher;
+
+    static uchar fingerprint(uint64 h) { return uchar(h >> 57); }
+
+    void setCtrl(uint i, uchar c) {
+        ctrl[i] = c;
+        if (i < GROUP) ctrl[cap + i] = c; }
+
+    uint match(uint pos, uchar c) const;    // -- bit 'i' set if 'ctrl[pos+i] == c'
+    uint matchFree(uint pos) const;         // -- bit 'i' set if 'ctrl[pos+i]' is empty or deleted
+
+    void resize(uint min_keys);
+    void dispose() { xfree(ctrl); xfree(slot); ctrl = NULL; slot = NULL; cap = sz = n_used = 0; }
+
+public:
+    StrashTab(HASH h) : ctrl(NULL), slot(NULL), cap(0), sz(0), n_used(0), hasher(h) {}
+   ~StrashTab() { dispose(); }
+
+    uint size    () const { return sz; }
+    uint capacity() const { return cap; }
+
+    void clear()               { dispose(); }
+    void reserve(uint n_keys)  { if (n_used - sz + n_keys > cap - cap/8) resize(n_keys); }
+        // -- Use before a bulk build to avoid repeated resizing.
+
+    template<class MATCH>
+    GLit lookup(uint64 h, const MATCH& pred) const;
+        // -- Returns 'GLit_NULL' if not found.
+
+    void insert(uint64 h, GLit key);
+    bool exclude(GLit key);
+        // -- Returns FALSE if 'key' was not in the table.
+};
+
+
+//=================================================================================================
+// -- Implementation:
+
+
+template<class HASH>
+inline uint StrashTab<HASH>::match(uint pos, uchar c) const
+{
+  #if defined(__SSE2__)
+    __m128i g = _mm_loadu_si128((const __m128i*)(ctrl + pos));
+    return (uint)_mm_movemask_epi8(_mm_cmpeq_epi8(g, _mm_set1_epi8((char)c)));
+  #else
+    uint mask = 0;
+    for (uint i = 0; i < GROUP; i++)
+        if (ctrl[pos + i] == c) mask |= 1u << i;
+    return mask;
+  #endif
+}
+
+
+template<class HASH>
+inline uint StrashTab<HASH>::matchFree(uint pos) const
+{
+  #if defined(__SSE2__)
+    __m128i g = _mm_loadu_si128((const __m128i*)(ctrl + pos));
+    return (uint)_mm_movemask_epi8(g);      // -- top bit is set exactly for 'Empty' and 'Deleted'
+  #else
+    uint mask = 0;
+    for (uint i = 0; i < GROUP; i++)
+        if (ctrl[pos + i] & 0x80) mask |= 1u << i;
+    return mask;
+  #endif
+}
+
+
+template<class HASH>
+template<class MATCH>
+inline GLit StrashTab<HASH>::lookup(uint64 h, const MATCH& pred) const
+{
+    if (cap == 0) return GLit_NULL;
+
+    uchar fp  = fingerprint(h);
+    uint  pos = uint(h) & (cap - 1);
+    for(;;){
+        for (uint m = match(pos, fp); m != 0; m &= m - 1){
+            uint i = (pos + lowestBitIdx(m)) & (cap - 1);
+            if (pred(slot[i]))
+                return slot[i];
+        }
+        if (match(pos, ctrl_Empty) != 0)
+            return GLit_NULL;
+        pos = (pos + GROUP) & (cap - 1);
+    }
+}
+
+
+template<class HASH>
+inline void StrashTab<HASH>::insert(uint64 h, GLit key)
+{
+    if (n_used + 1 > cap - cap/8)
+        resize(sz + 1);
+
+    uint pos = uint(h) & (cap - 1);
+    uint m;
+    while ((m = matchFree(pos)) == 0)
+        pos = (pos + GROUP) & (cap - 1);
+
+    uint i = (pos + lowestBitIdx(m)) & (cap - 1);
+    if (ctrl[i] == ctrl_Empty) n_used++;
+    setCtrl(i, fingerprint(h));
+    slot[i] = key;
+    sz++;
+}
+
+
+template<class HASH>
+bool StrashTab<HASH>::exclude(GLit key)
+{
+    if (cap == 0) return false;
+
+    uint64 h   = hasher.hash(key);
+    uchar  fp  = fingerprint(h);
+    uint   pos = uint(h) & (cap - 1);
+    for(;;){
+        for (uint m = match(pos, fp); m != 0; m &= m - 1){
+            uint i = (pos + lowestBitIdx(m)) & (cap - 1);
+            if (slot[i] == key){
+                setCtrl(i, ctrl_Deleted);
+                sz--;
+                return true;
+            }
+        }
+        if (match(pos, ctrl_Empty) != 0)
+            return false;
+        pos = (pos + GROUP) & (cap - 1);
+    }
+}
+
+
+// Reallocate for at least 'min_keys' keys at load factor 1/2 (also drops tombstones).
+template<class HASH>
+void StrashTab<HASH>::resize(uint min_keys)
+{
+    newMax(min_keys, sz);
+    uint new_cap = GROUP;
+    while (new_cap / 2 < min_keys) new_cap *= 2;
+
+    uchar* old_ctrl = ctrl;
+    GLit*  old_slot = slot;
+    uint   old_cap  = cap;
+
+    ctrl = xmalloc<uchar>(new_cap + GROUP);
+    slot = xmalloc<GLit>(new_cap);
+    memset(ctrl, ctrl_Empty, new_cap + GROUP);
+    cap = new_cap;
+    sz = n_used = 0;
+
+    for (uint i = 0; i < old_cap; i++)
+        if (!(old_ctrl[i] & 0x80))
+            insert(hasher.hash(old_slot[i]), old_slot[i]);
+
+    xfree(old_ctrl);
+    xfree(old_slot);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+}
+#endif
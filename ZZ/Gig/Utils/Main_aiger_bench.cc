@@ -0,0 +1,162 @@
+#include "Prelude.hh"
+#include "ZZ_CmdLine.hh"
+#include "ZZ_Gig.hh"
+#include "ZZ_Gig.IO.hh"
+
+using namespace ZZ;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Throughput and memory of the AIGER reader/writer. Gzipped files are read both through 'InFile'
+// (inflating inside 'In') and through a 'GunzipReader', with and without a decompression thread.
+// Memory figures are process sizes as reported by 'memUsedNow()' and 'memUsed()' (peak).
+
+
+static
+void randomAig(Gig& N, uint n_pis, uint n_ffs, uint n_ands, uint64 seed)
+{
+    Vec<GLit> ws;
+    for (uint i = 0; i < n_pis; i++) ws.push(N.add(gate_PI, i));
+    for (uint i = 0; i < n_ffs; i++) ws.push(N.add(gate_FF, i));
+    for (uint i = 0; i < n_ands; i++){
+        uint n = ws.size();
+        Wire x = ws[n - 1 - irand(seed, min_(n, 1000u))] + N;    // -- prefer recent gates to get some depth
+        Wire y = ws[irand(seed, n)] + N;
+        ws.push(N.add(gate_And).init(x ^ bool(irand(seed, 2)), y ^ bool(irand(seed, 2))));
+    }
+    for (uint i = 0; i < n_ffs; i++){
+        Wire w = N(gate_FF, i);
+        w.set(0, N.add(gate_Seq).init(ws[irand(seed, ws.size())] + N));
+        w.set(1, ~N.True());
+    }
+    N.add(gate_PO, 0).init(ws.last() + N);
+}
+
+
+struct Result {
+    String  what;
+    double  time;
+    uint64  bytes;
+    uint64  mem_now;
+    uint64  mem_peak;
+};
+
+
+static Vec<Result> results;
+static double      T0;
+
+
+static
+void startPhase()
+{
+    T0 = realTime();
+}
+
+
+static
+void endPhase(String what, uint64 bytes)
+{
+    Result r;
+    r.what     = what;
+    r.time     = realTime() - T0;
+    r.bytes    = bytes;
+    r.mem_now  = memUsedNow();
+    r.mem_peak = memUsed();
+    results.push(r);
+}
+
+
+static
+void readGz(String filename, Gig& N, bool threaded)
+{
+    File file(filename, "r");
+    if (file.null()) Throw(Excp_Msg) "Could not open: %_", filename;
+    GunzipReader gz(file, threaded);
+    In in(gz);
+    readAiger(in, N, false);
+}
+
+
+static
+void check(const Gig& N, const Gig& M)
+{
+    for (uint t = 0; t < GateType_size; t++){
+        if (N.typeCount(GateType(t)) != M.typeCount(GateType(t))){
+            ShoutLn "INTERNAL ERROR! Netlist read back differs: %_ %_ vs. %_", GateType_name[t], N.typeCount(GateType(t)), M.typeCount(GateType(t));
+            exit(1); }
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    ZZ_Init;
+
+    cli.add("input" , "string", "", "Input AIGER file (if empty, a random AIG is used).", 0);
+    cli.add("ands"  , "uint"  , "5000000", "AND-gates of random AIG.");
+    cli.add("ffs"   , "uint"  , "10000", "Flops of random AIG.");
+    cli.add("seed"  , "uint"  , "42", "Random seed.");
+    cli.add("tmp"   , "string", "aiger_bench_tmp", "Prefix of temporary files ('.aig' and '.aig.gz' are added).");
+    cli.add("gzip"  , "bool"  , "yes", "Also benchmark gzipped files.");
+    cli.add("keep"  , "bool"  , "no", "Keep temporary files.");
+    cli.parseCmdLine(argc, argv);
+    String input  = cli.get("input").string_val;
+    String tmp    = cli.get("tmp").string_val;
+    bool   gzip   = cli.get("gzip").bool_val;
+    String f_aig  = tmp + ".aig";
+    String f_gz   = tmp + ".aig.gz";
+
+    try{
+        // Get netlist:
+        Gig N;
+        if (input == ""){
+            startPhase();
+            randomAig(N, 1000, cli.get("ffs").int_val, cli.get("ands").int_val, cli.get("seed").int_val);
+            endPhase("generate", 0);
+        }else{
+            startPhase();
+            readAigerFile(input, N, false);
+            endPhase("read input", fileSize(input));
+        }
+        WriteLn "Netlist: %_", info(N);
+
+        // Write:
+        startPhase();
+        if (!writeAigerFile(f_aig, N)) Throw(Excp_Msg) "Could not create: %_", f_aig;
+        endPhase("write", fileSize(f_aig));
+        uint64 raw_size = fileSize(f_aig);
+
+        if (gzip){
+            startPhase();
+            if (!writeAigerFile(f_gz, N)) Throw(Excp_Msg) "Could not create: %_", f_gz;
+            endPhase("write gz", raw_size);
+        }
+
+        // Read back:
+        { Gig M; startPhase(); readAigerFile(f_aig, M, false); endPhase("read", raw_size); check(N, M); }
+        if (gzip){
+            { Gig M; startPhase(); InFile in(f_gz); readAiger(in, M, false); endPhase("read gz (InFile)"   , raw_size); check(N, M); }
+            { Gig M; startPhase(); readGz(f_gz, M, false);                  endPhase("read gz (unthreaded)", raw_size); check(N, M); }
+            { Gig M; startPhase(); readGz(f_gz, M, true);                   endPhase("read gz (threaded)"  , raw_size); check(N, M); }
+        }
+
+        // Report:
+        uint n_gates = N.count();
+        WriteLn "AIGER size: %DB  (gzipped: %DB)", raw_size, gzip ? fileSize(f_gz) : 0;
+        WriteLn "%<22%_  %>8%_  %>10%_  %>10%_  %>10%_  %>10%_", "phase", "time", "MB/s", "Mgates/s", "mem now", "mem peak";
+        for (uint i = 0; i < results.size(); i++){
+            const Result& r = results[i];
+            WriteLn "%<22%_  %>8%t  %>10%.1f  %>10%.2f  %>10%DB  %>10%DB", r.what, r.time, r.bytes / r.time / 1e6, n_gates / r.time / 1e6, r.mem_now, r.mem_peak;
+        }
+
+    }catch (const Excp_Msg& err){
+        ShoutLn "ERROR! %_", err.msg;
+        exit(1);
+    }
+
+    if (!cli.get("keep").bool_val){
+        remove(f_aig.c_str());
+        if (gzip) remove(f_gz.c_str());
+    }
+    return 0;
+}
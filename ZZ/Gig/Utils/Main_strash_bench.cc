@@ -0,0 +1,223 @@
+#include "Prelude.hh"
+#include "ZZ_CmdLine.hh"
+#include "ZZ_Gig.hh"
+#include "ZZ_Gig.IO.hh"
+#include "ZZ/Generics/Set.hh"
+
+using namespace ZZ;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Compares the open addressing 'StrashTab' against the chained 'Set' previously used by
+// 'GigObj_Strash', on the AND-gates of a netlist. Both tables use the hash function they are
+// (were) used with in 'Strash.cc'.
+
+
+// Old table:
+struct OldHash {
+    const Gig* N;
+    OldHash(const Gig* N_ = NULL) : N(N_) {}
+    uint64 hash(GLit p) const { Wire w = p + *N; return defaultHash(make_tuple(w[0].lit(), w[1].lit())); }
+    bool equal(GLit p, GLit q) const { Wire u = p + *N; Wire v = q + *N; return u[0] == v[0] && u[1] == v[1]; }
+};
+
+typedef Set<GLit,OldHash> OldTab;
+
+
+static
+GLit oldLookup(const OldTab& tab, const Gig& N, GLit u, GLit v, uind idx)
+{
+    for (void* cell = tab.firstCell(idx); cell; cell = tab.nextCell(cell)){
+        Wire w = tab.key(cell) + N;
+        if (w[0] == u && w[1] == v)
+            return w;
+    }
+    return GLit_NULL;
+}
+
+
+// New table:
+struct NewHash {
+    const Gig* N;
+    NewHash(const Gig* N_ = NULL) : N(N_) {}
+    uint64 hash(GLit p) const { Wire w = p + *N; return strashMix((uint64(w[0].lit().data()) << 32) | w[1].lit().data()); }
+};
+
+struct NewMatch {
+    const Gig& N; GLit u, v;
+    NewMatch(const Gig& N_, GLit u_, GLit v_) : N(N_), u(u_), v(v_) {}
+    bool operator()(GLit p) const { Wire w = p + N; return w[0] == u && w[1] == v; }
+};
+
+typedef StrashTab<NewHash> NewTab;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+static
+void randomAig(Gig& N, uint n_pis, uint n_ands, uint64 seed)
+{
+    N.strash();
+    Vec<GLit> ws;
+    for (uint i = 0; i < n_pis; i++)
+        ws.push(N.add(gate_PI));
+    while (N.typeCount(gate_And) < n_ands){
+        // -- prefer recent gates to get some depth
+        uint  n = ws.size();
+        Wire  x = ws[n - 1 - irand(seed, min_(n, 1000u))] + N;
+        Wire  y = ws[irand(seed, n)] + N;
+        Wire  z = aig_And(x ^ bool(irand(seed, 2)), y ^ bool(irand(seed, 2)));
+        if (z.id >= gid_FirstUser && z.id >= ws.last().id)
+            ws.push(+z);
+    }
+}
+
+
+int main(int argc, char** argv)
+{
+    ZZ_Init;
+
+    cli.add("input", "string", "", "Input GNL or AIGER file (if empty, a random AIG is used).", 0);
+    cli.add("ands" , "uint", "2000000", "Size of random AIG.");
+    cli.add("reps" , "uint", "5", "Number of repetitions of each lookup pass.");
+    cli.add("seed" , "uint", "42", "Random seed.");
+    cli.parseCmdLine(argc, argv);
+    String input = cli.get("input").string_val;
+    uint   reps  = cli.get("reps").int_val;
+    uint64 seed  = cli.get("seed").int_val;
+
+    // Get netlist:
+    Gig N;
+    try{
+        if (input == "")
+            randomAig(N, 1000, cli.get("ands").int_val, seed);
+        else if (hasExtension(input, "aig"))
+            readAigerFile(input, N, true);
+        else if (hasExtension(input, "gnl"))
+            N.load(input);
+        else{
+            ShoutLn "ERROR! Unknown file extension: %_", input;
+            exit(1);
+        }
+    }catch (const Excp_Msg& err){
+        ShoutLn "PARSE ERROR! %_", err.msg;
+        exit(1);
+    }
+    if (!N.isStrashed())
+        N.strash();
+    WriteLn "Netlist: %_", info(N);
+
+    Vec<GLit> ands;
+    For_Gates(N, w)
+        if (w.type() == gate_And)
+            ands.push(w);
+    uint n = ands.size();
+    if (n == 0){ ShoutLn "No AND-gates."; exit(1); }
+
+    // Random pairs of (mostly) non-existing inputs:
+    Vec<Pair<GLit,GLit> > misses;
+    for (uint i = 0; i < n; i++){
+        GLit u = ands[irand(seed, n)] ^ bool(irand(seed, 2));
+        GLit v = ands[irand(seed, n)] ^ bool(irand(seed, 2));
+        if (v < u) swp(u, v);
+        misses.push(make_tuple(u, v));
+    }
+
+    OldHash old_hash(&N);
+    NewHash new_hash(&N);
+    OldTab  old_tab(old_hash);
+    NewTab  new_tab(new_hash);
+    double T0;
+    uint   found;
+
+    // Insert (incremental, including lookup as in 'add_Bin()'):
+    T0 = cpuTime();
+    for (uint i = 0; i < n; i++){
+        Wire   w = ands[i] + N;
+        uint64 h = defaultHash(make_tuple(w[0].lit(), w[1].lit()));
+        uind   idx = old_tab.index_(h);
+        if (!oldLookup(old_tab, N, w[0], w[1], idx))
+            old_tab.newEntry(idx, w);
+    }
+    double T_old_ins = cpuTime() - T0;
+
+    T0 = cpuTime();
+    for (uint i = 0; i < n; i++){
+        Wire   w = ands[i] + N;
+        uint64 h = strashMix((uint64(w[0].lit().data()) << 32) | w[1].lit().data());
+        if (!new_tab.lookup(h, NewMatch(N, w[0], w[1])))
+            new_tab.insert(h, w);
+    }
+    double T_new_ins = cpuTime() - T0;
+
+    // Bulk build:
+    new_tab.clear();
+    T0 = cpuTime();
+    new_tab.reserve(n);
+    for (uint i = 0; i < n; i++){
+        Wire w = ands[i] + N;
+        new_tab.insert(strashMix((uint64(w[0].lit().data()) << 32) | w[1].lit().data()), w);
+    }
+    double T_new_bulk = cpuTime() - T0;
+
+    // Lookups (hits):
+    found = 0;
+    T0 = cpuTime();
+    for (uint r = 0; r < reps; r++){
+        for (uint i = 0; i < n; i++){
+            Wire w = ands[i] + N;
+            found += (bool)oldLookup(old_tab, N, w[0], w[1], old_tab.index_(defaultHash(make_tuple(w[0].lit(), w[1].lit()))));
+        }
+    }
+    double T_old_hit = cpuTime() - T0;
+    uint found_old_hit = found;
+
+    found = 0;
+    T0 = cpuTime();
+    for (uint r = 0; r < reps; r++){
+        for (uint i = 0; i < n; i++){
+            Wire w = ands[i] + N;
+            found += (bool)new_tab.lookup(strashMix((uint64(w[0].lit().data()) << 32) | w[1].lit().data()), NewMatch(N, w[0], w[1]));
+        }
+    }
+    double T_new_hit = cpuTime() - T0;
+    uint found_new_hit = found;
+
+    // Lookups (misses):
+    uint found_old = 0;
+    T0 = cpuTime();
+    for (uint r = 0; r < reps; r++){
+        for (uint i = 0; i < n; i++){
+            GLit u = misses[i].fst, v = misses[i].snd;
+            found_old += (bool)oldLookup(old_tab, N, u, v, old_tab.index_(defaultHash(make_tuple(u, v))));
+        }
+    }
+    double T_old_miss = cpuTime() - T0;
+
+    uint found_new = 0;
+    T0 = cpuTime();
+    for (uint r = 0; r < reps; r++){
+        for (uint i = 0; i < n; i++){
+            GLit u = misses[i].fst, v = misses[i].snd;
+            found_new += (bool)new_tab.lookup(strashMix((uint64(u.data()) << 32) | v.data()), NewMatch(N, u, v));
+        }
+    }
+    double T_new_miss = cpuTime() - T0;
+
+    if (old_tab.size() != n || new_tab.size() != n || found_old_hit != reps * n || found_new_hit != reps * n || found_old != found_new){
+        ShoutLn "INTERNAL ERROR! Tables disagree (hits: %_ %_, misses: %_ %_).", found_old_hit, found_new_hit, found_old, found_new;
+        exit(1); }
+
+    // Report:
+    double M = n / 1e6;
+    double MR = M * reps;
+    WriteLn "AND-gates: %_", n;
+    WriteLn "                    %>12%_  %>12%_", "old (Set)", "new (StrashTab)";
+    WriteLn "insert  [Mops/s]    %>12%.2f  %>12%.2f", M  / T_old_ins , M  / T_new_ins;
+    WriteLn "bulk    [Mops/s]    %>12%_  %>12%.2f", "-", M / T_new_bulk;
+    WriteLn "hit     [Mops/s]    %>12%.2f  %>12%.2f", MR / T_old_hit , MR / T_new_hit;
+    WriteLn "miss    [Mops/s]    %>12%.2f  %>12%.2f", MR / T_old_miss, MR / T_new_miss;
+
+    return 0;
+}
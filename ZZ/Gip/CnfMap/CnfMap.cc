@@ -371,6 +371,7 @@ void CnfMap::run()
 CnfMap::CnfMap(Gig& N_, Params_CnfMap P_) :
     P(P_), N(N_)
 {
+    npn4Init();
     removeUnreach(N);
     introduceMuxes(N);
     N.compact();
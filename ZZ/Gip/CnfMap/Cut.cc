@@ -27,7 +27,7 @@ void Cut::trim()
 {
     if (sz == 0) return;
     while ((ftb & 0x5555) == ((ftb & 0xAAAA) >> 1)){
-        ftb = apply_perm4[PERM4_3012][ftb];
+        ftb = applyPerm4(PERM4_3012, ftb);
         inputs[0] = inputs[1];
         inputs[1] = inputs[2];
         inputs[2] = inputs[3];
@@ -37,7 +37,7 @@ void Cut::trim()
 
     if (sz == 1) return;
     while ((ftb & 0x3333) == ((ftb & 0xCCCC) >> 2)){
-        ftb = apply_perm4[PERM4_0312][ftb];
+        ftb = applyPerm4(PERM4_0312, ftb);
         inputs[1] = inputs[2];
         inputs[2] = inputs[3];
         sz--;
@@ -46,7 +46,7 @@ void Cut::trim()
 
     if (sz == 2) return;
     while ((ftb & 0x0F0F) == ((ftb & 0xF0F0) >> 4)){
-        ftb = apply_perm4[PERM4_0132][ftb];
+        ftb = applyPerm4(PERM4_0132, ftb);
         inputs[2] = inputs[3];
         sz--;
         if (sz == 2) return;
@@ -115,8 +115,8 @@ Cut combineCuts_And(const Cut& cut1, const Cut& cut2, bool inv1, bool inv2, bool
     // Compute new FTB:
     ushort ftb1 = cut1.ftb ^ (inv1 ? (ushort)0xFFFF : (ushort)0x0000);
     ushort ftb2 = cut2.ftb ^ (inv2 ? (ushort)0xFFFF : (ushort)0x0000);
-    ftb1 = apply_perm4[pseq4_to_perm4[pseq4Make(perm1[0], perm1[1], perm1[2], perm1[3])]][ftb1];
-    ftb2 = apply_perm4[pseq4_to_perm4[pseq4Make(perm2[0], perm2[1], perm2[2], perm2[3])]][ftb2];
+    ftb1 = applyPerm4(pseq4_to_perm4[pseq4Make(perm1[0], perm1[1], perm1[2], perm1[3])], ftb1);
+    ftb2 = applyPerm4(pseq4_to_perm4[pseq4Make(perm2[0], perm2[1], perm2[2], perm2[3])], ftb2);
 
     result.ftb = (!use_xor) ? (ftb1 & ftb2) : (ftb1 ^ ftb2);
     result.trim();
@@ -176,9 +176,9 @@ Cut combineCuts_Mux(const Cut& cut1, const Cut& cut2, const Cut& cut3, bool inv1
     ushort ftb1 = cut1.ftb ^ (inv1 ? (ushort)0xFFFF : (ushort)0x0000);
     ushort ftb2 = cut2.ftb ^ (inv2 ? (ushort)0xFFFF : (ushort)0x0000);
     ushort ftb3 = cut3.ftb ^ (inv3 ? (ushort)0xFFFF : (ushort)0x0000);
-    ftb1 = apply_perm4[pseq4_to_perm4[pseq4Make(perm1[0], perm1[1], perm1[2], perm1[3])]][ftb1];
-    ftb2 = apply_perm4[pseq4_to_perm4[pseq4Make(perm2[0], perm2[1], perm2[2], perm2[3])]][ftb2];
-    ftb3 = apply_perm4[pseq4_to_perm4[pseq4Make(perm3[0], perm3[1], perm3[2], perm3[3])]][ftb3];
+    ftb1 = applyPerm4(pseq4_to_perm4[pseq4Make(perm1[0], perm1[1], perm1[2], perm1[3])], ftb1);
+    ftb2 = applyPerm4(pseq4_to_perm4[pseq4Make(perm2[0], perm2[1], perm2[2], perm2[3])], ftb2);
+    ftb3 = applyPerm4(pseq4_to_perm4[pseq4Make(perm3[0], perm3[1], perm3[2], perm3[3])], ftb3);
 
     result.ftb = (ftb1 & ftb2) | (~ftb1 & ftb3);
     result.trim();
@@ -24,6 +24,8 @@ using namespace std;
 
 void clausify(const Gig& F, const Vec<GLit>& roots, MetaSat& S, WMapX<Lit>& f2s, bool init_ffs, Vec<GLit>* new_ffs)
 {
+    npn4Init();
+
     Vec<GLit> Q(copy_, roots);
     Vec<Lit> tmp;
 
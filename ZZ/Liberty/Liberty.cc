@@ -15,6 +15,7 @@
 #include "Liberty.hh"
 #include "ZZ_LinReg.hh"
 #include "BoolExpr.hh"
+#include <sys/mman.h>
 
 namespace ZZ {
 using namespace std;
@@ -1097,6 +1098,18 @@ void LibertyParser::parse(LibertyListener& lis)
 }
 
 
+//=================================================================================================
+// -- Destructor:
+
+
+SC_Lib::~SC_Lib()
+{
+    dispose(text);
+    if (scl_image)
+        munmap((void*)scl_image, scl_image_sz);
+}
+
+
 //=================================================================================================
 // -- Formatting with units:
 
@@ -189,7 +189,10 @@ struct SC_Cell {
     uint    n_inputs;       // -- 'pins[0 .. n_inputs-1]' are input pins
     uint    n_outputs;      // -- 'pins[n_inputs .. n_inputs+n_outputs-1]' are output pins
 
-    SC_Cell() : seq(false), unsupp(false), area(0), drive_strength(0), n_inputs(0), n_outputs(0) {}
+    // Lazy loading:
+    uint64  lazy_timing;    // -- if non-zero, 'rtiming' tables are not yet read; offset into 'SC_Lib::scl_image' (see 'loadCellTiming()')
+
+    SC_Cell() : seq(false), unsupp(false), area(0), drive_strength(0), n_inputs(0), n_outputs(0), lazy_timing(0) {}
 
     SC_Pin&       outPin(uint i)       { return pins[n_inputs + i]; }
     const SC_Pin& outPin(uint i) const { return pins[n_inputs + i]; }
@@ -222,11 +225,14 @@ struct SC_Lib {
     NamedSet<SC_Cell>        cells;
 
     // Constructor:
-    SC_Lib() : default_max_out_slew(-1), unit_time(9), unit_cap(make_tuple(1,12)) {
+    SC_Lib() : default_max_out_slew(-1), unit_time(9), unit_cap(make_tuple(1,12)), scl_image(NULL), scl_image_sz(0) {
         cells.add(slize("NULL_GATE")); cells.add(slize("PI_GATE")); cells[0].unsupp = cells[1].unsupp = true; }
-   ~SC_Lib() { dispose(text); }
+   ~SC_Lib();
     Array<char> text;       // -- all 'Str's refer to substrings of this array
 
+    cchar*  scl_image;      // -- memory mapped SCL file if read lazily (unmapped by destructor)
+    uint64  scl_image_sz;
+
     // Gate access:
     SC_Cell&       operator[](uint i)       { return cells[i]; }
     const SC_Cell& operator[](uint i) const { return cells[i]; }
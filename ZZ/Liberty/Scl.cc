@@ -15,6 +15,10 @@
 
 #include "Prelude.hh"
 #include "Scl.hh"
+#include "ZZ_Md5.hh"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 
 namespace ZZ {
 using namespace std;
@@ -24,6 +28,13 @@ using namespace std;
 // Helper functions:
 
 
+// Version 7 moved the timing tables of each cell after its pins and prefixed them by their size
+// (in bytes), so that a reader can skip them. Version 8 also stores sequential and unsupported
+// cells (for the latter, only pin names and directions), so that reading an SCL file gives the
+// same cells, with the same indices, as reading the Liberty file it was produced from.
+static const uint scl_version = 8;
+
+
 static
 void putU(Out& out, uint64 val)
 {
@@ -88,9 +99,37 @@ void writeSurface(Out& out, const SC_Surface& s)
 }
 
 
+// Timing tables of one cell; written separately (prefixed by their size) so that they can be
+// skipped by a lazy reader.
+static
+void writeCellTiming(Out& out, const SC_Cell& cell)
+{
+    for (uint j = 0; j < cell.n_outputs; j++){
+        const SC_Pin& pin = cell.outPin(j);
+        for (uint k = 0; k < pin.rtiming.size(); k++){
+            putu(out, pin.rtiming[k].size());
+                // -- NOTE! After post-processing, the size of the 'rtiming[k]' vector is either
+                // 0 or 1 (in static timing, we have merged all tables to get the worst case).
+                // The case with size 0 should only occur for multi-output gates.
+            if (pin.rtiming[k].size() == 1){
+                const SC_Timing& timing = pin.rtiming[k][0];
+                    // -- NOTE! We don't need to save 'related_pin' string because we have sorted
+                    // the elements on input pins.
+                putu(out, (uint)timing.tsense);
+                writeSurface(out, timing.cell_rise);
+                writeSurface(out, timing.cell_fall);
+                writeSurface(out, timing.rise_trans);
+                writeSurface(out, timing.fall_trans);
+            }else
+                assert(pin.rtiming[k].size() == 0);
+        }
+    }
+}
+
+
 void writeScl(Out& out, const SC_Lib& L)
 {
-    putu(out, /*version*/6);
+    putu(out, /*version*/scl_version);
 
     // Write non-composite fields:
     putz(out, L.lib_name);
@@ -131,22 +170,28 @@ void writeScl(Out& out, const SC_Lib& L)
     }
 
     // Write 'cells' vector:
-    uint n_valid_cells = 0;
-    for (uint i = 0; i < L.cells.size(); i++){
-        const SC_Cell& cell = L.cells[i];
-        if (cell.seq || cell.unsupp) continue;
-        n_valid_cells++;
-    }
-
-    putu(out, n_valid_cells);
-    for (uint i = 0; i < L.cells.size(); i++){
+    putu(out, L.cells.size() - SC_Lib::N_RESERVED_GATES);
+    Out tmp;
+    for (uint i = SC_Lib::N_RESERVED_GATES; i < L.cells.size(); i++){
         const SC_Cell& cell = L.cells[i];
-        if (cell.seq || cell.unsupp) continue;
+        assert(cell.lazy_timing == 0);
 
         putz(out, cell.name);
+        putu(out, (uint)cell.seq | ((uint)cell.unsupp << 1));
         putF(out, cell.area);
         putu(out, cell.drive_strength);
 
+        if (cell.unsupp){
+            // Pins are not post-processed for unsupported cells; keep only what the Verilog
+            // prelude needs:
+            putu(out, cell.pins.size());
+            for (uint j = 0; j < cell.pins.size(); j++){
+                putz(out, cell.pins[j].name);
+                putu(out, (uint)cell.pins[j].dir);
+            }
+            continue;
+        }
+
         // Write 'pins': (sorted at this point; first inputs, then outputs)
         putu(out, cell.n_inputs);
         putu(out, cell.n_outputs);
@@ -173,27 +218,18 @@ void writeScl(Out& out, const SC_Lib& L)
                 putU(out, pin.func[k]); // -- 64-bit number, written uncompressed (low-byte first)
             putz(out, pin.func_text);
 
-            // Write 'rtiming': (pin-to-pin timing tables for this particular output)
+            // Write names of 'rtiming' (the tables follow after all pins):
             assert(pin.rtiming.size() == cell.n_inputs);
-            for (uint k = 0; k < pin.rtiming.size(); k++){
+            for (uint k = 0; k < pin.rtiming.size(); k++)
                 putz(out, pin.rtiming[k].name); // <<== redundant? remove?
-                putu(out, pin.rtiming[k].size());
-                    // -- NOTE! After post-processing, the size of the 'rtiming[k]' vector is either
-                    // 0 or 1 (in static timing, we have merged all tables to get the worst case).
-                    // The case with size 0 should only occur for multi-output gates.
-                if (pin.rtiming[k].size() == 1){
-                    const SC_Timing& timing = pin.rtiming[k][0];
-                        // -- NOTE! We don't need to save 'related_pin' string because we have sorted
-                        // the elements on input pins.
-                    putu(out, (uint)timing.tsense);
-                    writeSurface(out, timing.cell_rise);
-                    writeSurface(out, timing.cell_fall);
-                    writeSurface(out, timing.rise_trans);
-                    writeSurface(out, timing.fall_trans);
-                }else
-                    assert(pin.rtiming[k].size() == 0);
-            }
         }
+
+        // Write timing tables:
+        tmp.vec().clear();
+        writeCellTiming(tmp, cell);
+        putu(out, tmp.vec().size());
+        for (uint j = 0; j < tmp.vec().size(); j++)
+            out.push(tmp.vec()[j]);
     }
 }
 
@@ -233,18 +269,42 @@ void readSurface(In& in, SC_Surface& s)
 
 
 
+static
+void readCellTiming(In& in, SC_Cell& cell)
+{
+    for (uint j = 0; j < cell.n_outputs; j++){
+        SC_Pin& pin = cell.outPin(j);
+        for (uint k = 0; k < cell.n_inputs; k++){
+            uint n = getu(in); assert(n <= 1);
+            if (n == 1){
+                pin.rtiming[k].push();
+                SC_Timing& timing = pin.rtiming[k][0];
+
+                timing.tsense = (SC_TSense)getu(in);
+                readSurface(in, timing.cell_rise);
+                readSurface(in, timing.cell_fall);
+                readSurface(in, timing.rise_trans);
+                readSurface(in, timing.fall_trans);
+            }
+        }
+    }
+}
+
+
 macro void patch(Str& s, char* base) {
     s.data = base + (uind)(uintp)s.data; }
 
 
+// If 'lazy' is set, 'in' must be an in-memory stream (of the whole file); timing tables of
+// version 7 files are then skipped and their position stored in 'lazy_timing'.
 static
-void readScl_internal(In& in, SC_Lib& L)
+void readScl_internal(In& in, SC_Lib& L, bool lazy)
 {
     Vec<char> text;     // -- all strings will be stored here
 
     uint version = getu(in);
-    if (version < 5)
-        Throw(Excp_ParseError) "SCL reader expected version >= 5, not: %_", version;
+    if (version < 5 || version > scl_version)
+        Throw(Excp_ParseError) "SCL reader expected version 5..%_, not: %_", scl_version, version;
 
     // Read non-composite fields:
     L.lib_name = gets(in, text);                // [bp]
@@ -287,9 +347,23 @@ void readScl_internal(In& in, SC_Lib& L)
         SC_Cell& cell = L.cells.last();
 
         cell.name = gets(in, text);     // [bp]
+        if (version >= 8){
+            uint flags = getu(in);
+            cell.seq    = flags & 1;
+            cell.unsupp = flags & 2;
+        }
         cell.area = getF(in);
         cell.drive_strength = getu(in);
 
+        if (cell.unsupp){
+            for (uint j = getu(in); j != 0; j--){
+                cell.pins.push();
+                cell.pins.last().name = gets(in, text);     // [bp]
+                cell.pins.last().dir  = (SC_Dir)getu(in);
+            }
+            continue;
+        }
+
         cell.n_inputs  = getu(in);
         cell.n_outputs = getu(in);
 
@@ -315,10 +389,18 @@ void readScl_internal(In& in, SC_Lib& L)
             pin.func.init(getu(in));
             for (uint k = 0; k < pin.func.size(); k++)
                 pin.func[k] = getU(in);
-            if (version == 6)
+            if (version >= 6)
                 pin.func_text = gets(in, text);     // [bp]
 
-            // Write 'rtiming': (pin-to-pin timing tables for this particular output)
+            if (version >= 7){
+                for (uint k = 0; k < cell.n_inputs; k++){
+                    pin.rtiming.push();
+                    pin.rtiming.last().name = gets(in, text);   // [bp]
+                }
+                continue;
+            }
+
+            // Read 'rtiming': (pin-to-pin timing tables for this particular output)
             for (uint k = 0; k < cell.n_inputs; k++){
                 pin.rtiming.push();
                 pin.rtiming.last().name = gets(in, text);   // [bp]
@@ -337,6 +419,17 @@ void readScl_internal(In& in, SC_Lib& L)
                     assert(pin.rtiming[k].size() == 0);
             }
         }
+
+        // Read timing tables (version 7):
+        if (version >= 7){
+            uint64 sz = getu(in);
+            if (lazy){
+                if (sz > in.avail()) throw Excp_EOF();
+                cell.lazy_timing = in.tell();
+                in.skip(sz);
+            }else
+                readCellTiming(in, cell);
+        }
     }
 
     // Back-patch strings:
@@ -360,6 +453,12 @@ void readScl_internal(In& in, SC_Lib& L)
         SC_Cell& cell = L.cells[i];
         patch(cell.name, base);
 
+        if (cell.unsupp){
+            for (uint j = 0; j < cell.pins.size(); j++)
+                patch(cell.pins[j].name, base);
+            continue;
+        }
+
         for (uint j = 0; j < cell.n_inputs; j++)
             patch(cell.pins[j].name, base);
 
@@ -390,20 +489,177 @@ void readScl_internal(In& in, SC_Lib& L)
 void readScl(In& in, SC_Lib& L)
 {
     try{
-        readScl_internal(in, L);
+        readScl_internal(in, L, false);
     }catch (Excp_EOF){
         throw Excp_ParseError("Unexpected end-of-file.");
     }
 }
 
 
-void readSclFile(String filename, SC_Lib& L)
+void readSclFile(String filename, SC_Lib& L, bool lazy)
 {
-    InFile in(filename);
-    if (in.null())
+    if (!lazy){
+        InFile in(filename);
+        if (in.null())
+            Throw(Excp_ParseError) "Could not open: %_", filename;
+
+        readScl(in, L);
+        return;
+    }
+
+    // Map file:
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1)
         Throw(Excp_ParseError) "Could not open: %_", filename;
 
-    readScl(in, L);
+    struct stat st;
+    if (fstat(fd, &st) != 0 || st.st_size == 0){
+        ::close(fd);
+        Throw(Excp_ParseError) "Could not read: %_", filename; }
+    uint64 sz = st.st_size;
+
+    void* base = mmap(NULL, sz, PROT_READ, MAP_PRIVATE, fd, 0);
+    ::close(fd);
+    if (base == MAP_FAILED)
+        Throw(Excp_ParseError) "Could not memory-map: %_", filename;
+
+    // Read everything but the timing tables:
+    try{
+        In in((cchar*)base, sz);
+        readScl_internal(in, L, true);
+    }catch (Excp_EOF){
+        munmap(base, sz);
+        throw Excp_ParseError("Unexpected end-of-file.");
+    }catch (...){
+        munmap(base, sz);
+        throw;
+    }
+
+    // Keep the mapping only if something was left unread (older versions are read in full):
+    bool keep = false;
+    for (uint i = 0; i < L.cells.size(); i++)
+        if (L.cells[i].lazy_timing != 0) keep = true;
+
+    if (keep){
+        assert(L.scl_image == NULL);
+        L.scl_image = (cchar*)base;
+        L.scl_image_sz = sz;
+    }else
+        munmap(base, sz);
+}
+
+
+//=================================================================================================
+// -- Lazy loading:
+
+
+void loadCellTiming(SC_Lib& L, uint cell_idx)
+{
+    SC_Cell& cell = L.cells[cell_idx];
+    if (cell.lazy_timing == 0) return;
+
+    assert(L.scl_image != NULL);
+    assert(cell.lazy_timing < L.scl_image_sz);
+    In in(L.scl_image + cell.lazy_timing, L.scl_image_sz - cell.lazy_timing);
+    try{
+        readCellTiming(in, cell);
+    }catch (Excp_EOF){
+        throw Excp_ParseError("Unexpected end-of-file.");
+    }
+    cell.lazy_timing = 0;
+}
+
+
+void loadCellTiming(SC_Lib& L)
+{
+    for (uint i = 0; i < L.cells.size(); i++)
+        loadCellTiming(L, i);
+}
+
+
+void loadCellTiming(NetlistRef N, SC_Lib& L)
+{
+    For_Gatetype(N, gate_Uif, w)
+        loadCellTiming(L, attr_Uif(w).sym);
+}
+
+
+//=================================================================================================
+// -- Cached Liberty reading:
+
+
+static
+bool hashFile(String filename, md5_hash& result)
+{
+    int fd = ::open(filename.c_str(), O_RDONLY);
+    if (fd == -1) return false;
+
+    MD5 m;
+    Vec<uchar> buf(1024 * 1024);
+    for(;;){
+        ssize_t n = ::read(fd, buf.base(), buf.size());
+        if (n < 0){ ::close(fd); return false; }
+        if (n == 0) break;
+        m.update(buf.base(), (uint)n);
+    }
+    ::close(fd);
+
+    result = m.finalize();
+    return true;
+}
+
+
+static
+String sclCacheDir()
+{
+    cchar* dir = getenv("ZZ_SCL_CACHE");
+    if (dir != NULL)
+        return String(dir);     // -- empty string disables the cache
+
+    cchar* home = getenv("HOME");
+    if (home == NULL || home[0] == 0)
+        return String();
+
+    String path;
+    FWrite(path) "%_/.cache", home;
+    mkdir(path.c_str(), 0755);
+    path += "/zz_scl";
+    mkdir(path.c_str(), 0755);
+    return path;
+}
+
+
+bool readLibertyCached(String filename, SC_Lib& L, bool lazy, TimingTablesMode timing_mode)
+{
+    md5_hash h;
+    String   dir = (timing_mode == ttm_Keep) ? String() : sclCacheDir();     // -- SCL cannot store unmerged tables
+    if (dir == "" || !hashFile(filename, h)){
+        readLiberty(filename, L, timing_mode);
+        return false; }
+
+    String scl_file;
+    FWrite(scl_file) "%_/%.16x%.16x-v%_-%_.scl", dir, h.snd, h.fst, scl_version, (uint)timing_mode;
+
+    // Cache hit:
+    if (fileExists(scl_file)){
+        try{
+            readSclFile(scl_file, L, lazy);
+            return true;
+        }catch (Excp_ParseError){
+            // Corrupt entry; start over and regenerate it below:
+            L.~SC_Lib();
+            new (&L) SC_Lib;
+        }
+    }
+
+    // Cache miss:
+    readLiberty(filename, L, timing_mode);
+
+    String tmp_file;
+    FWrite(tmp_file) "%_.%_.tmp", scl_file, getpid();
+    if (writeSclFile(tmp_file, L))
+        rename(tmp_file.c_str(), scl_file.c_str());     // -- atomic, so concurrent runs never see a partial file
+    return false;
 }
 
 
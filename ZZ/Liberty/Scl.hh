@@ -11,11 +11,17 @@
 //| 
 //| This is a compact binary version of the Liberty format, containing only the fields relevant to
 //| static timing analysis.
+//|
+//| From version 7, the timing tables of each cell are stored after its pins, prefixed by their
+//| size. A lazy reader memory maps the file, reads names, pins and functions of all cells (which
+//| is what Verilog parsing and cell grouping needs) and skips the tables, which make up most of
+//| the file. Tables are then read per cell on demand through 'loadCellTiming()'.
 //|________________________________________________________________________________________________
 
 #ifndef ZZ__Liberty__Scl_hh
 #define ZZ__Liberty__Scl_hh
 
+#include "ZZ_Netlist.hh"
 #include "Liberty.hh"
 
 namespace ZZ {
@@ -27,11 +33,28 @@ using namespace std;
 
 void writeScl(Out& out, const SC_Lib& L);
 bool writeSclFile(String filename, const SC_Lib& L);
-    // -- returns FALSE if file 'filename' could not be created. 
+    // -- returns FALSE if file 'filename' could not be created. NOTE! All timing tables must be
+    // loaded.
 
 void readScl(In& in, SC_Lib& L);
-void readSclFile(String filename, SC_Lib& L);
-    // -- may throw 'Excp_ParseError'.
+void readSclFile(String filename, SC_Lib& L, bool lazy = false);
+    // -- may throw 'Excp_ParseError'. If 'lazy' is TRUE, the timing tables ('rtiming' of output
+    // pins) are left empty until loaded by 'loadCellTiming()' (files older than version 7 are
+    // still read in full).
+
+void loadCellTiming(SC_Lib& L, uint cell_idx);
+void loadCellTiming(SC_Lib& L);
+void loadCellTiming(NetlistRef N, SC_Lib& L);
+    // -- Read timing tables of a lazily read library: for one cell, for all cells, or for all
+    // cells used by the 'Uif's of 'N'. Cells already loaded are skipped. NOTE! Not thread-safe;
+    // load everything needed before starting any threads.
+
+bool readLibertyCached(String filename, SC_Lib& L, bool lazy = false, TimingTablesMode timing_mode = ttm_Merge);
+    // -- Like 'readLiberty()' but goes through a cache of SCL files, keyed on the MD5 of the
+    // file content. The cache lives in '$ZZ_SCL_CACHE' (if set; empty string disables caching)
+    // or '~/.cache/zz_scl'. Returns TRUE if the library was read from the cache ('lazy' then
+    // applies). A cache entry that cannot be read is regenerated from 'filename'. May throw
+    // 'Excp_ParseError'.
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
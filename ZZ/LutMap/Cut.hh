@@ -13,6 +13,11 @@
 
 #ifndef ZZ__LutMap__Cut_hh
 #define ZZ__LutMap__Cut_hh
+
+#if defined(__SSE2__)
+#include <emmintrin.h>
+#endif
+
 namespace ZZ {
 using namespace std;
 
@@ -21,37 +26,47 @@ using namespace std;
 
 
 class LutMap_Cut {                // -- this class represents 6-input cuts.
-    void extendAbstr(gate_id g) { abstr |= 1u << (g & 31); }
+    void extendAbstr(gate_id g) { abstr |= 1ull << (g & 63); }
+    void clearInputs()          { for (uint i = 0; i < 7; i++) inputs[i] = gid_MAX; }
 
-    gate_id inputs[6];
+    gate_id inputs[7];            // -- unused slots are 'gid_MAX' (so 'inputs[6]' always is); used as sentinels when merging
     ushort  sz;
 public:
     ushort  mux_depth;
-    uint    abstr;
+    uint64  abstr;
 
-    LutMap_Cut(Tag_empty) : sz(0), mux_depth(0), abstr(0) {}
-    LutMap_Cut(gate_id g) : sz(1), mux_depth(0), abstr(0) { inputs[0] = g; extendAbstr(g); }
+    LutMap_Cut(Tag_empty) : sz(0), mux_depth(0), abstr(0) { clearInputs(); }
+    LutMap_Cut(gate_id g) : sz(1), mux_depth(0), abstr(0) { clearInputs(); inputs[0] = g; extendAbstr(g); }
     LutMap_Cut()          : sz(7)                         {}
 
     uint    size()                const { return sz; }
-    gate_id operator[](int index) const { return inputs[index]; }
+    gate_id operator[](int index) const { return inputs[index]; }   // -- 'index' may be up to 6 for non-null cuts (returns 'gid_MAX' past the end)
     bool    null()                const { return uint(sz) > 6; }
     void    mkNull()                    { sz = 7; }
 
     void    push(gate_id g) { if (!null()){ inputs[sz++] = g; extendAbstr(g); } }
 
-    //bool    operator==(const LutMap_Cut& other) const;
+    bool    operator==(const LutMap_Cut& other) const;
+
+    friend bool subsumes(const LutMap_Cut& c, const LutMap_Cut& d);
 };
 
 
-//inline bool LutMap_Cut::operator==(const LutMap_Cut& other) const
-//{
-//    if (abstr != other.abstr) return false;
-//    if (sz != other.sz) return false;
-//    for (uint i = 0; i < sz; i++)
-//        if (inputs[i] != other.inputs[i]) return false;
-//    return true;
-//}
+// Inputs are compared as two overlapping groups of four: 'inputs[0..3]' and 'inputs[3..6]'.
+inline bool LutMap_Cut::operator==(const LutMap_Cut& other) const
+{
+    if (abstr != other.abstr) return false;
+    if (sz != other.sz) return false;
+  #if defined(__SSE2__)
+    __m128i lo = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)&inputs[0]), _mm_loadu_si128((const __m128i*)&other.inputs[0]));
+    __m128i hi = _mm_cmpeq_epi32(_mm_loadu_si128((const __m128i*)&inputs[3]), _mm_loadu_si128((const __m128i*)&other.inputs[3]));
+    return _mm_movemask_epi8(_mm_and_si128(lo, hi)) == 0xFFFF;
+  #else
+    for (uint i = 0; i < sz; i++)
+        if (inputs[i] != other.inputs[i]) return false;
+    return true;
+  #endif
+}
 
 
 template<> fts_macro void write_(Out& out, const LutMap_Cut& v)
@@ -73,8 +88,10 @@ template<> fts_macro void write_(Out& out, const LutMap_Cut& v)
 //- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
 
-// Check if cut 'c' is a subset of cut 'd'. Cuts must be sorted. FTB is ignored.
-macro bool subsumes(const LutMap_Cut& c, const LutMap_Cut& d)
+// Check if cut 'c' is a subset of cut 'd'. FTB is ignored. With SSE2, the slots of 'c' are
+// matched against each slot of 'd' in turn without branching ('gid_MAX' padding of 'c' is matched
+// by 'd.inputs[6]').
+inline bool subsumes(const LutMap_Cut& c, const LutMap_Cut& d)
 {
     assert_debug(!c.null());
     assert_debug(!d.null());
@@ -85,22 +102,46 @@ macro bool subsumes(const LutMap_Cut& c, const LutMap_Cut& d)
     if (c.abstr & ~d.abstr)
         return false;
 
-    if (c.size() == d.size()){
-        for (uint i = 0; i < c.size(); i++)
-            if (c[i] != d[i])
+  #if defined(__SSE2__)
+    __m128i lo = _mm_loadu_si128((const __m128i*)&c.inputs[0]);
+    __m128i hi = _mm_loadu_si128((const __m128i*)&c.inputs[3]);
+    __m128i found_lo = _mm_setzero_si128();
+    __m128i found_hi = _mm_setzero_si128();
+    for (uint j = 0; j < 7; j++){
+        __m128i x = _mm_set1_epi32((int)d.inputs[j]);
+        found_lo = _mm_or_si128(found_lo, _mm_cmpeq_epi32(x, lo));
+        found_hi = _mm_or_si128(found_hi, _mm_cmpeq_epi32(x, hi));
+    }
+    return _mm_movemask_epi8(_mm_and_si128(found_lo, found_hi)) == 0xFFFF;
+  #else
+    uint j = 0;
+    for (uint i = 0; i < c.size(); i++){
+        while (c[i] != d[j]){
+            j++;
+            if (j == d.size())
                 return false;
-    }else{
-        uint j = 0;
-        for (uint i = 0; i < c.size(); i++){
-            while (c[i] != d[j]){
-                j++;
-                if (j == d.size())
-                    return false;
-            }
         }
     }
-
     return true;
+  #endif
+}
+
+
+// Merge two sorted cuts. Returns a null cut if the result would have more than 'k' inputs.
+inline LutMap_Cut mergeCuts(const LutMap_Cut& c, const LutMap_Cut& d, uint k)
+{
+    LutMap_Cut result(empty_);
+    uint i = 0;
+    uint j = 0;
+    for(;;){
+        gate_id x = min_(c[i], d[j]);   // -- exhausted cuts read 'gid_MAX'
+        if (x == gid_MAX) break;
+        if (result.size() == k) return LutMap_Cut();
+        i += (c[i] == x);
+        j += (d[j] == x);
+        result.push(x);
+    }
+    return result;
 }
 
 
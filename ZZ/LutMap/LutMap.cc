@@ -25,6 +25,7 @@
 
 #define ELA_GLOBAL_LIM 500      // -- if more nodes than this is dereferenced, MFFC is too big to consider
 #define ELA_TIMING
+#define CUTGEN_CHUNK   64       // -- number of gates a cut generation thread claims at a time
 
 namespace ZZ {
 using namespace std;
@@ -123,6 +124,19 @@ struct LutMap_Cost {
 };
 
 
+// Cut generation state private to each thread. Cuts are allocated from the thread's own arena.
+struct LutMap_Scratch {
+    SlimAlloc<LutMap_Cut> mem;
+    Vec<LutMap_Cut>       cuts;
+    Vec<LutMap_Cost>      costs;
+    Vec<uint>             where;
+    Vec<uint>             list;
+    uint64                cuts_enumerated;
+
+    LutMap_Scratch() : cuts_enumerated(0) {}
+};
+
+
 class LutMap {
     typedef LutMap_Cost Cost;
 
@@ -132,7 +146,7 @@ class LutMap {
     WMapX<GLit>*         remap;
 
     // State:
-    SlimAlloc<Cut>    mem;
+    Vec<LutMap_Scratch*> scr;               // -- one per thread; sequential code uses 'scr[0]'
     WMap<Array<Cut> > cutmap;
     WMap<Cut>         winner;
     WMap<float>       area_est;
@@ -149,11 +163,22 @@ class LutMap {
     uint64            mapped_area;
     float             mapped_delay;
 
+    // Level-parallel cut generation:
+    Vec<GLit>         lv_order;             // -- gates sorted on level
+    Vec<uint>         lv_start;             // -- level 'i' is 'lv_order[lv_start[i] .. lv_start[i+1]-1]'
+    Vec<uint>         lv_next;              // -- next gate to claim (relative 'lv_start[i]') for each level
+  #if defined(ZZ_PTHREADS)
+    pthread_barrier_t lv_barrier;
+  #endif
+
     // Internal methods:
-    void  prioritizeCuts(Wire w, Array<Cut> cuts);
+    void  prioritizeCuts(Wire w, Array<Cut> cuts, LutMap_Scratch& S);
     void  reprioritizeCuts(Wire w, Array<Cut> cuts);
     void  generateCuts_LogicGate(Wire w, Vec<Cut>& out);
-    void  generateCuts(Wire w);
+    void  generateCuts(Wire w, LutMap_Scratch& S);
+    void  computeLevels();
+    void  generateAllCuts();
+    void  disposeCuts();
     void  updateFanoutEst(bool instantiate);
     void  run();
 
@@ -164,10 +189,6 @@ class LutMap {
 
 
     // Temporaries:
-    Vec<Cut>     tmp_cuts;
-    Vec<Cost>    tmp_costs;
-    Vec<uint>    tmp_where;
-    Vec<uint>    tmp_list;
     WZet         in_memo;
     WMap<uint64> memo;
 
@@ -177,6 +198,9 @@ class LutMap {
 public:
 
     LutMap(Gig& N, Params_LutMap P, WMapX<GLit>* remap);
+   ~LutMap();
+
+    void  cutGenWorker(uint thread_id);     // -- INTERNAL
 };
 
 
@@ -272,13 +296,13 @@ struct Area_lt {
 };
 
 
-void LutMap::prioritizeCuts(Wire w, Array<Cut> cuts)
+void LutMap::prioritizeCuts(Wire w, Array<Cut> cuts, LutMap_Scratch& S)
 {
     assert(cuts.size() > 0);
     assert(fanout_est[w] > 0);
 
     // Setup cost vector:
-    Vec<Cost>& costs = tmp_costs;
+    Vec<Cost>& costs = S.costs;
     costs.setSize(cuts.size());
 
     for (uint i = 0; i < cuts.size(); i++){
@@ -327,8 +351,8 @@ void LutMap::prioritizeCuts(Wire w, Array<Cut> cuts)
     }
 
     // Implement order:
-    Vec<uint>& where = tmp_where;
-    Vec<uint>& list  = tmp_list;
+    Vec<uint>& where = S.where;
+    Vec<uint>& list  = S.list;
     where.setSize(cuts.size());
     list .setSize(cuts.size());
     for (uint i = 0; i < cuts.size(); i++)
@@ -433,7 +457,9 @@ float delay(const Cut& cut, const WMap<float>& arrival, Gig& N)
 }
 
 
-void LutMap::generateCuts(Wire w)
+// Only reads the state of gates in the transitive fanin of 'w' (which makes it safe to run on
+// all gates of the same level in parallel).
+void LutMap::generateCuts(Wire w, LutMap_Scratch& S)
 {
     switch (w.type()){
     case gate_Const:    // -- constants should really have been propagated before mapping, but let's allow for them
@@ -451,14 +477,14 @@ void LutMap::generateCuts(Wire w)
     case gate_Lut4:
         // Inductive case:
         if (!cutmap[w]){
-            Vec<Cut>& cuts = tmp_cuts;
+            Vec<Cut>& cuts = S.cuts;
             cuts.clear();   // -- keep last winner
             if (!winner[w].null())
                 cuts.push(winner[w]);     // <<==FT cannot push last winner if mux_depth gets too big
             generateCuts_LogicGate(w, cuts);
 
-            cuts_enumerated += cuts.size();
-            prioritizeCuts(w, cuts.slice());
+            S.cuts_enumerated += cuts.size();
+            prioritizeCuts(w, cuts.slice(), S);
 
             if (!probeRound()){
                 cuts.shrinkTo(P.cuts_per_node);
@@ -469,9 +495,9 @@ void LutMap::generateCuts(Wire w)
                 }
                 cuts.shrinkTo(2 * P.cuts_per_node);
             }
-            cutmap(w) = Array_copy(cuts, mem);
+            cutmap(w) = Array_copy(cuts, S.mem);
         }else
-            prioritizeCuts(w, cutmap[w]);
+            prioritizeCuts(w, cutmap[w], S);
         break;
 
     case gate_PO:
@@ -504,6 +530,138 @@ void LutMap::generateCuts(Wire w)
 }
 
 
+// Sort gates on level. Gates of the same level don't depend on each other in 'generateCuts()'.
+void LutMap::computeLevels()
+{
+    WMap<uint> level(N, 0);
+    uint n_levels = 1;
+    For_All_Gates(N, w){
+        switch (w.type()){
+        case gate_And:
+        case gate_Lut4:
+        case gate_Bar:
+        case gate_Sel:
+        case gate_Delay:{
+            uint lv = 0;
+            For_Inputs(w, v)
+                newMax(lv, level[v] + 1);
+            level(w) = lv;
+            newMax(n_levels, lv + 1);
+            break;}
+        default:;
+            // -- global sources, POs and Seqs do not look at their inputs
+        }
+    }
+
+    lv_start.reset(n_levels + 1, 0);
+    For_All_Gates(N, w)
+        lv_start[level[w] + 1]++;
+    for (uint i = 1; i < lv_start.size(); i++)
+        lv_start[i] += lv_start[i-1];
+
+    Vec<uint> pos;
+    lv_start.copyTo(pos);
+    lv_order.setSize(lv_start.last());
+    For_All_Gates(N, w)
+        lv_order[pos[level[w]]++] = w;
+}
+
+
+#if defined(ZZ_PTHREADS)
+struct LutMap_ThreadArg {
+    LutMap* mapper;
+    uint    thread_id;
+};
+
+
+extern "C" void* lutMapCutGenThread(void* data);
+void* lutMapCutGenThread(void* data)
+{
+    LutMap_ThreadArg& arg = *static_cast<LutMap_ThreadArg*>(data);
+    arg.mapper->cutGenWorker(arg.thread_id);
+    return NULL;
+}
+
+
+void LutMap::cutGenWorker(uint thread_id)
+{
+    LutMap_Scratch& S = *scr[thread_id];
+    for (uint lv = 0; lv+1 < lv_start.size(); lv++){
+        uint end = lv_start[lv+1];
+        for(;;){
+            uint i = lv_start[lv] + atomicAdd(&lv_next[lv], (uint)CUTGEN_CHUNK);
+            if (i >= end) break;
+
+            uint stop = min_(i + CUTGEN_CHUNK, end);
+            for (; i < stop; i++)
+                generateCuts(lv_order[i] + N, S);
+        }
+        pthread_barrier_wait(&lv_barrier);
+    }
+}
+
+#else
+void LutMap::cutGenWorker(uint) { assert(false); }
+#endif
+
+
+void LutMap::generateAllCuts()
+{
+    for (uint t = 0; t < scr.size(); t++)
+        scr[t]->cuts_enumerated = 0;
+
+  #if defined(ZZ_PTHREADS)
+    if (scr.size() > 1){
+        // Grow maps written by worker threads to full size so they are never reallocated:
+        GLit last = GLit(N.size() - 1);
+        cutmap(last);
+        area_est(last);
+        arrival(last);
+
+        lv_next.reset(lv_start.size(), 0);
+        pthread_barrier_init(&lv_barrier, NULL, scr.size());
+
+        Vec<LutMap_ThreadArg> args(scr.size());
+        Vec<pthread_t>        threads(scr.size());
+        for (uint t = 1; t < scr.size(); t++){
+            args[t].mapper = this;
+            args[t].thread_id = t;
+            if (pthread_create(&threads[t], NULL, lutMapCutGenThread, &args[t]) != 0){
+                ShoutLn "ERROR! Could not create cut generation thread.";
+                exit(1); }
+        }
+        cutGenWorker(0);
+        for (uint t = 1; t < scr.size(); t++)
+            pthread_join(threads[t], NULL);
+
+        pthread_barrier_destroy(&lv_barrier);
+
+    }else
+  #endif
+    {
+        For_All_Gates(N, w)
+            generateCuts(w, *scr[0]);
+    }
+
+    cuts_enumerated = 0;
+    for (uint t = 0; t < scr.size(); t++)
+        cuts_enumerated += scr[t]->cuts_enumerated;
+}
+
+
+// Free all cuts. A cut array may have been allocated by any thread's arena; large arrays are
+// returned to 'malloc()' by 'dispose()', small ones are reclaimed by clearing the arenas.
+void LutMap::disposeCuts()
+{
+    for (uint i = 0; i < cutmap.base().size(); i++)
+        dispose(cutmap.base()[i], scr[0]->mem);
+    cutmap.clear();
+
+    for (uint t = 0; t < scr.size(); t++)
+        scr[t]->mem.clear();
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Exact local area:
 
@@ -957,13 +1115,14 @@ void LutMap::run()
         }
     }
 
+    if (scr.size() > 1)
+        computeLevels();
+
     // Techmap:
     uint last_round = P.n_rounds - 1 + (uint)P.map_for_delay;
     for (round = 0; round <= last_round; round++){
         double T0 = cpuTime();
-        cuts_enumerated = 0;
-        For_All_Gates(N, w)
-            generateCuts(w);
+        generateAllCuts();
         double T1 = cpuTime();
 
         bool instantiate = (round == last_round);
@@ -985,9 +1144,7 @@ void LutMap::run()
                         winner(w) = cutmap[w][0];
             }
 
-            for (uint i = 0; i < cutmap.base().size(); i++)
-                dispose(cutmap.base()[i], mem);
-            cutmap.clear();
+            disposeCuts();
         }
     }
 
@@ -1002,6 +1159,7 @@ LutMap::LutMap(Gig& N_, Params_LutMap P_, WMapX<GLit>* remap_) :
     P(P_), N(N_), remap(remap_)
 {
     assert(!N.is_frozen);
+    npn4Init();
 
     if (Has_Gob(N, Strash))
         Remove_Gob(N, Strash);
@@ -1027,6 +1185,15 @@ LutMap::LutMap(Gig& N_, Params_LutMap P_, WMapX<GLit>* remap_) :
 
     normalizeLut4s(N);
 
+    uint n_threads = max_(P.n_threads, 1u);
+  #if !defined(ZZ_PTHREADS)
+    if (n_threads > 1 && !P.quiet)
+        WriteLn "NOTE! Compiled without pthreads; generating cuts on a single thread.";
+    n_threads = 1;
+  #endif
+    for (uint t = 0; t < n_threads; t++)
+        scr.push(new LutMap_Scratch);
+
     // Run mapper:
     run();
   #if 1   /*DEBUG*/
@@ -1035,15 +1202,20 @@ LutMap::LutMap(Gig& N_, Params_LutMap P_, WMapX<GLit>* remap_) :
   #endif  /*END DEBUG*/
 
     // Free memory:
-    for (uint i = 0; i < cutmap.base().size(); i++)
-        dispose(cutmap.base()[i], mem);
-    mem.clear(false);
+    disposeCuts();
 
     area_est  .clear(true);
     fanout_est.clear(true);
 }
 
 
+LutMap::~LutMap()
+{
+    for (uint t = 0; t < scr.size(); t++)
+        delete scr[t];
+}
+
+
 // The 'remap' map will map old gates to new gates (with sign, so 'x' can go to '~y'). Naturally,
 // many signals may be gone; these are mapped to 'glit_NULL'. NOTE! Even inputs may be missing from
 // 'remap' if they are not in the transitive fanin of any output.
@@ -37,6 +37,7 @@ struct Params_LutMap {
     bool    use_fmux;           // Some architectures have a free MUX that can combine the outputs of two LUT6 with a third signal.
     bool    reprio;             // Re-prioritize cuts (should only be turned off for experimental purposes)
     bool    end_with_unmap;     // Instead of producing a mapped netlist, unmap the final design
+    uint    n_threads;          // Cut generation is done level by level on this many threads (requires 'ZZ_PTHREADS'). Result is independent of this value.
     bool    quiet;
 
     Params_LutMap() :
@@ -49,6 +50,7 @@ struct Params_LutMap {
         use_fmux(false),
         reprio(true),
         end_with_unmap(false),
+        n_threads(1),
         quiet(false)
     {
         for (uint i = 0; i < elemsof(lut_cost); i++)
@@ -0,0 +1,130 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Main_cut_bench.cc
+//| Module      : LutMap
+//| Description : Microbenchmark for 6-input cut enumeration.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Enumerates cuts of every AND gate of each given AIG using the same cut primitives as the LUT
+//| mapper ('mergeCuts()', 'subsumes()' and the signature filter of 'LutMap_Cut'). No cost
+//| function is used; the first 'cuts_per_node' cuts found are kept. Reports the best time over
+//| a number of runs as cuts per second.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "ZZ_Gig.hh"
+#include "ZZ_Gig.IO.hh"
+#include "Cut.hh"
+
+using namespace ZZ;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+static const uint cut_size      = 6;
+static const uint cuts_per_node = 10;    // -- same as the default of 'Params_LutMap'
+
+
+// Same as 'applySubsumptionAndAddCut()' of the mapper, minus the early abort on trivial cuts.
+static
+void addCut(const LutMap_Cut& cut, Vec<LutMap_Cut>& out)
+{
+    for (uint k = 0; k < out.size(); k++){
+        if (subsumes(out[k], cut))
+            return;
+
+        if (subsumes(cut, out[k])){
+            out[k] = cut;
+            for (k++; k < out.size();){
+                if (subsumes(cut, out[k])){
+                    out[k] = out.last();
+                    out.pop();
+                }else
+                    k++;
+            }
+            return;
+        }
+    }
+    out.push(cut);
+}
+
+
+// Returns the number of cuts enumerated (before truncating to 'cuts_per_node').
+static
+uint64 enumerateCuts(const Gig& N, uint64& n_merges)
+{
+    Vec<Vec<LutMap_Cut> > cutmap(N.size());
+    Vec<LutMap_Cut>       out;
+    uint64                n_cuts = 0;
+
+    For_UpOrder(N, w){
+        if (w != gate_And) continue;
+
+        const Vec<LutMap_Cut>& cs0 = cutmap[w[0].id];
+        const Vec<LutMap_Cut>& cs1 = cutmap[w[1].id];
+        LutMap_Cut triv0(w[0].id);
+        LutMap_Cut triv1(w[1].id);
+
+        out.clear();
+        for (int i0 = -1; i0 < (int)cs0.size(); i0++){ const LutMap_Cut& c0 = (i0 == -1) ? triv0 : cs0[i0];
+        for (int i1 = -1; i1 < (int)cs1.size(); i1++){ const LutMap_Cut& c1 = (i1 == -1) ? triv1 : cs1[i1];
+            if (moreThanKBitsSet(c0.abstr | c1.abstr, cut_size))
+                continue;
+            n_merges++;
+            LutMap_Cut cut = mergeCuts(c0, c1, cut_size);
+            if (!cut.null())
+                addCut(cut, out);
+        }}
+
+        n_cuts += out.size();
+        Vec<LutMap_Cut>& dst = cutmap[w.id];
+        for (uint i = 0; i < out.size() && i < cuts_per_node; i++)
+            dst.push(out[i]);
+    }
+
+    return n_cuts;
+}
+
+
+int main(int argc, char** argv)
+{
+    ZZ_Init;
+
+    if (argc < 2 || argv[1][0] == '-'){
+        ShoutLn "USAGE: cut_bench.exe <file.aig>...";
+        exit(1); }
+    uint runs = 5;
+
+    double total_T = 0;
+    uint64 total_cuts = 0;
+    for (int n = 1; n < argc; n++){
+        Gig N;
+        try{
+            readAigerFile(argv[n], N, false);
+        }catch (Excp_Msg& msg){
+            ShoutLn "PARSE ERROR! %_", msg;
+            exit(1);
+        }
+
+        double best = DBL_MAX;
+        uint64 n_cuts = 0, n_merges = 0;
+        for (uint i = 0; i < runs; i++){
+            n_merges = 0;
+            double T0 = cpuTime();
+            n_cuts = enumerateCuts(N, n_merges);
+            newMin(best, cpuTime() - T0);
+        }
+
+        WriteLn "%<24%_  ands: %>8%,d   cuts: %>10%,d   merges: %>11%,d   time: %>9%t   %>6%.2f Mcuts/s", argv[n], N.typeCount(gate_And), n_cuts, n_merges, best, n_cuts / best / 1e6;
+        total_T    += best;
+        total_cuts += n_cuts;
+    }
+
+    if (argc > 2){
+        NewLine;
+        WriteLn "Total: %,d cuts in %t  (%.2f Mcuts/s)", total_cuts, total_T, total_cuts / total_T / 1e6;
+    }
+
+    return 0;
+}
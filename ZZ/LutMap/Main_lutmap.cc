@@ -420,12 +420,12 @@ int main(int argc, char** argv)
 {
     ZZ_Init;
 
-    cli.add("input"   , "string", arg_REQUIRED, "Input AIGER, GIG or GNL.", 0);
-    cli.add("output"  , "string", ""          , "Output GNL, GIG or BLIF file (optional).", 1);
+    cli.add("input"   , "string", arg_REQUIRED, "Input AIGER, GIG, GNL or GNLI (binary image).", 0);
+    cli.add("output"  , "string", ""          , "Output GNL, GNLI, GIG or BLIF file (optional).", 1);
     cli.add("keep"    , "string", ""          , "List of forcable gates (only for GNL input).");
     cli.add("blif"    , "string", ""          , "Save original input in BLIF format (for debugging only). Add '@' as last character to skip mapping.");
     cli.add("pnl"     , "string", ""          , "Save original input in PNL format (for debugging only). Add '@' as last character to skip mapping.");
-    cli.add("gnl"     , "string", ""          , "Save original input in GNL format (for debugging only). Add '@' as last character to skip mapping.");
+    cli.add("gnl"     , "string", ""          , "Save original input in GNL format (or GNLI if extension says so). Add '@' as last character to skip mapping.");
     cli.add("gig"     , "string", ""          , "Save original input in GIG format (for debugging only). Add '@' as last character to skip mapping.");
     cli.add("prot"    , "bool"  , "no"        , "Protect fanout-free gates by adding a PO to each one.");
     cli.add("strash"  , "bool"  , "no"        , "Apply structural hashing before mapping.");
@@ -451,6 +451,7 @@ int main(int argc, char** argv)
     cli.add("remap"   , "string", ""          , "Write signal mapping to this file (requires 'sig' to be set).");
     cli.add("verif"   , "bool"  , "no"        , "Signal tracking verification -- output files for equivalence checking.");
     cli.add("unmap"   , "bool"  , "no"        , "Unmap final mapped design.");
+    cli.add("threads" , "uint"  , "1"         , "Generate cuts on this many threads (mapping result is the same for any value).");
     cli.parseCmdLine(argc, argv);
 
     String input  = cli.get("input").string_val;
@@ -469,6 +470,7 @@ int main(int argc, char** argv)
     P.reprio         = cli.get("reprio").bool_val;
     P.use_fmux       = cli.get("fmux").bool_val;
     P.end_with_unmap = cli.get("unmap").bool_val;
+    P.n_threads      = cli.get("threads").int_val;
 
     if (cli.get("cost").enum_val == 0){
         for (uint i = 0; i <= 6; i++)
@@ -505,7 +507,7 @@ int main(int argc, char** argv)
             closeChildIo(io);
             waitpid(pid, NULL, 0);
 
-        }else if (hasExtension(input, "gnl")){
+        }else if (hasExtension(input, "gnl") || hasExtension(input, "gnli")){
             N.load(input);
             if (cli.get("keep").string_val != ""){
                 Str text = readFile(cli.get("keep").string_val);
@@ -632,7 +634,8 @@ int main(int argc, char** argv)
             quit = true;
             gnl.pop(); }
 
-        N.save(gnl);
+        if (hasExtension(gnl, "gnli")) N.saveImage(gnl);
+        else                           N.save(gnl);
         WriteLn "Wrote: \a*%_\a*", gnl;
 
         if (quit) return 0;
@@ -794,6 +797,9 @@ int main(int argc, char** argv)
         }else if (hasExtension(output, "gnl")){
             N.save(output);
             WriteLn "Wrote: \a*%_\a*", output;
+        }else if (hasExtension(output, "gnli")){
+            N.saveImage(output);
+            WriteLn "Wrote: \a*%_\a*", output;
         }else if (hasExtension(output, "gig")){
             writeGigForTechmap(output, N);
             WriteLn "Wrote: \a*%_\a*", output;
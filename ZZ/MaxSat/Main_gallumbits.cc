@@ -17,6 +17,10 @@ int main(int argc, char** argv)
     cli.addCommand("core", "Core based solver.");
     cli.addCommand("sort", "Sorter based solver.");
     cli.addCommand("sort-down", "Sorter based solver, starting with SAT solution [still buggy!].");
+
+    CLI cli_port;
+    cli_port.add("threads", "bool", ZZ_If_Pthreads_Else("yes", "no"), "Run each engine on its own thread (otherwise interleaved).");
+    cli.addCommand("portfolio", "Core, stratified core and totalizer engines sharing bounds (supports weights).", &cli_port);
     cli.parseCmdLine(argc, argv);
 
     MaxSatProb P;
@@ -36,6 +40,8 @@ int main(int argc, char** argv)
         sorterMaxSat(P, false);
     else if (cli.cmd == "sort-down")
         sorterMaxSat(P, true);
+    else if (cli.cmd == "portfolio")
+        portfolioMaxSat(P, cli.get("threads").bool_val);
     else
         assert(false);
 
@@ -444,6 +444,530 @@ void coreMaxSat(MaxSatProb& P)
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Portfolio:
+
+
+/*
+Several engines work on private SAT solvers and meet only through 'MaxSatBounds':
+
+  - 'core'   -- WPM1 (Fu-Malik with weight splitting); raises the lower bound once per core.
+  - 'strat'  -- Same, but assumes only soft clauses above a weight threshold, lowered whenever
+                the current level is satisfiable. Each such model is a new upper bound.
+  - 'tot'    -- SAT-UNSAT linear search over a weighted totalizer. The totalizer is built once,
+                capped at the first upper bound; tightening only adds unit clauses.
+
+Every model found is scored on the original soft clauses and offered as an upper bound. Core
+engines remove ("harden") soft clauses too heavy to be violated under the shared upper bound.
+Solving is chopped into conflict-limited slices so that engines notice when the bounds meet.
+*/
+
+
+static const uint64 portfolio_slice   = 1000;       // -- conflicts per 'solve()' call
+static const uint64 portfolio_tot_lim = 4000000;    // -- clause limit for the totalizer
+
+
+struct MaxSatBounds {
+    volatile uint64 lb;
+    volatile uint64 ub;
+    volatile bool   done;
+    volatile bool   unsat;      // -- hard clauses are UNSAT
+
+    MaxSatBounds() : lb(0), ub(UINT64_MAX), done(false), unsat(false) {}
+};
+
+
+ZZ_Local_Lock(maxsat_bounds);
+
+
+static
+void reportBounds(MaxSatBounds& B, cchar* who)
+{
+    uint64 lb = B.lb, ub = B.ub;
+    if (ub == UINT64_MAX)
+        WriteLn "  %<5%_  lb: %_   ub: -   [%t cpu, %t real]", who, lb, cpuTime(), realTime();
+    else
+        WriteLn "  %<5%_  lb: %_   ub: %_   [%t cpu, %t real]", who, lb, ub, cpuTime(), realTime();
+}
+
+
+static
+void raiseLowerBound(MaxSatBounds& B, uint64 lb, cchar* who)
+{
+    ZZ_Scoped_Lock(maxsat_bounds);
+    if (lb <= B.lb) return;
+    B.lb = lb;
+    if (B.lb >= B.ub) B.done = true;
+    reportBounds(B, who);
+}
+
+
+static
+void flagUnsat(MaxSatBounds& B)
+{
+    ZZ_Scoped_Lock(maxsat_bounds);
+    B.unsat = true;
+    B.done  = true;
+}
+
+
+//=================================================================================================
+// -- Common engine state:
+
+
+struct MaxSatEngine {
+    cchar*        name;
+    MaxSatProb&   P;
+    MaxSatBounds& B;
+    MiniSat2      S;
+    Vec<Lit>      act;      // -- activation literal of each soft clause ('Lit_NULL' for hard clauses)
+
+    MaxSatEngine(cchar* name_, MaxSatProb& P_, MaxSatBounds& B_);
+    virtual ~MaxSatEngine() {}
+
+    virtual bool step() = 0;    // -- Returns TRUE when the engine has nothing more to contribute.
+
+    lbool  solve(const Vec<Lit>& assumps);
+    uint64 offerModel();        // -- Score current model and offer it as an upper bound. Returns its cost.
+};
+
+
+MaxSatEngine::MaxSatEngine(cchar* name_, MaxSatProb& P_, MaxSatBounds& B_) :
+    name(name_), P(P_), B(B_)
+{
+    while (S.nVars() < P.n_vars + 2)
+        S.addLit();
+
+    Vec<Lit> tmp;
+    for (uint i = 0; i < P.size(); i++){
+        tmp.clear();
+        for (uint j = 0; j < P[i].size(); j++)
+            tmp.push(Lit(P[i][j].id + 1, P[i][j].sign));    // -- first literal has index 2 (see 'sorterMaxSat()')
+
+        if (P.weight[i] == UINT64_MAX)
+            act.push(Lit_NULL);
+        else{
+            act.push(S.addLit());
+            tmp.push(~act[LAST]);
+        }
+        S.addClause(tmp);
+    }
+}
+
+
+lbool MaxSatEngine::solve(const Vec<Lit>& assumps)
+{
+    S.setConflictLim(portfolio_slice);
+    return S.solve(assumps);
+}
+
+
+uint64 MaxSatEngine::offerModel()
+{
+    uint64 cost = 0;
+    for (uint i = 0; i < P.size(); i++){
+        if (P.weight[i] == UINT64_MAX) continue;
+        bool sat = false;
+        for (uint j = 0; j < P[i].size() && !sat; j++)
+            sat = (S.value(Lit(P[i][j].id + 1, P[i][j].sign)) == l_True);
+        if (!sat)
+            cost += P.weight[i];
+    }
+
+    ZZ_Scoped_Lock(maxsat_bounds);
+    if (cost < B.ub){
+        B.ub = cost;
+        if (B.lb >= B.ub) B.done = true;
+        reportBounds(B, name);
+    }
+    return cost;
+}
+
+
+//=================================================================================================
+// -- Core guided engine (optionally stratified):
+
+
+struct MaxSatCore : MaxSatEngine {
+    Vec<Lit>    soft;       // -- activation literals of current soft constraints...
+    Vec<uint64> weight;     // -- ...and their remaining weight
+    uint64      lb;
+    uint64      thres;      // -- only soft constraints of at least this weight are assumed
+    uint64      ub_seen;
+    Vec<double> score;      // -- assumption order, bumped when relaxed (as in 'coreMaxSat()'); indexed by literal ID
+    double      score_inc;
+
+    MaxSatCore(cchar* name, MaxSatProb& P, MaxSatBounds& B, bool stratify);
+    bool step();
+
+    void harden();
+    void relax(const Vec<Lit>& core);
+};
+
+
+MaxSatCore::MaxSatCore(cchar* name, MaxSatProb& P, MaxSatBounds& B, bool stratify) :
+    MaxSatEngine(name, P, B), lb(0), thres(1), ub_seen(UINT64_MAX), score_inc(1.0)
+{
+    for (uint i = 0; i < act.size(); i++){
+        if (act[i] == Lit_NULL) continue;
+        soft.push(act[i]);
+        weight.push(P.weight[i]);
+        if (stratify) newMax(thres, P.weight[i]);
+    }
+}
+
+
+// Soft constraints weighing more than the gap between the bounds cannot be violated in any
+// improving solution; turn them into hard constraints.
+void MaxSatCore::harden()
+{
+    uint64 ub = B.ub;
+    if (ub >= ub_seen) return;
+    ub_seen = ub;
+
+    uint j = 0;
+    for (uint i = 0; i < soft.size(); i++){
+        if (lb < ub && weight[i] > ub - lb)
+            S.addClause(soft[i]);
+        else{
+            soft  [j] = soft  [i];
+            weight[j] = weight[i];
+            j++;
+        }
+    }
+    soft  .shrinkTo(j);
+    weight.shrinkTo(j);
+}
+
+
+// Split the weights of 'core' at their minimum, relax the split-off parts and allow at most one
+// of them to be violated.
+void MaxSatCore::relax(const Vec<Lit>& core)
+{
+    Vec<uint> idx(S.nVars(), UINT_MAX);
+    for (uint i = 0; i < soft.size(); i++)
+        idx[soft[i].id] = i;
+
+    uint64 w_min = UINT64_MAX;
+    for (uint i = 0; i < core.size(); i++)
+        newMin(w_min, weight[idx[core[i].id]]);
+
+    Vec<Lit> ps;
+    uint n_soft = soft.size();
+    for (uint i = 0; i < core.size(); i++){
+        uint k = idx[core[i].id];
+        Lit  p = S.addLit();
+        Lit  a = S.addLit();
+        S.addClause(p, ~a, soft[k]);
+        score(a.id, 0.0) = score(soft[k].id, 0.0) + score_inc;
+        weight[k] -= w_min;
+        soft  .push(a);
+        weight.push(w_min);
+        ps.push(p);
+    }
+
+    // Remove constraints whose weight dropped to zero (old activation literals are left free):
+    uint j = 0;
+    for (uint i = 0; i < soft.size(); i++){
+        if (i < n_soft && weight[i] == 0) continue;
+        soft  [j] = soft  [i];
+        weight[j] = weight[i];
+        j++;
+    }
+    soft  .shrinkTo(j);
+    weight.shrinkTo(j);
+
+    // At-most-one (sequential counter, added directly to the solver):
+    if (ps.size() <= 5){
+        for (uint i = 0; i < ps.size(); i++)
+            for (uint j = i+1; j < ps.size(); j++)
+                S.addClause(~ps[i], ~ps[j]);
+    }else{
+        Lit s = ps[0];
+        for (uint i = 1; i < ps.size(); i++){
+            S.addClause(~s, ~ps[i]);
+            if (i + 1 < ps.size()){
+                Lit t = S.addLit();
+                S.addClause(~s, t);
+                S.addClause(~ps[i], t);
+                s = t;
+            }
+        }
+    }
+
+    score_inc *= 1.05;
+    if (score_inc > 1e100){
+        for (uint i = 0; i < score.size(); i++) score[i] *= 1e-100;
+        score_inc *= 1e-100; }
+
+    lb += w_min;
+}
+
+
+bool MaxSatCore::step()
+{
+    harden();
+
+    Vec<Pair<double,Lit> > as;
+    uint64 next_thres = 0;
+    for (uint i = 0; i < soft.size(); i++){
+        if (weight[i] >= thres) as.push(make_tuple(-score(soft[i].id, 0.0), soft[i]));
+        else                    newMax(next_thres, weight[i]);
+    }
+    sort(as);
+
+    Vec<Lit> assumps;
+    for (uint i = 0; i < as.size(); i++)
+        assumps.push(as[i].snd);
+
+    lbool result = solve(assumps);
+    if (result == l_Undef)
+        return false;
+
+    if (result == l_True){
+        uint64 cost = offerModel();
+        if (next_thres == 0){
+            // All soft constraints assumed; 'lb' is optimal:
+            assert(cost == lb);
+            raiseLowerBound(B, lb, name);
+            return true;
+        }
+        thres = next_thres;
+        return false;
+    }
+
+    Vec<Lit> core;
+    S.getConflict(core);
+    if (core.size() == 0){
+        flagUnsat(B);
+        return true;
+    }
+    relax(core);
+    raiseLowerBound(B, lb, name);
+    return false;
+}
+
+
+//=================================================================================================
+// -- Totalizer based upper bounding:
+
+
+// Outputs of a weighted totalizer node: '(w, p)' where 'p' is implied if the relaxed inputs below
+// the node weigh 'w' (or more, if 'w' is the cap). Sorted on 'w'.
+typedef Vec<Pair<uint64,Lit> > TotNode;
+
+
+static
+Lit totOutput(const TotNode& node, uint64 w)
+{
+    uint lo = 0, hi = node.size();
+    while (hi - lo > 1){
+        uint mid = (lo + hi) / 2;
+        if (node[mid].fst <= w) lo = mid;
+        else                    hi = mid;
+    }
+    assert(node[lo].fst == w);
+    return node[lo].snd;
+}
+
+
+// Returns FALSE if more than 'budget' clauses would be needed.
+static
+bool totMerge(MetaSat& S, const TotNode& xs, const TotNode& ys, uint64 cap, TotNode& out, uint64& budget)
+{
+    uint64 n_clauses = xs.size() + ys.size() + uint64(xs.size()) * ys.size();
+    if (n_clauses > budget)
+        return false;
+    budget -= n_clauses;
+
+    Vec<uint64> ws;
+    for (uint i = 0; i < xs.size(); i++) ws.push(min_(xs[i].fst, cap));
+    for (uint j = 0; j < ys.size(); j++) ws.push(min_(ys[j].fst, cap));
+    for (uint i = 0; i < xs.size(); i++)
+        for (uint j = 0; j < ys.size(); j++)
+            ws.push(min_(xs[i].fst + ys[j].fst, cap));
+    sortUnique(ws);
+
+    out.clear();
+    for (uint i = 0; i < ws.size(); i++)
+        out.push(make_tuple(ws[i], S.addLit()));
+
+    for (uint i = 0; i < xs.size(); i++) S.addClause(~xs[i].snd, totOutput(out, min_(xs[i].fst, cap)));
+    for (uint j = 0; j < ys.size(); j++) S.addClause(~ys[j].snd, totOutput(out, min_(ys[j].fst, cap)));
+    for (uint i = 0; i < xs.size(); i++)
+        for (uint j = 0; j < ys.size(); j++)
+            S.addClause(~xs[i].snd, ~ys[j].snd, totOutput(out, min_(xs[i].fst + ys[j].fst, cap)));
+    return true;
+}
+
+
+struct MaxSatTot : MaxSatEngine {
+    TotNode root;
+    bool    built;
+    uint64  bound;          // -- current model must cost less than this
+    uint    n_blocked;      // -- number of root outputs (from the top) fixed to FALSE
+
+    MaxSatTot(cchar* name, MaxSatProb& P, MaxSatBounds& B) :
+        MaxSatEngine(name, P, B), built(false), bound(UINT64_MAX), n_blocked(0) {}
+
+    bool step();
+
+    bool build(uint64 cap);
+    void tighten(uint64 ub);
+};
+
+
+bool MaxSatTot::build(uint64 cap)
+{
+    // Leaves sorted on weight so that equal weights meet early (fewer distinct sums):
+    Vec<Pair<uint64,Lit> > leaves;
+    for (uint i = 0; i < act.size(); i++)
+        if (act[i] != Lit_NULL)
+            leaves.push(make_tuple(P.weight[i], ~act[i]));
+    sort(leaves);
+
+    Vec<TotNode> nodes(leaves.size());
+    for (uint i = 0; i < leaves.size(); i++)
+        nodes[i].push(make_tuple(min_(leaves[i].fst, cap), leaves[i].snd));
+
+    uint64 budget = portfolio_tot_lim;
+    while (nodes.size() > 1){
+        Vec<TotNode> next((nodes.size() + 1) / 2);
+        for (uint i = 0; i + 1 < nodes.size(); i += 2){
+            if (!totMerge(S, nodes[i], nodes[i+1], cap, next[i/2], budget))
+                return false;
+            nodes[i]  .clear(true);     // -- free memory early
+            nodes[i+1].clear(true);
+        }
+        if (nodes.size() & 1)
+            nodes.last().moveTo(next.last());
+        next.moveTo(nodes);
+    }
+
+    if (nodes.size() == 1)
+        nodes[0].moveTo(root);
+    built = true;
+    return true;
+}
+
+
+void MaxSatTot::tighten(uint64 ub)
+{
+    if (ub >= bound) return;
+    bound = ub;
+    while (n_blocked < root.size() && root[root.size() - 1 - n_blocked].fst >= bound){
+        S.addClause(~root[root.size() - 1 - n_blocked].snd);
+        n_blocked++;
+    }
+}
+
+
+bool MaxSatTot::step()
+{
+    if (built){
+        tighten(B.ub);
+        if (bound == 0 || B.lb >= bound)
+            return true;
+    }
+
+    Vec<Lit> no_assumps;
+    lbool result = solve(no_assumps);
+    if (result == l_Undef)
+        return false;
+
+    if (result == l_False){
+        if (!built) flagUnsat(B);
+        else        raiseLowerBound(B, bound, name);    // -- nothing cheaper than 'bound' exists
+        return true;
+    }
+
+    uint64 cost = offerModel();
+    if (!built && !build(cost)){
+        ZZ_Scoped_Lock(maxsat_bounds);
+        WriteLn "  %<5%_  totalizer too big; giving up.", name;
+        return true;
+    }
+    tighten(cost);
+    return false;
+}
+
+
+//=================================================================================================
+// -- Driver:
+
+
+#if defined(ZZ_PTHREADS)
+extern "C" void* maxSatEngineThread(void* data);
+void* maxSatEngineThread(void* data)
+{
+    MaxSatEngine& E = *static_cast<MaxSatEngine*>(data);
+    while (!E.B.done && !E.step());
+    return NULL;
+}
+#endif
+
+
+// Runs the core, stratified core (weighted instances only) and totalizer engines until the shared
+// bounds meet. Each engine gets its own thread if 'use_threads' is set (and pthreads are
+// available); otherwise engines are interleaved on the calling thread, one slice at a time.
+void portfolioMaxSat(MaxSatProb& P, bool use_threads)
+{
+    MaxSatBounds B;
+
+    bool weighted = false;
+    for (uint i = 0; i < P.size(); i++)
+        if (P.weight[i] != UINT64_MAX && P.weight[i] != 1)
+            weighted = true;
+
+    Vec<MaxSatEngine*> engines;
+    engines.push(new MaxSatCore("core", P, B, false));
+    engines.push(new MaxSatTot ("tot" , P, B));
+    if (weighted)
+        engines.push(new MaxSatCore("strat", P, B, true));
+
+  #if !defined(ZZ_PTHREADS)
+    use_threads = false;
+  #endif
+
+    if (!use_threads){
+        Vec<MaxSatEngine*> active(copy_, engines);
+        while (!B.done && active.size() > 0){
+            for (uint i = 0; i < active.size() && !B.done;){
+                if (active[i]->step()){
+                    active[i] = active.last();
+                    active.pop();
+                }else
+                    i++;
+            }
+        }
+
+    }else{
+      #if defined(ZZ_PTHREADS)
+        Vec<pthread_t> threads(engines.size());
+        for (uint i = 0; i < engines.size(); i++){
+            if (pthread_create(&threads[i], NULL, maxSatEngineThread, engines[i]) != 0){
+                ShoutLn "ERROR! Could not create MaxSat engine thread.";
+                exit(1); }
+        }
+        for (uint i = 0; i < engines.size(); i++)
+            pthread_join(threads[i], NULL);
+      #endif
+    }
+
+    for (uint i = 0; i < engines.size(); i++)
+        delete engines[i];
+
+    uint64 lb = B.lb, ub = B.ub;
+    if (B.unsat)
+        WriteLn "Hard clauses are UNSAT.";
+    else if (lb >= ub)
+        WriteLn "Optimal solution found. Cost: %_", ub;
+    else
+        WriteLn "Gave up. Bounds: [%_, %_]", lb, ub;
+    WriteLn "CPU-time: %t   Real-time: %t", cpuTime(), realTime();
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 }
 
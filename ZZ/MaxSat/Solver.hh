@@ -25,6 +25,7 @@ using namespace std;
 
 void sorterMaxSat(MaxSatProb& P, bool down);
 void coreMaxSat(MaxSatProb& P);
+void portfolioMaxSat(MaxSatProb& P, bool use_threads);
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
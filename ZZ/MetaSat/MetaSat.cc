@@ -561,6 +561,420 @@ bool MiniSat2s::exportCnf(const String& filename)
 }
 
 
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Parallel MiniSat 2.2 portfolio:
+
+
+// Learnt clauses are published into a ring buffer of 32-bit words. A record is:
+//
+//     [stamp] [size | producer << 24] [lit_0] ... [lit_{size-1}]
+//
+// A producer reserves space by atomically advancing 'head', writes the payload and then the
+// stamp (derived from the record position, with the top bit set so it can't be confused with
+// a literal). Each consumer keeps a private 'tail'. A record is consumed only once its stamp
+// is in place, and it is discarded if 'head' moved more than a full lap past it while reading
+// (the data may have been overwritten). Consumers that fall behind simply skip ahead; losing a
+// shared clause is harmless.
+
+static const uint   ring_size       = 1 << 18;   // -- in words (must be power of two)
+static const uint   share_max_size  = 8;         // }- clauses are shared if they are short OR have
+static const uint   share_max_lbd   = 3;         // }  a small LBD ("glue")...
+static const uint   share_hard_size = 32;        // -- ...but never longer than this
+static const uint   warmup_confls   = 1000;      // -- conflicts for instance 0 alone before threads are launched
+
+
+struct ParSat_Reader {
+    ParSat_Shared* shared;
+    uint           num;
+    uint64         tail;
+};
+
+
+struct ParSat_Shared {
+    volatile uint32     buf[ring_size];
+    volatile uint64     head;
+    volatile int        winner;
+    Vec<ParSat_Reader>  readers;
+
+    // Per solve:
+    MS::Solver* const*  solvers;
+    const MS_litvec*    assumps;
+    Vec<lbool>          results;
+
+    ParSat_Shared() : head(0), winner(-1), solvers(NULL), assumps(NULL) {
+        for (uint i = 0; i < ring_size; i++) buf[i] = 0; }
+};
+
+
+macro uint32 ringStamp(uint64 pos) { return 0x80000000u | (uint32)((pos + 1) & 0x7FFFFFFFu); }
+
+
+static
+void parSatExport(void* data, const MS::vec<MS::Lit>& c, int lbd)
+{
+    if (c.size() > (int)share_hard_size || (c.size() > (int)share_max_size && lbd > (int)share_max_lbd))
+        return;
+
+    ParSat_Reader& R = *static_cast<ParSat_Reader*>(data);
+    ParSat_Shared& H = *R.shared;
+    uint   n   = c.size() + 2;
+    uint64 pos = atomicAdd(&H.head, (uint64)n);
+
+    const uint mask = ring_size - 1;
+    H.buf[(pos + 1) & mask] = (uint32)c.size() | (R.num << 24);
+    for (int i = 0; i < c.size(); i++)
+        H.buf[(pos + 2 + i) & mask] = (uint32)MS::toInt(c[i]);
+    memoryBarrier();
+    H.buf[pos & mask] = ringStamp(pos);
+}
+
+
+static
+bool parSatImport(void* data, MS::vec<MS::Lit>& out)
+{
+    ParSat_Reader& R = *static_cast<ParSat_Reader*>(data);
+    ParSat_Shared& H = *R.shared;
+    const uint mask = ring_size - 1;
+
+    for(;;){
+        uint64 head = H.head;
+        if (head - R.tail > ring_size - share_hard_size - 2)
+            R.tail = head;              // -- fell behind; skip what we missed
+        if (R.tail == head)
+            return false;
+
+        uint64 pos = R.tail;
+        if (H.buf[pos & mask] != ringStamp(pos))
+            return false;               // -- producer has not finished writing the record yet
+        memoryBarrier();
+
+        uint32 hdr  = H.buf[(pos + 1) & mask];
+        uint   size = hdr & 0xFFFFFF;
+        uint   prod = hdr >> 24;
+        out.clear();
+        for (uint i = 0; i < size; i++)
+            out.push(MS::toLit((int)H.buf[(pos + 2 + i) & mask]));
+        memoryBarrier();
+
+        if (H.head - pos > ring_size){  // -- overwritten while we were reading
+            R.tail = H.head;
+            continue; }
+
+        R.tail = pos + size + 2;
+        if (prod != R.num && size <= share_hard_size)
+            return true;
+    }
+}
+
+
+// Make instance 'i' behave differently from the others (instance 0 uses MiniSat's defaults).
+static
+void configureInstance(MS::Solver& S, uint i)
+{
+    if (i == 0) return;
+
+    S.random_seed = 91648253 + 7919.0 * i;
+    switch (i % 4){
+    case 1: S.random_var_freq = 0.02; break;
+    case 2: S.luby_restart = false; S.rnd_init_act = true; break;
+    case 3: S.phase_saving = 0; S.var_decay = 0.90; break;
+    case 0: S.random_var_freq = 0.01; S.ccmin_mode = 1; break;
+    }
+    if (i >= 4)
+        S.rnd_pol = true;
+}
+
+
+#if defined(ZZ_PTHREADS)
+extern "C" void* parSatThread(void* data);
+void* parSatThread(void* data)
+{
+    ParSat_Reader& R = *static_cast<ParSat_Reader*>(data);
+    ParSat_Shared& H = *R.shared;
+    MS::Solver&    S = *H.solvers[R.num];
+
+    MS::lbool result = S.solveLimited(*H.assumps);
+    H.results[R.num] = fromMs(result);
+    if (result != MS::l_Undef && atomicCas(&H.winner, -1, (int)R.num)){
+        for (uint i = 0; i < H.readers.size(); i++)
+            if (i != R.num) H.solvers[i]->interrupt();
+    }
+    return NULL;
+}
+#endif
+
+
+ParSat::ParSat(uint n_solvers)
+{
+    if (n_solvers == 0)
+        n_solvers = ZZ_If_Pthreads_Else(max_(2u, min_(8u, numCpus())), 1);
+
+    MS_litvec& tmp  = *(MS_litvec*)(void*)&tmp_lits;
+    new (&tmp) MS_litvec;
+
+    shared = new ParSat_Shared;
+    shared->readers.setSize(n_solvers);
+    S.setSize(n_solvers, NULL);
+    for (uint i = 0; i < n_solvers; i++){
+        ParSat_Reader& R = shared->readers[i];
+        R.shared = shared;
+        R.num    = i;
+        R.tail   = 0;
+        S[i] = new MS::Solver;
+    }
+    init();
+}
+
+
+ParSat::~ParSat()
+{
+    for (uint i = 0; i < S.size(); i++)
+        delete S[i];
+    delete shared;
+}
+
+
+void ParSat::init()
+{
+    for (uint i = 0; i < S.size(); i++){
+        configureInstance(*S[i], i);
+        if (S.size() > 1){
+            S[i]->share_data   = &shared->readers[i];
+            S[i]->share_export = parSatExport;
+            S[i]->share_import = parSatImport;
+        }
+    }
+    confl_lim = UINT64_MAX;
+    winner = 0;
+
+    Lit null_lit = addLit(); assert(null_lit.id == 0);
+    true_lit = addLit();
+    MetaSat::addClause(true_lit);
+}
+
+
+void ParSat::clear(bool dealloc)
+{
+    for (uint i = 0; i < S.size(); i++){
+        S[i]->~Solver();
+        new (S[i]) MS::Solver;
+    }
+    init();
+}
+
+
+Lit ParSat::True() const
+{
+    return true_lit;
+}
+
+
+Lit ParSat::addLit()
+{
+    MS::Var x = S[0]->newVar();
+    for (uint i = 1; i < S.size(); i++){
+        MS::Var y = S[i]->newVar(); assert(x == y); }
+    return fromMs(MS::mkLit(x));
+}
+
+
+void ParSat::addClause_(const Vec<Lit>& ps)
+{
+    MS_litvec& tmp = *(MS_litvec*)(void*)&tmp_lits;
+    tmp.clear();
+    for (uint i = 0; i < ps.size(); i++)
+        tmp.push(toMs(ps[i]));
+
+    for (uint i = 0; i < S.size(); i++)
+        S[i]->addClause(tmp);
+}
+
+
+void ParSat::recycleLit(Lit p)
+{
+    // NOTE! 'releaseVar()' cannot be used: instances fix different variables at the top level and
+    // free released variables at different times, so 'newVar()' would return different numbers
+    // in different instances afterwards. Just set 'p' to TRUE (in all instances).
+    MetaSat::addClause(p);
+}
+
+
+void ParSat::setConflictLim(uint64 n_confl)
+{
+    confl_lim = n_confl;
+}
+
+
+lbool ParSat::solve_(const Vec<Lit>& assumps)
+{
+    MS_litvec& tmp = *(MS_litvec*)(void*)&tmp_lits;
+    tmp.clear();
+    for (uint i = 0; i < assumps.size(); i++)
+        tmp.push(toMs(assumps[i]));
+
+    bool   limited = (confl_lim < (uint64)INT64_MAX);
+    uint64 lim     = limited ? confl_lim : (uint64)INT64_MAX;
+    confl_lim = UINT64_MAX;
+    winner = 0;
+
+    // Warm-up on the calling thread:
+    uint64 confl0 = S[0]->conflicts;
+    if (S.size() > 1 || limited)
+        S[0]->setConfBudget((S.size() > 1) ? min_(lim, (uint64)warmup_confls) : lim);
+    lbool ret = fromMs(S[0]->solveLimited(tmp));
+    S[0]->budgetOff();
+    lim -= min_(lim, S[0]->conflicts - confl0);
+
+    if (ret != l_Undef || lim == 0 || S.size() == 1)
+        return ret;
+
+  #if defined(ZZ_PTHREADS)
+    // Run all instances in parallel:
+    ParSat_Shared& H = *shared;
+    H.solvers = S.base();
+    H.assumps = &tmp;
+    H.winner  = -1;
+    H.results.reset(S.size(), l_Undef);
+    for (uint i = 0; i < S.size(); i++)
+        if (limited) S[i]->setConfBudget(lim);
+
+    Vec<pthread_t> threads(S.size());
+    for (uint i = 0; i < S.size(); i++){
+        if (pthread_create(&threads[i], NULL, parSatThread, &H.readers[i]) != 0){
+            ShoutLn "ERROR! Could not create SAT solver thread.";
+            exit(1); }
+    }
+    for (uint i = 0; i < S.size(); i++)
+        pthread_join(threads[i], NULL);
+
+    for (uint i = 0; i < S.size(); i++){
+        S[i]->clearInterrupt();
+        S[i]->budgetOff(); }
+
+    if (H.winner == -1)
+        return l_Undef;
+    winner = H.winner;
+    return H.results[winner];
+
+  #else
+    // No threads; continue with instance 0 only:
+    if (limited) S[0]->setConfBudget(lim);
+    ret = fromMs(S[0]->solveLimited(tmp));
+    S[0]->budgetOff();
+    return ret;
+  #endif
+}
+
+
+void ParSat::randomizeVarOrder(uint64 seed)
+{
+    /*nothing yet*/
+}
+
+
+bool ParSat::okay() const
+{
+    for (uint i = 0; i < S.size(); i++)
+        if (!S[i]->okay()) return false;
+    return true;
+}
+
+
+lbool ParSat::value_(uint x) const
+{
+    return fromMs(S[winner]->modelValue(x));
+}
+
+
+void ParSat::getModel(Vec<lbool>& m) const
+{
+    m.setSize(nVars());
+    for (uint i = 0; i < nVars(); i++)
+        m[i] = fromMs(S[winner]->modelValue(i));
+}
+
+
+void ParSat::getConflict(Vec<Lit>& confl)
+{
+    confl.clear();
+    for (int i = 0; i < S[winner]->conflict.size(); i++)
+        confl.push(~fromMs(S[winner]->conflict[i]));
+}
+
+
+double ParSat::getActivity(uint x) const
+{
+    return S[winner]->activity[x] / S[winner]->var_inc;
+}
+
+
+uint ParSat::nClauses() const
+{
+    return S[0]->nClauses();
+}
+
+
+uint ParSat::nLearnts() const
+{
+    uint n = 0;
+    for (uint i = 0; i < S.size(); i++)
+        n += S[i]->nLearnts();
+    return n;
+}
+
+
+uint ParSat::nConflicts() const
+{
+    uint64 n = 0;
+    for (uint i = 0; i < S.size(); i++)
+        n += S[i]->conflicts;
+    return n;
+}
+
+
+uint ParSat::nVars() const
+{
+    return S[0]->nVars();
+}
+
+
+void ParSat::freeze(uint x)
+{
+    /*nothing*/
+}
+
+
+void ParSat::thaw(uint x)
+{
+    /*nothing*/
+}
+
+
+void ParSat::preprocess(bool /*final_call*/)
+{
+    /*nothing*/
+}
+
+
+void ParSat::getCnf(Vec<Lit>& out_cnf)
+{
+    assert(false);  // <<== later
+}
+
+
+void ParSat::setVerbosity(int verb_level)
+{
+    for (uint i = 0; i < S.size(); i++)
+        S[i]->verbosity = verb_level;
+}
+
+
+bool ParSat::exportCnf(const String& filename)
+{
+    return S[0]->exportCnf(filename.c_str());
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // ABC SAT wrapper:
 
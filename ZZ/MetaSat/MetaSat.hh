@@ -281,7 +281,37 @@ private:
 };
 
 
-//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+//- - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+
+
+struct ParSat_Shared;
+
+// Portfolio of differently configured MiniSat 2.2 instances solving the same CNF. On the first
+// call to 'solve()', instance 0 runs alone for a few conflicts (easy queries are common in
+// incremental use); if that does not settle the query, all instances are run on separate threads
+// and the first answer wins. Short or low-LBD learnt clauses are exchanged through a lock-free
+// ring buffer. Without 'ZZ_PTHREADS', this degenerates to a single MiniSat 2.2. Variables are
+// never reused; 'recycleLit()' just adds a unit clause.
+//
+struct ParSat : MetaSat {
+    ParSat(uint n_solvers = 0);     // -- '0' means pick based on the number of CPUs.
+    virtual ~ParSat();
+
+    MetaSat_OVERRIDES
+
+private:
+    Vec< ::Minisat::Solver*> S;
+    ParSat_Shared*           shared;
+    Lit                      true_lit;
+    minisat2_vec_data        tmp_lits;
+    uint64                   confl_lim;
+    uint                     winner;    // -- instance that answered last call to 'solve()'
+
+    void init();
+};
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // 'MultiSat' -- Dynamically become anyone of the wrapped solvers:
 
 
@@ -294,6 +324,7 @@ enum SolverType {
     sat_Glu,        // Glucose 2.2
     sat_Glr,        // GlucoRed by Siert Wieringa
     sat_Msr,        // MiniRed by Siert Wieringa
+    sat_Par,        // Multi-threaded portfolio of MiniSat 2.2 instances with clause sharing
 };
 
 
@@ -345,6 +376,7 @@ inline void MultiSat::selectSolver(SolverType type)
     case sat_Glu:  S = new GluSat()    ; break;
     case sat_Glr:  S = new GlrSat()    ; break;
     case sat_Msr:  S = new MiniRedSat(); break;
+    case sat_Par:  S = new ParSat()    ; break;
     default: assert(false); }
 }
 
@@ -80,6 +80,12 @@ Solver::Solver() :
   , learntsize_adjust_start_confl (100)
   , learntsize_adjust_inc         (1.5)
 
+    // Clause exchange:
+    //
+  , share_data   (NULL)
+  , share_export (NULL)
+  , share_import (NULL)
+
     // Statistics: (formerly in 'SolverStats')
     //
   , solves(0), starts(0), decisions(0), rnd_decisions(0), propagations(0), conflicts(0)
@@ -96,6 +102,7 @@ Solver::Solver() :
   , progress_estimate  (0)
   , remove_satisfied   (true)
   , next_var           (0)
+  , lbd_counter        (0)
 
     // Resource constraints:
     //
@@ -686,6 +693,71 @@ bool Solver::simplify()
 }
 
 
+/*_________________________________________________________________________________________________
+|
+|  computeLbd : (c : const vec<Lit>&)  ->  [int]
+|
+|  Description:
+|    Number of distinct decision levels among the literals of 'c' (all must be assigned).
+|________________________________________________________________________________________________@*/
+int Solver::computeLbd(const vec<Lit>& c)
+{
+    if (lbd_stamp.size() <= decisionLevel())
+        lbd_stamp.growTo(decisionLevel() + 1, 0);
+    lbd_counter++;
+
+    int n = 0;
+    for (int i = 0; i < c.size(); i++){
+        int l = level(var(c[i]));
+        if (lbd_stamp[l] != lbd_counter){
+            lbd_stamp[l] = lbd_counter;
+            n++; }
+    }
+    return n;
+}
+
+
+/*_________________________________________________________________________________________________
+|
+|  importClauses : (added : bool&)  ->  [bool]
+|
+|  Description:
+|    Fetch clauses through 'share_import()' and add them as learnt clauses, simplified by the
+|    top-level assignment. Must be called at decision level 0. Sets 'added' if any clause or unit
+|    was added. Returns FALSE if the solver became UNSAT.
+|________________________________________________________________________________________________@*/
+bool Solver::importClauses(bool& added)
+{
+    assert(decisionLevel() == 0);
+    vec<Lit>& c = import_tmp;
+    while (share_import(share_data, c)){
+        bool satisfied = false;
+        int  j = 0;
+        for (int i = 0; i < c.size(); i++){
+            if (var(c[i]) >= nVars() || value(c[i]) == l_True){
+                satisfied = true;   // -- (unknown variables should not happen; drop clause to be safe)
+                break; }
+            if (value(c[i]) == l_Undef)
+                c[j++] = c[i];
+        }
+        if (satisfied) continue;
+        c.shrink(c.size() - j);
+
+        added = true;
+        if (c.size() == 0)
+            return ok = false;
+        else if (c.size() == 1)
+            uncheckedEnqueue(c[0]);
+        else{
+            CRef cr = ca.alloc(c, true);
+            learnts.push(cr);
+            attachClause(cr);
+        }
+    }
+    return true;
+}
+
+
 /*_________________________________________________________________________________________________
 |
 |  search : (nof_conflicts : int) (params : const SearchParams&)  ->  [lbool]
@@ -716,6 +788,8 @@ lbool Solver::search(int nof_conflicts)
 
             learnt_clause.clear();
             analyze(confl, learnt_clause, backtrack_level);
+            if (share_export != NULL)
+                share_export(share_data, learnt_clause, computeLbd(learnt_clause));
             cancelUntil(backtrack_level);
 
             if (learnt_clause.size() == 1){
@@ -755,6 +829,15 @@ lbool Solver::search(int nof_conflicts)
             if (decisionLevel() == 0 && !simplify())
                 return l_False;
 
+            // Add clauses learnt by other solvers (propagate them before deciding):
+            if (decisionLevel() == 0 && share_import != NULL){
+                bool added = false;
+                if (!importClauses(added))
+                    return l_False;
+                if (added)
+                    continue;
+            }
+
             if (learnts.size()-nAssigns() >= max_learnts)
                 // Reduce the set of learnt clauses:
                 reduceDB();
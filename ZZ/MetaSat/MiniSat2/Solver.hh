@@ -149,6 +149,12 @@ public:
     int       learntsize_adjust_start_confl;
     double    learntsize_adjust_inc;
 
+    // Clause exchange with other solvers working on the same CNF (both hooks are optional):
+    //
+    void*     share_data;
+    void    (*share_export)(void* data, const vec<Lit>& learnt, int lbd);  // Called for each learnt clause.
+    bool    (*share_import)(void* data, vec<Lit>& out_clause);             // Polled at decision level 0 until it returns FALSE.
+
     // Statistics: (read-only member variable)
     //
     uint64_t solves, starts, decisions, rnd_decisions, propagations, conflicts;
@@ -228,6 +234,9 @@ public:
     vec<ShrinkStackElem>analyze_stack;
     vec<Lit>            analyze_toclear;
     vec<Lit>            add_tmp;
+    vec<Lit>            import_tmp;
+    vec<uint64_t>       lbd_stamp;
+    uint64_t            lbd_counter;
 
     double              max_learnts;
     double              learntsize_adjust_confl;
@@ -237,7 +246,7 @@ public:
     //
     int64_t             conflict_budget;    // -1 means no budget.
     int64_t             propagation_budget; // -1 means no budget.
-    bool                asynch_interrupt;
+    volatile bool       asynch_interrupt;   // May be set from another thread.
 
     // Main internal methods:
     //
@@ -256,6 +265,8 @@ public:
     void     reduceDB         ();                                                      // Reduce the set of learnt clauses.
     void     removeSatisfied  (vec<CRef>& cs);                                         // Shrink 'cs' to contain only non-satisfied clauses.
     void     rebuildOrderHeap ();
+    bool     importClauses    (bool& added);                                           // Add clauses from 'share_import()'. Returns FALSE if UNSAT.
+    int      computeLbd       (const vec<Lit>& c);                                     // Number of distinct decision levels in 'c'.
 
     // Maintaining Variable/Clause activity:
     //
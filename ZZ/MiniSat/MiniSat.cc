@@ -112,7 +112,8 @@ void MiniSat<pfl>::clear(bool dealloc, bool clear_stats)
     free_vars.clear(dealloc);
 
     wlDisposeAll();
-    watches.clear(dealloc);
+    watches    .clear(dealloc);
+    bin_watches.clear(dealloc);
 
     analyze_visit  .clear(dealloc);
     cl_tmp         .clear(dealloc);
@@ -141,19 +142,13 @@ void MiniSat<pfl>::clear(bool dealloc, bool clear_stats)
 #define wl_realloc(ptr, old_sz, new_sz) yrealloc(ptr, old_sz, new_sz)
 
 
-template<bool pfl>
-Array<GClause> MiniSat<pfl>::wlGet(Lit p)
-{
-    WHead& h = watches[p.data()];
-    return Array_new(h.get(), h.size());
-}
+// The watcher lists of long clauses and of binary clauses share the same representation. These
+// helpers operate on a single list:
 
 
-template<bool pfl>
-void MiniSat<pfl>::wlAdd(Lit p, GClause c)
+static inline   // -- (inline because Sun can't handle static functions called from template code correctly)
+void whAdd(WHead& h, GClause c)
 {
-    WHead& h = watches[p.data()];
-
     if (h.isExt()){
         // External data:
         if (h.size() == h.cap()){
@@ -184,11 +179,9 @@ void MiniSat<pfl>::wlAdd(Lit p, GClause c)
 }
 
 
-template<bool pfl>
-void MiniSat<pfl>::wlShrink(Lit p, uint new_size)
+static inline
+void whShrink(WHead& h, uint new_size)
 {
-    WHead& h = watches[p.data()];
-
     if (h.isExt()){
         // External data:
         GClause* ptr = h.ext();
@@ -205,29 +198,21 @@ void MiniSat<pfl>::wlShrink(Lit p, uint new_size)
 }
 
 
-template<bool pfl>
-void MiniSat<pfl>::wlPop(Lit p)
-{
-    WHead& h = watches[p.data()];
-    wlShrink(p, h.size() - 1);
-}
-
-
-template<bool pfl>
-void MiniSat<pfl>::wlClear(Lit p)
+static inline
+void whClear(WHead& h)
 {
-    WHead& h = watches[p.data()];
-
     if (h.isExt())
         wl_free(h.ext(), h.cap());
     h.size() = 0;
 }
 
 
-template<bool pfl>
-bool MiniSat<pfl>::wlRemove(Lit p, GClause c)
+// Removes 'c' from the list. Clauses in the list of long clauses are followed by a blocker
+// literal which is removed too.
+static inline
+bool whRemove(WHead& h, GClause c)
 {
-    Array<GClause> ws = wlGet(p);
+    Array<GClause> ws = Array_new(h.get(), h.size());
     if (ws.size() == 0) return false;
 
     uint j = 0;
@@ -235,22 +220,51 @@ bool MiniSat<pfl>::wlRemove(Lit p, GClause c)
     for (; ws[j] != c; j++) if (j >= ws.size()-1) return false; // <<== super temporary! (fix in removeVars()!)
 #if !defined(BLOCKING_LITERALS)
     for (; j < ws.size()-1; j++) ws[j] = ws[j+1];
-    wlPop(p);
+    whShrink(h, ws.size() - 1);
 #else
     if (c.isLit()){
         for (; j < ws.size()-1; j++) ws[j] = ws[j+1];
-        wlPop(p);
+        whShrink(h, ws.size() - 1);
     }else{
         for (; j < ws.size()-2; j++) ws[j] = ws[j+2];
-        wlPop(p);
-        wlPop(p);
+        whShrink(h, ws.size() - 2);
     }
 #endif
     return true;
 }
 
 
-// Deallocate memory allocated for watcher lists (but don't touch the actual 'watches[]' vector).
+template<bool pfl>
+Array<GClause> MiniSat<pfl>::wlGet(Lit p)
+{
+    WHead& h = watches[p.data()];
+    return Array_new(h.get(), h.size());
+}
+
+
+template<bool pfl> void MiniSat<pfl>::wlAdd   (Lit p, GClause c)    { whAdd   (watches[p.data()], c); }
+template<bool pfl> void MiniSat<pfl>::wlShrink(Lit p, uint new_size) { whShrink(watches[p.data()], new_size); }
+template<bool pfl> void MiniSat<pfl>::wlPop   (Lit p)               { whShrink(watches[p.data()], watches[p.data()].size() - 1); }
+template<bool pfl> void MiniSat<pfl>::wlClear (Lit p)               { whClear (watches[p.data()]); }
+template<bool pfl> bool MiniSat<pfl>::wlRemove(Lit p, GClause c)    { return whRemove(watches[p.data()], c); }
+
+
+template<bool pfl>
+Array<GClause> MiniSat<pfl>::blGet(Lit p)
+{
+    WHead& h = bin_watches[p.data()];
+    return Array_new(h.get(), h.size());
+}
+
+
+template<bool pfl> void MiniSat<pfl>::blAdd   (Lit p, Lit q)         { whAdd   (bin_watches[p.data()], GClause_new(q)); }
+template<bool pfl> void MiniSat<pfl>::blShrink(Lit p, uint new_size) { whShrink(bin_watches[p.data()], new_size); }
+template<bool pfl> void MiniSat<pfl>::blClear (Lit p)               { whClear (bin_watches[p.data()]); }
+template<bool pfl> bool MiniSat<pfl>::blRemove(Lit p, Lit q)         { return whRemove(bin_watches[p.data()], GClause_new(q)); }
+
+
+// Deallocate memory allocated for watcher lists (but don't touch the actual 'watches[]' and
+// 'bin_watches[]' vectors).
 template<bool pfl>
 void MiniSat<pfl>::wlDisposeAll()
 {
@@ -259,6 +273,11 @@ void MiniSat<pfl>::wlDisposeAll()
         if (h.isExt())
             wl_free(h.ext(), h.cap());
     }
+    for (uint i = 0; i < bin_watches.size(); i++){
+        WHead& h = bin_watches[i];
+        if (h.isExt())
+            wl_free(h.ext(), h.cap());
+    }
 }
 
 
@@ -579,8 +598,8 @@ void MiniSat<pfl>::newClause(const Vec<Lit>& ps_, clause_id id)
 
     if (!pfl && ps.size() == 2){
         // Create special binary clause watch:
-        wlAdd(~ps[0], GClause_new(ps[1]));
-        wlAdd(~ps[1], GClause_new(ps[0]));
+        blAdd(~ps[0], ps[1]);
+        blAdd(~ps[1], ps[0]);
         if (is_unit){
             bool ret = enqueue(ps[0], GClause_new(~ps[1])); assert(ret); }
 
@@ -683,17 +702,19 @@ void MiniSat<pfl>::simplifyDB_intern()
     if (!pfl){
         for (uint i = simpDB_assigns; i < nAssigns(); i++){
             Lit            p  = trail[i];
-            Array<GClause> ws = wlGet(~p);
+            Array<GClause> ws = blGet(~p);
             for (uint j = 0; j < ws.size(); j++){
-                if (ws[j].isLit() && wlRemove(~ws[j].lit(), GClause_new(p))) // -- remove binary GClause from "other" watcher list
+                if (blRemove(~ws[j].lit(), p))      // -- remove binary clause from "other" watcher list
                     n_bin_clauses--;
             }
 
-            ws = wlGet(p);
+            ws = blGet(p);
             for (uint j = 0; j < ws.size(); j++){
-                if (ws[j].isLit() && wlRemove(~ws[j].lit(), GClause_new(~p))) // -- remove binary GClause from "other" watcher list
+                if (blRemove(~ws[j].lit(), ~p))     // -- remove binary clause from "other" watcher list
                     n_bin_clauses--;
             }
+            blClear( p);
+            blClear(~p);
             wlClear( p);
             wlClear(~p);
         }
@@ -737,6 +758,8 @@ Var MiniSat<pfl>::newVar()
     x = nVars();
     watches     .push();          // -- list for positive literal
     watches     .push();          // -- list for negative literal
+    bin_watches .push();
+    bin_watches .push();
     vdata       .push();
 #if defined(EXPERIMENTAL)
     assign_     .push(l_Undef);
@@ -1024,6 +1047,26 @@ Clause* MiniSat<pfl>::propagate()
         stats.propagations++;
         simpDB_props--;
 
+        // Binary clauses first (no clause memory is touched):
+        if (!pfl){
+            Array<GClause> bs = blGet(p);
+            for (uint k = 0; k < bs.size(); k++){
+                Lit q = bs[k].lit();
+                if (!enqueue(q, GClause_new(p))){
+                    if (dl() == 0)
+                        ok = false;
+                    confl = propagate_tmpbin.clause(MEM);
+                    (*confl)[1] = ~p;
+                    (*confl)[0] = ~q;
+                    qhead = trail.size();
+                    n_inspections += k + 1;
+                    goto Done;
+                }
+            }
+            n_inspections += bs.size();
+        }
+
+        // Long clauses:
         Array<GClause> ws = wlGet(p);
         GClause*       i,* j, *end;
 
@@ -1033,101 +1076,82 @@ Clause* MiniSat<pfl>::propagate()
 #endif
         for (i = j = ws.base(), end = i + ws.size();  i != end;){
             n_inspections++;
-            if (i->isLit()){
-                if (!enqueue(i->lit(), GClause_new(p))){
-                    if (dl() == 0)
-                        ok = false;
-                    confl = propagate_tmpbin.clause(MEM);
-                    (*confl)[1] = ~p;
-                    (*confl)[0] = ~i->lit();
-
-                    qhead = trail.size();
-                    // Copy the remaining watches:
-                    while (i < end)
-                        *j++ = *i++;
-                }else
-                    *j++ = *i++;
-            }else{
-                Clause& c = *i->clause(MEM); i++;
 #if defined(BLOCKING_LITERALS)
-                assert(i->isBLit());
-                Lit block_lit = i->lit();
-                if (value(block_lit) == l_True)
-                //if (false)
-                {
-                    *j++ = GClause_new(&c, MEM);
-                    *j++ = *i++;
-                }else{
-                    i++;
+            assert(i[1].isBLit());
+            if (value(i[1].lit()) == l_True){
+                // Clause satisfied by blocker -- don't look at it:
+                *j++ = *i++;
+                *j++ = *i++;
+                continue;
+            }
+            Clause& c = *i->clause(MEM); i += 2;
 #else
-                {
+            Clause& c = *i->clause(MEM); i++;
 #endif
-                    assert(pfl || c.size() > 2);
-                    // Make sure the false literal is 'c[1]':
-                    Lit false_lit = ~p;
-                    if (c[0] == false_lit)
-                        c[0] = c[1], c[1] = false_lit;
-                    assert(c[1] == false_lit);
-
-                    // If 0th watch is true, then clause is already satisfied.
-                    Lit   first = c[0];
-                    lbool val   = value(first);
-                    if (val == l_True){
-                        *j++ = GClause_new(&c, MEM);
+            // Make sure the false literal is 'c[1]':
+            Lit false_lit = ~p;
+            if (c[0] == false_lit)
+                c[0] = c[1], c[1] = false_lit;
+            assert(c[1] == false_lit);
+
+            // If 0th watch is true, then clause is already satisfied.
+            Lit   first = c[0];
+            lbool val   = value(first);
+            if (val == l_True){
+                *j++ = GClause_new(&c, MEM);
 #if defined(BLOCKING_LITERALS)
-                        *j++ = GClause_newBLit(first);
+                *j++ = GClause_newBLit(first);
 #endif
-                    }else{
-                        // Look for new watch:
-                        for (uint k = 2; k < c.size(); k++){
-                            if (value(c[k]) != l_False){
-                                c[1] = c[k]; c[k] = false_lit;
-                                wlAdd(~c[1], GClause_new(&c, MEM));
+            }else{
+                // Look for new watch:
+                for (uint k = 2; k < c.size(); k++){
+                    if (value(c[k]) != l_False){
+                        c[1] = c[k]; c[k] = false_lit;
+                        wlAdd(~c[1], GClause_new(&c, MEM));
 #if defined(BLOCKING_LITERALS)
-                                wlAdd(~c[1], GClause_newBLit(c[0]));
+                        wlAdd(~c[1], GClause_newBLit(c[0]));
 #endif
-                                goto FoundWatch;
-                            }
-                        }
+                        goto FoundWatch;
+                    }
+                }
 
-                        // Did not find watch -- clause is unit under assignment:
-                        if (pfl && dl() == 0){
-                            // Log production of top-level unit clause:
-                            proof.beginChain(c.id());
-                            for (uint k = 1; k < c.size(); k++)
-                                proof.resolve(unit_id[c[k].id], ~c[k]);
-                            clause_id id = proof.endChain();    // <<=== verify result
-                            assert(unit_id[first.id] == clause_id_NULL || value(first) == l_False);    // -- if variable already has 'id', it must be with the other polarity and we should have derived the empty clause here
-                            if (value(first) != l_False)
-                                unit_id[first.id] = id;
-                            else{
-                                // Empty clause derived:
-                                proof.beginChain(unit_id[first.id]);
-                                proof.resolve(id, first);
-                                proof.endChain();    // <<=== verify result
-                            }
-                        }
+                // Did not find watch -- clause is unit under assignment:
+                if (pfl && dl() == 0){
+                    // Log production of top-level unit clause:
+                    proof.beginChain(c.id());
+                    for (uint k = 1; k < c.size(); k++)
+                        proof.resolve(unit_id[c[k].id], ~c[k]);
+                    clause_id id = proof.endChain();    // <<=== verify result
+                    assert(unit_id[first.id] == clause_id_NULL || value(first) == l_False);    // -- if variable already has 'id', it must be with the other polarity and we should have derived the empty clause here
+                    if (value(first) != l_False)
+                        unit_id[first.id] = id;
+                    else{
+                        // Empty clause derived:
+                        proof.beginChain(unit_id[first.id]);
+                        proof.resolve(id, first);
+                        proof.endChain();    // <<=== verify result
+                    }
+                }
 
-                        *j++ = GClause_new(&c, MEM);
+                *j++ = GClause_new(&c, MEM);
 #if defined(BLOCKING_LITERALS)
-                        *j++ = GClause_newBLit(first);
+                *j++ = GClause_newBLit(first);
 #endif
-                        if (!enqueue(first, GClause_new(&c, MEM))){
-                            if (dl() == 0)
-                                ok = false;
-                            confl = &c;
-                            qhead = trail.size();
-                            // Copy the remaining watches:
-                            while (i < end)
-                                *j++ = *i++;
-                        }
-                      FoundWatch:;
-                    }
+                if (!enqueue(first, GClause_new(&c, MEM))){
+                    if (dl() == 0)
+                        ok = false;
+                    confl = &c;
+                    qhead = trail.size();
+                    // Copy the remaining watches:
+                    while (i < end)
+                        *j++ = *i++;
                 }
+              FoundWatch:;
             }
         }
         wlShrink(p, ws.size() + j - i);
     }
+  Done:;
 
     stats.inspections += n_inspections;
     vt += n_inspections;
@@ -1244,6 +1268,7 @@ lbool MiniSat<pfl>::search(int nof_conflicts, int nof_learnts)
                 return l_False;
             }
             clause_id id = analyze(confl, learnt_clause);
+            if (pfl) proof.learned(id);
             //**/ShoutLn "%_", learnt_clause;
             newClause(learnt_clause, id);
             varDecayActivity();
@@ -1581,39 +1606,41 @@ void MiniSat<pfl>::removeVars(IntZet<Var>& xs, Vec<Var>& kept)
     for (uint i = 0; i < watches.size(); i++){
         Lit p = Lit(packed_, i);
         if (xs.has(p.id)){
-            Array<GClause> cs = wlGet(p);
-            for (uint j = 0; j < cs.size(); j++)
-                if (cs[j].isLit())
-                    bin_deleted++;
+            bin_deleted += blGet(p).size();
+            blClear(p);
             wlClear(p);
         }else{
-            Array<GClause> cs = wlGet(p);
+            Array<GClause> bs = blGet(p);
             uint j = 0;
+            for (uind k = 0; k < bs.size(); k++){
+                if (!xs.has(bs[k].lit().id))
+                    bs[j++] = bs[k];
+                else
+                    bin_deleted++;
+            }
+            blShrink(p, j);
+
+            Array<GClause> cs = wlGet(p);
+            j = 0;
             for (uind k = 0; k < cs.size(); k++){
 #if defined(BLOCKING_LITERALS)
                 assert(!cs[k].isBLit());
 #endif
-                bool keep = cs[k].isLit() ? (!xs.has(cs[k].lit().id)) :
-                                            !cs[k].clause(MEM)->tag();
+                bool keep = !cs[k].clause(MEM)->tag();
 #if !defined(BLOCKING_LITERALS)
                 if (keep){
                     cs[j] = cs[k];
                     j++;
-                }else if (cs[k].isLit())
-                    bin_deleted--;
+                }
 #else
                 if (keep){
                     cs[j] = cs[k];
                     j++;
-                    if (!cs[k].isLit()){
-                        k++;
-                        assert(cs[k].isBLit());
-                        cs[j] = cs[k];
-                        j++;
-                    }
-                }else if (cs[k].isLit())
-                    bin_deleted--;
-                else
+                    k++;
+                    assert(cs[k].isBLit());
+                    cs[j] = cs[k];
+                    j++;
+                }else
                     k++;
 #endif
             }
@@ -1645,6 +1672,8 @@ void MiniSat<pfl>::removeVars(IntZet<Var>& xs, Vec<Var>& kept)
 
         assert(wlGet( Lit(x)).size() == 0);
         assert(wlGet(~Lit(x)).size() == 0);
+        assert(blGet( Lit(x)).size() == 0);
+        assert(blGet(~Lit(x)).size() == 0);
 
         vdata[x] = MSVarData();
         activity[x] = 0;
@@ -1986,9 +2015,9 @@ void MiniSat<pfl>::exportCnf(Out& out, bool exclude_units)
             // Write binary clauses:
             for (uint i = 0; i < 2*nVars(); i++){
                 Lit p  = Lit(packed_, i);
-                Array<GClause> ws = wlGet(~p);
+                Array<GClause> ws = blGet(~p);
                 for (uint j = 0; j < ws.size(); j++){
-                    if (ws[j].isLit() && ws[j].lit() < p){
+                    if (ws[j].lit() < p){
                         ps.clear();
                         ps.push(p);
                         ps.push(ws[j].lit());
@@ -2042,13 +2071,16 @@ void MiniSat<pfl>::dumpState()
     WriteLn "watches:";
     for (uint i = 0; i < watches.size(); i++){
         Lit p = Lit(packed_, i);
+        Array<GClause> bs = blGet(p);
         Array<GClause> cs = wlGet(p);
-        if (cs.size() == 0) continue;
+        if (bs.size() == 0 && cs.size() == 0) continue;
 
         Write "  %C%_:", (i & 1) ? '\0' : ' ', p;
+        for (uint j = 0; j < bs.size(); j++)
+            Write " <%_>", bs[j].lit();
         for (uint j = 0; j < cs.size(); j++){
-            if (cs[j].isLit()) Write " <%_>", cs[j].lit();
-            else               Write " @%_", cs[j].offset();
+            if (cs[j].isBLit()) Write " [%_]", cs[j].lit();
+            else                Write " @%_", cs[j].offset();
         }
         NewLine;
     }
@@ -2124,6 +2156,7 @@ void MiniSat<pfl>::copyTo(MiniSat<pfl>& other) const
     cpy(vdata, other.vdata);
     cpy(free_vars, other.free_vars);
     cpy(watches, other.watches);
+    cpy(bin_watches, other.bin_watches);
     cpy(trail, other.trail);
     cpy(trail_lim, other.trail_lim);
     cpy(qhead, other.qhead);
@@ -2144,8 +2177,8 @@ void MiniSat<pfl>::copyTo(MiniSat<pfl>& other) const
     cpy(cc_cb_data, other.cc_cb_data);
 
     // Copy all external watcher lists:
-    for (uind i = 0; i < other.watches.size(); i++){
-        WHead& w = other.watches[i];
+    for (uind i = 0; i < 2 * other.watches.size(); i++){
+        WHead& w = (i < other.watches.size()) ? other.watches[i] : other.bin_watches[i - other.watches.size()];
         if (w.isExt()){
             GClause* src = w.ext_.data;
             uint sz = w.size();
@@ -2163,6 +2196,7 @@ template<bool pfl>
 void MiniSat<pfl>::moveTo(MiniSat<pfl>& other)
 {
     other.clear(true, true);
+    other.proof.closeFile();
     memcpy(&other, this, sizeof(*this));
     new (this) MiniSat<pfl>(proof.iterator());
 }
@@ -41,7 +41,7 @@ protected:
     Vec<GClause>    clauses;        // List of problem clauses. No literal GClauses.
     Vec<GClause>    learnts;        // List of learnt clauses. No literal GClauses.
     Vec<clause_id>  unit_id;        // In proof-logging mode: the clause IDs for unit literals.
-    int             n_bin_clauses;  // }- Keep track of number of binary clauses "inlined" into the watcher lists
+    int             n_bin_clauses;  // }- Keep track of number of binary clauses "inlined" into the binary watcher lists
     int             n_bin_learnts;  // }  (we do this primarily to get identical behavior to the version without the binary clauses trick).
     double          cla_inc;        // Amount to bump next clause with.
     double          cla_decay;      // INVERSE decay factor for clause activity: stores 1/decay.
@@ -88,7 +88,8 @@ protected:
     IntZet<Var>     free_vars;
 
     // BCP:
-    Vec<WHead>      watches;        // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true).
+    Vec<WHead>      watches;        // 'watches[lit]' is a list of constraints watching 'lit' (will go there if literal becomes true). Each clause is followed by a blocker literal.
+    Vec<WHead>      bin_watches;    // 'bin_watches[lit]' lists the literals implied by 'lit' through binary clauses (only used if '!pfl').
     Vec<Lit>        trail;          // Assignment stack; stores all assigments made in the order they were made.
     Vec<int>        trail_lim;      // Separator indices for different decision levels in 'trail'.
     int             qhead;          // Head of queue (as index into the trail -- no more explicit propagation queue in MiniSat).
@@ -136,6 +137,14 @@ protected:
     bool           wlRemove(Lit p, GClause c);
     void           wlDisposeAll();
 
+    // Same for binary clauses ('bl' = binary list):
+    //
+    Array<GClause> blGet   (Lit p);
+    void           blAdd   (Lit p, Lit q);
+    void           blShrink(Lit p, uint new_size);
+    void           blClear (Lit p);
+    bool           blRemove(Lit p, Lit q);
+
     // Clause memory management:
     //
     GClause   allocClause(bool learnt, const Vec<Lit>& ps);
@@ -284,6 +293,10 @@ public:
 
     void  proofTraverse    () { proof.iterate(conflict_id); }
     void  proofClearVisited() { proof.clearVisited(); }
+    void  proofUseFile     (String filename = "") { proof.useFile(filename); }
+    void  proofStreaming   (bool on = true)       { proof.setStreaming(on); }
+        // -- Disk-backed proof log and streaming traversal (see 'Proof::useFile()' and
+        // 'Proof::setStreaming()'). Both settings survive 'clear()'.
 
     void  randomizeVarOrder(uint64& seed, bool rnd_polarity = true);
     void  clearLearnts();
@@ -15,6 +15,9 @@
 
 #include "Proof.hh"
 #include "ZZ/Generics/Sort.hh"
+#include <sys/mman.h>
+#include <fcntl.h>
+#include <errno.h>
 
 //#define DEBUG_OUTPUT
 //#define DEBUG_CHECK_PROOF
@@ -73,7 +76,141 @@ void binResolve(Vec<Lit>& main, const Vec<Lit>& other, Lit p)
 }
 
 
-//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+// Proof storage:
+
+
+void PfStore::openFile(String filename)
+{
+    assert(!isFile());
+    if (filename == ""){
+        fd = tmpFile("/tmp/zz_proof_", filename);
+        if (fd != -1)
+            unlink(filename.c_str());   // -- file goes away when closed (or when the process dies)
+    }else
+        fd = ::open(filename.c_str(), O_RDWR | O_CREAT | O_TRUNC, 0644);
+    if (fd == -1)
+        throw Excp_Msg("Could not open proof file.");
+    fcntl(fd, F_SETFD, FD_CLOEXEC);
+
+    flushed    = 0;
+    unreleased = 0;
+    flush();        // -- offsets are preserved; everything so far goes to the file
+}
+
+
+void PfStore::closeFile()
+{
+    if (!isFile()) return;
+
+    if (base) munmap(base, mapped);
+    ::close(fd);
+    fd         = -1;
+    base       = NULL;
+    mapped     = 0;
+    flushed    = 0;
+    unreleased = 0;
+}
+
+
+void PfStore::flush()
+{
+    assert(isFile());
+    if (tail.size() == 0) return;
+
+    // Grow mapping if needed (reading never goes beyond 'flushed', so it may extend past EOF):
+    uint64 new_sz = flushed + tail.size();
+    if (new_sz > mapped){
+        uint64 sz = max_(2 * mapped, (uint64)1 << 30);
+        while (sz < new_sz) sz *= 2;
+        if (base) munmap(base, mapped);
+        void* p = mmap(NULL, sz, PROT_READ, MAP_SHARED | MAP_NORESERVE, fd, 0);
+        if (p == MAP_FAILED){
+            base = NULL;
+            mapped = 0;
+            throw Excp_Msg("Could not memory-map proof file."); }
+        base   = (uchar*)p;
+        mapped = sz;
+    }
+
+    uind pos = 0;
+    while (pos < tail.size()){
+        ssize_t n = pwrite(fd, &tail[pos], tail.size() - pos, flushed + pos);
+        if (n < 0){
+            if (errno == EINTR) continue;
+            throw Excp_Msg("Could not write proof file."); }
+        pos += n;
+    }
+    flushed = new_sz;
+    unreleased += tail.size();
+    tail.clear();
+
+    if (unreleased >= RELEASE_INTERVAL)
+        releasePages();
+}
+
+
+// Pages of the mapping read since last call stop counting towards the resident set (they stay
+// in the page cache and are brought back cheaply if needed again).
+void PfStore::releasePages()
+{
+    if (base && flushed > 0)
+        madvise(base, flushed, MADV_DONTNEED);
+    unreleased = 0;
+}
+
+
+void PfStore::clear()
+{
+    tail.clear(true);
+    if (isFile()){
+        if (base) madvise(base, flushed, MADV_DONTNEED);
+        if (ftruncate(fd, 0) != 0)
+            throw Excp_Msg("Could not truncate proof file.");
+        flushed    = 0;
+        unreleased = 0;
+    }
+}
+
+
+void PfStore::moveTo(PfStore& dst)
+{
+    dst.closeFile();
+    tail.moveTo(dst.tail);
+    dst.fd         = fd;
+    dst.flushed    = flushed;
+    dst.base       = base;
+    dst.mapped     = mapped;
+    dst.unreleased = unreleased;
+    fd         = -1;
+    base       = NULL;
+    mapped     = 0;
+    flushed    = 0;
+    unreleased = 0;
+}
+
+
+void PfStore::copyTo(PfStore& dst) const
+{
+    dst.closeFile();
+    dst.tail.clear(true);
+    if (!isFile()){
+        tail.copyTo(dst.tail);
+        return; }
+
+    dst.openFile("");
+    for (uint64 off = 0; off < flushed; off += CHUNK){
+        uint64 end = min_(flushed, off + CHUNK);
+        for (uint64 i = off; i < end; i++)
+            dst.tail.push(base[i]);
+        dst.flush();
+    }
+    for (uind i = 0; i < tail.size(); i++)
+        dst.tail.push(tail[i]);
+}
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Proof logging:
 
 
@@ -222,7 +359,7 @@ void Proof::deleted(clause_id gone)
             head[id] = PfHead();
         }
 
-        if ((uint64)freed_bytes * 4 > ext_data.size() + head.size() * sizeof(PfHead)){
+        if (!ext_data.isFile() && (uint64)freed_bytes * 4 > ext_data.size() + head.size() * sizeof(PfHead)){
             //**/WriteLn "Compacting %D bytes with %D unused (mem: %DB)", ext_data.size(), freed_bytes, memUsed();
             compact(); }
     }
@@ -244,6 +381,9 @@ struct ExtOffset_lt {
 
 void Proof::compact()
 {
+    assert(!ext_data.isFile());
+    Vec<uchar>& mem = ext_data.tail;
+
     Vec<clause_id> ids;
     for (uind id = 0; id < head.size(); id++){
         if (head[id].null() || !head[id].isExt()) continue;
@@ -259,7 +399,7 @@ void Proof::compact()
         assert(offset >= prev_offset);
 
         // Get size of block:
-        const uchar* data0 = &ext_data[offset]; assert_debug(data0 == head[id].data(ext_data));
+        const uchar* data0 = &mem[offset]; assert_debug(data0 == head[id].data(ext_data));
         const uchar* data  = data0;
         uint n = getu(data);
         if (!head[id].isRoot()) n = 2*n + 1;
@@ -269,14 +409,14 @@ void Proof::compact()
         // Move block:
         if (offset != prev_offset){
             for (uint i = 0; i < block_sz; i++)
-                ext_data[prev_offset + i] = ext_data[offset + i];
+                mem[prev_offset + i] = mem[offset + i];
             head[id].data_offset = ((uint64)prev_offset << 2) | (head[id].data_offset & 3);
         }
         prev_offset += block_sz;
     }
 
-    assert(freed_bytes == ext_data.size() - prev_offset);
-    ext_data.shrinkTo(prev_offset);
+    assert(freed_bytes == mem.size() - prev_offset);
+    mem.shrinkTo(prev_offset);
     freed_bytes = 0;
 }
 
@@ -352,6 +492,9 @@ void Proof::iterate(clause_id goal)
     proof_iter->begin();
     iterateRec(goal);
     proof_iter->end(goal);
+
+    if (ext_data.isFile())
+        ext_data.releasePages();
 }
 
 
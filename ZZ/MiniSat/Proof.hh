@@ -8,7 +8,11 @@
 //| (C) Copyright 2010-2014, The Regents of the University of California
 //|________________________________________________________________________________________________
 //|                                                                                  -- COMMENTS --
-//|
+//| Each clause ID has a 'PfHead'. Short clauses/chains are stored inline in the head, longer ones
+//| in a separate byte stream ('PfStore') which is either kept in memory (and compacted as clauses
+//| are freed) or written to an append-only file and read back through a memory mapping (see
+//| 'Proof::useFile()'). In the latter case, the memory footprint of the proof is about 10 bytes per
+//| live clause ID, independent of the length of the resolution chains.
 //|________________________________________________________________________________________________
 
 #ifndef ZZ__MiniSat__Proof_h
@@ -173,7 +177,51 @@ struct ProofCheck : public ProofIter {
 
 
 //=================================================================================================
-// -- Helper class:
+// -- Helper classes:
+
+
+// Byte stream holding the data of long clauses/chains. In memory mode, 'tail' holds everything.
+// In file mode, data is appended to 'tail' and written to the file in chunks; bytes at offsets
+// below 'flushed' are read through a read-only shared mapping of the file, which the kernel pages
+// in on demand (and which is released by 'releasePages()').
+//
+struct PfStore : public NonCopyable {
+    Vec<uchar>  tail;
+    int         fd;             // -- '-1' in memory mode
+    uint64      flushed;        // -- number of bytes written to the file
+    uchar*      base;           // -- mapping of the file (may be larger than the file itself)
+    uint64      mapped;         // -- size of mapping
+    uint64      unreleased;     // -- bytes written since last 'releasePages()'
+
+    enum { CHUNK = 1024 * 1024, RELEASE_INTERVAL = 64 * 1024 * 1024 };
+
+    PfStore() : fd(-1), flushed(0), base(NULL), mapped(0), unreleased(0) {}
+   ~PfStore() { closeFile(); }
+
+    bool   isFile() const { return fd != -1; }
+    uint64 size  () const { return flushed + tail.size(); }
+
+    const uchar* data(uint64 offset) const {
+        return (offset < flushed) ? base + offset : &tail[uind(offset - flushed)]; }
+
+    uint64 append(const Vec<uchar>& data) {    // -- returns offset of 'data'
+        if (size() == 0) tail.push(0);          // -- must not use offset 0
+        uint64 offset = size();
+        for (uind i = 0; i < data.size(); i++)
+            tail.push(data[i]);
+        if (isFile() && tail.size() >= CHUNK)
+            flush();
+        return offset;
+    }
+
+    void openFile(String filename);     // -- current contents is written to the new file
+    void closeFile();                   // -- pre-condition: store is empty (after 'clear()')
+    void flush();
+    void releasePages();
+    void clear();                       // -- file (if any) is kept, but truncated
+    void moveTo(PfStore& dst);          // -- leaves this store empty and in memory mode
+    void copyTo(PfStore& dst) const;    // -- 'dst' gets a new temporary file if this store is in file mode
+};
 
 
 struct PfHead {
@@ -185,20 +233,17 @@ struct PfHead {
     bool isExt() const {
         return (uchar(data_offset) & 2); }
 
-    const uchar* data(const Vec<uchar>& ext_data) const {
+    const uchar* data(const PfStore& ext_data) const {
         if (isExt())
-            return &ext_data[uind(data_offset >> 2)];
+            return ext_data.data(data_offset >> 2);
         else
             return (uchar*)&data_offset + 1;
     }
 
-    void storeData(Vec<uchar>& ext_data, bool is_root, const Vec<uchar>& data) {
+    void storeData(PfStore& ext_data, bool is_root, const Vec<uchar>& data) {
         data_offset = uind(is_root);
         if (data.size() > 7){
-            data_offset |= 2 | ((uint64)ext_data.size() << 2);
-            //**/if (data_offset < ext_data.size()) Dump(data_offset, ext_data.size());
-            for (uind i = 0; i < data.size(); i++)
-                ext_data.push(data[i]);
+            data_offset |= 2 | (ext_data.append(data) << 2);
         }else{
             uchar* inl_data = (uchar*)&data_offset + 1;
             for (uind i = 0; i < data.size(); i++)
@@ -225,9 +270,11 @@ class Proof : public NonCopyable {
     void markProcessed (clause_id id) { proc_mask(id >> 5, 0) |=  (1u << (id & 31)); }
     void clearProcessed(clause_id id) { proc_mask(id >> 5, 0) &= ~(1u << (id & 31)); }
 
+    bool streaming;                 // -- report learned clauses to 'proof_iter' as they are derived
+
     // Proof log:
     Vec<PfHead>      head;
-    Vec<uchar>       ext_data;
+    PfStore          ext_data;
     Vec<ushort>      refC;          // -- reference counting with saturation on 65535
     uind             freed_bytes;
     Queue<clause_id> free_list;     // -- recycled clause IDs
@@ -297,19 +344,19 @@ public:
 
     Proof(ProofIter* proof_iter_) :
         proof_iter(proof_iter_),
+        streaming(false),
         freed_bytes(0),
         last_id(clause_id_NULL)
     {
         PfHead dummy;
         dummy.data_offset = 1;
         assert( ((uchar*)&dummy.data_offset)[0] == 1 );  // -- verify layout of 'data_offset'
-        ext_data.push(0);   // -- must not use offset 0
     }
 
-    void clear() {          // -- 'proof_iter' is NOT reset!
+    void clear() {          // -- 'proof_iter', streaming mode and proof file are NOT reset!
         proc_mask.clear(true);
         head     .clear(true);
-        ext_data .clear(true);
+        ext_data .clear();
         refC     .clear(true);
         free_list.clear(true);
         chain_id .clear(true);
@@ -329,6 +376,7 @@ public:
         chain_id .moveTo(dst.chain_id);
         chain_lit.moveTo(dst.chain_lit);
         buf      .moveTo(dst.buf);
+        dst.streaming   = streaming;
         dst.last_id     = last_id;
         dst.freed_bytes = freed_bytes;
         last_id     = clause_id_NULL;
@@ -346,12 +394,25 @@ public:
         chain_id .copyTo(dst.chain_id);
         chain_lit.copyTo(dst.chain_lit);
         buf      .copyTo(dst.buf);
+        dst.streaming   = streaming;
         dst.last_id     = last_id;
         dst.freed_bytes = freed_bytes;
     }
 
     ProofIter* iterator() const { return proof_iter; }  // -- used internally in 'MiniSat.cc'; don't use directly.
 
+    void useFile(String filename = "") { ext_data.openFile(filename); }
+        // -- Keep proof data in an append-only file instead of in memory. If no filename is given,
+        // an anonymous temporary file is used. Freed data is not reclaimed (the file only grows).
+    void closeFile() { ext_data.closeFile(); }
+        // -- Go back to memory mode. Pre-condition: proof is empty (after 'clear()').
+
+    void setStreaming(bool on) { assert(!on || proof_iter); streaming = on; }
+        // -- In streaming mode, every learned clause is traversed as soon as it is derived (as if
+        // 'iterate()' was called on it). Final traversals are then almost free, at the cost of
+        // processing learned clauses that never become part of a final proof. Root clauses are
+        // still only reported when first used, so the iterator can classify their variables late.
+
   //________________________________________
   //  Proof Logging:
 
@@ -360,6 +421,8 @@ public:
     void      resolve   (clause_id next, Lit p);  // -- 'p' should be in clause 'next'; '~p' in the current chain.
     clause_id endChain  (const Vec<Lit>* result = NULL); // -- 'result' will be checked in special debug mode only.
     void      deleted   (clause_id gone);
+    void      learned   (clause_id id) { if (streaming) iterateRec(id); }
+        // -- Called by the solver for each conflict clause (may be called for any clause).
     clause_id last      () { return last_id; }
 
     bool revive(clause_id id) {
@@ -263,20 +263,22 @@ void readAiger_(In& in, NetlistRef N, bool store_comment)
         }
     }
 
-    // Read ANDs:
-    for (uind i = 0; i < n_Ands; i++){
-        uind delta0 = (uind)getUInt(in);
-        uind delta1 = (uind)getUInt(in);
-        uind my_id  = i + 1 + n_PIs + n_Flops;
-        uind lit0   = 2*my_id - delta0;
-        uind lit1   = lit0 - delta1;
-        Wire w_and  = N[aig2nl[my_id]]; assert_debug(type(w_and) == gate_And);
-        Wire w0     = N[aig2nl[lit0 >> 1]] ^ (lit0 & 1);
-        Wire w1     = N[aig2nl[lit1 >> 1]] ^ (lit1 & 1);
-        w_and.set(0, w0);
-        w_and.set(1, w1);
-        //printf("%u = %sx%u & %sx%u\n", my_id, (left&1)?"~":"", left>>1, (right&1)?"~":"", right>>1);
-        //printf("%u = %sx%u & %sx%u\n", my_id, sign(w0)?"~":"", id(w0) - gid_FirstUser + 1, sign(w1)?"~":"", id(w1) - gid_FirstUser + 1);
+    // Read ANDs (decoding the deltas in batches, see 'getUInts()'):
+    const uind batch = 8192;
+    Vec<uint> deltas(2 * batch);
+    for (uind i0 = 0; i0 < n_Ands; i0 += batch){
+        uind n = min_(batch, n_Ands - i0);
+        getUInts(in, deltas.base(), 2 * n);
+        for (uind j = 0; j < n; j++){
+            uind my_id  = i0 + j + 1 + n_PIs + n_Flops;
+            uind lit0   = 2*my_id - deltas[2*j];
+            uind lit1   = lit0 - deltas[2*j + 1];
+            Wire w_and  = N[aig2nl[my_id]]; assert_debug(type(w_and) == gate_And);
+            Wire w0     = N[aig2nl[lit0 >> 1]] ^ (lit0 & 1);
+            Wire w1     = N[aig2nl[lit1 >> 1]] ^ (lit1 & 1);
+            w_and.set(0, w0);
+            w_and.set(1, w1);
+        }
     }
 
     // Read names:
@@ -343,17 +345,32 @@ void readAiger(In& in, NetlistRef N, bool store_comment)
         throw Excp_AigerParseError(String("Unexpected end-of-file."));
     }catch (Excp_ParseNum err){
         throw Excp_AigerParseError(String("Incorrect number encoding: ") + Excp_ParseNum::Type_name[err.type]);
+    }catch (Excp_InZstreamError){
+        throw Excp_AigerParseError(String("Corrupt gzip stream."));
     }
 }
 
 
+// Opens files the same way as 'InFile' but decompresses gzipped files on a separate thread
+// (if compiled with 'ZZ_PTHREADS'), overlapping it with parsing.
 void readAigerFile(String filename, NetlistRef N, bool store_comment)
 {
-    InFile in(filename);
-    if (in.null())
+    bool gzipped = hasExtension(filename, "gz");
+    File file(filename, "r");
+    if (file.null() && !gzipped){
+        file.open(filename + ".gz", "r");
+        gzipped = true; }
+    if (file.null())
         throw Excp_AigerParseError(String("Could not open: ") + filename);
 
-    readAiger(in, N, store_comment);
+    if (gzipped){
+        GunzipReader gz(file);
+        In in(gz);
+        readAiger(in, N, store_comment);
+    }else{
+        In in(file);
+        readAiger(in, N, store_comment);
+    }
 }
 
 
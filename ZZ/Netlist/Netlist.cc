@@ -271,6 +271,9 @@ Pair<GLit*,gate_id> allocDynGate(Netlist_data& N, GateType type, uint n_inputs,
 // Netlist -- constructor/destructor:
 
 
+ZZ_Local_Lock(netlist_alloc);
+
+
 void reserveNetlists(uint count)
 {
     global_netlists_frozen_ = false;
@@ -292,6 +295,7 @@ void unreserveNetlists()
 Netlist::Netlist()
 {
     // Look for freed netlist:
+    ZZ_Acquire_Lock(netlist_alloc);
     netlist_id nid = global_netlists_first_free_;
     if (nid != nid_NULL){
         global_netlists_first_free_ = global_netlists_[nid].nl_next_free;
@@ -306,6 +310,7 @@ Netlist::Netlist()
         new (&global_netlists_[nid]) Netlist_data();
         global_netlists_sz_++;
     }
+    ZZ_Release_Lock(netlist_alloc);
 
     init(nid);
 }
@@ -359,8 +364,7 @@ void Netlist::init(netlist_id nid)
 Netlist::~Netlist()
 {
     Netlist_data& N = global_netlists_[this->nl_];
-    N.nl_next_free = global_netlists_first_free_;   // }- put netlist on free list
-    global_netlists_first_free_ = N.nl_;            // }
+    netlist_id    nid = N.nl_;
     N.nl_ = nid_NULL;       // -- indicates that the netlist has been freed
     N.mem.clear();
     N.gates.clear(true);
@@ -388,6 +392,10 @@ Netlist::~Netlist()
         delete N.send_proxy;
         N.send_proxy = NULL;
     }
+
+    ZZ_Scoped_Lock(netlist_alloc);
+    N.nl_next_free = global_netlists_first_free_;   // }- put netlist on free list (last, so that no other thread can grab it while being cleared)
+    global_netlists_first_free_ = nid;              // }
 }
 
 
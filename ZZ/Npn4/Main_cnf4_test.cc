@@ -137,6 +137,7 @@ int main(int argc, char** argv)
 int main(int argc, char** argv)
 {
     ZZ_Init;
+    npn4Init();
 
     ftb4_t ftb = 0;
   #if 0
@@ -0,0 +1,126 @@
+//_________________________________________________________________________________________________
+//|                                                                                      -- INFO --
+//| Name        : Main_startup_bench.cc
+//| Module      : Npn4
+//| Description : Measures process startup time and memory of every executable in a build tree.
+//|________________________________________________________________________________________________
+//|                                                                                  -- COMMENTS --
+//| Each '*.exe' found under the given build directory is run with '-h' (which parses the command
+//| line, prints usage and exits), so the time measured is dominated by static initialization.
+//| Reports the best wall clock time over a number of runs and the peak resident set size.
+//|________________________________________________________________________________________________
+
+#include "Prelude.hh"
+#include "Npn4.hh"
+#include "ZZ/Generics/Sort.hh"
+#include <sys/wait.h>
+#include <sys/resource.h>
+#include <fcntl.h>
+
+using namespace ZZ;
+
+
+//mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
+
+
+static
+void findExecutables(String dir, Vec<Pair<String,String> >& out)     // -- (name, full path)
+{
+    Vec<FileInfo> files, dirs;
+    if (!readDir(dir, files, dirs))
+        return;
+
+    for (uint i = 0; i < files.size(); i++)
+        if (hasSuffix(files[i].name, ".exe"))
+            out.push(make_tuple(files[i].name, files[i].full));
+
+    for (uint i = 0; i < dirs.size(); i++)
+        if (dirs[i].name[0] != '.' && dirs[i].name != "CMakeFiles")
+            findExecutables(dirs[i].full, out);
+}
+
+
+// Returns wall clock time of one run, or -1 if it timed out. 'max_rss' is in kB.
+static
+double runOnce(String exe, double timeout, uint64& max_rss)
+{
+    double T0 = realTime();
+    pid_t pid = fork();
+    if (pid == 0){
+        int fd = open("/dev/null", O_RDWR);
+        dup2(fd, 0); dup2(fd, 1); dup2(fd, 2);
+        execl(exe.c_str(), exe.c_str(), "-h", (char*)NULL);
+        _exit(127);
+    }
+
+    struct rusage usage;
+    for(;;){
+        pid_t ret = wait4(pid, NULL, WNOHANG, &usage);
+        if (ret == pid)
+            break;
+        if (realTime() - T0 > timeout){
+            kill(pid, SIGKILL);
+            wait4(pid, NULL, 0, &usage);
+            return -1;
+        }
+        usleep(100);
+    }
+    double T = realTime() - T0;
+
+    newMax(max_rss, (uint64)usage.ru_maxrss);
+    return T;
+}
+
+
+int main(int argc, char** argv)
+{
+    ZZ_Init;
+
+    if (argc > 3 || (argc > 1 && argv[1][0] == '-')){
+        ShoutLn "USAGE: startup_bench.exe [<build dir>] [<runs per executable>]";
+        exit(1); }
+    String dir     = (argc > 1) ? argv[1] : ".";
+    uint   runs    = (argc > 2) ? max_(1, atoi(argv[2])) : 5;
+    double timeout = 5;     // -- seconds; some executables ignore '-h' and start working
+
+    // Lazily built tables (not part of startup, but shown for reference):
+    double T0 = realTime();
+    npn4Init();
+    double T1 = realTime();
+    npn4Init();
+    double T2 = realTime();
+    WriteLn "npn4Init()    : %t first call, %t second call", T1 - T0, T2 - T1;
+    NewLine;
+
+    Vec<Pair<String,String> > exes;
+    findExecutables(dir, exes);
+    sort(exes);
+
+    double total = 0;
+    uint   n_timeouts = 0;
+    for (uint i = 0; i < exes.size(); i++){
+        double best = DBL_MAX;
+        uint64 max_rss = 0;
+        for (uint n = 0; n < runs; n++){
+            double T = runOnce(exes[i].snd, timeout, max_rss);
+            if (T < 0){ best = -1; break; }
+            newMin(best, T);
+        }
+
+        if (best < 0){
+            WriteLn "%<24%_   timeout", exes[i].fst;
+            n_timeouts++;
+        }else{
+            WriteLn "%<24%_ %>10%t  %>8%_ kB", exes[i].fst, best, max_rss;
+            total += best;
+        }
+    }
+
+    NewLine;
+    WriteLn "Executables   : %_  (%_ timed out)", exes.size(), n_timeouts;
+    WriteLn "Total startup : %t", total;
+    if (exes.size() > n_timeouts)
+        WriteLn "Average       : %t", total / (exes.size() - n_timeouts);
+
+    return 0;
+}
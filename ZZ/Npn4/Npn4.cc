@@ -89,12 +89,13 @@ pseq4_t inv_pseq4     [256];
 pseq4_t perm4_to_pseq4[24];
 perm4_t inv_perm4     [24];
 
-ftb4_t apply_perm4    [24][65536];
-ftb4_t apply_inv_perm4[24][65536];
-ftb4_t apply_negs4    [32][65536];
+ftb4_t npn4_perm_half[24][2][256];
+ftb4_t npn4_negs_half[16][2][256];
 
 uint npn4_just[222][16];     // -- list of minimal justifications for each function
 
+volatile bool npn4_ready = false;
+
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Internal helpers:
@@ -119,7 +120,7 @@ static ftb4_t permutePseq4(ftb4_t ftb, pseq4_t pseq)
 }
 
 
-// About 5 times slower than the table driven permutation (not too bad)
+// About 5 times slower than 'applyPerm4()' (not too bad)
 static
 ftb4_t permute4(ftb4_t f, perm4_t perm)
 {
@@ -250,14 +251,16 @@ void genPseqMaps()
 }
 
 
+// Permutations and input negations only move bits around, so they distribute over OR and can be
+// applied to each byte of the FTB separately. Two 256 entry tables per transformation replace the
+// full 64K entry tables (40 KB instead of 11 MB).
 static
 void genApplyPerm()
 {
     for (perm4_t perm = 0; perm < 24; perm++){
-        for (uint ftb = 0; ftb < 65536; ftb++){
-            ftb4_t f = permute4(ftb, perm);
-            apply_perm4[perm][ftb] = f;
-            apply_inv_perm4[perm][f]   = ftb;
+        for (uint b = 0; b < 256; b++){
+            npn4_perm_half[perm][0][b] = permute4(b, perm);
+            npn4_perm_half[perm][1][b] = permute4(b << 8, perm);
         }
     }
 }
@@ -266,10 +269,10 @@ void genApplyPerm()
 static
 void genApplyNegs()
 {
-    for (negs4_t negs = 0; negs < 32; negs++){
-        for (uint ftb = 0; ftb < 65536; ftb++){
-            ftb4_t f = negate4(ftb, negs);
-            apply_negs4[negs][ftb] = f;
+    for (negs4_t negs = 0; negs < 16; negs++){
+        for (uint b = 0; b < 256; b++){
+            npn4_negs_half[negs][0][b] = negate4(b, negs);
+            npn4_negs_half[negs][1][b] = negate4(b << 8, negs);
         }
     }
 }
@@ -285,7 +288,7 @@ void genNpnNorm()
         ftb4_t ftb = npn4_repr[cl];
         for (negs4_t negs = 0; negs < 32; negs++){
             for (perm4_t perm = 0; perm < 24; perm++){
-                ftb4_t f = apply_negs4[negs][apply_perm4[perm][ftb]];
+                ftb4_t f = applyNegs4(negs, applyPerm4(perm, ftb));
                 if (npn4_norm[f].eq_class == 255){
                     npn4_norm[f].eq_class = cl;
                     npn4_norm[f].perm = perm;
@@ -355,9 +358,16 @@ void genNpnJust()   // -- takes about 1.2 ms
 }
 
 
+// Only the small tables are built at startup (a few microseconds); the rest is left to 'npn4Init()'.
 ZZ_Initializer(npn4, -9500) {
     adjustSupport();
     genPseqMaps();
+}
+
+
+static
+void buildTables()
+{
     genApplyPerm();
     genApplyNegs();
     genNpnNorm();
@@ -365,6 +375,23 @@ ZZ_Initializer(npn4, -9500) {
 }
 
 
+#if defined(ZZ_PTHREADS)
+static pthread_once_t npn4_once = PTHREAD_ONCE_INIT;
+#endif
+
+
+void npn4Build()
+{
+  #if defined(ZZ_PTHREADS)
+    pthread_once(&npn4_once, buildTables);
+  #else
+    if (!npn4_ready)
+        buildTables();
+  #endif
+    npn4_ready = true;      // -- (set after the tables are complete; 'pthread_once()' is a full barrier)
+}
+
+
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
 // Ftb6 like interface:
 
@@ -58,7 +58,7 @@ macro bool validPseq4(pseq4_t pseq) {
 static const ftb4_t lut4_buf[4] = { 0xAAAA, 0xCCCC, 0xF0F0, 0xFF00 };
 static const ftb4_t lut4_inv[4] = { 0x5555, 0x3333, 0x0F0F, 0x00FF };
 
-extern Npn4Norm npn4_norm   [65536];
+extern Npn4Norm npn4_norm   [65536];  // -- NOTE! Built by 'npn4Init()'.
 extern ftb4_t   npn4_repr   [222];
 extern uchar    npn4_repr_sz[222];  // -- size of support
 
@@ -67,11 +67,30 @@ extern pseq4_t inv_pseq4     [256];
 extern pseq4_t perm4_to_pseq4[24];
 extern perm4_t inv_perm4     [24];
 
-extern ftb4_t apply_perm4    [24][65536];
-extern ftb4_t apply_inv_perm4[24][65536];
-extern ftb4_t apply_negs4    [32][65536];
+extern ftb4_t npn4_perm_half[24][2][256];   // -- permutation of low/high byte of an FTB; use 'applyPerm4()'
+extern ftb4_t npn4_negs_half[16][2][256];   // -- same for input negations; use 'applyNegs4()'
 
-extern uint npn4_just[222][16];     // -- list of minimal justifications for each function
+extern uint npn4_just[222][16];     // -- list of minimal justifications for each function (built by 'npn4Init()')
+
+
+extern volatile bool npn4_ready;
+void npn4Build();
+
+macro void npn4Init() { if (!npn4_ready) npn4Build(); }
+    // -- Must be called before using 'npn4_norm', 'npn4_just', 'applyPerm4()' or 'applyNegs4()'.
+    // The tables are built by the first call (about a millisecond), so processes that never use
+    // them don't pay for them. Cheap to call repeatedly; thread safe.
+
+
+macro ftb4_t applyPerm4(perm4_t perm, ftb4_t ftb) {
+    return npn4_perm_half[perm][0][ftb & 0xFF] | npn4_perm_half[perm][1][ftb >> 8]; }
+
+macro ftb4_t applyInvPerm4(perm4_t perm, ftb4_t ftb) {
+    return applyPerm4(inv_perm4[perm], ftb); }
+
+macro ftb4_t applyNegs4(negs4_t negs, ftb4_t ftb) {
+    ftb4_t f = npn4_negs_half[negs & 15][0][ftb & 0xFF] | npn4_negs_half[negs & 15][1][ftb >> 8];
+    return (negs & 16) ? ftb4_t(~f) : f; }
 
 // Some useful NPN classes:
 static const uchar npn4_cl_TRUE   = 0;
@@ -114,6 +114,7 @@ void upOrderBfs(Gig& N, Vec<gate_id>& result)
 static
 bool muxInputs(Gig& N, const Cut& c, Wire& w0, Wire& w1, Wire& w2, bool assert_is_mux = false)
 {
+    npn4Init();
     Npn4Norm n = npn4_norm[(ushort)c.ftb()];
     if (n.eq_class == npn4_cl_MUX){  // -- pin order: (pin0 ? pin2 : pin1)
         pseq4_t seq = perm4_to_pseq4[n.perm];
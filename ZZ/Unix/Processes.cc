@@ -123,6 +123,11 @@ char startProcess(const String& cmd, const Vec<String>& args, int& out_pid, int
             prctl(PR_SET_PDEATHSIG, mode.pdeath_sig);
       #endif
 
+        // Don't inherit signals blocked by the parent (e.g. for use with 'signalfd()'):
+        sigset_t empty_mask;
+        sigemptyset(&empty_mask);
+        sigprocmask(SIG_SETMASK, &empty_mask, NULL);
+
         // Setup process mode:
         if (mode.username != "" && !setUser(mode.username)) fail(signal_pipe, 'u');
         if (mode.dir != "" && chdir(mode.dir.c_str()) == -1) fail(signal_pipe, 'd');
@@ -30,6 +30,7 @@ int main(int argc, char** argv)
     cli.add("verific", "bool", "yes", "If no, Verific operators are black-boxed.");
     cli.add("dump-mods", "bool", "no", "[DEBUG]. Write down individual modules to aiger files.");
     cli.add("dump-sigs", "bool", "no", "[DEBUG]. Write signatures of all modules to stdout.");
+    cli.add("threads", "uint", "1", "Build module netlists on this many threads (result is the same for any value).");
 
     cli.add("undecl-sym", "{ignore, warn, error}", "warn"  , "Warn if nets are used before they are declared, or if they are never declared.");
     cli.add("dang-logic", "{ignore, warn, error}", "warn"  , "Warn if module contains logic that is not feeding into any output.");
@@ -49,6 +50,11 @@ int main(int argc, char** argv)
     String sizes  = cli.get("sizes").string_val;
     bool   dump_mods = cli.get("dump-mods").bool_val;
     bool   dump_sigs = cli.get("dump-sigs").bool_val;
+    uint   n_threads = cli.get("threads").int_val;
+  #if !defined(ZZ_PTHREADS)
+    if (n_threads > 1)
+        WriteLn "NOTE! Compiled without pthreads; parsing on a single thread.";
+  #endif
     Params_Flatten P;
     P.store_names      = cli.get("names").enum_val;
     P.strict_aig       = !cli.get("muxes").bool_val;
@@ -102,6 +108,7 @@ int main(int argc, char** argv)
 
     // Parse Verilog:    
     Vec<VerilogModule> modules;
+    VerilogStats stats;
     SC_Lib L;
     try{
         String prelude;
@@ -113,7 +120,7 @@ int main(int argc, char** argv)
             genPrelude(L, prelude, true);
         }
 
-        readVerilog((meta_input == "") ? input : meta_input, P.store_names, err, modules, prelude.slice());
+        readVerilog((meta_input == "") ? input : meta_input, P.store_names, err, modules, prelude.slice(), n_threads, &stats);
 
     }catch(Excp_ParseError err){
         if (meta_input != "") unlink(meta_input.c_str());
@@ -123,6 +130,13 @@ int main(int argc, char** argv)
     if (meta_input != "") unlink(meta_input.c_str());
     double T0 = cpuTime();
     WriteLn "Parsing: %t", T0;
+    {
+        double mb = stats.n_bytes / 1e6;
+        WriteLn "  read + preprocess : %>9%t   %>8%.1f MB/s", stats.t_read , mb / stats.t_read;
+        WriteLn "  tokenize          : %>9%t   %>8%.1f MB/s   (%_ tokens)", stats.t_lex  , mb / stats.t_lex, stats.n_tokens;
+        WriteLn "  scan interfaces   : %>9%t   %>8%.1f MB/s   (%_ modules)", stats.t_scan , mb / stats.t_scan, stats.n_modules;
+        WriteLn "  build modules     : %>9%t   %>8%.1f MB/s   (%_ thread%s)", stats.t_build, mb / stats.t_build, stats.n_threads, (stats.n_threads == 1) ? "" : "s";
+    }
 
     // Dump modules?
     if (dump_mods){
@@ -146,13 +160,15 @@ int main(int argc, char** argv)
 
     // Flatten design:
     Netlist N_flat;
+    double T0_real = realTime();
     uint top = flatten(modules, N_flat, P);
     if (top == UINT_MAX){
         WriteLn "ERROR! Could not determine top module!";
         exit(1);
     }
     double T1 = cpuTime();
-    WriteLn "Flattening: %t", T1-T0;
+    double T_flat = realTime() - T0_real;
+    WriteLn "Flattening: %t   (%.2f Mgates/s)", T1-T0, N_flat.gateCount() / T_flat / 1e6;
     WriteLn "Top module: #%_ %_", top, modules[top].mod_name;
     WriteLn "Flattened statistics -- %_", info(N_flat);
 
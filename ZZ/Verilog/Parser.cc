@@ -14,6 +14,11 @@
 #include "Prelude.hh"
 #include "Parser.hh"
 #include "ZZ/Generics/RefC.hh"
+#include "ZZ/Generics/Set.hh"
+#include "ZZ/Generics/Sort.hh"
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <fcntl.h>
 
 //#define PARSER_DEBUG
 
@@ -457,6 +462,7 @@ template<> fts_macro void write_(Out& out, const VExpr& e)
 
 
 struct ParserListener;
+struct PL_Base;
 
 class VerilogParser {
   //________________________________________
@@ -475,8 +481,11 @@ class VerilogParser {
     Map<String,uint> pp_sym;    // Defined preprocessor symbols (with counter).
     Vec<uchar>       pp_nest;   // Each element corresponds to a nested `ifdef and describes its state.
 
-    Vec<char>   text;   // Contains text after preprocessing
-    Vec<Tok>    toks;   // Tokenized input; contain offsets into 'text'
+    Vec<char>   text;       // Contains text after preprocessing
+    Vec<Tok>    toks;       // Tokenized input; contain offsets into 'text'
+    Vec<uint>   mod_start;  // Index into 'toks' of each module definition (set by 'parse()')
+
+    Map<Str,Pair<uint,uint> > imap;     // Module item keywords (see 'module_items[]')
 
   //________________________________________
   //  Major internal methods:
@@ -485,6 +494,7 @@ class VerilogParser {
     void preprocessText(String filename, Array<char> raw);  // -- parse 'raw' (using 'filename' only for error messages)
     void tokenize();
     void parse(Vec<VerilogModule>& result);
+    void buildParallel(PL_Base& scan, Vec<VerilogModule>& result);
 
   //________________________________________
   //  Internal helpers:
@@ -503,6 +513,11 @@ class VerilogParser {
     Pair<Str,VExpr> parseConnect        (Tok*& p);
 
     void parse(ParserListener& pl);
+    void parseModule(Tok*& p, ParserListener& pl);
+        // -- Parses the module definition starting at 'p' (advancing 'p' past 'endmodule'). Only
+        // reads the parser state, so modules can be parsed concurrently by separate listeners.
+
+    friend struct ParallelBuild;
 
 public:
   //________________________________________
@@ -510,8 +525,10 @@ public:
 
     bool          store_names;
     VerilogErrors error_levels;
+    uint          n_threads;    // -- for building module netlists
+    VerilogStats* stats;        // -- if non-NULL, filled in by 'read()'
 
-    VerilogParser() : store_names(true) {}
+    VerilogParser();
 
     void read(String filename, /*out*/Vec<VerilogModule>& result, /*in*/Array<char> prelude);
 
@@ -652,10 +669,21 @@ bool VerilogParser::symExists(Str arg) const
 
 void VerilogParser::read(String filename, /*out*/Vec<VerilogModule>& result, /*in*/Array<char> prelude)
 {
+    double T0 = realTime();
     if (prelude)
         preprocessText("<prelude>", prelude);
     preprocess(filename);
+
+    double T1 = realTime();
     tokenize();
+
+    if (stats){
+        stats->n_bytes  = text.size();
+        stats->n_tokens = toks.size();
+        stats->t_read   = T1 - T0;
+        stats->t_lex    = realTime() - T1;
+    }
+
     parse(result);
 }
 
@@ -664,6 +692,40 @@ void VerilogParser::read(String filename, /*out*/Vec<VerilogModule>& result, /*i
 // -- Preprocessor:
 
 
+// Source file mapped copy-on-write; 'removeComments()' edits the text in place, so only pages
+// containing comments are actually copied. Compressed and non-regular files are read normally.
+struct SourceFile : NonCopyable {
+    Array<char> data;
+    bool        mapped;
+
+    SourceFile(String filename);
+   ~SourceFile() { if (mapped) munmap(data.base(), data.size()); else dispose(data); }
+};
+
+
+SourceFile::SourceFile(String filename) :
+    mapped(false)
+{
+    if (!hasExtension(filename, "gz")){
+        int fd = ::open(filename.c_str(), O_RDONLY);
+        if (fd != -1){
+            struct stat st;
+            if (fstat(fd, &st) == 0 && S_ISREG(st.st_mode) && st.st_size > 0){
+                void* base = mmap(NULL, st.st_size, PROT_READ | PROT_WRITE, MAP_PRIVATE, fd, 0);
+                if (base != MAP_FAILED){
+                    data = Array<char>((char*)base, st.st_size);
+                    mapped = true;
+                }
+            }
+            ::close(fd);
+        }
+    }
+
+    if (!mapped)
+        data = readFile(filename);
+}
+
+
 // NOTE! The special comment "// Verific Verilog Description of OPERATOR" will be replaced
 // by a fictitious keyword '__verific_operator__'. Same thing for '// [-BLACK BOX-]'
 // (becomes '__black_box__').
@@ -750,14 +812,13 @@ void VerilogParser::preprocess(String file_, String from_file, uint from_line)
             throw Excp_ParseError((FMT "[%_:%_] Recursive include statement.", from_file, from_line));
     pp_files.push(file);
 
-    Array<char> raw = readFile(file);
-    if (!raw){
+    SourceFile raw(file);
+    if (!raw.data){
         if (from_file != "") throw Excp_ParseError((FMT "[%_:%_] Missing include file: %_", from_file, from_line, file));
         else                 throw Excp_ParseError((FMT "Could not open: %_", file));
     }
 
-    preprocessText(file, raw);
-    dispose(raw);
+    preprocessText(file, raw.data);
 
     pp_files.pop();
 }
@@ -775,6 +836,7 @@ void VerilogParser::preprocessText(String file, Array<char> raw)
         throw Excp_ParseError((FMT "Unterminated multi-line comment in file: %_", file));
 
     Push_Location(1, file);
+    text.reserve(text.size() + raw.size() + 1);
 
     uint      line = 0;
     uint      nominal_line = 0;         // -- for `line statements
@@ -783,11 +845,8 @@ void VerilogParser::preprocessText(String file, Array<char> raw)
     cchar*    end = &raw.end_();
     while (p != end){
         // Scan one line:
-        cchar* q = p;
-        for(;;){
-            if (q == end || *q == '\n') break;
-            q++;
-        }
+        cchar* q = (cchar*)memchr(p, '\n', end - p);
+        if (!q) q = end;
         Str buf = slice(*p, *q);
         p = q;
         if (*p == '\n') p++;
@@ -908,13 +967,14 @@ void VerilogParser::preprocessText(String file, Array<char> raw)
 
         }else if (pp_nest.size() == 0 || pp_nest.last() == UNDER_MATCH){
             // Program text:
-            for (uind i = 0; i < buf.size(); i++){
-                char c = buf[i];
-                if (c == 0)
+            if (buf.size() > 0){
+                if (memchr(buf.base(), 0, buf.size()))
                     throw Excp_ParseError((FMT "[%_:%_] Input file cannot contain characer 0.", file, line));
-                if (c == '`')
+                if (memchr(buf.base(), '`', buf.size()))
                     throw Excp_ParseError((FMT "[%_:%_] Stray preprocessor character: `", file, line));
-                text.push(c);
+                uind n = text.size();
+                text.growTo(n + buf.size());
+                memcpy(&text[n], buf.base(), buf.size());
             }
         }
 
@@ -1196,6 +1256,9 @@ struct ParserListener {
         // but this is not checked for by parser. If unnamed, the 'Str' part 'of 'conns'
         // is the NULL array 'Str()'.
 
+    virtual void skippedInstance(Str mod_name) {}
+        // -- Module instantiation skipped in 'ARGS_ONLY' mode (only the module name is parsed).
+
     virtual void assign(Str lhs_name, uint lhs_index, const VExpr& rhs) {}
         // -- Continuous assignment. If 'lhs_index == UINT_MAX', then there is no array indexing.
 
@@ -1229,13 +1292,6 @@ struct PL_Base : ParserListener {
     Vec<Str>            mod_id2name;
     Vec<VArgData>       args;           // -- 'args[mod_id]' give all information on formal arguments
     Vec<NetlistRef>     netlists;       // -- 'netlists[mod_id]' gives netlist for that module
-
-    void moveTo(PL_Base& dst) {
-        mod_name2id.moveTo(dst.mod_name2id);
-        mod_id2name.moveTo(dst.mod_id2name);
-        args.moveTo(dst.args);
-        netlists.moveTo(dst.netlists);
-    }
 };
 
 
@@ -1244,13 +1300,29 @@ struct PL_Base : ParserListener {
 
 
 struct ScanModules : PL_Base {
+    Set<Str>    inst_mods;      // -- names of all instantiated modules
+
+    bool undefinedModules() const;
+        // -- Are some modules instantiated without being defined?
+
     // ParserListener interface:
     Mode newModule(Str mod_name, const Vec<Str>& formals, bool verific_op, bool black_box);
     void argDecl(VArgKind kind, Pair<uint,uint> range, const Vec<Str>& vars);
     void endModule();
+    void skippedInstance(Str mod_name) { inst_mods.add(mod_name); }
 };
 
 
+bool ScanModules::undefinedModules() const
+{
+    For_Set(inst_mods){
+        if (!mod_name2id.has(Set_Key(inst_mods)))
+            return true;
+    }
+    return false;
+}
+
+
 ParserListener::Mode ScanModules::newModule(Str mod_name, const Vec<Str>& formals, bool verific_op, bool black_box)
 {
     // Add module:
@@ -1333,8 +1405,13 @@ struct BM_Net {
 };
 
 
-struct BuildModules : PL_Base {
-    Vec<VerilogModule>  mods;       // -- list of all modules
+struct BuildModules : ParserListener {
+    Map<Str,uint>&      mod_name2id;    // }
+    Vec<Str>&           mod_id2name;    // }- From the scan phase; shared (and only read) if modules are
+    Vec<VArgData>&      args;           // }  built in parallel.
+    Vec<NetlistRef>&    netlists;       // }
+
+    Vec<VerilogModule>& mods;       // -- list of all modules
     uint                mod_id;     // -- active module
 
     Map<Str,uint>       lname2id;   // -- local name ("lname") to ID; different from argument name ID in 'args'.
@@ -1347,8 +1424,11 @@ struct BuildModules : PL_Base {
     // Options:
     bool            store_names;
     VerilogErrors   error_levels;
+    Out&            out;            // -- warnings are written here
+
+    BuildModules(PL_Base& scan, Vec<VerilogModule>& mods_, bool store_names_, VerilogErrors error_levels_, Out& out_ = std_out);
 
-    BuildModules(PL_Base& scan, bool store_names_, VerilogErrors error_levels_);
+    void clearModule();
 
     uint addName(Str lname, uint width_);
     uint lookup(Str lname);
@@ -1372,15 +1452,32 @@ struct BuildModules : PL_Base {
 };
 
 
-BuildModules::BuildModules(PL_Base& scan, bool store_names_, VerilogErrors error_levels_) :
+BuildModules::BuildModules(PL_Base& scan, Vec<VerilogModule>& mods_, bool store_names_, VerilogErrors error_levels_, Out& out_) :
+    mod_name2id(scan.mod_name2id),
+    mod_id2name(scan.mod_id2name),
+    args(scan.args),
+    netlists(scan.netlists),
+    mods(mods_),
     width(UINT_MAX),
     gates(glit_NULL),
     store_names(store_names_),
-    error_levels(error_levels_)
+    error_levels(error_levels_),
+    out(out_)
+{
+    mod_id = UINT_MAX;
+    idC = 0;
+}
+
+
+// Clean up local data (after a module is done or its parsing failed).
+void BuildModules::clearModule()
 {
-    scan.moveTo(*this);
     mod_id = UINT_MAX;
     idC = 0;
+    lname2id.clear();
+    width.clear();
+    gates.clear();
+    nets.clear();
 }
 
 
@@ -1406,7 +1503,7 @@ inline uint BuildModules::lookup(Str lname)
         if (error_levels.undeclared_symbols == vel_Ignore){
             id = addName(lname, 1);
         }else if (error_levels.undeclared_symbols == vel_Warning){
-            WriteLn "WARNING! Net '\a/%_\a/' in module '\a*%_\a*' not declared.  (assumed to be single bit)", lname, mods[mod_id].mod_name;
+            FWriteLn(out) "WARNING! Net '\a/%_\a/' in module '\a*%_\a*' not declared.  (assumed to be single bit)", lname, mods[mod_id].mod_name;
             id = addName(lname, 1);
         }else
             throw String((FMT "Net not declared: %_", lname));
@@ -1613,7 +1710,7 @@ void BuildModules::endModule()
             if (!gates[sym_id + i]){
                 if (!arg.black_box){
                     if (error_levels.no_driver == vel_Warning)
-                        WriteLn "WARNING! Net '\a/%_%_\a/' in module '\a*%_\a*' has no driver.  (added pseudo-input)", name, (width[sym_id] == 1) ? String() : String((FMT "[%_]", i)), M.mod_name;
+                        FWriteLn(out) "WARNING! Net '\a/%_%_\a/' in module '\a*%_\a*' has no driver.  (added pseudo-input)", name, (width[sym_id] == 1) ? String() : String((FMT "[%_]", i)), M.mod_name;
                     else if (error_levels.no_driver == vel_Error)
                         throw String((FMT "Net has no driver: %_[%_]", (width[sym_id] == 1) ? String() : String((FMT "[%_]", i)) ));
                 }
@@ -1645,7 +1742,7 @@ void BuildModules::endModule()
             Wire w_po = N[M.out_gate[num]];
             if (!w){
                 if (error_levels.no_driver == vel_Warning){
-                    WriteLn "WARNING! Missing definition for output signal: \a/%_%_\a/  (added pseudo-input)", arg_name, (width[sym_id] == 1) ? String() : String((FMT "[%_]", i));
+                    FWriteLn(out) "WARNING! Missing definition for output signal: \a/%_%_\a/  (added pseudo-input)", arg_name, (width[sym_id] == 1) ? String() : String((FMT "[%_]", i));
                 }else if (error_levels.no_driver == vel_Error)
                     throw String((FMT "Missing definition for output signal: %_%_", arg_name, (width[sym_id] == 1) ? String() : String((FMT "[%_]", i)) ));
                 w = N.add(PI_());       // -- add pseudo-input
@@ -1666,7 +1763,7 @@ void BuildModules::endModule()
         For_Gates(N, w){
             if (type(w) != gate_PO && fanout_count[w] == 0){
                 if (error_levels.dangling_logic == vel_Warning)
-                    WriteLn "WARNING! Module contains dangling logic: \a*%_\a*  (gate: \a/%_\a/)", M.mod_name, N.names().get(w);
+                    FWriteLn(out) "WARNING! Module contains dangling logic: \a*%_\a*  (gate: \a/%_\a/)", M.mod_name, N.names().get(w);
                 else if (error_levels.dangling_logic == vel_Error)
                     throw String((FMT "Module contains dangling logic: %_  (gate: %_)", M.mod_name, N.names().get(w)));
             }
@@ -1676,13 +1773,7 @@ void BuildModules::endModule()
     if (!removeBuffers(N))
         throw String((FMT "Module contains infinte loop among buffers/inverters: %_", M.mod_name));
 
-    // Clean up local data:
-    mod_id = UINT_MAX;
-    idC = 0;
-    lname2id.clear();
-    width.clear();
-    gates.clear();
-    nets.clear();
+    clearModule();
 }
 
 
@@ -1719,7 +1810,7 @@ void BuildModules::instance(Str mod_name, Str inst_name, const Vec<Pair<Str,VExp
         else{
             // Unknown module, guessing interface:
             if (error_levels.undefined_module == vel_Warning)
-                WriteLn "WARNING! Module '\a*%_\a*' used in '\a*%_\a*' is not defined.  (guessing interface)", mod_name, M.mod_name;
+                FWriteLn(out) "WARNING! Module '\a*%_\a*' used in '\a*%_\a*' is not defined.  (guessing interface)", mod_name, M.mod_name;
 
             // Add empty module:
             submod_id = mod_id2name.size();
@@ -1863,7 +1954,7 @@ void BuildModules::instance(Str mod_name, Str inst_name, const Vec<Pair<Str,VExp
             if (error_levels.unused_output == vel_Error)
                 throw String((FMT "Unused output(s) in instance '%_' of module '%_'.", inst_name, mod_name));
             else if (error_levels.unused_output == vel_Warning)
-                WriteLn "WARNING! Unused output(s) in instance '\a/%_\a/' of module '\a*%_\a*'.", inst_name, mod_name;
+                FWriteLn(out) "WARNING! Unused output(s) in instance '\a/%_\a/' of module '\a*%_\a*'.", inst_name, mod_name;
 
         }else{
             Vec<int>& ns = conn_nets [outputs[i]];
@@ -2054,16 +2145,145 @@ void BuildModules::end()
 // -- Parser: Main method
 
 
+VerilogParser::VerilogParser() :
+    store_names(true),
+    n_threads(1),
+    stats(NULL)
+{
+    for (uind i = 0; i < elemsof(module_items); i++)
+        imap.set(slize(module_items[i].sym), make_tuple((uint)module_items[i].item, (uint)module_items[i].sub));
+}
+
+
 void VerilogParser::parse(Vec<VerilogModule>& result)
 {
+    double T0 = realTime();
     ScanModules scan;
     parse(scan);
 
-    BuildModules build(scan, store_names, error_levels);
-    parse(build);
-    build.mods.moveTo(result);
+    double T1 = realTime();
+    result.clear();
+
+    // The interface of an undefined module is guessed from its first instantiation, which would
+    // make the result depend on thread scheduling; such designs are built sequentially.
+    uint n_used = 1;
+  #if defined(ZZ_PTHREADS)
+    if (n_threads > 1 && mod_start.size() > 1 && !scan.undefinedModules()){
+        n_used = min_(n_threads, (uint)mod_start.size());
+        buildParallel(scan, result);
+    }
+  #endif
+    if (n_used == 1){
+        BuildModules build(scan, result, store_names, error_levels);
+        parse(build);
+    }
+
+    if (stats){
+        stats->n_modules = mod_start.size();
+        stats->n_threads = n_used;
+        stats->t_scan    = T1 - T0;
+        stats->t_build   = realTime() - T1;
+    }
+}
+
+
+//=================================================================================================
+// -- Parser: Parallel build
+
+
+#if defined(ZZ_PTHREADS)
+
+struct ParallelBuild {
+    VerilogParser&      P;
+    PL_Base&            scan;
+    Vec<VerilogModule>& mods;
+
+    Vec<uint>           order;      // -- modules, largest first (for load balancing)
+    volatile uint       next;       // -- next index into 'order' to claim
+    Vec<Vec<char> >     log;        // -- warnings of each module
+    Vec<String>         error;      // -- error message of each module (empty if none)
+
+    ParallelBuild(VerilogParser& P_, PL_Base& scan_, Vec<VerilogModule>& mods_) :
+        P(P_), scan(scan_), mods(mods_), next(0) {}
+
+    void worker();
+};
+
+
+extern "C" void* verilogBuildThread(void* data);
+void* verilogBuildThread(void* data)
+{
+    static_cast<ParallelBuild*>(data)->worker();
+    return NULL;
+}
+
+
+// Each thread has its own 'BuildModules' (for the module-local tables) and writes only to the
+// netlist and 'VerilogModule' of the module it is building.
+void ParallelBuild::worker()
+{
+    Out buf;
+    BuildModules build(scan, mods, P.store_names, P.error_levels, buf);
+
+    for(;;){
+        uint i = atomicAdd(&next, 1u);
+        if (i >= order.size()) break;
+
+        uint m = order[i];
+        VerilogParser::Tok* p = &P.toks[P.mod_start[m]];
+        try{
+            P.parseModule(p, build);
+        }catch (Excp_ParseError err){
+            error[m] = err.msg;
+            build.clearModule();
+        }
+        buf.vec().moveTo(log[m]);
+    }
+}
+
+
+void VerilogParser::buildParallel(PL_Base& scan, Vec<VerilogModule>& result)
+{
+    uint n_mods = mod_start.size();
+    uint n_thr  = min_(n_threads, n_mods);
+    result.growTo(scan.mod_id2name.size());     // -- never reallocated by the workers
+
+    ParallelBuild pb(*this, scan, result);
+    pb.log  .growTo(n_mods);
+    pb.error.growTo(n_mods);
+
+    Vec<Pair<uint,uint> > sz;
+    for (uint i = 0; i < n_mods; i++){
+        uint end = (i+1 < n_mods) ? mod_start[i+1] : toks.size() - 1;
+        sz.push(make_tuple(end - mod_start[i], i));
+    }
+    sort_reverse(sz);
+    for (uint i = 0; i < n_mods; i++)
+        pb.order.push(sz[i].snd);
+
+    Vec<pthread_t> threads(n_thr);
+    for (uint t = 1; t < n_thr; t++){
+        if (pthread_create(&threads[t], NULL, verilogBuildThread, &pb) != 0){
+            ShoutLn "ERROR! Could not create Verilog parser thread.";
+            exit(1); }
+    }
+    pb.worker();
+    for (uint t = 1; t < n_thr; t++)
+        pthread_join(threads[t], NULL);
+
+    // Output warnings and the first error in module order (same as a sequential build):
+    for (uint i = 0; i < n_mods; i++){
+        for (uind j = 0; j < pb.log[i].size(); j++)
+            std_out.push(pb.log[i][j]);
+        if (pb.error[i] != "")
+            throw Excp_ParseError(pb.error[i]);
+    }
 }
 
+#else
+void VerilogParser::buildParallel(PL_Base&, Vec<VerilogModule>&) { assert(false); }
+#endif
+
 
 //=================================================================================================
 // -- Parser: Recursive decent parser
@@ -2287,255 +2507,258 @@ Pair<Str,VExpr> VerilogParser::parseConnect(Tok*& p)
 
 void VerilogParser::parse(ParserListener& pl)
 {
-    // Setup module item map:
-    Map<Str,Pair<uint,uint> > imap;
-    for (uind i = 0; i < elemsof(module_items); i++)
-        imap.set(slize(module_items[i].sym), make_tuple((uint)module_items[i].item, (uint)module_items[i].sub));
-
-    // Parse modules:
     Tok* p = toks.base();
-    Tok* p0 = p;
+    mod_start.clear();
+    while (TOK != tok_NULL){
+        mod_start.push(p - toks.base());
+        parseModule(p, pl);
+    }
+    pl.end();
+}
 
-    try{
-        while (TOK != tok_NULL){
-            // Read module header:
-            bool verific_op = false;
-            bool black_box  = false;
-            if (TOK == tok_Ident && eq(STR, "__verific_operator__")){
-                verific_op = true;
-                NEXT; }
-            if (TOK == tok_Ident && eq(STR, "__black_box__")){
-                black_box = true;
-                NEXT; }
 
-            if (TOK != tok_Ident || !eq(STR, "module")) throw Excp_ParseError((FMT "[%_] Expected module definition, not: %_", LOC, STR));
-            NEXT;
+void VerilogParser::parseModule(Tok*& p, ParserListener& pl)
+{
+    Tok* p0 = toks.base();
 
-            if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected module name, not: %_", LOC, STR));
-            Str module_name = STR;
-            NEXT;
+    try{
+        // Read module header:
+        bool verific_op = false;
+        bool black_box  = false;
+        if (TOK == tok_Ident && eq(STR, "__verific_operator__")){
+            verific_op = true;
+            NEXT; }
+        if (TOK == tok_Ident && eq(STR, "__black_box__")){
+            black_box = true;
+            NEXT; }
+
+        if (TOK != tok_Ident || !eq(STR, "module")) throw Excp_ParseError((FMT "[%_] Expected module definition, not: %_", LOC, STR));
+        NEXT;
 
-            if (TOK != tok_LParen) throw Excp_ParseError((FMT "[%_] Expected '(', not: %_", LOC, STR));
-            NEXT;
+        if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected module name, not: %_", LOC, STR));
+        Str module_name = STR;
+        NEXT;
 
-            Vec<Str> formals;
-            while (TOK != tok_RParen){
-                if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected formal argument, not: %_", LOC, STR));
-                formals.push(STR);
-                NEXT;
-                if (TOK == tok_Comma) NEXT;
-            }
-            NEXT;
+        if (TOK != tok_LParen) throw Excp_ParseError((FMT "[%_] Expected '(', not: %_", LOC, STR));
+        NEXT;
 
-            if (TOK != tok_Semi) throw Excp_ParseError((FMT "[%_] Expected ';' after module header, not: %_", LOC, STR));
+        Vec<Str> formals;
+        while (TOK != tok_RParen){
+            if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected formal argument, not: %_", LOC, STR));
+            formals.push(STR);
             NEXT;
+            if (TOK == tok_Comma) NEXT;
+        }
+        NEXT;
 
-          #ifdef PARSER_DEBUG
-            WriteLn "ModuleHead: name=%_  formals=%_%_", module_name, formals, (verific_op ? "  [verific-op]" : "");
-          #endif
-
-            ParserListener::Mode mode;
-            mode = pl.newModule(module_name, formals, verific_op, black_box);
+        if (TOK != tok_Semi) throw Excp_ParseError((FMT "[%_] Expected ';' after module header, not: %_", LOC, STR));
+        NEXT;
 
-            // Skip module?
-            if (mode == ParserListener::SKIP){      // <<== skip verific operators goes here?
-                while (!(TOK == tok_Ident && eq(STR, "endmodule")))
-                    NEXT;
-            }
+      #ifdef PARSER_DEBUG
+        WriteLn "ModuleHead: name=%_  formals=%_%_", module_name, formals, (verific_op ? "  [verific-op]" : "");
+      #endif
 
-            // Read module items:
-            for(;;){
-                if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected keyword or identifier, not: %_", LOC, STR));
+        ParserListener::Mode mode;
+        mode = pl.newModule(module_name, formals, verific_op, black_box);
 
-                Str sym = STR;
+        // Skip module?
+        if (mode == ParserListener::SKIP){      // <<== skip verific operators goes here?
+            while (!(TOK == tok_Ident && eq(STR, "endmodule")))
                 NEXT;
+        }
 
-                Pair<uint,uint>* m = NULL;
-                bool match = imap.peek(sym, m);
-
-                // Skip item?
-                if (mode == ParserListener::ARGS_ONLY && (!match || (m->fst != i_Arg && m->fst != i_End))){
-                    while (TOK != tok_Semi && TOK != tok_NULL) NEXT;
-                    if (TOK == tok_Semi) NEXT;
-
-                    continue;
-                }
+        // Read module items:
+        for(;;){
+            if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected keyword or identifier, not: %_", LOC, STR));
 
-                // Parse item:
-                if (!match){
-                    //
-                    // == MODULE INSTANTIATION ==
-                    //
-                    Str module_name = sym;
+            Str sym = STR;
+            NEXT;
 
-                    /*parse optional parameter value assignment here*/
+            Pair<uint,uint>* m = NULL;
+            bool match = imap.peek(sym, m);
 
-                    for(;;){
-                        if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected module instance name, not: %_", LOC, STR));
-                        Str instance_name = STR;
-                        NEXT;
+            // Skip item?
+            if (mode == ParserListener::ARGS_ONLY && (!match || (m->fst != i_Arg && m->fst != i_End))){
+                if (!match)
+                    pl.skippedInstance(sym);
+                while (TOK != tok_Semi && TOK != tok_NULL) NEXT;
+                if (TOK == tok_Semi) NEXT;
 
-                        if (TOK != tok_LParen) throw Excp_ParseError((FMT "[%_] Expected '(' not: %_", LOC, STR));
-                        NEXT;
+                continue;
+            }
 
-                        Vec<Pair<Str,VExpr> > conns;
-                        for(;;){
-                            conns.push(parseConnect(p));
-                            if (conns.last().snd->type == vx_NULL)
-                                conns.pop();
+            // Parse item:
+            if (!match){
+                //
+                // == MODULE INSTANTIATION ==
+                //
+                Str module_name = sym;
 
-                            if (TOK == tok_RParen){
-                                NEXT;
-                                break; }
-                            if (TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ')' or ',' in connection list, not: %_", LOC, STR));
-                            NEXT;
-                        }
+                /*parse optional parameter value assignment here*/
 
-                      #ifdef PARSER_DEBUG
-                        WriteLn "ModuleInst:  mod_name=%_  inst_name=%_  conns=%_", module_name, instance_name, conns;
-                      #endif
+                for(;;){
+                    if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected module instance name, not: %_", LOC, STR));
+                    Str instance_name = STR;
+                    NEXT;
 
-                        if (TOK != tok_Semi && TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ';' or ',' after module instance, not: %_", LOC, STR));
+                    if (TOK != tok_LParen) throw Excp_ParseError((FMT "[%_] Expected '(' not: %_", LOC, STR));
+                    NEXT;
 
-                        pl.instance(module_name, instance_name, conns);
+                    Vec<Pair<Str,VExpr> > conns;
+                    for(;;){
+                        conns.push(parseConnect(p));
+                        if (conns.last().snd->type == vx_NULL)
+                            conns.pop();
 
-                        if (TOK == tok_Semi){
+                        if (TOK == tok_RParen){
                             NEXT;
                             break; }
+                        if (TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ')' or ',' in connection list, not: %_", LOC, STR));
                         NEXT;
                     }
 
-                }else{
-                    //
-                    // == OTHER MODULE ITEM ==
-                    //
-                    switch (m->fst){
-                    case i_Arg:{
-                        Pair<uint,uint> rng = parseOptionalRange(p);
-                        Vec<Str> vars;
-                        parseListOfVariables(p, vars);  // -- swallows ';'
-
-                      #ifdef PARSER_DEBUG
-                        cchar* type_name[] = { "<null>", "Input", "Output", "Unsupp" };
-                        WriteLn "ArgDecl %_: [%_:%_] %_", type_name[m->snd], rng.fst, rng.snd, vars;
-                      #endif
-
-                        pl.argDecl((VArgKind)m->snd, rng, vars);
+                  #ifdef PARSER_DEBUG
+                    WriteLn "ModuleInst:  mod_name=%_  inst_name=%_  conns=%_", module_name, instance_name, conns;
+                  #endif
 
-                        break;}
+                    if (TOK != tok_Semi && TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ';' or ',' after module instance, not: %_", LOC, STR));
 
-                    case i_Net:{
-                        // if next token is "trireg", then the net declarion has a different syntax (ignoring for now)
+                    pl.instance(module_name, instance_name, conns);
 
-                        Pair<uint,uint> rng = parseOptionalRange(p);    // -- ignoring "scalared <range>" and "vectored <range>"
-                        /*parse optional delay here*/
-                        Vec<Str> vars;
-                        parseListOfVariables(p, vars);  // -- swallows ';'
+                    if (TOK == tok_Semi){
+                        NEXT;
+                        break; }
+                    NEXT;
+                }
 
-                      #ifdef PARSER_DEBUG
-                        cchar* type_name[] = { "<null>", "Wire", "Unsupp" };
-                        WriteLn "NetDecl %_: [%_:%_] %_", type_name[m->snd], rng.fst, rng.snd, vars;
-                      #endif
-                        pl.netDecl((VNetKind)m->snd, rng, vars);
+            }else{
+                //
+                // == OTHER MODULE ITEM ==
+                //
+                switch (m->fst){
+                case i_Arg:{
+                    Pair<uint,uint> rng = parseOptionalRange(p);
+                    Vec<Str> vars;
+                    parseListOfVariables(p, vars);  // -- swallows ';'
 
-                        break;}
+                  #ifdef PARSER_DEBUG
+                    cchar* type_name[] = { "<null>", "Input", "Output", "Unsupp" };
+                    WriteLn "ArgDecl %_: [%_:%_] %_", type_name[m->snd], rng.fst, rng.snd, vars;
+                  #endif
 
-                    case i_Assign:
-                        // we only support continues assignments of type 'x = <expr>' or 'x[<num>] = <expr>'
+                    pl.argDecl((VArgKind)m->snd, rng, vars);
 
-                        /*may parse "drive strength" and "delay" here*/
-                        for(;;){
-                            if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected lvalue identifier in 'assign', not: %_", LOC, STR));
-                            Str name = STR;
-                            NEXT;
+                    break;}
 
-                            uint idx = UINT_MAX;
-                            if (TOK == tok_LBrack){
-                                NEXT;
-                                if (TOK != tok_Num || !simpleNumber(STR)) throw Excp_ParseError((FMT "[%_] Expected constant number in array assignment: %_", LOC, STR));
-                                idx = stringToUInt64((Str)STR);
-                                NEXT;
+                case i_Net:{
+                    // if next token is "trireg", then the net declarion has a different syntax (ignoring for now)
 
-                                if (TOK != tok_RBrack) throw Excp_ParseError((FMT "[%_] Expected ']' after array index, not: %_", LOC, STR));
-                                NEXT;
-                            }
+                    Pair<uint,uint> rng = parseOptionalRange(p);    // -- ignoring "scalared <range>" and "vectored <range>"
+                    /*parse optional delay here*/
+                    Vec<Str> vars;
+                    parseListOfVariables(p, vars);  // -- swallows ';'
 
-                            if (TOK != tok_Assign) throw Excp_ParseError((FMT "[%_] Expected '=' in continuous assignment, not: %_", LOC, STR));
-                            NEXT;
+                  #ifdef PARSER_DEBUG
+                    cchar* type_name[] = { "<null>", "Wire", "Unsupp" };
+                    WriteLn "NetDecl %_: [%_:%_] %_", type_name[m->snd], rng.fst, rng.snd, vars;
+                  #endif
+                    pl.netDecl((VNetKind)m->snd, rng, vars);
 
-                            VExpr expr = parseExpr(p);
+                    break;}
 
-                          #ifdef PARSER_DEBUG
-                            if (idx == UINT_MAX)
-                                WriteLn "Assign %_ := %_", name, expr;
-                            else
-                                WriteLn "Assign %_[%_] := %_", name, idx, expr;
-                          #endif
+                case i_Assign:
+                    // we only support continues assignments of type 'x = <expr>' or 'x[<num>] = <expr>'
 
-                            if (TOK != tok_Semi && TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ';' or ',' in assignment list, not: %_", LOC, STR));
+                    /*may parse "drive strength" and "delay" here*/
+                    for(;;){
+                        if (TOK != tok_Ident) throw Excp_ParseError((FMT "[%_] Expected lvalue identifier in 'assign', not: %_", LOC, STR));
+                        Str name = STR;
+                        NEXT;
 
-                            pl.assign(name, idx, expr);
+                        uint idx = UINT_MAX;
+                        if (TOK == tok_LBrack){
+                            NEXT;
+                            if (TOK != tok_Num || !simpleNumber(STR)) throw Excp_ParseError((FMT "[%_] Expected constant number in array assignment: %_", LOC, STR));
+                            idx = stringToUInt64((Str)STR);
+                            NEXT;
 
-                            if (TOK == tok_Semi){
-                                NEXT;
-                                break; }
+                            if (TOK != tok_RBrack) throw Excp_ParseError((FMT "[%_] Expected ']' after array index, not: %_", LOC, STR));
                             NEXT;
                         }
 
-                        break;
+                        if (TOK != tok_Assign) throw Excp_ParseError((FMT "[%_] Expected '=' in continuous assignment, not: %_", LOC, STR));
+                        NEXT;
+
+                        VExpr expr = parseExpr(p);
 
-                    case i_Gate:{
-                        uint gate_type ___unused = m->snd;
-                        // Comma separated list of instances:
-                        for(;;){
-                            // (drive strength ("(supply0, weak1)") and delay ("#2+2") can come before name, but ignored for now)
-                            Str gate_name;
-                            if (TOK == tok_Ident){
-                                gate_name = STR;
-                                NEXT; }
+                      #ifdef PARSER_DEBUG
+                        if (idx == UINT_MAX)
+                            WriteLn "Assign %_ := %_", name, expr;
+                        else
+                            WriteLn "Assign %_[%_] := %_", name, idx, expr;
+                      #endif
+
+                        if (TOK != tok_Semi && TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ';' or ',' in assignment list, not: %_", LOC, STR));
+
+                        pl.assign(name, idx, expr);
 
-                            if (TOK != tok_LParen) throw Excp_ParseError((FMT "[%_] Expected '(', not: %_", LOC, STR));
+                        if (TOK == tok_Semi){
                             NEXT;
+                            break; }
+                        NEXT;
+                    }
 
-                            Vec<VExpr> args;      // -- must be non-empty
-                            for(;;){
-                                args.push(parseExpr(p));
+                    break;
 
-                                if (TOK == tok_RParen){
-                                    NEXT;
-                                    break; }
-                                if (TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ')' or ',' in argument list, not: %_", LOC, STR));
-                                NEXT;
-                            }
+                case i_Gate:{
+                    uint gate_type ___unused = m->snd;
+                    // Comma separated list of instances:
+                    for(;;){
+                        // (drive strength ("(supply0, weak1)") and delay ("#2+2") can come before name, but ignored for now)
+                        Str gate_name;
+                        if (TOK == tok_Ident){
+                            gate_name = STR;
+                            NEXT; }
 
-                          #ifdef PARSER_DEBUG
-                            cchar* type_name[] = { "NULL", "And", "Nand", "Or", "Nor", "Xor", "Xnor", "Not", "Buf", "Unsupp" };
-                            WriteLn "Gate:  type=%_  gate_name=%_  args=%_", type_name[m->snd], gate_name, args;
-                          #endif
+                        if (TOK != tok_LParen) throw Excp_ParseError((FMT "[%_] Expected '(', not: %_", LOC, STR));
+                        NEXT;
 
-                            pl.gate((VGateKind)m->snd, gate_name, args);
+                        Vec<VExpr> args;      // -- must be non-empty
+                        for(;;){
+                            args.push(parseExpr(p));
 
-                            if (TOK == tok_Semi){
+                            if (TOK == tok_RParen){
                                 NEXT;
                                 break; }
-
-                            if (TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ';' or ',' after module instance, not: %_", LOC, STR));
+                            if (TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ')' or ',' in argument list, not: %_", LOC, STR));
                             NEXT;
                         }
-                        break;}
 
-                    case i_Unsupp:
-                        throw Excp_ParseError((FMT "[%_] Unsupported module item: %_", LOC, sym));
+                      #ifdef PARSER_DEBUG
+                        cchar* type_name[] = { "NULL", "And", "Nand", "Or", "Nor", "Xor", "Xnor", "Not", "Buf", "Unsupp" };
+                        WriteLn "Gate:  type=%_  gate_name=%_  args=%_", type_name[m->snd], gate_name, args;
+                      #endif
 
-                    case i_End:
-                        pl.endModule();
-                        goto EndModule;
-                    default: assert(false); }
-                }
+                        pl.gate((VGateKind)m->snd, gate_name, args);
+
+                        if (TOK == tok_Semi){
+                            NEXT;
+                            break; }
+
+                        if (TOK != tok_Comma) throw Excp_ParseError((FMT "[%_] Expected ';' or ',' after module instance, not: %_", LOC, STR));
+                        NEXT;
+                    }
+                    break;}
+
+                case i_Unsupp:
+                    throw Excp_ParseError((FMT "[%_] Unsupported module item: %_", LOC, sym));
+
+                case i_End:
+                    pl.endModule();
+                    return;
+                default: assert(false); }
             }
-          EndModule:;
         }
-        pl.end();
 
     }catch (String msg){
         if (p != p0) p--;
@@ -2578,11 +2801,14 @@ void write_VerilogModule(Out& out, const VerilogModule& v)
 // Main function:
 
 
-void readVerilog(String file, bool store_names, VerilogErrors error_levels, /*out*/Vec<VerilogModule>& modules, /*in*/Array<char> prelude)
+void readVerilog(String file, bool store_names, VerilogErrors error_levels, /*out*/Vec<VerilogModule>& modules, /*in*/Array<char> prelude,
+                 uint n_threads, /*out*/VerilogStats* stats)
 {
     VerilogParser parser;
     parser.store_names  = store_names;
     parser.error_levels = error_levels;
+    parser.n_threads    = n_threads;
+    parser.stats        = stats;
     parser.read(file, modules, prelude);
 }
 
@@ -107,11 +107,28 @@ struct VerilogErrors {
 };
 
 
+struct VerilogStats {
+    uint64  n_bytes;        // -- size of source text (after preprocessing)
+    uint64  n_tokens;
+    uint    n_modules;      // -- modules defined in the source
+    uint    n_threads;      // -- threads actually used for building modules
+
+    double  t_read;         // -- reading and preprocessing (real time, all stages)
+    double  t_lex;
+    double  t_scan;         // -- first pass: module interfaces
+    double  t_build;        // -- second pass: module netlists
+
+    VerilogStats() : n_bytes(0), n_tokens(0), n_modules(0), n_threads(1), t_read(0), t_lex(0), t_scan(0), t_build(0) {}
+};
+
+
 void readVerilog(String file, bool store_names, VerilogErrors error_levels, /*out*/Vec<VerilogModule>& modules,
-                 /*in*/Array<char> prelude = Array<char>());
+                 /*in*/Array<char> prelude = Array<char>(), uint n_threads = 1, /*out*/VerilogStats* stats = NULL);
     // -- May throw 'Excp_ParseError'. Optional argument 'prelude' contains text that is added 
     // before the contents of 'file'. NOTE! Contents of 'prelude' may be changed (e.g. comments
-    // are spaced out).
+    // are spaced out). With 'n_threads > 1' (and 'ZZ_PTHREADS'), module bodies are built in
+    // parallel; the result (including warnings and which error is reported) is the same as for
+    // a single thread.
 
 
 //mmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmmm
@@ -17,6 +17,13 @@ set(_ZZ_PSEUDO_ROOT "${_ZZ_SOURCE_ROOT}")
 set(ZZ_INCLUDE_ROOT "${_ZZ_BINARY_ROOT}/__zz_include__")
 execute_process( COMMAND "${CMAKE_COMMAND}" -E make_directory ${ZZ_INCLUDE_ROOT} )
 
+# multi-threading support (see 'ZZ_PTHREADS' in Prelude.hh); affects all modules
+option(ZZ_PTHREADS "Compile with multi-threading support." OFF)
+
+if( ZZ_PTHREADS )
+    add_definitions(-DZZ_PTHREADS)
+endif()
+
 
 function(_zz_add_library name)
     add_library( ${name} EXCLUDE_FROM_ALL ${ARGN} )